@@ -0,0 +1,171 @@
+#include "AnimationClock.h"
+#include "duilib/Core/GlobalManager.h"
+#include "duilib/Core/Window.h"
+
+namespace ui
+{
+
+AnimationClock::AnimationClock(Window* pWindow):
+    m_pWindow(pWindow),
+    m_nNextAnimationId(1),
+    m_nFrameIntervalMs(16),
+    m_nHiddenFrameIntervalMs(250),
+    m_nTimerIntervalMs(0),
+    m_bTicking(false)
+{
+}
+
+AnimationClock::~AnimationClock()
+{
+    Clear();
+}
+
+size_t AnimationClock::AddAnimation(const std::weak_ptr<WeakFlag>& weakFlag, const AnimationTickCallback& callback)
+{
+    GlobalManager::Instance().AssertUIThread();
+    ASSERT(callback != nullptr);
+    if (callback == nullptr) {
+        return 0;
+    }
+    AnimationInfo animationInfo;
+    animationInfo.m_nAnimationId = m_nNextAnimationId++;
+    animationInfo.m_weakFlag = weakFlag;
+    animationInfo.m_callback = callback;
+    m_animations.push_back(animationInfo);
+    if (m_nTimerIntervalMs == 0) {
+        StartTimer();
+    }
+    return animationInfo.m_nAnimationId;
+}
+
+void AnimationClock::RemoveAnimation(size_t nAnimationId)
+{
+    for (AnimationInfo& animationInfo : m_animations) {
+        if (animationInfo.m_nAnimationId == nAnimationId) {
+            //帧回调执行过程中不能删除元素，只做标记，本帧结束后统一删除
+            animationInfo.m_callback = nullptr;
+            break;
+        }
+    }
+    if (!m_bTicking) {
+        RemoveExpiredAnimations();
+    }
+}
+
+size_t AnimationClock::GetAnimationCount() const
+{
+    size_t nCount = 0;
+    for (const AnimationInfo& animationInfo : m_animations) {
+        if ((animationInfo.m_callback != nullptr) && !animationInfo.m_weakFlag.expired()) {
+            ++nCount;
+        }
+    }
+    return nCount;
+}
+
+void AnimationClock::Clear()
+{
+    if (m_bTicking) {
+        for (AnimationInfo& animationInfo : m_animations) {
+            animationInfo.m_callback = nullptr;
+        }
+    }
+    else {
+        m_animations.clear();
+    }
+    m_timerFlag.Cancel();
+    m_nTimerIntervalMs = 0;
+}
+
+void AnimationClock::SetFrameInterval(uint32_t nFrameIntervalMs)
+{
+    ASSERT(nFrameIntervalMs > 0);
+    if ((nFrameIntervalMs > 0) && (m_nFrameIntervalMs != nFrameIntervalMs)) {
+        m_nFrameIntervalMs = nFrameIntervalMs;
+        if (m_nTimerIntervalMs != 0) {
+            StartTimer();
+        }
+    }
+}
+
+uint32_t AnimationClock::GetFrameInterval() const
+{
+    return m_nFrameIntervalMs;
+}
+
+void AnimationClock::SetHiddenFrameInterval(uint32_t nFrameIntervalMs)
+{
+    ASSERT(nFrameIntervalMs > 0);
+    if (nFrameIntervalMs > 0) {
+        m_nHiddenFrameIntervalMs = nFrameIntervalMs;
+    }
+}
+
+uint32_t AnimationClock::GetHiddenFrameInterval() const
+{
+    return m_nHiddenFrameIntervalMs;
+}
+
+uint32_t AnimationClock::GetCurrentFrameInterval() const
+{
+    if ((m_pWindow != nullptr) && m_pWindow->IsWindow()) {
+        if (!m_pWindow->IsWindowVisible() || m_pWindow->IsWindowMinimized()) {
+            //窗口不可见，降低动画的刷新频率
+            return std::max(m_nHiddenFrameIntervalMs, m_nFrameIntervalMs);
+        }
+    }
+    return m_nFrameIntervalMs;
+}
+
+void AnimationClock::StartTimer()
+{
+    m_timerFlag.Cancel();
+    m_nTimerIntervalMs = GetCurrentFrameInterval();
+    auto tickCallback = UiBind(&AnimationClock::OnTick, this);
+    GlobalManager::Instance().Timer().AddTimer(m_timerFlag.GetWeakFlag(), tickCallback, m_nTimerIntervalMs);
+}
+
+void AnimationClock::RemoveExpiredAnimations()
+{
+    auto iter = m_animations.begin();
+    while (iter != m_animations.end()) {
+        if ((iter->m_callback == nullptr) || iter->m_weakFlag.expired()) {
+            iter = m_animations.erase(iter);
+        }
+        else {
+            ++iter;
+        }
+    }
+    if (m_animations.empty()) {
+        //没有动画，停止定时器
+        m_timerFlag.Cancel();
+        m_nTimerIntervalMs = 0;
+    }
+}
+
+void AnimationClock::OnTick()
+{
+    std::weak_ptr<WeakFlag> weakFlag = GetWeakFlag();
+    m_bTicking = true;
+    //只处理本帧开始前添加的动画，帧回调中添加的动画从下一帧开始播放
+    const size_t nCount = m_animations.size();
+    for (size_t nIndex = 0; nIndex < nCount; ++nIndex) {
+        if ((m_animations[nIndex].m_callback == nullptr) || m_animations[nIndex].m_weakFlag.expired()) {
+            continue;
+        }
+        //复制一份回调函数，回调过程中可能会添加动画，导致容器重新分配
+        AnimationTickCallback callback = m_animations[nIndex].m_callback;
+        callback();
+        if (weakFlag.expired()) {
+            return;
+        }
+    }
+    m_bTicking = false;
+    RemoveExpiredAnimations();
+    if ((m_nTimerIntervalMs != 0) && (m_nTimerIntervalMs != GetCurrentFrameInterval())) {
+        //窗口的可见状态发生变化，调整帧间隔
+        StartTimer();
+    }
+}
+
+} // namespace ui
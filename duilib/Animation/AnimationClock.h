@@ -0,0 +1,127 @@
+#ifndef UI_ANIMATION_ANIMATIONCLOCK_H_
+#define UI_ANIMATION_ANIMATIONCLOCK_H_
+
+#include "duilib/duilib_defs.h"
+#include "duilib/Core/Callback.h"
+#include <vector>
+
+namespace ui
+{
+class Window;
+
+/** 动画帧的回调函数原型：void FunctionName();
+*/
+typedef std::function<void(void)> AnimationTickCallback;
+
+/** 窗口的动画时钟：窗口内所有正在播放的动画（AnimationPlayer、GIF动画等）共用一个定时器，
+*   每帧统一触发一次，动画产生的重绘区域合并到同一次绘制中；
+*   窗口隐藏或者最小化时，降低触发频率，减少CPU占用
+*/
+class UILIB_API AnimationClock : public virtual SupportWeakCallback
+{
+public:
+    explicit AnimationClock(Window* pWindow);
+    virtual ~AnimationClock() override;
+    AnimationClock(const AnimationClock& r) = delete;
+    AnimationClock& operator=(const AnimationClock& r) = delete;
+
+public:
+    /** 添加一个动画
+    * @param [in] weakFlag 动画的取消机制，如果weakFlag.expired()为true，自动移除该动画
+    * @param [in] callback 每帧的回调函数
+    * @return 返回动画ID（大于0），可用于RemoveAnimation
+    */
+    size_t AddAnimation(const std::weak_ptr<WeakFlag>& weakFlag, const AnimationTickCallback& callback);
+
+    /** 移除一个动画
+    * @param [in] nAnimationId 动画ID，即AddAnimation的返回值
+    */
+    void RemoveAnimation(size_t nAnimationId);
+
+    /** 获取正在播放的动画个数
+    */
+    size_t GetAnimationCount() const;
+
+    /** 移除所有动画
+    */
+    void Clear();
+
+    /** 设置帧间隔（单位：毫秒），默认为16毫秒（约60帧/秒）
+    */
+    void SetFrameInterval(uint32_t nFrameIntervalMs);
+
+    /** 获取帧间隔（单位：毫秒）
+    */
+    uint32_t GetFrameInterval() const;
+
+    /** 设置窗口隐藏或者最小化时的帧间隔（单位：毫秒），默认为250毫秒
+    */
+    void SetHiddenFrameInterval(uint32_t nFrameIntervalMs);
+
+    /** 获取窗口隐藏或者最小化时的帧间隔（单位：毫秒）
+    */
+    uint32_t GetHiddenFrameInterval() const;
+
+private:
+    /** 定时器触发，播放一帧
+    */
+    void OnTick();
+
+    /** 按当前窗口状态，启动（或者重新启动）定时器
+    */
+    void StartTimer();
+
+    /** 获取当前应使用的帧间隔
+    */
+    uint32_t GetCurrentFrameInterval() const;
+
+    /** 删除已经移除或者失效的动画
+    */
+    void RemoveExpiredAnimations();
+
+private:
+    /** 动画信息
+    */
+    struct AnimationInfo
+    {
+        size_t m_nAnimationId = 0;          //动画ID
+        std::weak_ptr<WeakFlag> m_weakFlag; //取消机制
+        AnimationTickCallback m_callback;   //每帧的回调函数(为nullptr表示已经移除)
+    };
+
+    /** 关联的窗口
+    */
+    Window* m_pWindow;
+
+    /** 所有正在播放的动画
+    */
+    std::vector<AnimationInfo> m_animations;
+
+    /** 下一个动画ID
+    */
+    size_t m_nNextAnimationId;
+
+    /** 帧间隔（单位：毫秒）
+    */
+    uint32_t m_nFrameIntervalMs;
+
+    /** 窗口隐藏时的帧间隔（单位：毫秒）
+    */
+    uint32_t m_nHiddenFrameIntervalMs;
+
+    /** 当前定时器的时间间隔（单位：毫秒），为0表示定时器未启动
+    */
+    uint32_t m_nTimerIntervalMs;
+
+    /** 是否正在执行帧回调
+    */
+    bool m_bTicking;
+
+    /** 定时器的取消机制
+    */
+    WeakCallbackFlag m_timerFlag;
+};
+
+} // namespace ui
+
+#endif // UI_ANIMATION_ANIMATIONCLOCK_H_
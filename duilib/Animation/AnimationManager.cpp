@@ -20,11 +20,22 @@ AnimationPlayer* AnimationManager::GetAnimationPlayer(AnimationType animationTyp
     }
 }
 
+bool AnimationManager::IsAnimationPlaying() const
+{
+    for (auto it = m_animationMap.begin(); it != m_animationMap.end(); ++it) {
+        if ((it->second != nullptr) && it->second->IsPlaying()) {
+            return true;
+        }
+    }
+    return false;
+}
+
 AnimationPlayer* AnimationManager::SetFadeHot(bool bFadeHot)
 {
     AnimationPlayer* animationArgs = nullptr;
     if (bFadeHot) {
         animationArgs = new AnimationPlayer();
+        animationArgs->SetControl(m_pControl);
         animationArgs->SetAnimationType(AnimationType::kAnimationHot);
         animationArgs->SetStartValue(0);
         animationArgs->SetEndValue(255);
@@ -47,6 +58,7 @@ AnimationPlayer* AnimationManager::SetFadeAlpha(bool bFadeVisible)
     AnimationPlayer* animationArgs = nullptr;
     if (bFadeVisible) {
         animationArgs = new AnimationPlayer();
+        animationArgs->SetControl(m_pControl);
         animationArgs->SetAnimationType(AnimationType::kAnimationAlpha);
         animationArgs->SetStartValue(0);
         animationArgs->SetEndValue(255);
@@ -77,6 +89,7 @@ AnimationPlayer* AnimationManager::SetFadeWidth(bool bFadeWidth)
     }
     if (bFadeWidth && (cx > 0)) {
         animationArgs = new AnimationPlayer();
+        animationArgs->SetControl(m_pControl);
         animationArgs->SetAnimationType(AnimationType::kAnimationWidth);
         animationArgs->SetStartValue(0);
         animationArgs->SetEndValue(cx);
@@ -105,6 +118,7 @@ AnimationPlayer* AnimationManager::SetFadeHeight(bool bFadeHeight)
     }
     if (bFadeHeight && (cy > 0)) {
         animationArgs = new AnimationPlayer();
+        animationArgs->SetControl(m_pControl);
         animationArgs->SetAnimationType(AnimationType::kAnimationHeight);
         animationArgs->SetStartValue(0);
         animationArgs->SetEndValue(cy);
@@ -135,6 +149,7 @@ AnimationPlayer* AnimationManager::SetFadeInOutX(bool bFade, bool bIsFromRight)
     }
     if (bFade) {
         animationArgs = new AnimationPlayer();
+        animationArgs->SetControl(m_pControl);
         animationArgs->SetEndValue(0);
         animationArgs->SetSpeedUpRatio(0.3);
         animationArgs->SetSpeedUpfactorA(0.006);
@@ -178,6 +193,7 @@ AnimationPlayer* AnimationManager::SetFadeInOutY(bool bFade, bool bIsFromBottom)
     }
     if (bFade) {
         animationArgs = new AnimationPlayer();
+        animationArgs->SetControl(m_pControl);
         animationArgs->SetEndValue(0);
         animationArgs->SetSpeedUpRatio(0.3);
         animationArgs->SetSpeedUpfactorA(0.006);
@@ -29,6 +29,10 @@ public:
     */
     AnimationPlayer* GetAnimationPlayer(AnimationType animationType) const;
 
+    /** 是否有正在播放的动画
+    */
+    bool IsAnimationPlaying() const;
+
     /** 设置或清除播放动画，对应动画类型为：kAnimationAlpha
     * @param [in] bFadeHot true表示设置动画，false表示清除动画
     * @return 设置时返回动画播放接口，清除时返回nullptr
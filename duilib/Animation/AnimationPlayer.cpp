@@ -1,5 +1,8 @@
 #include "AnimationPlayer.h"
 #include "duilib/Core/GlobalManager.h"
+#include "duilib/Core/Control.h"
+#include "duilib/Core/Window.h"
+#include "duilib/Animation/AnimationClock.h"
 
 #define AP_NO_VALUE -1
 
@@ -14,7 +17,8 @@ AnimationPlayerBase::AnimationPlayerBase():
     m_animationType(AnimationType::kAnimationNone),
     m_bFirstRun(true),
     m_playCallback(nullptr),
-    m_completeCallback(nullptr)
+    m_completeCallback(nullptr),
+    m_pControl(nullptr)
 {
     InitBaseData();
 }
@@ -110,9 +114,19 @@ void AnimationPlayerBase::StartTimer()
     }
 
     Play();
+    if (!m_bPlaying) {
+        return;
+    }
     auto playCallback = UiBind(&AnimationPlayerBase::Play, this);
-    ASSERT(m_elapseMillSeconds <= INT32_MAX);
-    GlobalManager::Instance().Timer().AddTimer(m_weakFlagOwner.GetWeakFlag(), playCallback, (uint32_t)m_elapseMillSeconds);
+    Window* pWindow = (m_pControl != nullptr) ? m_pControl->GetWindow() : nullptr;
+    if ((pWindow != nullptr) && pWindow->IsWindow()) {
+        //由窗口的动画时钟统一驱动，同一帧内的所有动画合并绘制
+        pWindow->GetAnimationClock().AddAnimation(m_weakFlagOwner.GetWeakFlag(), playCallback);
+    }
+    else {
+        ASSERT(m_elapseMillSeconds <= INT32_MAX);
+        GlobalManager::Instance().Timer().AddTimer(m_weakFlagOwner.GetWeakFlag(), playCallback, (uint32_t)m_elapseMillSeconds);
+    }
 }
 
 void AnimationPlayerBase::Play()
@@ -7,6 +7,7 @@
 
 namespace ui 
 {
+class Control;
 
 typedef std::function<void (int64_t)> PlayCallback;        //播放回调函数
 typedef std::function<void (void)> CompleteCallback;    //播放完成回调函数
@@ -63,6 +64,14 @@ public:
     */
     void SetCompleteCallback(const CompleteCallback& callback) { m_completeCallback = callback; }
 
+    /** 设置关联的控件：如果控件已经关联窗口，动画使用窗口的动画时钟驱动，否则使用独立的定时器
+    */
+    void SetControl(Control* pControl) { m_pControl = pControl; }
+
+    /** 获取关联的控件
+    */
+    Control* GetControl() const { return m_pControl; }
+
     /** 停止并清理资源
     */
     void Clear();
@@ -180,6 +189,10 @@ protected:
     /** 定时器终止标志
     */
     WeakCallbackFlag m_weakFlagOwner;
+
+    /** 关联的控件
+    */
+    Control* m_pControl;
 };
 
 
@@ -4,6 +4,7 @@
 #include "duilib/Core/Keyboard.h"
 #include "duilib/Box/VirtualHTileLayout.h"
 #include "duilib/Box/VirtualVTileLayout.h"
+#include <set>
 
 namespace ui 
 {
@@ -27,7 +28,8 @@ ListBox::ListBox(Window* pWindow, Layout* pLayout) :
     m_bSelectNextWhenActiveRemoved(false),
     m_bMultiSelect(false),
     m_bSelectLikeListCtrl(false),
-    m_bSelectNoneWhenClickBlank(true)
+    m_bSelectNoneWhenClickBlank(true),
+    m_bSelChangePending(false)
 {
 }
 
@@ -1292,9 +1294,24 @@ int32_t ListBox::CalcVTileRows(VTileLayout* pVTileLayout) const
 
 void ListBox::SendEventMsg(const EventArgs& msg)
 {
+    if (IsUpdating() && (msg.GetSender() == this) &&
+        ((msg.eventType == kEventSelect) || (msg.eventType == kEventUnSelect) || (msg.eventType == kEventSelChange))) {
+        //批量更新期间，选择事件合并为一个kEventSelChange事件，在EndUpdate时触发
+        m_bSelChangePending = true;
+        return;
+    }
     ScrollBox::SendEventMsg(msg);
 }
 
+void ListBox::OnEndUpdate()
+{
+    BaseClass::OnEndUpdate();
+    if (m_bSelChangePending) {
+        m_bSelChangePending = false;
+        SendEvent(kEventSelChange);
+    }
+}
+
 size_t ListBox::GetCurSel() const
 {
     return m_iCurSel;
@@ -2062,6 +2079,45 @@ bool ListBox::RemoveItemAt(size_t iIndex)
     return true;
 }
 
+bool ListBox::AddItemsAt(const std::vector<Control*>& controls, size_t iIndex)
+{
+    ASSERT(iIndex <= GetItemCount());
+    if (iIndex > GetItemCount()) {
+        return false;
+    }
+    AutoBoxUpdate autoUpdate(this);
+    bool bRet = true;
+    size_t nAddedCount = 0;
+    for (Control* pControl : controls) {
+        //子项的索引号在全部插入后统一更新
+        if (!ScrollBox::AddItemAt(pControl, iIndex + nAddedCount)) {
+            bRet = false;
+            continue;
+        }
+        ++nAddedCount;
+        IListBoxItem* pListItem = dynamic_cast<IListBoxItem*>(pControl);
+        if (pListItem != nullptr) {
+            pListItem->SetOwner(this);
+            if (!IsMultiSelect()) {
+                pListItem->OptionSelected(false, false);
+            }
+        }
+    }
+    if (nAddedCount > 0) {
+        const size_t itemCount = GetItemCount();
+        for (size_t i = iIndex; i < itemCount; ++i) {
+            IListBoxItem* pListItem = dynamic_cast<IListBoxItem*>(GetItemAt(i));
+            if (pListItem != nullptr) {
+                pListItem->SetListBoxIndex(i);
+            }
+        }
+        if (Box::IsValidItemIndex(m_iCurSel) && (m_iCurSel >= iIndex)) {
+            m_iCurSel += nAddedCount;
+        }
+    }
+    return bRet;
+}
+
 void ListBox::RemoveAllItems()
 {
     if (!IsAutoDestroyChild()) {
@@ -2352,6 +2408,15 @@ void ListBox::PaintFrameSelection(IRender* pRender)
     }
 }
 
+bool ListBox::CalcScrollBlitRect(int64_t dx, int64_t dy, UiRect& rcScroll)
+{
+    if ((m_pHelper != nullptr) && m_pHelper->IsInFrameSelection()) {
+        //框选区域不随内容平移
+        return false;
+    }
+    return BaseClass::CalcScrollBlitRect(dx, dy, rcScroll);
+}
+
 void ListBox::GetScrollDeltaValue(int32_t& nHScrollValue, int32_t& nVScrollValue) const
 {
     nHScrollValue = DUI_NOSET_VALUE;
@@ -211,6 +211,12 @@ public:
      */
     virtual void RemoveAllItems() override;
 
+    /** 在指定位置批量插入子项（所有子项插入完成后，统一更新子项的索引号）
+     * @param [in] controls 子项指针列表
+     * @param[in] iIndex 第一个子项的插入位置，范围是：[0, GetItemCount()]
+     */
+    virtual bool AddItemsAt(const std::vector<Control*>& controls, size_t iIndex) override;
+
 public:
     /** 设置是否支持鼠标框选功能
     */
@@ -323,6 +329,11 @@ protected:
     */
     virtual bool OnSwitchToSingleSelect();
 
+    /** 结束批量更新：如果批量更新期间选择项有变化，触发一次kEventSelChange事件
+    *  （批量更新期间，不触发kEventSelect、kEventUnSelect和kEventSelChange事件）
+    */
+    virtual void OnEndUpdate() override;
+
     /** 同步当前选择项的选择状态
     * @return 如果有变化返回true，否则返回false
     */
@@ -510,6 +521,10 @@ protected:
     */
     virtual void PaintFrameSelection(IRender* pRender);
 
+    /** 计算滚动时可以复用已绘制内容的区域（鼠标框选时不复用）
+    */
+    virtual bool CalcScrollBlitRect(int64_t dx, int64_t dy, UiRect& rcScroll) override;
+
     /** 列表项的子项收到鼠标事件
     * @return true表示截获该消息，子项不再处理该消息；返回false表示子项继续处理该消息
     */
@@ -599,6 +614,9 @@ private:
 
     //当鼠标点击空白部分时，是否取消选择(仅当开启鼠标框选功能时有效)
     bool m_bSelectNoneWhenClickBlank;
+
+    //批量更新期间，选择项是否有变化
+    bool m_bSelChangePending;
 };
 
 /////////////////////////////////////////////////////////////////////////////////////
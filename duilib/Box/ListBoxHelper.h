@@ -87,6 +87,10 @@ public:
     */
     void PaintFrameSelection(IRender* pRender);
 
+    /** 是否正在鼠标框选（绘制框选区域）
+    */
+    bool IsInFrameSelection() const;
+
 private:
 
     /** 检查是否需要滚动视图
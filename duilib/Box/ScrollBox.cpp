@@ -20,7 +20,8 @@ ScrollBox::ScrollBox(Window* pWindow, Layout* pLayout) :
     m_pScrollAnimation(nullptr),
     m_pRenderOffsetYAnimation(nullptr),
     m_nVScrollUnitPixels(0),
-    m_nHScrollUnitPixels(0)
+    m_nHScrollUnitPixels(0),
+    m_bScrollBlit(true)
 {
     SetVerScrollUnitPixels(30, true);
     SetHorScrollUnitPixels(30, true);
@@ -94,6 +95,9 @@ void ScrollBox::SetAttribute(const DString& pstrName, const DString& pstrValue)
     else if ((pstrName == _T("hold_end")) || (pstrName == _T("holdend"))) {
         SetHoldEnd(pstrValue == _T("true"));
     }
+    else if (pstrName == _T("scroll_blit")) {
+        SetScrollBlitEnabled(pstrValue == _T("true"));
+    }
     else {
         Box::SetAttribute(pstrName, pstrValue);
     }
@@ -573,51 +577,20 @@ void ScrollBox::PaintChild(IRender* pRender, const UiRect& rcPaint)
         return;
     }
 
-    std::vector<Control*> delayItems;
-    for (Control* pControl : m_items) {
-        if (pControl == nullptr) {
-            continue;
-        }
-        if (!pControl->IsVisible()) {
-            continue;
-        }
-        if (pControl->GetPaintOrder() != 0) {
-            //设置了绘制顺序， 放入延迟绘制列表
-            delayItems.push_back(pControl);
-            continue;
-        }
-        UiSize scrollPos = GetScrollOffset();
-        UiRect rcNewPaint = GetPosWithoutPadding();
-        AutoClip alphaClip(pRender, rcNewPaint, IsClip());
-        rcNewPaint.Offset(scrollPos.cx, scrollPos.cy);
-        rcNewPaint.Offset(GetRenderOffset().x, GetRenderOffset().y);
-
+    //可见区域（子控件的坐标系）
+    UiSize scrollPos = GetScrollOffset();
+    UiRect rcNewPaint = GetPosWithoutPadding();
+    rcNewPaint.Offset(scrollPos.cx, scrollPos.cy);
+    rcNewPaint.Offset(GetRenderOffset().x, GetRenderOffset().y);
+    const std::vector<Control*>& paintItems = GetPaintItems(rcNewPaint);
+    if (!paintItems.empty()) {
+        AutoClip alphaClip(pRender, GetPosWithoutPadding(), IsClip());
         UiPoint ptOffset(scrollPos.cx, scrollPos.cy);
         UiPoint ptOldOrg = pRender->OffsetWindowOrg(ptOffset);
-        pControl->AlphaPaint(pRender, rcNewPaint);
-        pRender->SetWindowOrg(ptOldOrg);
-    }
-
-    if (!delayItems.empty()) {
-        std::sort(delayItems.begin(), delayItems.end(), [](const Control* a, const Control* b) {
-            return a->GetPaintOrder() < b->GetPaintOrder();
-            });
-        //绘制延迟绘制的控件
-        for (auto pControl : delayItems) {
-            if (pControl == nullptr) {
-                continue;
-            }
-            UiSize scrollPos = GetScrollOffset();
-            UiRect rcNewPaint = GetPosWithoutPadding();
-            AutoClip alphaClip(pRender, rcNewPaint, IsClip());
-            rcNewPaint.Offset(scrollPos.cx, scrollPos.cy);
-            rcNewPaint.Offset(GetRenderOffset().x, GetRenderOffset().y);
-
-            UiPoint ptOffset(scrollPos.cx, scrollPos.cy);
-            UiPoint ptOldOrg = pRender->OffsetWindowOrg(ptOffset);
+        for (Control* pControl : paintItems) {
             pControl->AlphaPaint(pRender, rcNewPaint);
-            pRender->SetWindowOrg(ptOldOrg);
         }
+        pRender->SetWindowOrg(ptOldOrg);
     }
 
     if( (m_pHScrollBar != nullptr) && m_pHScrollBar->IsVisible()) {
@@ -629,6 +602,20 @@ void ScrollBox::PaintChild(IRender* pRender, const UiRect& rcPaint)
     }
 }
 
+bool ScrollBox::IsPaintOccludedByItems(const UiRect& rcPaint)
+{
+    UiRect rcTarget;
+    if (!UiRect::Intersect(rcTarget, rcPaint, GetRect())) {
+        return false;
+    }
+    //子控件的坐标系：与PaintChild一致，加上滚动偏移和绘制偏移，子控件裁剪到除内边距以外的区域
+    UiPoint ptOffset(GetScrollOffset().cx + GetRenderOffset().x, GetScrollOffset().cy + GetRenderOffset().y);
+    rcTarget.Offset(ptOffset.x, ptOffset.y);
+    UiRect rcClip = IsClip() ? GetPosWithoutPadding() : GetRect();
+    rcClip.Offset(ptOffset.x, ptOffset.y);
+    return IsRectOccludedByItems(rcTarget, rcClip);
+}
+
 void ScrollBox::SetMouseEnabled(bool bEnabled)
 {
     if (m_pVScrollBar != nullptr) {
@@ -746,6 +733,7 @@ UiSize64 ScrollBox::GetScrollRange() const
 
 void ScrollBox::SetScrollPos(UiSize64 szPos)
 {
+    m_rcScrollBlit.Clear();
     UiSize oldScrollOffset = GetScrollOffset();
     if (szPos.cy < 0) {
         szPos.cy = 0;
@@ -782,10 +770,203 @@ void ScrollBox::SetScrollPos(UiSize64 szPos)
         OnScrollOffsetChanged(oldScrollOffset, newScrollOffset);
     }
 
-    Invalidate();
+    if (!ScrollPaintedRect(cx, cy)) {
+        Invalidate();
+    }
     SendEvent(kEventScrollChange, (cy == 0) ? 0 : 1, (cx == 0) ? 0 : 1);
 }
 
+bool ScrollBox::ScrollPaintedRect(int64_t dx, int64_t dy)
+{
+    Window* pWindow = GetWindow();
+    if ((pWindow == nullptr) || !m_bScrollBlit) {
+        return false;
+    }
+    UiRect rcScroll;
+    if (!CalcScrollBlitRect(dx, dy, rcScroll)) {
+        return false;
+    }
+    if ((std::abs(dx) >= rcScroll.Width()) || (std::abs(dy) >= rcScroll.Height())) {
+        return false;
+    }
+    //滚动位置增加时，内容向上（向左）平移
+    if (!pWindow->ScrollWindowRect(rcScroll, -(int32_t)dx, -(int32_t)dy)) {
+        return false;
+    }
+    m_rcScrollBlit = rcScroll;
+
+    //滚动条不参与平移，需要重绘
+    if ((m_pVScrollBar != nullptr) && m_pVScrollBar->IsVisible()) {
+        m_pVScrollBar->Invalidate();
+    }
+    if ((m_pHScrollBar != nullptr) && m_pHScrollBar->IsVisible()) {
+        m_pHScrollBar->Invalidate();
+    }
+    return true;
+}
+
+/** 判断控件及其可见的子控件中，是否有正在播放的动画
+*/
+static bool IsAnimationPlayingInTree(Control* pControl)
+{
+    if (pControl->IsAnimationPlaying()) {
+        return true;
+    }
+    Box* pBox = dynamic_cast<Box*>(pControl);
+    if (pBox != nullptr) {
+        const size_t nCount = pBox->GetItemCount();
+        for (size_t nIndex = 0; nIndex < nCount; ++nIndex) {
+            Control* pItem = pBox->GetItemAt(nIndex);
+            if ((pItem != nullptr) && pItem->IsVisible() && IsAnimationPlayingInTree(pItem)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool ScrollBox::CalcScrollBlitRect(int64_t /*dx*/, int64_t /*dy*/, UiRect& rcScroll)
+{
+    if ((GetWindow() == nullptr) || !IsVisible() || !IsClip()) {
+        return false;
+    }
+    //浮动的子控件位置不确定，不复用
+    const size_t nItemCount = m_items.size();
+    for (size_t nIndex = 0; nIndex < nItemCount; ++nIndex) {
+        Control* pControl = m_items[nIndex];
+        if ((pControl != nullptr) && pControl->IsVisible() && pControl->IsFloat()) {
+            return false;
+        }
+    }
+
+    //子控件的绘制区域（不含边框和滚动条）
+    rcScroll = GetPosWithoutPadding();
+    UiRect rcBorder = GetRect();
+    UiRectF rcBorderSize = GetBorderSize();
+    rcBorder.Deflate((int32_t)std::ceil(rcBorderSize.left), (int32_t)std::ceil(rcBorderSize.top),
+                     (int32_t)std::ceil(rcBorderSize.right), (int32_t)std::ceil(rcBorderSize.bottom));
+    if (!rcScroll.Intersect(rcBorder)) {
+        return false;
+    }
+    if ((m_pVScrollBar != nullptr) && m_pVScrollBar->IsVisible()) {
+        const UiRect& rcScrollBar = m_pVScrollBar->GetRect();
+        if (IsVScrollBarAtLeft()) {
+            rcScroll.left = std::max(rcScroll.left, rcScrollBar.right);
+        }
+        else {
+            rcScroll.right = std::min(rcScroll.right, rcScrollBar.left);
+        }
+    }
+    if ((m_pHScrollBar != nullptr) && m_pHScrollBar->IsVisible()) {
+        rcScroll.bottom = std::min(rcScroll.bottom, m_pHScrollBar->GetRect().top);
+    }
+    if (rcScroll.IsEmpty()) {
+        return false;
+    }
+
+    //显示区域内的子控件正在播放动画（比如淡入淡出、鼠标悬停动画）时，已绘制的内容随时会变化，不复用
+    const UiSize scrollOffset = GetScrollOffset();
+    for (size_t nIndex = 0; nIndex < nItemCount; ++nIndex) {
+        Control* pControl = m_items[nIndex];
+        if ((pControl == nullptr) || !pControl->IsVisible()) {
+            continue;
+        }
+        UiRect rcItem = pControl->GetRect();
+        rcItem.Offset(-scrollOffset.cx, -scrollOffset.cy);
+        UiRect rcTemp;
+        if (UiRect::Intersect(rcTemp, rcItem, rcScroll) && IsAnimationPlayingInTree(pControl)) {
+            return false;
+        }
+    }
+
+    //逐级检查父容器：不能有透明度、绘制缓存、图层、绘制偏移、背景图片、重叠的兄弟控件，
+    //且背景需要由不透明的纯色填充（平移后背景不变）
+    bool bOpaqueBkColor = false;
+    Control* pControl = this;
+    while (pControl != nullptr) {
+        if ((pControl->GetAlpha() != 255) || pControl->IsUseCache() || pControl->IsLayerEnabled() ||
+            !pControl->GetStateImage(pControl->GetState()).empty() || pControl->IsAnimationPlaying()) {
+            return false;
+        }
+        if ((pControl->GetRenderOffset().x != 0) || (pControl->GetRenderOffset().y != 0)) {
+            return false;
+        }
+        //转换为客户区坐标
+        const UiPoint scrollOffset = pControl->GetScrollOffsetInScrollBox();
+        UiRect rcControl = pControl->GetRect();
+        rcControl.Offset(-scrollOffset.x, -scrollOffset.y);
+        if (pControl != this) {
+            if (!rcScroll.Intersect(rcControl)) {
+                return false;
+            }
+            //父容器的滚动条悬浮在子控件上面
+            ScrollBox* pScrollBox = dynamic_cast<ScrollBox*>(pControl);
+            if (pScrollBox != nullptr) {
+                ScrollBar* pScrollBars[2] = { pScrollBox->GetVScrollBar(), pScrollBox->GetHScrollBar() };
+                for (ScrollBar* pScrollBar : pScrollBars) {
+                    if ((pScrollBar != nullptr) && pScrollBar->IsVisible()) {
+                        UiRect rcScrollBar = pScrollBar->GetRect();
+                        rcScrollBar.Offset(-scrollOffset.x, -scrollOffset.y);
+                        UiRect rcTemp;
+                        if (UiRect::Intersect(rcTemp, rcScrollBar, rcScroll)) {
+                            return false;
+                        }
+                    }
+                }
+            }
+        }
+        else {
+            rcScroll.Offset(-scrollOffset.x, -scrollOffset.y);
+        }
+        float fRoundWidth = 0;
+        float fRoundHeight = 0;
+        if (pControl->GetBorderRound(fRoundWidth, fRoundHeight)) {
+            //圆角区域不平移
+            UiRect rcInner = rcControl;
+            rcInner.Deflate((int32_t)std::ceil(fRoundWidth), (int32_t)std::ceil(fRoundHeight),
+                            (int32_t)std::ceil(fRoundWidth), (int32_t)std::ceil(fRoundHeight));
+            if (!rcInner.ContainsRect(rcScroll)) {
+                return false;
+            }
+        }
+        if (!bOpaqueBkColor) {
+            //状态颜色绘制在背景色之上，且随状态（比如鼠标悬停）变化
+            if (!pControl->GetStateColor(pControl->GetState()).empty() || pControl->HasHotState()) {
+                return false;
+            }
+            if (!pControl->GetBkImage().empty()) {
+                return false;
+            }
+            if (!pControl->GetBkColor().empty()) {
+                if (pControl->GetUiColor(pControl->GetBkColor()).GetA() != 255) {
+                    return false;
+                }
+                bOpaqueBkColor = true;
+            }
+        }
+
+        Box* pParent = pControl->GetParent();
+        if (pParent != nullptr) {
+            //兄弟控件与该区域重叠
+            const size_t nCount = pParent->GetItemCount();
+            for (size_t nIndex = 0; nIndex < nCount; ++nIndex) {
+                Control* pItem = pParent->GetItemAt(nIndex);
+                if ((pItem == nullptr) || (pItem == pControl) || !pItem->IsVisible()) {
+                    continue;
+                }
+                UiRect rcItem = pItem->GetRect();
+                rcItem.Offset(-scrollOffset.x, -scrollOffset.y);
+                UiRect rcTemp;
+                if (UiRect::Intersect(rcTemp, rcItem, rcScroll)) {
+                    return false;
+                }
+            }
+        }
+        pControl = pParent;
+    }
+    return bOpaqueBkColor && !rcScroll.IsEmpty();
+}
+
 void ScrollBox::SetScrollPosY(int64_t y)
 {
     UiSize64 scrollPos = GetScrollPos();
@@ -825,6 +1006,7 @@ void ScrollBox::LineUp(int32_t deltaValue, bool withAnimation)
     else {
         if (m_pScrollAnimation == nullptr) {
             m_pScrollAnimation = new AnimationPlayer;
+            m_pScrollAnimation->SetControl(this);
         }
         AnimationPlayer* pScrollAnimation = m_pScrollAnimation;
         pScrollAnimation->SetStartValue(scrollPos.cy);
@@ -878,6 +1060,7 @@ void ScrollBox::LineDown(int32_t deltaValue, bool withAnimation)
     else {
         if (m_pScrollAnimation == nullptr) {
             m_pScrollAnimation = new AnimationPlayer;
+            m_pScrollAnimation->SetControl(this);
         }
         AnimationPlayer* pScrollAnimation = m_pScrollAnimation;
         pScrollAnimation->SetStartValue(scrollPos.cy);
@@ -1150,6 +1333,7 @@ void ScrollBox::PlayRenderOffsetYAnimation(int64_t nRenderY)
 {
     if (m_pRenderOffsetYAnimation == nullptr) {
         m_pRenderOffsetYAnimation = new AnimationPlayer;
+        m_pRenderOffsetYAnimation->SetControl(this);
     }
     AnimationPlayer* pRenderOffsetYAnimation = m_pRenderOffsetYAnimation;
     if (pRenderOffsetYAnimation == nullptr) {
@@ -1224,6 +1408,21 @@ void ScrollBox::SetScrollBarFloat(bool bScrollBarFloat)
     m_bScrollBarFloat = bScrollBarFloat;
 }
 
+void ScrollBox::SetScrollBlitEnabled(bool bEnable)
+{
+    m_bScrollBlit = bEnable;
+}
+
+bool ScrollBox::IsScrollBlitEnabled() const
+{
+    return m_bScrollBlit;
+}
+
+const UiRect& ScrollBox::GetScrollBlitRect() const
+{
+    return m_rcScrollBlit;
+}
+
 bool ScrollBox::IsVScrollBarAtLeft() const
 {
     return m_bVScrollBarAtLeft;
@@ -1259,6 +1458,18 @@ void ScrollBox::ClearImageCache()
     }
 }
 
+void ScrollBox::GetLoadedImages(std::vector<Image*>& imageList) const
+{
+    BaseClass::GetLoadedImages(imageList);
+
+    if (m_pHScrollBar != nullptr) {
+        m_pHScrollBar->GetLoadedImages(imageList);
+    }
+    if (m_pVScrollBar != nullptr) {
+        m_pVScrollBar->GetLoadedImages(imageList);
+    }
+}
+
 void ScrollBox::StopScrollAnimation()
 {
     if (m_pScrollAnimation != nullptr) {
@@ -31,6 +31,7 @@ public:
     virtual bool MouseEnter(const EventArgs& msg) override;
     virtual bool MouseLeave(const EventArgs& msg) override;
     virtual void PaintChild(IRender* pRender, const UiRect& rcPaint) override;
+    virtual bool IsPaintOccludedByItems(const UiRect& rcPaint) override;
     virtual void SetMouseEnabled(bool bEnable = true) override;
     virtual void SetParent(Box* pParent) override;
     virtual void SetWindow(Window* pWindow) override;
@@ -38,6 +39,7 @@ public:
                                  uint32_t uFlags, const UiPoint& ptMouse,
                                  const UiPoint& scrollPos = UiPoint()) override;
     virtual void ClearImageCache() override;
+    virtual void GetLoadedImages(std::vector<Image*>& imageList) const override;
 
     /** DPI发生变化，更新控件大小和布局
     * @param [in] nOldDpiScale 旧的DPI缩放百分比
@@ -240,6 +242,16 @@ public:
     */
     void StopScrollAnimation();
 
+    /** 设置滚动时是否复用已经绘制的内容（只重绘新露出的区域），默认开启
+    *   不满足复用条件时（比如有透明度、背景图片、状态颜色、重叠的控件、正在播放的动画等），仍然会重绘整个容器
+    * @param [in] bEnable true表示开启，false表示关闭
+    */
+    void SetScrollBlitEnabled(bool bEnable);
+
+    /** 获取滚动时是否复用已经绘制的内容
+    */
+    bool IsScrollBlitEnabled() const;
+
     /** 监听滚动条位置变化事件
      * @param[in] callback 有变化后通知的回调函数
      */
@@ -270,7 +282,26 @@ protected:
      */
     virtual UiSize64 CalcRequiredSize(const UiRect& rc);
 
+    /** 计算滚动时可以复用已绘制内容的区域
+    * @param [in] dx 横向滚动的距离（滚动位置的变化值）
+    * @param [in] dy 纵向滚动的距离（滚动位置的变化值）
+    * @param [out] rcScroll 返回可以平移的区域（客户区坐标）
+    * @return 如果可以复用返回true，否则返回false
+    */
+    virtual bool CalcScrollBlitRect(int64_t dx, int64_t dy, UiRect& rcScroll);
+
+    /** 获取本次滚动复用已绘制内容的区域（客户区坐标），如果未复用，返回空矩形
+    */
+    const UiRect& GetScrollBlitRect() const;
+
 private:
+    /** 滚动后，尝试复用已经绘制的内容
+    * @param [in] dx 横向平移的距离
+    * @param [in] dy 纵向平移的距离
+    * @return 如果成功返回true，否则返回false（需要重绘整个容器）
+    */
+    bool ScrollPaintedRect(int64_t dx, int64_t dy);
+
     /** 设置位置大小
     * @param [in] rc外部传入的矩形范围
     * @param [in] bScrollProcess true表示内部递归调用，false表示外部调用
@@ -335,6 +366,12 @@ private:
 
     //容器的滚动条是否在左侧显示
     bool m_bVScrollBarAtLeft;
+
+    //滚动时是否复用已经绘制的内容
+    bool m_bScrollBlit;
+
+    //本次滚动复用已绘制内容的区域
+    UiRect m_rcScrollBlit;
 };
 
 /** 横向布局的ScrollBox
@@ -216,6 +216,8 @@ void VirtualHLayout::LazyArrangeChild(UiRect rc) const
     VirtualListBox::RefreshData refreshData;
     // 顶部index
     size_t nTopIndex = GetTopElementIndex(rc);
+    //控件复用：已经显示可见元素的控件保持不变，只有新显示的元素需要填充数据
+    pOwnerBox->RecycleItems(0, nTopIndex);
     size_t iCount = 0;
     size_t nItemCount = pOwnerBox->m_items.size();
     for (size_t nItemIndex = 0; nItemIndex < nItemCount; ++nItemIndex) {
@@ -230,14 +232,21 @@ void VirtualHLayout::LazyArrangeChild(UiRect rc) const
         // 填充数据
         size_t nElementIndex = nTopIndex + iCount;
         if (nElementIndex < pOwnerBox->GetElementCount()) {
+            const bool bFillElement = pOwnerBox->IsFillElementNeeded(pControl, nElementIndex);
             if (!pControl->IsVisible()) {
                 pControl->SetVisible(true);
             }
-            pOwnerBox->FillElement(pControl, nElementIndex);
-            refreshData.nItemIndex = nItemIndex;
-            refreshData.pControl = pControl;
-            refreshData.nElementIndex = nElementIndex;
-            refreshDataList.push_back(refreshData);
+            if (bFillElement) {
+                pOwnerBox->FillElement(pControl, nElementIndex);
+                refreshData.nItemIndex = nItemIndex;
+                refreshData.pControl = pControl;
+                refreshData.nElementIndex = nElementIndex;
+                refreshDataList.push_back(refreshData);
+            }
+            else {
+                //控件已经显示该数据元素，只需同步选择状态
+                pOwnerBox->UpdateElementSelected(pControl, nElementIndex);
+            }
         }
         else {
             if (pControl->IsVisible()) {
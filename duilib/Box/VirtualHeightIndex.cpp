@@ -0,0 +1,246 @@
+#include "VirtualHeightIndex.h"
+#include <algorithm>
+
+namespace ui
+{
+
+VirtualHeightIndex::VirtualHeightIndex():
+    m_nTotalHeight(0),
+    m_nEstimatedHeight(0)
+{
+}
+
+void VirtualHeightIndex::Clear()
+{
+    m_heights.clear();
+    m_measured.clear();
+    m_tree.clear();
+    m_nTotalHeight = 0;
+}
+
+void VirtualHeightIndex::Assign(const std::vector<int32_t>& heights)
+{
+    m_heights = heights;
+    for (int32_t& nHeight : m_heights) {
+        ASSERT(nHeight >= 0);
+        if (nHeight < 0) {
+            nHeight = 0;
+        }
+    }
+    m_measured.assign(m_heights.size(), true);
+    RebuildTree(0);
+}
+
+void VirtualHeightIndex::Resize(size_t nCount)
+{
+    const size_t nOldCount = m_heights.size();
+    if (nCount == nOldCount) {
+        return;
+    }
+    m_heights.resize(nCount, m_nEstimatedHeight);
+    m_measured.resize(nCount, false);
+    RebuildTree(std::min(nCount, nOldCount));
+}
+
+size_t VirtualHeightIndex::GetCount() const
+{
+    return m_heights.size();
+}
+
+void VirtualHeightIndex::Append(int32_t nHeight, size_t nCount)
+{
+    Insert(m_heights.size(), nHeight, nCount);
+}
+
+void VirtualHeightIndex::Insert(size_t nIndex, int32_t nHeight, size_t nCount)
+{
+    ASSERT(nIndex <= m_heights.size());
+    if (nIndex > m_heights.size()) {
+        nIndex = m_heights.size();
+    }
+    if (nCount == 0) {
+        return;
+    }
+    ASSERT(nHeight >= 0);
+    if (nHeight < 0) {
+        nHeight = 0;
+    }
+    m_heights.insert(m_heights.begin() + nIndex, nCount, nHeight);
+    m_measured.insert(m_measured.begin() + nIndex, nCount, true);
+    RebuildTree(nIndex);
+}
+
+void VirtualHeightIndex::Erase(size_t nIndex, size_t nCount)
+{
+    ASSERT(nIndex < m_heights.size());
+    if ((nIndex >= m_heights.size()) || (nCount == 0)) {
+        return;
+    }
+    nCount = std::min(nCount, m_heights.size() - nIndex);
+    m_heights.erase(m_heights.begin() + nIndex, m_heights.begin() + nIndex + nCount);
+    m_measured.erase(m_measured.begin() + nIndex, m_measured.begin() + nIndex + nCount);
+    RebuildTree(nIndex);
+}
+
+void VirtualHeightIndex::SetHeight(size_t nIndex, int32_t nHeight)
+{
+    ASSERT(nIndex < m_heights.size());
+    if (nIndex >= m_heights.size()) {
+        return;
+    }
+    ASSERT(nHeight >= 0);
+    if (nHeight < 0) {
+        nHeight = 0;
+    }
+    m_measured[nIndex] = true;
+    if (m_heights[nIndex] != nHeight) {
+        AddDelta(nIndex, (int64_t)nHeight - m_heights[nIndex]);
+        m_heights[nIndex] = nHeight;
+    }
+}
+
+int32_t VirtualHeightIndex::GetHeight(size_t nIndex) const
+{
+    ASSERT(nIndex < m_heights.size());
+    if (nIndex >= m_heights.size()) {
+        return 0;
+    }
+    return m_heights[nIndex];
+}
+
+int64_t VirtualHeightIndex::GetTotalHeight() const
+{
+    return m_nTotalHeight;
+}
+
+int64_t VirtualHeightIndex::GetOffset(size_t nIndex) const
+{
+    if (nIndex >= m_heights.size()) {
+        return m_nTotalHeight;
+    }
+    //前nIndex行的高度之和
+    int64_t nOffset = 0;
+    for (size_t i = nIndex; i > 0; i -= (i & (~i + 1))) {
+        nOffset += m_tree[i];
+    }
+    return nOffset;
+}
+
+size_t VirtualHeightIndex::FindIndex(int64_t nOffset) const
+{
+    if (nOffset < 0) {
+        nOffset = 0;
+    }
+    if (nOffset >= m_nTotalHeight) {
+        return InvalidIndex;
+    }
+    //二分查找：前缀和不超过nOffset的最大行数，即为包含该位置的行的索引号
+    const size_t nCount = m_heights.size();
+    size_t nMask = 1;
+    while ((nMask << 1) <= nCount) {
+        nMask <<= 1;
+    }
+    size_t nPos = 0;
+    int64_t nRemain = nOffset;
+    for (; nMask != 0; nMask >>= 1) {
+        const size_t nNext = nPos + nMask;
+        if ((nNext <= nCount) && (m_tree[nNext] <= nRemain)) {
+            nPos = nNext;
+            nRemain -= m_tree[nNext];
+        }
+    }
+    ASSERT(nPos < nCount);
+    return (nPos < nCount) ? nPos : InvalidIndex;
+}
+
+size_t VirtualHeightIndex::GetNextVisibleIndex(size_t nIndex) const
+{
+    if (nIndex >= m_heights.size()) {
+        return InvalidIndex;
+    }
+    if (m_heights[nIndex] > 0) {
+        return nIndex;
+    }
+    return FindIndex(GetOffset(nIndex));
+}
+
+void VirtualHeightIndex::SetEstimatedHeight(int32_t nHeight)
+{
+    ASSERT(nHeight >= 0);
+    if (nHeight < 0) {
+        nHeight = 0;
+    }
+    if (m_nEstimatedHeight == nHeight) {
+        return;
+    }
+    m_nEstimatedHeight = nHeight;
+    bool bChanged = false;
+    const size_t nCount = m_heights.size();
+    for (size_t nIndex = 0; nIndex < nCount; ++nIndex) {
+        if (!m_measured[nIndex]) {
+            m_heights[nIndex] = nHeight;
+            bChanged = true;
+        }
+    }
+    if (bChanged) {
+        RebuildTree(0);
+    }
+}
+
+int32_t VirtualHeightIndex::GetEstimatedHeight() const
+{
+    return m_nEstimatedHeight;
+}
+
+bool VirtualHeightIndex::IsMeasured(size_t nIndex) const
+{
+    ASSERT(nIndex < m_measured.size());
+    if (nIndex >= m_measured.size()) {
+        return false;
+    }
+    return m_measured[nIndex];
+}
+
+void VirtualHeightIndex::ResetMeasured(size_t nIndex)
+{
+    ASSERT(nIndex < m_heights.size());
+    if (nIndex >= m_heights.size()) {
+        return;
+    }
+    SetHeight(nIndex, m_nEstimatedHeight);
+    m_measured[nIndex] = false;
+}
+
+void VirtualHeightIndex::RebuildTree(size_t nFrom)
+{
+    const size_t nCount = m_heights.size();
+    if (nFrom > nCount) {
+        nFrom = nCount;
+    }
+    m_tree.resize(nCount + 1, 0);
+    for (size_t i = nFrom + 1; i <= nCount; ++i) {
+        //节点i记录(i - lowbit(i), i]区间的高度之和，等于本行的高度加上各子节点（i - 1, i - 2, i - 4, ...）的值，
+        //按下标递增的顺序计算，子节点已经是新值；所有节点的子节点数之和不超过n，所以总的时间复杂度为O(n - nFrom + log n)
+        const size_t nLowBit = i & (~i + 1);
+        int64_t nSum = m_heights[i - 1];
+        for (size_t nStep = 1; nStep < nLowBit; nStep <<= 1) {
+            nSum += m_tree[i - nStep];
+        }
+        m_tree[i] = nSum;
+    }
+    m_nTotalHeight = 0;
+    for (size_t i = nCount; i > 0; i -= (i & (~i + 1))) {
+        m_nTotalHeight += m_tree[i];
+    }
+}
+
+void VirtualHeightIndex::AddDelta(size_t nIndex, int64_t nDelta)
+{
+    const size_t nCount = m_heights.size();
+    for (size_t i = nIndex + 1; i <= nCount; i += (i & (~i + 1))) {
+        m_tree[i] += nDelta;
+    }
+    m_nTotalHeight += nDelta;
+}
+
+} // namespace ui
@@ -0,0 +1,147 @@
+#ifndef UI_BOX_VIRTUAL_HEIGHT_INDEX_H_
+#define UI_BOX_VIRTUAL_HEIGHT_INDEX_H_
+
+#include "duilib/duilib_defs.h"
+#include <vector>
+
+namespace ui
+{
+/** 虚表的行高索引（树状数组，记录每行高度的前缀和），用于行高不固定的虚表布局：
+*   按滚动位置查找元素、计算元素的起始位置、修改某行的高度，时间复杂度均为O(log n)；
+*   行高为0表示该行不显示（隐藏行）；
+*   支持按需测量：未测量的行按预估高度参与计算，测量后再设置实际高度
+*/
+class UILIB_API VirtualHeightIndex
+{
+public:
+    VirtualHeightIndex();
+
+    /** 无效的索引号
+    */
+    static constexpr size_t InvalidIndex = (size_t)-1;
+
+public:
+    /** 清空所有数据
+    */
+    void Clear();
+
+    /** 按各行的高度重建索引，时间复杂度O(n)
+    * @param [in] heights 各行的高度，高度为0表示该行不显示
+    */
+    void Assign(const std::vector<int32_t>& heights);
+
+    /** 设置行数，新增的行按预估高度设置，并标记为未测量，时间复杂度O(新增的行数 + log n)
+    * @param [in] nCount 新的行数
+    */
+    void Resize(size_t nCount);
+
+    /** 获取行数
+    */
+    size_t GetCount() const;
+
+    /** 在末尾追加行（标记为已测量），时间复杂度O(nCount + log n)
+    * @param [in] nHeight 新增行的高度，高度为0表示该行不显示
+    * @param [in] nCount 新增的行数
+    */
+    void Append(int32_t nHeight, size_t nCount = 1);
+
+    /** 在指定位置插入行（标记为已测量），时间复杂度O(GetCount() - nIndex + log n)
+    * @param [in] nIndex 插入位置，有效范围：[0, GetCount()]，等于GetCount()时为追加
+    * @param [in] nHeight 新增行的高度，高度为0表示该行不显示
+    * @param [in] nCount 新增的行数
+    */
+    void Insert(size_t nIndex, int32_t nHeight, size_t nCount = 1);
+
+    /** 删除从指定位置开始的行，时间复杂度O(GetCount() - nIndex + log n)
+    * @param [in] nIndex 第一个删除行的索引号，有效范围：[0, GetCount())
+    * @param [in] nCount 删除的行数
+    */
+    void Erase(size_t nIndex, size_t nCount = 1);
+
+    /** 设置指定行的高度（同时标记为已测量），时间复杂度O(log n)
+    * @param [in] nIndex 行的索引号，有效范围：[0, GetCount())
+    * @param [in] nHeight 行的高度，高度为0表示该行不显示
+    */
+    void SetHeight(size_t nIndex, int32_t nHeight);
+
+    /** 获取指定行的高度
+    * @param [in] nIndex 行的索引号，有效范围：[0, GetCount())
+    */
+    int32_t GetHeight(size_t nIndex) const;
+
+    /** 获取所有行的总高度
+    */
+    int64_t GetTotalHeight() const;
+
+    /** 获取指定行的起始位置（即前面所有行的高度之和），时间复杂度O(log n)
+    * @param [in] nIndex 行的索引号，有效范围：[0, GetCount()]
+    */
+    int64_t GetOffset(size_t nIndex) const;
+
+    /** 查找包含指定位置的行（跳过高度为0的行），时间复杂度O(log n)
+    * @param [in] nOffset 位置（相对于第一行的顶部）
+    * @return 返回行的索引号，如果位置超出总高度，返回InvalidIndex
+    */
+    size_t FindIndex(int64_t nOffset) const;
+
+    /** 获取从指定行开始（包含该行）第一个高度不为0的行，时间复杂度O(log n)
+    * @param [in] nIndex 行的索引号
+    * @return 返回行的索引号，如果没有，返回InvalidIndex
+    */
+    size_t GetNextVisibleIndex(size_t nIndex) const;
+
+public:
+    /** 设置未测量行的预估高度，已有的未测量行同步更新
+    * @param [in] nHeight 预估高度
+    */
+    void SetEstimatedHeight(int32_t nHeight);
+
+    /** 获取未测量行的预估高度
+    */
+    int32_t GetEstimatedHeight() const;
+
+    /** 判断指定行的高度是否已经测量
+    * @param [in] nIndex 行的索引号，有效范围：[0, GetCount())
+    */
+    bool IsMeasured(size_t nIndex) const;
+
+    /** 将指定行标记为未测量（比如行的内容变化后），高度恢复为预估高度
+    * @param [in] nIndex 行的索引号，有效范围：[0, GetCount())
+    */
+    void ResetMeasured(size_t nIndex);
+
+private:
+    /** 按m_heights重建树状数组，并更新总高度
+    * @param [in] nFrom 只重建下标大于nFrom的节点（前nFrom行没有变化时，这些节点不受影响）
+    */
+    void RebuildTree(size_t nFrom);
+
+    /** 修改一行的高度（增量）
+    */
+    void AddDelta(size_t nIndex, int64_t nDelta);
+
+private:
+    /** 各行的高度
+    */
+    std::vector<int32_t> m_heights;
+
+    /** 各行是否已经测量
+    */
+    std::vector<bool> m_measured;
+
+    /** 树状数组（下标从1开始）
+    */
+    std::vector<int64_t> m_tree;
+
+    /** 所有行的总高度
+    */
+    int64_t m_nTotalHeight;
+
+    /** 未测量行的预估高度
+    */
+    int32_t m_nEstimatedHeight;
+};
+
+}
+
+#endif // UI_BOX_VIRTUAL_HEIGHT_INDEX_H_
@@ -1,5 +1,6 @@
 #include "VirtualListBox.h"
 #include "duilib/Core/ScrollBar.h"
+#include "duilib/Core/Window.h"
 #include <algorithm>
 #include <set>
 
@@ -39,6 +40,8 @@ VirtualListBox::VirtualListBox(Window* pWindow, Layout* pLayout)
     , m_pVirtualLayout(nullptr)
     , m_nLastNoShiftIndex(0)
     , m_bEnableUpdateProvider(true)
+    , m_bForceFillElements(false)
+    , m_bRefreshPending(false)
 {
     ASSERT(pLayout != nullptr);
 }
@@ -118,6 +121,104 @@ void VirtualListBox::SetMultiSelect(bool bMultiSelect)
     m_bEnableUpdateProvider = bOldValue;
 }
 
+bool VirtualListBox::IsFillElementNeeded(Control* pControl, size_t nElementIndex) const
+{
+    if (m_bForceFillElements || (pControl == nullptr) || !pControl->IsVisible()) {
+        return true;
+    }
+    IListBoxItem* pListBoxItem = dynamic_cast<IListBoxItem*>(pControl);
+    if (pListBoxItem == nullptr) {
+        return true;
+    }
+    return pListBoxItem->GetElementIndex() != nElementIndex;
+}
+
+void VirtualListBox::UpdateElementSelected(Control* pControl, size_t nElementIndex)
+{
+    IListBoxItem* pListBoxItem = dynamic_cast<IListBoxItem*>(pControl);
+    if ((pListBoxItem == nullptr) || (m_pDataProvider == nullptr)) {
+        return;
+    }
+    bool bSelected = m_pDataProvider->IsElementSelected(nElementIndex);
+    if (pListBoxItem->IsSelected() != bSelected) {
+        bool bOldValue = m_bEnableUpdateProvider;
+        m_bEnableUpdateProvider = false;
+        pListBoxItem->SetItemSelected(bSelected);
+        m_bEnableUpdateProvider = bOldValue;
+    }
+}
+
+void VirtualListBox::RecycleItems(size_t nStartItemIndex, size_t nTopElementIndex)
+{
+    const size_t nItemCount = m_items.size();
+    if (m_bForceFillElements || (nStartItemIndex >= nItemCount)) {
+        //强制刷新时，所有控件都需要重新填充数据，不需要调整顺序
+        return;
+    }
+    //每个位置对应的控件：如果控件当前显示的元素在可见范围内，放在该元素对应的位置
+    const size_t nSlotCount = nItemCount - nStartItemIndex;
+    std::vector<Control*> slotItems(nSlotCount, nullptr);
+    std::vector<Control*> freeItems;
+    for (size_t nItemIndex = nStartItemIndex; nItemIndex < nItemCount; ++nItemIndex) {
+        Control* pControl = m_items[nItemIndex];
+        size_t nSlot = Box::InvalidIndex;
+        if ((pControl != nullptr) && pControl->IsVisible()) {
+            IListBoxItem* pListBoxItem = dynamic_cast<IListBoxItem*>(pControl);
+            if (pListBoxItem != nullptr) {
+                size_t nElementIndex = pListBoxItem->GetElementIndex();
+                if ((nElementIndex >= nTopElementIndex) && ((nElementIndex - nTopElementIndex) < nSlotCount)) {
+                    nSlot = nElementIndex - nTopElementIndex;
+                }
+            }
+        }
+        if ((nSlot != Box::InvalidIndex) && (slotItems[nSlot] == nullptr)) {
+            slotItems[nSlot] = pControl;
+        }
+        else {
+            freeItems.push_back(pControl);
+        }
+    }
+    //剩余的控件，按原来的顺序填充空闲位置（需要重新填充数据）
+    size_t nFreeIndex = 0;
+    for (size_t nSlot = 0; nSlot < nSlotCount; ++nSlot) {
+        if (slotItems[nSlot] == nullptr) {
+            ASSERT(nFreeIndex < freeItems.size());
+            if (nFreeIndex < freeItems.size()) {
+                slotItems[nSlot] = freeItems[nFreeIndex++];
+            }
+        }
+    }
+
+    //更新控件顺序，当前选择项跟随控件移动
+    Control* pCurSelControl = nullptr;
+    const size_t nCurSel = GetCurSel();
+    if (nCurSel < nItemCount) {
+        pCurSelControl = m_items[nCurSel];
+    }
+    bool bChanged = false;
+    for (size_t nSlot = 0; nSlot < nSlotCount; ++nSlot) {
+        const size_t nItemIndex = nStartItemIndex + nSlot;
+        Control* pControl = slotItems[nSlot];
+        if (m_items[nItemIndex] != pControl) {
+            m_items[nItemIndex] = pControl;
+            IListBoxItem* pListBoxItem = dynamic_cast<IListBoxItem*>(pControl);
+            if (pListBoxItem != nullptr) {
+                pListBoxItem->SetListBoxIndex(nItemIndex);
+            }
+            bChanged = true;
+        }
+    }
+    if (bChanged) {
+        OnItemsChanged();
+    }
+    if (bChanged && (pCurSelControl != nullptr)) {
+        size_t nNewCurSel = GetItemIndex(pCurSelControl);
+        if (nNewCurSel != nCurSel) {
+            SetCurSel(nNewCurSel);
+        }
+    }
+}
+
 Control* VirtualListBox::CreateElement()
 {
     Control* pControl = nullptr;
@@ -434,9 +535,23 @@ void VirtualListBox::OnModelDataChanged(size_t nStartElementIndex, size_t nEndEl
 void VirtualListBox::OnModelCountChanged()
 {
     //元素的个数发生变化（有添加或者删除）
+    if (IsUpdating()) {
+        //批量更新期间，推迟到EndUpdate时刷新
+        m_bRefreshPending = true;
+        return;
+    }
     Refresh();
 }
 
+void VirtualListBox::OnEndUpdate()
+{
+    if (m_bRefreshPending) {
+        m_bRefreshPending = false;
+        Refresh();
+    }
+    BaseClass::OnEndUpdate();
+}
+
 bool VirtualListBox::IsEnableUpdateProvider() const
 {
     return m_bEnableUpdateProvider;
@@ -591,7 +706,16 @@ void VirtualListBox::SetScrollPos(UiSize64 szPos)
     bool isChanged = (GetScrollPos().cy != szPos.cy) || (GetScrollPos().cx != szPos.cx);
     ListBox::SetScrollPos(szPos);
     if (isChanged) {
-        ReArrangeChild(false);
+        Window* pWindow = GetWindow();
+        if ((pWindow != nullptr) && !GetScrollBlitRect().IsEmpty()) {
+            //已经复用了平移后的内容，子控件整体平移产生的重绘请求可以忽略
+            pWindow->BeginScrollArrange(GetScrollBlitRect());
+            ReArrangeChild(false);
+            pWindow->EndScrollArrange();
+        }
+        else {
+            ReArrangeChild(false);
+        }
     }
 }
 
@@ -613,6 +737,13 @@ void VirtualListBox::PaintChild(IRender* pRender, const UiRect& rcPaint)
     BaseClass::PaintChild(pRender, rcPaint);
 }
 
+bool VirtualListBox::IsPaintOccludedByItems(const UiRect& rcPaint)
+{
+    //与PaintChild一致，先按滚动位置重新排列子控件
+    ReArrangeChild(false);
+    return BaseClass::IsPaintOccludedByItems(rcPaint);
+}
+
 void VirtualListBox::SendEventMsg(const EventArgs& msg)
 {
     VSendEvent(msg, false);
@@ -679,7 +810,10 @@ void VirtualListBox::ReArrangeChild(bool bForce)
             return;
         }
     }
+    //强制重新布局时（刷新列表），重新填充所有子项控件的数据
+    m_bForceFillElements = bForce;
     m_pVirtualLayout->LazyArrangeChild(GetPosWithoutPadding());
+    m_bForceFillElements = false;
     ASSERT(!m_pVirtualLayout->NeedReArrange());
 }
 
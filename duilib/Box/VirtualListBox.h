@@ -305,6 +305,7 @@ public:
     virtual void SetScrollPos(UiSize64 szPos) override;
     virtual void SetPos(UiRect rc) override;
     virtual void PaintChild(IRender* pRender, const UiRect& rcPaint) override;
+    virtual bool IsPaintOccludedByItems(const UiRect& rcPaint) override;
     virtual void SendEventMsg(const EventArgs& msg) override;
 
 protected:
@@ -386,6 +387,10 @@ protected:
     */
     void SetVirtualLayout(VirtualLayout* pVirtualLayout);
 
+    /** 结束批量更新：如果批量更新期间数据元素的个数有变化，刷新一次列表
+    */
+    virtual void OnEndUpdate() override;
+
     /** 获取虚表布局接口
     */
     VirtualLayout* GetVirtualLayout() const;
@@ -415,6 +420,25 @@ protected:
     */
     void FillElement(Control* pControl, size_t nElementIndex);
 
+    /** 判断子项控件是否需要填充数据（控件已经显示该数据元素时，不需要重新填充）
+    * @param[in] pControl 数据项控件指针
+    * @param[in] nElementIndex 数据元素的索引ID，范围：[0, GetElementCount())
+    */
+    bool IsFillElementNeeded(Control* pControl, size_t nElementIndex) const;
+
+    /** 同步子项控件的选择状态（控件已经显示该数据元素，不需要重新填充数据时调用，数据的选择状态可能已经变化）
+    * @param[in] pControl 数据项控件指针
+    * @param[in] nElementIndex 数据元素的索引ID，范围：[0, GetElementCount())
+    */
+    void UpdateElementSelected(Control* pControl, size_t nElementIndex);
+
+    /** 按数据元素索引号调整子项控件的顺序（界面控件复用）
+    *   已经显示某个数据元素的控件，移动到该元素对应的位置，滚动时只有新进入可见区域的元素需要填充数据
+    * @param [in] nStartItemIndex 参与调整的第一个子项控件的索引号（之前的控件不参与调整，比如表头控件）
+    * @param [in] nTopElementIndex 第一个参与调整的子项控件对应的数据元素索引号
+    */
+    void RecycleItems(size_t nStartItemIndex, size_t nTopElementIndex);
+
     /** 重新布局子项
     * @param[in] bForce 是否强制重新布局
     */
@@ -487,6 +511,14 @@ private:
     /** 是否允许从界面状态同步到存储状态
     */
     bool m_bEnableUpdateProvider;
+
+    /** 是否需要强制重新填充所有子项控件的数据（刷新列表时）
+    */
+    bool m_bForceFillElements;
+
+    /** 批量更新期间，数据元素的个数是否有变化（需要刷新列表）
+    */
+    bool m_bRefreshPending;
 };
 
 /** 横向布局的虚表ListBox
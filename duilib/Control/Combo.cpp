@@ -739,6 +739,7 @@ bool Combo::SetItemText(size_t iIndex, const DString& itemText)
         ASSERT(pTreeNode != nullptr);
         if (pTreeNode != nullptr) {
             pTreeNode->SetText(itemText);
+            OnComboItemsChanged();
             OnSelectedItemChanged();
             return true;
         }
@@ -783,6 +784,9 @@ size_t Combo::InsertTextItem(size_t iIndex, const DString& itemText)
         }
     }
     ASSERT(newIndex != Box::InvalidIndex);
+    if (newIndex != Box::InvalidIndex) {
+        OnComboItemsChanged();
+    }
     return newIndex;
 }
 
@@ -802,6 +806,7 @@ bool Combo::DeleteItem(size_t iIndex)
         }
     }
     if (bRemoved) {
+        OnComboItemsChanged();
         OnSelectedItemChanged();
     }
     return bRemoved;
@@ -810,6 +815,7 @@ bool Combo::DeleteItem(size_t iIndex)
 void Combo::DeleteAllItems()
 {
     m_treeView.GetRootNode()->RemoveAllChildNodes();
+    OnComboItemsChanged();
     OnSelectedItemChanged();
 }
 
@@ -1065,6 +1071,10 @@ void Combo::OnSelectedItemChanged()
     }
 }
 
+void Combo::OnComboItemsChanged()
+{
+}
+
 bool Combo::OnEditTextChanged(const ui::EventArgs& /*args*/)
 {
     if ((m_pWindow != nullptr) && !m_pWindow->IsClosingWnd()) {
@@ -312,6 +312,10 @@ protected:
     */
     virtual void OnSelectedItemChanged();
 
+    /** 子项列表发生变化（添加、删除子项，或者修改子项的文本）
+    */
+    virtual void OnComboItemsChanged();
+
     /** Edit的文本内容发生变化
      * @param[in] args 参数列表
      * @return 始终返回 true
@@ -4,7 +4,9 @@ namespace ui
 {
 
 FilterCombo::FilterCombo(Window* pWindow):
-    Combo(pWindow)
+    Combo(pWindow),
+    m_bFilterIndexDirty(true),
+    m_bFilterApplied(false)
 {
     SetComboType(kCombo_DropDown);
 }
@@ -55,39 +57,97 @@ bool FilterCombo::OnEditTextChanged(const ui::EventArgs& /*args*/)
     return true;
 }
 
+void FilterCombo::OnComboItemsChanged()
+{
+    BaseClass::OnComboItemsChanged();
+    m_bFilterIndexDirty = true;
+}
+
 void FilterCombo::FilterComboList(const DString& filterText)
 {
     TreeView* pTreeView = GetTreeView();
     if (pTreeView == nullptr) {
         return;
     }
-    size_t itemCount = pTreeView->GetItemCount();
-    for (size_t iIndex = 0; iIndex < itemCount; ++iIndex) {
-        Control* pControl = pTreeView->GetItemAt(iIndex);
-        if (pControl != nullptr) {
-            TreeNode* pTreeNode = dynamic_cast<TreeNode*>(pControl);
-            ASSERT(pTreeNode != nullptr);
-            if (pTreeNode != nullptr) {
-                pTreeNode->SetExpand(true, false);
-                if (IsFilterText(filterText, pTreeNode->GetText())) {
-                    pTreeNode->SetFadeVisible(true);
+    //子项数量不一致时，可能是通过TreeView的接口直接修改了子项，需要重建索引
+    if (m_bFilterIndexDirty || (m_filterIndex.GetItemCount() != pTreeView->GetItemCount())) {
+        RebuildFilterIndex();
+    }
+    std::vector<uint32_t> itemIndexList;
+    m_filterIndex.Query(filterText, itemIndexList);
+    {
+        //批量修改子项的可见性，结束后统一布局一次
+        AutoBoxUpdate autoUpdate(pTreeView);
+        if (!m_bFilterApplied) {
+            const size_t itemCount = m_filterIndex.GetItemCount();
+            std::vector<bool> itemVisible(itemCount, false);
+            for (uint32_t nIndex : itemIndexList) {
+                itemVisible[nIndex] = true;
+            }
+            for (size_t nIndex = 0; nIndex < itemCount; ++nIndex) {
+                SetFilterItemVisible(nIndex, itemVisible[nIndex]);
+            }
+        }
+        else {
+            //只修改可见性有变化的子项（两个列表都是有序的，按归并的方式比较）
+            auto iterOld = m_filterItemIndexList.begin();
+            auto iterNew = itemIndexList.begin();
+            while ((iterOld != m_filterItemIndexList.end()) || (iterNew != itemIndexList.end())) {
+                if ((iterNew == itemIndexList.end()) ||
+                    ((iterOld != m_filterItemIndexList.end()) && (*iterOld < *iterNew))) {
+                    SetFilterItemVisible(*iterOld, false);
+                    ++iterOld;
+                }
+                else if ((iterOld == m_filterItemIndexList.end()) || (*iterNew < *iterOld)) {
+                    SetFilterItemVisible(*iterNew, true);
+                    ++iterNew;
                 }
                 else {
-                    pTreeNode->SetFadeVisible(false);
+                    ++iterOld;
+                    ++iterNew;
                 }
             }
         }
     }
+    m_filterItemIndexList.swap(itemIndexList);
+    m_bFilterApplied = true;
     UpdateComboList();
 }
 
-bool FilterCombo::IsFilterText(const DString& filterText, const DString& itemText) const
+void FilterCombo::RebuildFilterIndex()
 {
-    DString lowerItemText = StringUtil::MakeLowerString(itemText);
-    if (filterText.empty()) {
-        return true;
+    TreeView* pTreeView = GetTreeView();
+    ASSERT(pTreeView != nullptr);
+    if (pTreeView == nullptr) {
+        return;
+    }
+    const size_t itemCount = pTreeView->GetItemCount();
+    std::vector<DString> itemTexts;
+    itemTexts.reserve(itemCount);
+    for (size_t iIndex = 0; iIndex < itemCount; ++iIndex) {
+        TreeNode* pTreeNode = dynamic_cast<TreeNode*>(pTreeView->GetItemAt(iIndex));
+        ASSERT(pTreeNode != nullptr);
+        if (pTreeNode != nullptr) {
+            pTreeNode->SetExpand(true, false);
+            itemTexts.push_back(pTreeNode->GetText());
+        }
+        else {
+            itemTexts.push_back(DString());
+        }
+    }
+    m_filterIndex.Rebuild(itemTexts);
+    m_filterItemIndexList.clear();
+    m_bFilterIndexDirty = false;
+    m_bFilterApplied = false;
+}
+
+void FilterCombo::SetFilterItemVisible(size_t nIndex, bool bVisible)
+{
+    TreeView* pTreeView = GetTreeView();
+    Control* pControl = (pTreeView != nullptr) ? pTreeView->GetItemAt(nIndex) : nullptr;
+    if (pControl != nullptr) {
+        pControl->SetFadeVisible(bVisible);
     }
-    return (lowerItemText.find(filterText) != DString::npos) ? true : false;
 }
 
 } // namespace ui
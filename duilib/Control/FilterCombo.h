@@ -2,6 +2,7 @@
 #define UI_CONTROL_FILTERCOMBO_H_
 
 #include "duilib/Control/Combo.h"
+#include "duilib/Control/FilterComboIndex.h"
 
 namespace ui 
 {
@@ -43,15 +44,40 @@ protected:
      */
     virtual bool OnEditTextChanged(const ui::EventArgs& args) override;
 
+    /** 子项列表发生变化（添加、删除子项，或者修改子项的文本）
+    */
+    virtual void OnComboItemsChanged() override;
+
 private:
 
     /** 对下拉框列表里面的内容进行过滤
     */
     void FilterComboList(const DString& filterText);
 
-    /** 判断文本是否满足过滤条件
+    /** 重建子项文本的检索索引，并展开所有节点
+    */
+    void RebuildFilterIndex();
+
+    /** 设置子项是否显示
+    */
+    void SetFilterItemVisible(size_t nIndex, bool bVisible);
+
+private:
+    /** 子项文本的检索索引
+    */
+    FilterComboIndex m_filterIndex;
+
+    /** 当前显示的子项索引号（按索引号从小到大排序）
+    */
+    std::vector<uint32_t> m_filterItemIndexList;
+
+    /** 检索索引是否需要重建
+    */
+    bool m_bFilterIndexDirty;
+
+    /** 索引重建后，是否已经按过滤结果设置过子项的可见性
     */
-    bool IsFilterText(const DString& filterText, const DString& itemText) const;
+    bool m_bFilterApplied;
 };
 
 } // namespace ui
@@ -0,0 +1,126 @@
+#include "FilterComboIndex.h"
+#include "duilib/Utils/StringUtil.h"
+#include <type_traits>
+
+namespace ui
+{
+/** 字符转换为倒排表的Key（按无符号数处理，避免UTF-8的多字节字符产生负数）
+*/
+static inline uint32_t GetCharKey(DString::value_type ch)
+{
+    return (uint32_t)(std::make_unsigned_t<DString::value_type>)ch;
+}
+
+FilterComboIndex::FilterComboIndex():
+    m_bLastValid(false)
+{
+}
+
+void FilterComboIndex::Clear()
+{
+    m_itemTexts.clear();
+    m_charItems.clear();
+    m_bigramItems.clear();
+    m_lastFilterText.clear();
+    m_lastItemIndexList.clear();
+    m_bLastValid = false;
+}
+
+void FilterComboIndex::Rebuild(const std::vector<DString>& itemTexts)
+{
+    Clear();
+    const size_t nCount = itemTexts.size();
+    m_itemTexts.resize(nCount);
+    for (size_t nIndex = 0; nIndex < nCount; ++nIndex) {
+        const DString& itemText = m_itemTexts[nIndex] = StringUtil::MakeLowerString(itemTexts[nIndex]);
+        const uint32_t nItemIndex = (uint32_t)nIndex;
+        const size_t nLength = itemText.size();
+        for (size_t nPos = 0; nPos < nLength; ++nPos) {
+            //子项按顺序加入，同一子项重复的字符只需要与最后一个比较
+            std::vector<uint32_t>& charItems = m_charItems[GetCharKey(itemText[nPos])];
+            if (charItems.empty() || (charItems.back() != nItemIndex)) {
+                charItems.push_back(nItemIndex);
+            }
+            if ((nPos + 1) < nLength) {
+                std::vector<uint32_t>& bigramItems = m_bigramItems[MakeBigramKey(itemText[nPos], itemText[nPos + 1])];
+                if (bigramItems.empty() || (bigramItems.back() != nItemIndex)) {
+                    bigramItems.push_back(nItemIndex);
+                }
+            }
+        }
+    }
+}
+
+size_t FilterComboIndex::GetItemCount() const
+{
+    return m_itemTexts.size();
+}
+
+void FilterComboIndex::Query(const DString& filterText, std::vector<uint32_t>& itemIndexList)
+{
+    itemIndexList.clear();
+    if (filterText.empty()) {
+        const size_t nCount = m_itemTexts.size();
+        itemIndexList.resize(nCount);
+        for (size_t nIndex = 0; nIndex < nCount; ++nIndex) {
+            itemIndexList[nIndex] = (uint32_t)nIndex;
+        }
+    }
+    else {
+        //候选子项：倒排表中最短的一组；如果新的过滤文本包含上次的过滤文本，匹配的子项一定在上次的结果中
+        const std::vector<uint32_t>* pCandidateList = GetCandidateList(filterText);
+        bool bNeedCheck = (filterText.size() > 1);
+        if ((pCandidateList != nullptr) && m_bLastValid && !m_lastFilterText.empty() &&
+            (m_lastItemIndexList.size() < pCandidateList->size()) &&
+            (filterText.find(m_lastFilterText) != DString::npos)) {
+            pCandidateList = &m_lastItemIndexList;
+            bNeedCheck = (filterText != m_lastFilterText);
+        }
+        if (pCandidateList != nullptr) {
+            if (!bNeedCheck) {
+                itemIndexList = *pCandidateList;
+            }
+            else {
+                for (uint32_t nIndex : *pCandidateList) {
+                    if (m_itemTexts[nIndex].find(filterText) != DString::npos) {
+                        itemIndexList.push_back(nIndex);
+                    }
+                }
+            }
+        }
+    }
+    m_lastFilterText = filterText;
+    m_lastItemIndexList = itemIndexList;
+    m_bLastValid = true;
+}
+
+uint64_t FilterComboIndex::MakeBigramKey(DString::value_type ch1, DString::value_type ch2)
+{
+    return ((uint64_t)GetCharKey(ch1) << 32) | (uint64_t)GetCharKey(ch2);
+}
+
+const std::vector<uint32_t>* FilterComboIndex::GetCandidateList(const DString& filterText) const
+{
+    const std::vector<uint32_t>* pCandidateList = nullptr;
+    const size_t nLength = filterText.size();
+    if (nLength == 1) {
+        auto iter = m_charItems.find(GetCharKey(filterText[0]));
+        if (iter != m_charItems.end()) {
+            pCandidateList = &iter->second;
+        }
+        return pCandidateList;
+    }
+    for (size_t nPos = 0; (nPos + 1) < nLength; ++nPos) {
+        auto iter = m_bigramItems.find(MakeBigramKey(filterText[nPos], filterText[nPos + 1]));
+        if (iter == m_bigramItems.end()) {
+            //该二元组不在任何子项中出现
+            return nullptr;
+        }
+        if ((pCandidateList == nullptr) || (iter->second.size() < pCandidateList->size())) {
+            pCandidateList = &iter->second;
+        }
+    }
+    return pCandidateList;
+}
+
+} // namespace ui
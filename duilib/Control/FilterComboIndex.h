@@ -0,0 +1,80 @@
+#ifndef UI_CONTROL_FILTERCOMBO_INDEX_H_
+#define UI_CONTROL_FILTERCOMBO_INDEX_H_
+
+#include "duilib/duilib_defs.h"
+#include <unordered_map>
+#include <vector>
+
+namespace ui
+{
+/** 过滤组合框的文本检索索引，用于子项数量很多的下拉列表：
+*   1. 子项文本预先转换为小写，过滤时不需要逐项转换；
+*   2. 按字符和相邻两个字符（二元组）建立倒排表，查询时只需要校验倒排表中最短的那一组子项；
+*   3. 新的过滤文本包含上次的过滤文本时（比如继续输入字符），只在上次的结果中查找
+*/
+class UILIB_API FilterComboIndex
+{
+public:
+    FilterComboIndex();
+    FilterComboIndex(const FilterComboIndex&) = delete;
+    FilterComboIndex& operator=(const FilterComboIndex&) = delete;
+
+public:
+    /** 清空所有数据
+    */
+    void Clear();
+
+    /** 按子项的文本重建索引，时间复杂度O(文本总长度)
+    * @param [in] itemTexts 各子项的文本（不需要转换为小写）
+    */
+    void Rebuild(const std::vector<DString>& itemTexts);
+
+    /** 获取索引中的子项数量
+    */
+    size_t GetItemCount() const;
+
+    /** 查找包含过滤文本的子项（不区分大小写）
+    * @param [in] filterText 过滤文本（已转换为小写），为空时返回所有子项
+    * @param [out] itemIndexList 返回子项的索引号，按索引号从小到大排序
+    */
+    void Query(const DString& filterText, std::vector<uint32_t>& itemIndexList);
+
+private:
+    /** 生成二元组的Key
+    */
+    static uint64_t MakeBigramKey(DString::value_type ch1, DString::value_type ch2);
+
+    /** 获取过滤文本的候选子项列表（倒排表中最短的一组）
+    * @return 如果某个字符或者二元组不存在，表示没有匹配的子项，返回nullptr
+    */
+    const std::vector<uint32_t>* GetCandidateList(const DString& filterText) const;
+
+private:
+    /** 各子项转换为小写后的文本
+    */
+    std::vector<DString> m_itemTexts;
+
+    /** 单个字符的倒排表：字符 -> 包含该字符的子项索引号（从小到大排序）
+    */
+    std::unordered_map<uint32_t, std::vector<uint32_t>> m_charItems;
+
+    /** 二元组的倒排表：相邻两个字符 -> 包含该二元组的子项索引号（从小到大排序）
+    */
+    std::unordered_map<uint64_t, std::vector<uint32_t>> m_bigramItems;
+
+    /** 上次查询的过滤文本
+    */
+    DString m_lastFilterText;
+
+    /** 上次查询的结果
+    */
+    std::vector<uint32_t> m_lastItemIndexList;
+
+    /** 上次查询的结果是否有效
+    */
+    bool m_bLastValid;
+};
+
+} // namespace ui
+
+#endif // UI_CONTROL_FILTERCOMBO_INDEX_H_
@@ -55,6 +55,10 @@ public:
     */
     virtual void ChangeDpiScale(uint32_t nOldDpiScale, uint32_t nNewDpiScale) override;
 
+    /** 语言发生变化，使用文本ID的标签重新计算大小并重绘
+    */
+    virtual void OnLanguageChanged() override;
+
     /** 恢复默认的文本样式
     */
     void SetDefaultTextStyle(bool bRedraw);
@@ -156,6 +160,7 @@ private:
     UiPadding16    m_rcTextPadding;
     UiString m_sText;
     UiString m_sTextId;
+    uint32_t m_nTextIdHandle;  //m_sTextId对应的字符串句柄（避免每次获取文本时按字符串ID查找）
     StateColorMap* m_pTextColorMap;
 };
 
@@ -169,6 +174,7 @@ LabelTemplate<InheritType>::LabelTemplate(Window* pWindow) :
     m_rcTextPadding(),
     m_sText(),
     m_sTextId(),
+    m_nTextIdHandle(LangManager::InvalidStringHandle),
     m_pTextColorMap(nullptr)
 {
     Box* pBox = dynamic_cast<Box*>(this);
@@ -321,13 +327,22 @@ template<typename InheritType>
 DString LabelTemplate<InheritType>::GetText() const
 {
     DString strText = m_sText.c_str();
-    if (strText.empty() && !m_sTextId.empty()) {
-        strText = GlobalManager::Instance().Lang().GetStringViaID(m_sTextId.c_str());
+    if (strText.empty() && (m_nTextIdHandle != LangManager::InvalidStringHandle)) {
+        strText = GlobalManager::Instance().Lang().GetStringViaHandle(m_nTextIdHandle);
     }
 
     return strText;
 }
 
+template<typename InheritType>
+void LabelTemplate<InheritType>::OnLanguageChanged()
+{
+    if (m_sText.empty() && !m_sTextId.empty()) {
+        this->RelayoutOrRedraw();
+        CheckShowToolTip();
+    }
+}
+
 template<typename InheritType>
 void LabelTemplate<InheritType>::SetAutoToolTip(bool bAutoShow)
 {
@@ -435,6 +450,10 @@ void LabelTemplate<InheritType>::SetTextId(const DString& strTextId)
         return;
     }
     m_sTextId = strTextId;
+    m_nTextIdHandle = GlobalManager::Instance().Lang().GetStringHandle(strTextId);
+    if (!strTextId.empty()) {
+        this->RegisterLangControl();
+    }
     this->RelayoutOrRedraw();
     CheckShowToolTip();
 }
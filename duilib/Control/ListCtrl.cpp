@@ -18,8 +18,10 @@ ListCtrl::ListCtrl(Window* pWindow):
     m_bEnableHeaderDragOrder(true),
     m_bShowHeaderCtrl(true),
     m_bEnableRefresh(true),
+    m_bHeaderCheckPending(false),
     m_bMultiSelect(true),
     m_bEnableColumnWidthAuto(true),
+    m_nColumnWidthAutoSampleCount(256),
     m_bAutoCheckSelect(false),
     m_bHeaderShowCheckBox(false),
     m_bDataItemShowCheckBox(false),
@@ -78,6 +80,8 @@ void ListCtrl::SetImageList(ListCtrlType type, const ImageListPtr& spImageList)
 {
     if (type == ListCtrlType::Report) {
         m_imageList[0] = spImageList;
+        //图标的宽度可能变化，缓存的宽度需要重新计算
+        m_pData->ClearColumnWidthCache();
     }
     else if (type == ListCtrlType::Icon) {
         m_imageList[1] = spImageList;
@@ -162,6 +166,9 @@ void ListCtrl::SetAttribute(const DString& strName, const DString& strValue)
     else if (strName == _T("enable_column_width_auto")) {
         SetEnableColumnWidthAuto(strValue == _T("true"));
     }
+    else if (strName == _T("column_width_auto_sample_count")) {
+        SetColumnWidthAutoSampleCount((size_t)std::max(StringUtil::StringToInt32(strValue), 0));
+    }
     else if (strName == _T("auto_check_select")) {
         SetAutoCheckSelect(strValue == _T("true"));
     }
@@ -635,6 +642,8 @@ DString ListCtrl::GetHeaderSplitControlClass() const
 void ListCtrl::SetCheckBoxClass(const DString& className)
 {
     m_checkBoxClass = className;
+    //CheckBox的宽度可能变化，缓存的宽度需要重新计算
+    m_pData->ClearColumnWidthCache();
 }
 
 DString ListCtrl::GetCheckBoxClass() const
@@ -658,6 +667,8 @@ DString ListCtrl::GetReportViewClass() const
 void ListCtrl::SetDataItemClass(const DString& className)
 {
     m_dataItemClass = className;
+    //内边距等属性可能变化，缓存的宽度需要重新计算
+    m_pData->ClearColumnWidthCache();
 }
 
 DString ListCtrl::GetDataItemClass() const
@@ -672,6 +683,8 @@ void ListCtrl::SetDataSubItemClass(const DString& className)
         ListCtrlSubItem defaultSubItem(GetWindow());
         defaultSubItem.SetClass(className);
         m_pData->SetDefaultTextStyle(defaultSubItem.GetTextStyle());
+        //字体等属性可能变化，缓存的宽度需要重新计算
+        m_pData->ClearColumnWidthCache();
     }
 }
 
@@ -846,6 +859,16 @@ bool ListCtrl::IsEnableColumnWidthAuto() const
     return m_bEnableColumnWidthAuto;
 }
 
+void ListCtrl::SetColumnWidthAutoSampleCount(size_t nSampleCount)
+{
+    m_nColumnWidthAutoSampleCount = nSampleCount;
+}
+
+size_t ListCtrl::GetColumnWidthAutoSampleCount() const
+{
+    return m_nColumnWidthAutoSampleCount;
+}
+
 ListCtrlHeaderItem* ListCtrl::InsertColumn(int32_t columnIndex, const ListCtrlColumn& columnInfo)
 {
     ASSERT(m_pHeaderCtrl != nullptr);
@@ -918,7 +941,7 @@ bool ListCtrl::SetColumnWidthAuto(size_t columnIndex)
         return bRet;
     }
     //计算该列的宽度
-    int32_t nMaxWidth = m_pData->GetMaxColumnWidth(nColumnId);
+    int32_t nMaxWidth = m_pData->GetMaxColumnWidth(nColumnId, m_nColumnWidthAutoSampleCount);
     if (nMaxWidth > 0) {
         bRet = SetColumnWidth(columnIndex, nMaxWidth, false);
     }
@@ -1379,6 +1402,11 @@ void ListCtrl::OnHeaderColumnSplitDoubleClick(ListCtrlHeaderItem* pHeaderItem)
 
 void ListCtrl::UpdateHeaderColumnCheckBox(size_t nColumnId)
 {
+    if (IsUpdating()) {
+        //批量更新期间，推迟到EndUpdate时同步
+        m_bHeaderCheckPending = true;
+        return;
+    }
     ASSERT(m_pHeaderCtrl != nullptr);
     if (m_pHeaderCtrl == nullptr) {
         return;
@@ -1415,6 +1443,11 @@ void ListCtrl::UpdateHeaderColumnCheckBox(size_t nColumnId)
 
 void ListCtrl::UpdateHeaderCheckBox()
 {
+    if (IsUpdating()) {
+        //批量更新期间，推迟到EndUpdate时同步
+        m_bHeaderCheckPending = true;
+        return;
+    }
     if (!IsDataItemShowCheckBox()) {
         //不显示CheckBox，忽略
         return;
@@ -1466,6 +1499,21 @@ size_t ListCtrl::AddDataItem(const ListCtrlSubItemData& dataItem)
     return nItemIndex;
 }
 
+size_t ListCtrl::AddDataItems(const std::vector<ListCtrlSubItemData>& dataItems)
+{
+    size_t columnId = GetColumnId(0);
+    ASSERT(columnId != Box::InvalidIndex);
+    if (columnId == Box::InvalidIndex) {
+        return Box::InvalidIndex;
+    }
+    size_t nItemIndex = m_pData->AddDataItems(columnId, dataItems);
+    if (nItemIndex != Box::InvalidIndex) {
+        UpdateHeaderColumnCheckBox(Box::InvalidIndex);
+        UpdateHeaderCheckBox();
+    }
+    return nItemIndex;
+}
+
 bool ListCtrl::InsertDataItem(size_t itemIndex, const ListCtrlSubItemData& dataItem)
 {
     size_t columnId = GetColumnId(0);
@@ -2065,6 +2113,40 @@ void ListCtrl::RefreshDataItems(const std::vector<size_t>& dataItemIndexs)
     }
 }
 
+void ListCtrl::OnBeginUpdate()
+{
+    BaseClass::OnBeginUpdate();
+    if (m_pReportView != nullptr) {
+        m_pReportView->BeginUpdate();
+    }
+    if (m_pIconView != nullptr) {
+        m_pIconView->BeginUpdate();
+    }
+    if (m_pListView != nullptr) {
+        m_pListView->BeginUpdate();
+    }
+}
+
+void ListCtrl::OnEndUpdate()
+{
+    //视图可能在批量更新期间创建，只结束已经开始批量更新的视图
+    if ((m_pReportView != nullptr) && m_pReportView->IsUpdating()) {
+        m_pReportView->EndUpdate();
+    }
+    if ((m_pIconView != nullptr) && m_pIconView->IsUpdating()) {
+        m_pIconView->EndUpdate();
+    }
+    if ((m_pListView != nullptr) && m_pListView->IsUpdating()) {
+        m_pListView->EndUpdate();
+    }
+    if (m_bHeaderCheckPending) {
+        m_bHeaderCheckPending = false;
+        UpdateHeaderColumnCheckBox(Box::InvalidIndex);
+        UpdateHeaderCheckBox();
+    }
+    BaseClass::OnEndUpdate();
+}
+
 bool ListCtrl::SetEnableRefresh(bool bEnable)
 {
     bool bOldEnable = m_bEnableRefresh;
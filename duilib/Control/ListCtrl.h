@@ -201,6 +201,12 @@ public:
     */
     size_t AddDataItem(const ListCtrlSubItemData& dataItem);
 
+    /** 在最后批量添加数据项(行数+N), 数据关联到第一列（列序号为0），全部添加完成后刷新一次界面
+    * @param [in] dataItems 数据项的内容列表
+    * @return 成功返回第一个数据项的索引号，有效范围：[0, GetDataItemCount()); 失败则返回Box::InvalidIndex
+    */
+    size_t AddDataItems(const std::vector<ListCtrlSubItemData>& dataItems);
+
     /** 在指定行位置添加一个数据项(行数+1)
     * @param [in] itemIndex 数据项的索引号, 有效范围：[0, GetDataItemCount())
     * @param [in] dataItem 数据项的内容
@@ -770,6 +776,13 @@ public:
     void SetEnableColumnWidthAuto(bool bEnable);
     bool IsEnableColumnWidthAuto() const;
 
+    /** 自动调整列宽时，抽样计算的单元格数量（默认为256）
+    *   未计算过宽度的单元格数量超过该值时，只计算显示长度最长的单元格，以提高大数据量时的计算速度；
+    *   如果为0，表示计算所有单元格（精确计算）
+    */
+    void SetColumnWidthAutoSampleCount(size_t nSampleCount);
+    size_t GetColumnWidthAutoSampleCount() const;
+
     /** 获取当前排序列的ID和排序方式
     * @param [out] nSortColumnId 排序列的ID
     * @param [out] bSortUp 当前排序是否为升序排列，true表示升序，false表示降序
@@ -939,6 +952,14 @@ protected:
     DString GetRichEditClass() const;
 
 protected:
+    /** 开始批量更新：同时对各个视图开始批量更新
+    */
+    virtual void OnBeginUpdate() override;
+
+    /** 结束批量更新：各个视图刷新一次，并同步表头的勾选状态
+    */
+    virtual void OnEndUpdate() override;
+
     /** 增加一列
     * @param [in] nColumnId 列的ID
     */
@@ -1177,6 +1198,10 @@ private:
     */
     bool m_bEnableRefresh;
 
+    /** 批量更新期间，是否需要同步表头的勾选状态
+    */
+    bool m_bHeaderCheckPending;
+
     /** 是否支持多选(默认是单选)
     */
     bool m_bMultiSelect;
@@ -1185,6 +1210,10 @@ private:
     */
     bool m_bEnableColumnWidthAuto;
 
+    /** 自动调整列宽时，抽样计算的单元格数量
+    */
+    size_t m_nColumnWidthAutoSampleCount;
+
     /** 是否自动勾选选择的数据项（与Windows下ListCtrl的LVS_EX_AUTOCHECKSELECT属性相似）
     */
     bool m_bAutoCheckSelect;
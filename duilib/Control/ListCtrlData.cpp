@@ -18,7 +18,9 @@ ListCtrlData::ListCtrlData() :
     m_nSelectedIndex(Box::InvalidIndex),
     m_nDefaultTextStyle(0),
     m_nDefaultItemHeight(-1),
-    m_bAutoCheckSelect(false)
+    m_bAutoCheckSelect(false),
+    m_nHeightIndexItemHeight(-1),
+    m_bHeightIndexDirty(true)
 {
 }
 
@@ -58,7 +60,33 @@ bool ListCtrlData::FillElement(Control* pControl, size_t nElementIndex)
     return bRet;
 }
 
-int32_t ListCtrlData::GetMaxColumnWidth(size_t columnId) const
+/** 估算文本的显示长度：按字符计数，CJK等宽字符按2个字符计算（用于抽样时选取最长的文本）
+*/
+static size_t GetTextDisplayLength(const UiString& text)
+{
+    size_t nLength = 0;
+    const DString::value_type* pText = text.c_str();
+    if (pText == nullptr) {
+        return nLength;
+    }
+#ifdef DUILIB_UNICODE
+    for (; *pText != 0; ++pText) {
+        nLength += ((uint32_t)*pText >= 0x2E80) ? 2 : 1;
+    }
+#else
+    //UTF-8编码：不计算后续字节，3字节及以上的字符（CJK等）按2个字符计算
+    for (; *pText != 0; ++pText) {
+        const uint8_t ch = (uint8_t)*pText;
+        if ((ch & 0xC0) == 0x80) {
+            continue;
+        }
+        nLength += (ch >= 0xE0) ? 2 : 1;
+    }
+#endif
+    return nLength;
+}
+
+int32_t ListCtrlData::GetMaxColumnWidth(size_t columnId, size_t nSampleCount) const
 {
     int32_t nMaxWidth = -1;
     std::vector<ListCtrlSubItemData2Ptr> subItemList;
@@ -67,11 +95,45 @@ int32_t ListCtrlData::GetMaxColumnWidth(size_t columnId) const
     if (iter != m_dataMap.end()) {
         const StoragePtrList& storageList = iter->second;
         const size_t nCount = storageList.size();
+        //已经计算过宽度的单元格，只需要宽度最大的一个
+        ListCtrlSubItemData2Ptr pMaxCachedStorage;
+        //未计算过宽度的单元格
+        std::vector<ListCtrlSubItemData2Ptr> uncachedList;
         for (size_t index = 0; index < nCount; ++index) {
-            if (storageList[index] != nullptr) {
-                subItemList.push_back(storageList[index]);
+            const ListCtrlSubItemData2Ptr& pStorage = storageList[index];
+            if ((pStorage == nullptr) || pStorage->text.empty()) {
+                continue;
+            }
+            if (pStorage->nCachedWidth >= 0) {
+                if ((pMaxCachedStorage == nullptr) || (pMaxCachedStorage->nCachedWidth < pStorage->nCachedWidth)) {
+                    pMaxCachedStorage = pStorage;
+                }
+            }
+            else {
+                uncachedList.push_back(pStorage);
+            }
+        }
+        if (pMaxCachedStorage != nullptr) {
+            subItemList.push_back(pMaxCachedStorage);
+        }
+        if ((nSampleCount > 0) && (uncachedList.size() > nSampleCount)) {
+            //抽样：只计算显示长度最长的nSampleCount个单元格
+            std::vector<std::pair<size_t, size_t>> textLengthList; //<文本长度, 索引号>
+            textLengthList.reserve(uncachedList.size());
+            for (size_t index = 0; index < uncachedList.size(); ++index) {
+                textLengthList.push_back({ GetTextDisplayLength(uncachedList[index]->text), index });
+            }
+            std::nth_element(textLengthList.begin(), textLengthList.begin() + (nSampleCount - 1), textLengthList.end(),
+                             [](const std::pair<size_t, size_t>& a, const std::pair<size_t, size_t>& b) {
+                                 return a.first > b.first;
+                             });
+            for (size_t index = 0; index < nSampleCount; ++index) {
+                subItemList.push_back(uncachedList[textLengthList[index].second]);
             }
         }
+        else {
+            subItemList.insert(subItemList.end(), uncachedList.begin(), uncachedList.end());
+        }
     }
     if (!subItemList.empty()) {
         ASSERT(m_pListView != nullptr);
@@ -82,6 +144,17 @@ int32_t ListCtrlData::GetMaxColumnWidth(size_t columnId) const
     return nMaxWidth;
 }
 
+void ListCtrlData::ClearColumnWidthCache()
+{
+    for (auto& iter : m_dataMap) {
+        for (const ListCtrlSubItemData2Ptr& pStorage : iter.second) {
+            if (pStorage != nullptr) {
+                pStorage->nCachedWidth = -1;
+            }
+        }
+    }
+}
+
 size_t ListCtrlData::GetElementCount() const
 {
     return GetDataItemCount();
@@ -214,11 +287,14 @@ void ListCtrlData::ChangeDpiScale(const DpiManager& dpiManager, uint32_t nOldDpi
             data.nItemHeight = ui::TruncateToUInt16(dpiManager.GetScaleInt((int32_t)data.nItemHeight, nOldDpiScale));
         }
     }
+    m_bHeightIndexDirty = true;
+    ClearColumnWidthCache();
 }
 
 void ListCtrlData::SubItemToStorage(const ListCtrlSubItemData& item, Storage& storage) const
 {
     storage.text = item.text;
+    storage.nCachedWidth = -1;
     if (item.nTextFormat >= 0) {
         storage.nTextFormat = TruncateToUInt16(item.nTextFormat);
     }
@@ -293,6 +369,7 @@ bool ListCtrlData::RemoveColumn(size_t columnId)
             m_hideRowCount = 0;
             m_heightRowCount = 0;
             m_atTopRowCount = 0;
+            m_bHeightIndexDirty = true;
         }
         EmitCountChanged();
         return true;
@@ -394,6 +471,100 @@ bool ListCtrlData::IsNormalMode() const
     return (m_hideRowCount == 0) && (m_heightRowCount == 0) && (m_atTopRowCount == 0);
 }
 
+const VirtualHeightIndex& ListCtrlData::GetRowHeightIndex(int32_t nDefaultItemHeight)
+{
+    RebuildRowHeightIndex(nDefaultItemHeight);
+    return m_rowHeightIndex;
+}
+
+const VirtualHeightIndex& ListCtrlData::GetAtTopRowHeightIndex(int32_t nDefaultItemHeight)
+{
+    RebuildRowHeightIndex(nDefaultItemHeight);
+    return m_atTopHeightIndex;
+}
+
+void ListCtrlData::GetRowIndexHeights(const ListCtrlItemData& rowData, int32_t nDefaultItemHeight,
+                                      int32_t& nRowHeight, int32_t& nAtTopHeight) const
+{
+    nRowHeight = 0;
+    nAtTopHeight = 0;
+    int32_t nItemHeight = (rowData.nItemHeight < 0) ? nDefaultItemHeight : rowData.nItemHeight;
+    if (!rowData.bVisible || (nItemHeight <= 0)) {
+        //不可见的行，高度为0
+        return;
+    }
+    if (rowData.nAlwaysAtTop >= 0) {
+        nAtTopHeight = nItemHeight;
+    }
+    else {
+        nRowHeight = nItemHeight;
+    }
+}
+
+void ListCtrlData::RebuildRowHeightIndex(int32_t nDefaultItemHeight)
+{
+    if (!m_bHeightIndexDirty &&
+        (m_nHeightIndexItemHeight == nDefaultItemHeight) &&
+        (m_rowHeightIndex.GetCount() == m_rowDataList.size())) {
+        return;
+    }
+    const size_t nCount = m_rowDataList.size();
+    std::vector<int32_t> rowHeights(nCount, 0);
+    std::vector<int32_t> atTopHeights(nCount, 0);
+    for (size_t index = 0; index < nCount; ++index) {
+        GetRowIndexHeights(m_rowDataList[index], nDefaultItemHeight, rowHeights[index], atTopHeights[index]);
+    }
+    m_rowHeightIndex.Assign(rowHeights);
+    m_atTopHeightIndex.Assign(atTopHeights);
+    m_nHeightIndexItemHeight = nDefaultItemHeight;
+    m_bHeightIndexDirty = false;
+}
+
+void ListCtrlData::UpdateRowHeightIndex(size_t itemIndex)
+{
+    if (m_bHeightIndexDirty || (itemIndex >= m_rowHeightIndex.GetCount())) {
+        //索引需要重建，使用时再统一处理
+        return;
+    }
+    int32_t nRowHeight = 0;
+    int32_t nAtTopHeight = 0;
+    GetRowIndexHeights(m_rowDataList[itemIndex], m_nHeightIndexItemHeight, nRowHeight, nAtTopHeight);
+    m_rowHeightIndex.SetHeight(itemIndex, nRowHeight);
+    m_atTopHeightIndex.SetHeight(itemIndex, nAtTopHeight);
+}
+
+void ListCtrlData::InsertRowHeightIndex(size_t itemIndex, size_t nCount)
+{
+    if (m_bHeightIndexDirty || ((m_rowHeightIndex.GetCount() + nCount) != m_rowDataList.size()) ||
+        (itemIndex > m_rowHeightIndex.GetCount())) {
+        m_bHeightIndexDirty = true;
+        return;
+    }
+    if (nCount == 0) {
+        return;
+    }
+    //新增的行数据相同，高度也相同
+    int32_t nRowHeight = 0;
+    int32_t nAtTopHeight = 0;
+    GetRowIndexHeights(m_rowDataList[itemIndex], m_nHeightIndexItemHeight, nRowHeight, nAtTopHeight);
+    m_rowHeightIndex.Insert(itemIndex, nRowHeight, nCount);
+    m_atTopHeightIndex.Insert(itemIndex, nAtTopHeight, nCount);
+}
+
+void ListCtrlData::EraseRowHeightIndex(size_t itemIndex, size_t nCount)
+{
+    if (m_bHeightIndexDirty || (m_rowHeightIndex.GetCount() != (m_rowDataList.size() + nCount)) ||
+        ((itemIndex + nCount) > m_rowHeightIndex.GetCount())) {
+        m_bHeightIndexDirty = true;
+        return;
+    }
+    if (nCount == 0) {
+        return;
+    }
+    m_rowHeightIndex.Erase(itemIndex, nCount);
+    m_atTopHeightIndex.Erase(itemIndex, nCount);
+}
+
 size_t ListCtrlData::GetDataItemCount() const
 {
 #ifdef _DEBUG
@@ -423,6 +594,12 @@ bool ListCtrlData::SetDataItemCount(size_t itemCount)
     for (auto iter = m_dataMap.begin(); iter != m_dataMap.end(); ++iter) {
         iter->second.resize(itemCount);
     }
+    if (itemCount > nOldCount) {
+        InsertRowHeightIndex(nOldCount, itemCount - nOldCount);
+    }
+    else {
+        EraseRowHeightIndex(itemCount, nOldCount - itemCount);
+    }
     if (itemCount < nOldCount) {
         //行数变少了
         if ((m_hideRowCount != 0) || (m_heightRowCount != 0) || (m_atTopRowCount != 0)) {
@@ -478,6 +655,44 @@ size_t ListCtrlData::AddDataItem(size_t columnId, const ListCtrlSubItemData& dat
 
     //行数据，插入1条数据
     m_rowDataList.push_back(ListCtrlItemData());
+    InsertRowHeightIndex(m_rowDataList.size() - 1, 1);
+
+    EmitCountChanged();
+    return nDataItemIndex;
+}
+
+size_t ListCtrlData::AddDataItems(size_t columnId, const std::vector<ListCtrlSubItemData>& dataItems)
+{
+    ASSERT(IsValidDataColumnId(columnId));
+    if (!IsValidDataColumnId(columnId) || dataItems.empty()) {
+        return Box::InvalidIndex;
+    }
+
+    const size_t nNewCount = m_rowDataList.size() + dataItems.size();
+    size_t nDataItemIndex = Box::InvalidIndex;
+    for (auto iter = m_dataMap.begin(); iter != m_dataMap.end(); ++iter) {
+        size_t id = iter->first;
+        StoragePtrList& storageList = iter->second;
+        storageList.reserve(nNewCount);
+        if (id == columnId) {
+            //关联列：保存数据
+            nDataItemIndex = storageList.size();
+            for (const ListCtrlSubItemData& dataItem : dataItems) {
+                StoragePtr pStorage = std::make_shared<Storage>();
+                SubItemToStorage(dataItem, *pStorage);
+                storageList.push_back(pStorage);
+            }
+        }
+        else {
+            //其他列：插入空数据
+            storageList.resize(storageList.size() + dataItems.size());
+        }
+    }
+
+    //行数据，插入数据
+    const size_t nOldCount = m_rowDataList.size();
+    m_rowDataList.resize(nNewCount);
+    InsertRowHeightIndex(nOldCount, nNewCount - nOldCount);
 
     EmitCountChanged();
     return nDataItemIndex;
@@ -516,6 +731,7 @@ bool ListCtrlData::InsertDataItem(size_t itemIndex, size_t columnId, const ListC
         ++m_nSelectedIndex;
     }
     m_rowDataList.insert(m_rowDataList.begin() + itemIndex, ListCtrlItemData());
+    InsertRowHeightIndex(itemIndex, 1);
 
     EmitCountChanged();
     return true;
@@ -547,6 +763,7 @@ bool ListCtrlData::DeleteDataItem(size_t itemIndex)
             }
         }
         m_rowDataList.erase(m_rowDataList.begin() + itemIndex);
+        EraseRowHeightIndex(itemIndex, 1);
         if (!oldData.bVisible) {
             m_hideRowCount -= 1;
             ASSERT(m_hideRowCount >= 0);
@@ -584,6 +801,7 @@ bool ListCtrlData::DeleteAllDataItems()
     m_hideRowCount = 0;
     m_heightRowCount = 0;
     m_atTopRowCount = 0;
+    m_bHeightIndexDirty = true;
 
     if (bDeleted) {
         EmitCountChanged();
@@ -657,6 +875,7 @@ bool ListCtrlData::SetDataItemData(size_t itemIndex, const ListCtrlItemData& ite
             m_atTopRowCount += 1;
         }
         ASSERT(m_atTopRowCount >= 0);
+        UpdateRowHeightIndex(itemIndex);
         bRet = true;
     }
     if (bCountChanged) {
@@ -698,6 +917,7 @@ bool ListCtrlData::SetDataItemVisible(size_t itemIndex, bool bVisible, bool& bCh
             m_hideRowCount += 1;
         }
         ASSERT(m_hideRowCount >= 0);
+        UpdateRowHeightIndex(itemIndex);
         bRet = true;
     }
     if (bChanged) {
@@ -1013,6 +1233,7 @@ bool ListCtrlData::SetDataItemAlwaysAtTop(size_t itemIndex, int8_t nAlwaysAtTop,
             m_atTopRowCount += 1;
         }
         ASSERT(m_atTopRowCount >= 0);
+        UpdateRowHeightIndex(itemIndex);
         bRet = true;
     }
     //不刷新，由外部判断是否需要刷新
@@ -1056,6 +1277,7 @@ bool ListCtrlData::SetDataItemHeight(size_t itemIndex, int32_t nItemHeight, bool
             m_heightRowCount += 1;
         }
         ASSERT(m_heightRowCount >= 0);
+        UpdateRowHeightIndex(itemIndex);
         bRet = true;
     }
     //不刷新，由外部判断是否需要刷新
@@ -1170,6 +1392,7 @@ bool ListCtrlData::SetSubItemText(size_t itemIndex, size_t columnId, const DStri
     }
     if (pStorage->text != text) {
         pStorage->text = text;
+        pStorage->nCachedWidth = -1;
         EmitDataChanged(itemIndex, itemIndex);
     }    
     return true;
@@ -1336,6 +1559,7 @@ bool ListCtrlData::SetSubItemTextFormat(size_t itemIndex, size_t columnId, int32
 
     if (pStorage->nTextFormat != nValidTextFormat) {
         pStorage->nTextFormat = ui::TruncateToUInt16(nValidTextFormat);
+        pStorage->nCachedWidth = -1;
         EmitDataChanged(itemIndex, itemIndex);
     }
     return true;
@@ -1404,6 +1628,7 @@ bool ListCtrlData::SetSubItemShowCheckBox(size_t itemIndex, size_t columnId, boo
     }
     if (pStorage->bShowCheckBox != bShowCheckBox) {
         pStorage->bShowCheckBox = bShowCheckBox;
+        pStorage->nCachedWidth = -1;
         EmitDataChanged(itemIndex, itemIndex);
     }    
     return true;
@@ -1460,6 +1685,7 @@ bool ListCtrlData::SetSubItemImageId(size_t itemIndex, size_t columnId, int32_t
     }
     if (pStorage->nImageId != imageId) {
         pStorage->nImageId = imageId;
+        pStorage->nCachedWidth = -1;
         EmitDataChanged(itemIndex, itemIndex);
     }
     return true;
@@ -1550,6 +1776,7 @@ bool ListCtrlData::SortDataItems(size_t nColumnId, size_t nColumnIndex,
             bFoundSelectedIndex = true;
         }
     }
+    m_bHeightIndexDirty = true;
 
     EmitCountChanged();
     return true;
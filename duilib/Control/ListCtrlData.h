@@ -2,6 +2,7 @@
 #define UI_CONTROL_LIST_CTRL_DATA_PROVIDER_H_
 
 #include "duilib/Box/VirtualListBox.h"
+#include "duilib/Box/VirtualHeightIndex.h"
 #include "duilib/Control/ListCtrlDefs.h"
 
 namespace ui
@@ -104,10 +105,17 @@ public:
     */
     bool RemoveColumn(size_t columnId);
 
-    /** 获取某列的宽度最大值
+    /** 获取某列的宽度最大值（已经计算过的单元格使用缓存的宽度）
+    * @param [in] columnId 列的ID
+    * @param [in] nSampleCount 抽样计算的数量：未计算过宽度的单元格数量超过该值时，只计算显示长度最长的nSampleCount个单元格；
+    *                          如果为0，表示计算所有单元格
     * @return 返回该列宽度的最大值，返回的是DPI自适应后的值； 如果失败返回-1
     */
-    int32_t GetMaxColumnWidth(size_t columnId) const;
+    int32_t GetMaxColumnWidth(size_t columnId, size_t nSampleCount = 0) const;
+
+    /** 清除所有单元格缓存的显示宽度（DPI或者字体变化后，需要重新计算）
+    */
+    void ClearColumnWidthCache();
 
     /** 设置一列的勾选状态（Checked或者UnChecked）
     * @param [in] columnId 列的ID
@@ -132,6 +140,13 @@ public:
     */
     size_t AddDataItem(size_t columnId, const ListCtrlSubItemData& dataItem);
 
+    /** 在最后批量添加数据项（预先分配空间）, 全部添加完成后刷新一次界面显示
+    * @param [in] columnId 列的ID
+    * @param [in] dataItems 数据项的内容列表
+    * @return 成功返回第一个数据项的行索引号，失败则返回Box::InvalidIndex
+    */
+    size_t AddDataItems(size_t columnId, const std::vector<ListCtrlSubItemData>& dataItems);
+
     /** 在指定行位置添加一个数据项, 并刷新界面显示
     * @param [in] itemIndex 数据项的索引号
     * @param [in] columnId 列的ID
@@ -564,6 +579,16 @@ public:
     */
     bool IsNormalMode() const;
 
+    /** 获取行高索引（只统计非置顶的可见行，其他行的高度为0），用于按滚动位置快速查找行
+    * @param [in] nDefaultItemHeight 默认行高
+    */
+    const VirtualHeightIndex& GetRowHeightIndex(int32_t nDefaultItemHeight);
+
+    /** 获取置顶行的行高索引（只统计置顶的可见行，其他行的高度为0）
+    * @param [in] nDefaultItemHeight 默认行高
+    */
+    const VirtualHeightIndex& GetAtTopRowHeightIndex(int32_t nDefaultItemHeight);
+
 private:
     /** 排序数据
     */
@@ -598,6 +623,35 @@ private:
     */
     void UpdateNormalMode();
 
+    /** 获取一行在行高索引中的高度
+    * @param [in] rowData 行数据
+    * @param [in] nDefaultItemHeight 默认行高
+    * @param [out] nRowHeight 在行高索引中的高度
+    * @param [out] nAtTopHeight 在置顶行的行高索引中的高度
+    */
+    void GetRowIndexHeights(const ListCtrlItemData& rowData, int32_t nDefaultItemHeight,
+                            int32_t& nRowHeight, int32_t& nAtTopHeight) const;
+
+    /** 如果行数据整体变化（默认行高变化、排序、清空等），重建行高索引
+    */
+    void RebuildRowHeightIndex(int32_t nDefaultItemHeight);
+
+    /** 行的属性（行高、隐藏、置顶）变化后，更新行高索引
+    */
+    void UpdateRowHeightIndex(size_t itemIndex);
+
+    /** 插入行（新增的行均为默认数据）后，同步更新行高索引，不需要重建
+    * @param [in] itemIndex 第一个新增行的索引号
+    * @param [in] nCount 新增的行数
+    */
+    void InsertRowHeightIndex(size_t itemIndex, size_t nCount);
+
+    /** 删除行后，同步更新行高索引，不需要重建
+    * @param [in] itemIndex 第一个删除行的索引号
+    * @param [in] nCount 删除的行数
+    */
+    void EraseRowHeightIndex(size_t itemIndex, size_t nCount);
+
 private:
     /** 视图控件接口
     */
@@ -650,6 +704,22 @@ private:
     /** 当前默认的行高
     */
     int32_t m_nDefaultItemHeight;
+
+    /** 行高索引（非置顶的可见行）
+    */
+    VirtualHeightIndex m_rowHeightIndex;
+
+    /** 置顶行的行高索引
+    */
+    VirtualHeightIndex m_atTopHeightIndex;
+
+    /** 行高索引使用的默认行高
+    */
+    int32_t m_nHeightIndexItemHeight;
+
+    /** 行高索引是否需要重建
+    */
+    bool m_bHeightIndexDirty;
 };
 
 }//namespace ui
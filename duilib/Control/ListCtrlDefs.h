@@ -79,6 +79,7 @@ struct ListCtrlSubItemData2
     UiString userDataS;             //用户自定义数据(字符串类型)
     int32_t nSortGroup = 0;         //所属分组（比如文件夹和文件可分为两组，排序后，文件夹和文件是分开的）
     bool bEditable = false;         //是否可编辑
+    int32_t nCachedWidth = -1;      //缓存的显示宽度（自动调整列宽时使用，DPI缩放后的值），如果为-1表示未计算，内容变化后需要重置为-1
 };
 
 //列数据的智能指针
@@ -209,26 +209,11 @@ size_t ListCtrlReportView::GetTopDataItemIndex(int64_t nScrollPosY) const
     if (pDataProvider == nullptr) {
         return itemIndex;
     }
-    const ListCtrlData::RowDataList& itemDataList = pDataProvider->GetItemDataList();
-    int64_t totalItemHeight = 0;
-    int32_t nItemHeight = 0;
-    const size_t dataItemCount = itemDataList.size();
-    for (size_t index = 0; index < dataItemCount; ++index) {
-        const ListCtrlItemData& rowData = itemDataList[index];
-        nItemHeight = rowData.nItemHeight;
-        if (nItemHeight < 0) {
-            //取默认行高
-            nItemHeight = m_pListCtrl->GetDataItemHeight();
-        }
-        if (!rowData.bVisible || (nItemHeight  == 0)){
-            continue;
-        }
-        totalItemHeight += nItemHeight;
-        //如果每行高度都相同，相当于 nScrollPosY / ItemHeight
-        if (totalItemHeight > nScrollPosY) {
-            itemIndex = index;
-            break;
-        }
+    //置顶的元素不参与滚动，按行高索引查找滚动位置所在的行
+    const VirtualHeightIndex& rowHeightIndex = pDataProvider->GetRowHeightIndex(m_pListCtrl->GetDataItemHeight());
+    size_t nFoundIndex = rowHeightIndex.FindIndex(nScrollPosY);
+    if (nFoundIndex != VirtualHeightIndex::InvalidIndex) {
+        itemIndex = nFoundIndex;
     }
     return itemIndex;
 }
@@ -281,59 +266,22 @@ void ListCtrlReportView::GetDataItemsToShow(int64_t nScrollPosY, size_t maxCount
     if (pDataProvider == nullptr) {
         return;
     }
-    size_t nTopDataItemIndex = Box::InvalidIndex; //顶部可见的第一个元素序号
     const int32_t nDefaultItemHeight = m_pListCtrl->GetDataItemHeight(); //默认行高
     //置顶的元素序号
-    struct AlwaysAtTopData
-    {
-        int8_t nAlwaysAtTop;    //置顶优先级
-        size_t nItemIndex;      //元素索引
-        int32_t nItemHeight;    //元素的高度
-    };
     std::vector<AlwaysAtTopData> alwaysAtTopItemList;
-    
-    const ListCtrlData::RowDataList& itemDataList = pDataProvider->GetItemDataList();
-    int64_t totalItemHeight = 0;
-    int32_t nItemHeight = 0;
-    const size_t dataItemCount = itemDataList.size();
-    for (size_t index = 0; index < dataItemCount; ++index) {
-        const ListCtrlItemData& rowData = itemDataList[index];
-        nItemHeight = (rowData.nItemHeight < 0) ? nDefaultItemHeight : rowData.nItemHeight;
-        if (!rowData.bVisible || (nItemHeight == 0)) {
-            //不可见的，跳过
-            continue;
-        }
+    GetAlwaysAtTopItems(maxCount, alwaysAtTopItemList);
 
-        if (rowData.nAlwaysAtTop >= 0) {
-            //置顶的元素
-            if (alwaysAtTopItemList.size() < maxCount) {
-                alwaysAtTopItemList.push_back({ rowData.nAlwaysAtTop, index, nItemHeight });
-            }
-            continue;
-        }
-
-        if (nTopDataItemIndex == Box::InvalidIndex) {
-            totalItemHeight += nItemHeight;
-            //如果每行高度都相同，相当于 nScrollPosY / ItemHeight
-            if (totalItemHeight > nScrollPosY) {
-                nTopDataItemIndex = index;
-                nPrevItemHeights = totalItemHeight - nItemHeight;
-            }
-        }
-
-        if ((nTopDataItemIndex != Box::InvalidIndex) && (itemIndexList.size() < maxCount)){
-            itemIndexList.push_back({ index, nItemHeight });
-        }
+    //顶部可见的第一个元素及其后的元素（行高索引中，不可见的和置顶的元素高度为0）
+    const VirtualHeightIndex& rowHeightIndex = pDataProvider->GetRowHeightIndex(nDefaultItemHeight);
+    size_t index = rowHeightIndex.FindIndex(nScrollPosY);
+    if (index != VirtualHeightIndex::InvalidIndex) {
+        nPrevItemHeights = rowHeightIndex.GetOffset(index);
     }
-
-    //对置顶的排序
-    if (!alwaysAtTopItemList.empty()) {
-        std::stable_sort(alwaysAtTopItemList.begin(), alwaysAtTopItemList.end(),
-            [](const AlwaysAtTopData& a, const AlwaysAtTopData& b) {
-                //nAlwaysAtTop值大的，排在前面
-                return a.nAlwaysAtTop > b.nAlwaysAtTop;
-            });
+    while ((index != VirtualHeightIndex::InvalidIndex) && (itemIndexList.size() < maxCount)) {
+        itemIndexList.push_back({ index, rowHeightIndex.GetHeight(index) });
+        index = rowHeightIndex.GetNextVisibleIndex(index + 1);
     }
+
     for (const AlwaysAtTopData& item : alwaysAtTopItemList) {
         atTopItemIndexList.push_back({ item.nItemIndex, item.nItemHeight });
     }
@@ -350,6 +298,36 @@ void ListCtrlReportView::GetDataItemsToShow(int64_t nScrollPosY, size_t maxCount
     ASSERT((itemIndexList.size() + atTopItemIndexList.size()) <= maxCount);
 }
 
+void ListCtrlReportView::GetAlwaysAtTopItems(size_t maxCount, std::vector<AlwaysAtTopData>& alwaysAtTopItemList) const
+{
+    alwaysAtTopItemList.clear();
+    ListCtrlData* pDataProvider = m_pData;
+    if ((pDataProvider == nullptr) || (m_pListCtrl == nullptr)) {
+        return;
+    }
+    const VirtualHeightIndex& atTopHeightIndex = pDataProvider->GetAtTopRowHeightIndex(m_pListCtrl->GetDataItemHeight());
+    if (atTopHeightIndex.GetTotalHeight() <= 0) {
+        //没有置顶的元素
+        return;
+    }
+    const ListCtrlData::RowDataList& itemDataList = pDataProvider->GetItemDataList();
+    size_t index = atTopHeightIndex.GetNextVisibleIndex(0);
+    while ((index != VirtualHeightIndex::InvalidIndex) && (alwaysAtTopItemList.size() < maxCount)) {
+        ASSERT(index < itemDataList.size());
+        alwaysAtTopItemList.push_back({ itemDataList[index].nAlwaysAtTop, index, atTopHeightIndex.GetHeight(index) });
+        index = atTopHeightIndex.GetNextVisibleIndex(index + 1);
+    }
+
+    //对置顶的排序
+    if (!alwaysAtTopItemList.empty()) {
+        std::stable_sort(alwaysAtTopItemList.begin(), alwaysAtTopItemList.end(),
+            [](const AlwaysAtTopData& a, const AlwaysAtTopData& b) {
+                //nAlwaysAtTop值大的，排在前面
+                return a.nAlwaysAtTop > b.nAlwaysAtTop;
+            });
+    }
+}
+
 int32_t ListCtrlReportView::GetMaxDataItemsToShow(int64_t nScrollPosY, int32_t nRectHeight, 
                                                 std::vector<size_t>* pItemIndexList,
                                                 std::vector<size_t>* pAtTopItemIndexList) const
@@ -374,95 +352,45 @@ int32_t ListCtrlReportView::GetMaxDataItemsToShow(int64_t nScrollPosY, int32_t n
     if (pDataProvider == nullptr) {
         return 0;
     }
-    size_t nTopDataItemIndex = Box::InvalidIndex; //顶部可见的第一个元素序号
     const int32_t nDefaultItemHeight = m_pListCtrl->GetDataItemHeight(); //默认行高
     //置顶的元素序号
-    struct AlwaysAtTopData
-    {
-        int8_t nAlwaysAtTop;
-        size_t index;
-    };
     std::vector<AlwaysAtTopData> alwaysAtTopItemList;
-    std::vector<size_t> itemIndexList;
-
-    const ListCtrlData::RowDataList& itemDataList = pDataProvider->GetItemDataList();
-    int64_t totalItemHeight = 0;
-    int32_t nItemHeight = 0;
-    const size_t dataItemCount = itemDataList.size();
-    for (size_t index = 0; index < dataItemCount; ++index) {
-        const ListCtrlItemData& rowData = itemDataList[index];
-        nItemHeight = (rowData.nItemHeight < 0) ? nDefaultItemHeight : rowData.nItemHeight;
-        if (!rowData.bVisible || (nItemHeight == 0)) {
-            //不可见的，跳过
-            continue;
-        }
+    GetAlwaysAtTopItems(Box::InvalidIndex, alwaysAtTopItemList);
 
-        if (rowData.nAlwaysAtTop >= 0) {
-            //置顶的元素
-            alwaysAtTopItemList.push_back({ rowData.nAlwaysAtTop, index });
-            continue;
-        }
-
-        if (nTopDataItemIndex == Box::InvalidIndex) {
-            totalItemHeight += nItemHeight;
-            //如果每行高度都相同，相当于 nScrollPosY / ItemHeight
-            if (totalItemHeight > nScrollPosY) {
-                nTopDataItemIndex = index;
-            }
-        }
-
-        if (nTopDataItemIndex != Box::InvalidIndex) {
-            itemIndexList.push_back(index);
-        }
-    }
-
-    //对置顶的排序
-    if (!alwaysAtTopItemList.empty()) {
-        std::stable_sort(alwaysAtTopItemList.begin(), alwaysAtTopItemList.end(),
-            [](const AlwaysAtTopData& a, const AlwaysAtTopData& b) {
-                //nAlwaysAtTop值大的，排在前面
-                return a.nAlwaysAtTop > b.nAlwaysAtTop;
-            });
-    }
-    std::vector<size_t> atTopIndexList;
-    std::vector<size_t> tempItemIndexList;
-    tempItemIndexList.swap(itemIndexList);
-    for (const AlwaysAtTopData& item : alwaysAtTopItemList) {
-        itemIndexList.push_back(item.index);
-        atTopIndexList.push_back(item.index);
-    }
-    for (size_t index : tempItemIndexList) {
-        itemIndexList.push_back(index);
-    }
     int32_t nShowItemCount = 0;
     int64_t nTotalHeight = 0;
-    for (size_t index : itemIndexList) {
-        if (index >= dataItemCount) {
-            continue;
+    //先显示置顶的元素，然后从顶部可见的第一个元素开始，直到显示区域填满
+    for (const AlwaysAtTopData& item : alwaysAtTopItemList) {
+        nTotalHeight += item.nItemHeight;
+        if (nTotalHeight < nRectHeight) {
+            if (pItemIndexList) {
+                pItemIndexList->push_back(item.nItemIndex);
+            }
+            if (pAtTopItemIndexList != nullptr) {
+                pAtTopItemIndexList->push_back(item.nItemIndex);
+            }
+            ++nShowItemCount;
         }
-        const ListCtrlItemData& rowData = itemDataList[index];
-        nItemHeight = rowData.nItemHeight;
-        if (nItemHeight < 0) {
-            //取默认行高
-            nItemHeight = nDefaultItemHeight;
+        else {
+            nShowItemCount += 2;
+            return nShowItemCount;
         }
-        nTotalHeight += nItemHeight;
+    }
+    const VirtualHeightIndex& rowHeightIndex = pDataProvider->GetRowHeightIndex(nDefaultItemHeight);
+    size_t index = rowHeightIndex.FindIndex(nScrollPosY);
+    while (index != VirtualHeightIndex::InvalidIndex) {
+        nTotalHeight += rowHeightIndex.GetHeight(index);
         if (nTotalHeight < nRectHeight) {
             if (pItemIndexList) {
                 pItemIndexList->push_back(index);
             }
-            if (pAtTopItemIndexList != nullptr) {
-                if (std::find(atTopIndexList.begin(),
-                              atTopIndexList.end(), index) != atTopIndexList.end()) {
-                    pAtTopItemIndexList->push_back(index);
-                }
-            }
             ++nShowItemCount;
         }
         else {
             nShowItemCount += 2;
             break;
         }
+        index = rowHeightIndex.GetNextVisibleIndex(index + 1);
     }
     return nShowItemCount;
 }
@@ -479,32 +407,10 @@ int64_t ListCtrlReportView::GetDataItemTotalHeights(size_t itemIndex, bool bIncl
         return 0;
     }
     const int32_t nDefaultItemHeight = m_pListCtrl->GetDataItemHeight(); //默认行高
-    const ListCtrlData::RowDataList& itemDataList = pDataProvider->GetItemDataList();
-    int64_t totalItemHeight = 0;
-    int32_t nItemHeight = 0;
-    const size_t dataItemCount = itemDataList.size();
-    for (size_t index = 0; index < dataItemCount; ++index) {
-        const ListCtrlItemData& rowData = itemDataList[index];
-        nItemHeight = (rowData.nItemHeight < 0) ? nDefaultItemHeight : rowData.nItemHeight;
-        if (!rowData.bVisible || (nItemHeight == 0)) {
-            //不可见的，跳过
-            continue;
-        }
-
-        if (rowData.nAlwaysAtTop >= 0) {
-            //置顶的元素，需要统计在内
-            if (bIncludeAtTops) {
-                totalItemHeight += nItemHeight;
-            }            
-        }
-        else if (index < itemIndex) {
-            //符合要求的元素
-            totalItemHeight += nItemHeight;
-        }
-        else if (!bIncludeAtTops) {
-            //已经完成
-            break;
-        }
+    //非置顶元素：统计itemIndex之前的元素；置顶元素：需要时全部统计在内
+    int64_t totalItemHeight = pDataProvider->GetRowHeightIndex(nDefaultItemHeight).GetOffset(itemIndex);
+    if (bIncludeAtTops) {
+        totalItemHeight += pDataProvider->GetAtTopRowHeightIndex(nDefaultItemHeight).GetTotalHeight();
     }
     return totalItemHeight;
 }
@@ -557,6 +463,34 @@ void ListCtrlReportView::MoveTopItemsToLast(std::vector<Control*>& items, std::v
     ASSERT(items.size() == m_items.size());
 }
 
+bool ListCtrlReportView::CalcScrollBlitRect(int64_t dx, int64_t dy, UiRect& rcScroll)
+{
+    if ((m_pListCtrl == nullptr) || (m_pData == nullptr)) {
+        return false;
+    }
+    if (!BaseClass::CalcScrollBlitRect(dx, dy, rcScroll)) {
+        return false;
+    }
+    //Header与置顶元素固定在顶部，不随内容平移
+    const int32_t nDefaultItemHeight = m_pListCtrl->GetDataItemHeight();
+    int64_t nTopItemHeights = m_pListCtrl->GetHeaderHeight();
+    nTopItemHeights += m_pData->GetAtTopRowHeightIndex(nDefaultItemHeight).GetTotalHeight();
+    if (nTopItemHeights <= 0) {
+        return true;
+    }
+    if (dx != 0) {
+        //横向滚动时，Header与置顶元素也需要重绘
+        return false;
+    }
+    const UiPoint scrollOffset = GetScrollOffsetInScrollBox();
+    const int64_t nTop = (int64_t)GetPosWithoutPadding().top - scrollOffset.y + nTopItemHeights;
+    if (nTop >= rcScroll.bottom) {
+        return false;
+    }
+    rcScroll.top = std::max(rcScroll.top, (int32_t)nTop);
+    return !rcScroll.IsEmpty();
+}
+
 void ListCtrlReportView::PaintChild(IRender* pRender, const UiRect& rcPaint)
 {
     //重写VirtualListBox::PaintChild / ScrollBox::PaintChild函数，确保Header正常绘制
@@ -1064,6 +998,11 @@ int32_t ListCtrlReportView::GetMaxDataItemWidth(const std::vector<ListCtrlSubIte
         if (pStorage->text.empty()) {
             continue;
         }
+        if (pStorage->nCachedWidth >= 0) {
+            //已经计算过宽度，使用缓存的值
+            nMaxWidth = std::max(nMaxWidth, pStorage->nCachedWidth);
+            continue;
+        }
 
         subItem.SetText(pStorage->text.c_str());
         if (pStorage->nTextFormat != 0) {
@@ -1079,6 +1018,7 @@ int32_t ListCtrlReportView::GetMaxDataItemWidth(const std::vector<ListCtrlSubIte
         subItem.SetFixedHeight(UiFixedInt::MakeAuto(), false, false);
         subItem.SetReEstimateSize(true);
         UiEstSize sz = subItem.EstimateSize(UiSize(0, 0));
+        pStorage->nCachedWidth = std::max(sz.cx.GetInt32(), 0);
         nMaxWidth = std::max(nMaxWidth, sz.cx.GetInt32());
     }
 
@@ -1242,25 +1182,7 @@ bool ListCtrlReportView::OnFrameSelection(int64_t left, int64_t /*right*/, int64
 
     const int32_t nDefaultItemHeight = m_pListCtrl->GetDataItemHeight(); //默认行高
     int32_t nTopItemHeights = m_pListCtrl->GetHeaderHeight(); //Header与置顶元素所占有的高度
-
-    std::vector<size_t> itemIndexList;
-
-    int64_t totalItemHeight = 0;
-    int32_t nItemHeight = 0;    
-    for (size_t index = 0; index < dataItemCount; ++index) {
-        const ListCtrlItemData& rowData = itemDataList[index];
-        nItemHeight = (rowData.nItemHeight < 0) ? nDefaultItemHeight : rowData.nItemHeight;
-        if (!rowData.bVisible || (nItemHeight == 0)) {
-            //不可见的，跳过
-            continue;
-        }
-
-        if (rowData.nAlwaysAtTop >= 0) {
-            //置顶的元素
-            nTopItemHeights += nItemHeight;
-            continue;
-        }
-    }
+    nTopItemHeights += (int32_t)pDataProvider->GetAtTopRowHeightIndex(nDefaultItemHeight).GetTotalHeight();
 
     top -= nTopItemHeights;
     bottom -= nTopItemHeights;
@@ -1270,27 +1192,23 @@ bool ListCtrlReportView::OnFrameSelection(int64_t left, int64_t /*right*/, int64
     if (bottom < 0) {
         bottom = 0;
     }
-    for (size_t index = 0; index < dataItemCount; ++index) {
-        const ListCtrlItemData& rowData = itemDataList[index];
-        nItemHeight = (rowData.nItemHeight < 0) ? nDefaultItemHeight : rowData.nItemHeight;
-        if (!rowData.bVisible || (nItemHeight == 0)) {
-            //不可见的，跳过
-            continue;
-        }
 
-        if (rowData.nAlwaysAtTop >= 0) {
-            //置顶的元素，排除掉
-            continue;
-        }
-        totalItemHeight += nItemHeight;
-        if (totalItemHeight > top) {
-            //开始
-            itemIndexList.push_back(index);
-        }
+    //框选范围内的元素（置顶的元素，排除掉）
+    std::vector<size_t> itemIndexList;
+    const VirtualHeightIndex& rowHeightIndex = pDataProvider->GetRowHeightIndex(nDefaultItemHeight);
+    size_t index = rowHeightIndex.FindIndex(top);
+    int64_t totalItemHeight = 0;
+    if (index != VirtualHeightIndex::InvalidIndex) {
+        totalItemHeight = rowHeightIndex.GetOffset(index);
+    }
+    while (index != VirtualHeightIndex::InvalidIndex) {
+        itemIndexList.push_back(index);
+        totalItemHeight += rowHeightIndex.GetHeight(index);
         if (totalItemHeight > bottom) {
             //结束
             break;
         }
+        index = rowHeightIndex.GetNextVisibleIndex(index + 1);
     }
 
     //选择框选的数据
@@ -1789,6 +1707,9 @@ void ListCtrlReportLayout::LazyArrangeChildNormal(UiRect rc) const
     VirtualListBox::RefreshDataList refreshDataList;
     VirtualListBox::RefreshData refreshData;
 
+    //控件复用：已经显示可见元素的控件保持不变，只有新显示的元素需要填充数据（表头控件不参与）
+    pDataView->RecycleItems(1, nTopElementIndex);
+
     size_t iCount = 0;
     //第一个元素是表头控件，跳过填充数据，所以从1开始
     for (size_t index = 1; index < nItemCount; ++index) {
@@ -1805,16 +1726,23 @@ void ListCtrlReportLayout::LazyArrangeChildNormal(UiRect rc) const
 
         // 填充数据        
         if (nElementIndex < pDataView->GetElementCount()) {
+            const bool bFillElement = pDataView->IsFillElementNeeded(pControl, nElementIndex);
             if (!pControl->IsVisible()) {
                 pControl->SetVisible(true);
             }
-            pDataView->FillElement(pControl, nElementIndex);
             diplayItemIndexList.push_back(nElementIndex);
+            if (bFillElement) {
+                pDataView->FillElement(pControl, nElementIndex);
 
-            refreshData.nItemIndex = index;
-            refreshData.pControl = pControl;
-            refreshData.nElementIndex = nElementIndex;
-            refreshDataList.push_back(refreshData);
+                refreshData.nItemIndex = index;
+                refreshData.pControl = pControl;
+                refreshData.nElementIndex = nElementIndex;
+                refreshDataList.push_back(refreshData);
+            }
+            else {
+                //控件已经显示该数据元素，只需同步选择状态
+                pDataView->UpdateElementSelected(pControl, nElementIndex);
+            }
         }
         else {
             if (pControl->IsVisible()) {
@@ -166,6 +166,10 @@ protected:
     */
     virtual void PaintChild(IRender* pRender, const UiRect& rcPaint) override;
 
+    /** 计算滚动时可以复用已绘制内容的区域（不含Header和置顶的元素）
+    */
+    virtual bool CalcScrollBlitRect(int64_t dx, int64_t dy, UiRect& rcScroll) override;
+
     /** 查找子控件
     */
     virtual Control* FindControl(FINDCONTROLPROC Proc, void* pProcData, uint32_t uFlags,
@@ -261,6 +265,21 @@ private:
     */
     void MoveTopItemsToLast(std::vector<Control*>& items, std::vector<Control*>& atTopItems) const;
 
+    /** 置顶的元素
+    */
+    struct AlwaysAtTopData
+    {
+        int8_t nAlwaysAtTop;    //置顶优先级
+        size_t nItemIndex;      //元素索引
+        int32_t nItemHeight;    //元素的高度
+    };
+
+    /** 获取置顶的可见元素，按置顶优先级排序（优先级相同的，按元素顺序）
+    * @param [in] maxCount 最多取多少条记录（按元素顺序截取后再排序）
+    * @param [out] alwaysAtTopItemList 返回置顶的元素
+    */
+    void GetAlwaysAtTopItems(size_t maxCount, std::vector<AlwaysAtTopData>& alwaysAtTopItemList) const;
+
 private:
     /** ListCtrl 控件接口
     */
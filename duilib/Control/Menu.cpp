@@ -1004,6 +1004,12 @@ bool MenuItem::MouseEnter(const ui::EventArgs& msg)
     return ret;
 }
 
+bool MenuItem::IsPaintOccludedByItems(const ui::UiRect& /*rcPaint*/)
+{
+    //下级菜单项不在当前菜单项中绘制，不能用于遮挡剔除
+    return false;
+}
+
 void MenuItem::PaintChild(ui::IRender* pRender, const ui::UiRect& rcPaint)
 {
     UiRect rcTemp;
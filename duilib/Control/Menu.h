@@ -281,6 +281,7 @@ private:
     virtual bool ButtonUp(const ui::EventArgs& msg) override;
     virtual bool MouseEnter(const ui::EventArgs& msg) override;
     virtual void PaintChild(ui::IRender* pRender, const ui::UiRect& rcPaint) override;
+    virtual bool IsPaintOccludedByItems(const ui::UiRect& rcPaint) override;
 
 private:
     friend Menu; //需要访问部分私有成员函数
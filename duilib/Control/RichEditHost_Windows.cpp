@@ -372,20 +372,14 @@ void RichEditHost::TxInvalidateRect(LPCRECT prc, BOOL /*fMode*/)
     if (m_pRichEdit == nullptr) {
         return;
     }
-    Window* pWindow = m_pRichEdit->GetWindow();
-    if (pWindow == nullptr) {
-        return;
-    }
-
-    UiPoint scrollOffset = m_pRichEdit->GetScrollOffsetInScrollBox();
     UiRect rc = (prc == nullptr) ? m_rcClient : MakeUiRect(*prc);
-    rc.Offset(-scrollOffset.x, -scrollOffset.y);
 
-    //标记窗口指定区域为脏区域，进行重绘(取控件位置部分，避免引发其他控件的重绘)
-    UiRect rcRichEdit = m_pRichEdit->GetRect();
-    rcRichEdit.Offset(-scrollOffset.x, -scrollOffset.y);
-    rc.Intersect(rcRichEdit);
-    pWindow->Invalidate(rc);
+    //标记控件指定区域为脏区域，进行重绘(取控件位置部分，避免引发其他控件的重绘)
+    //通过控件重绘，如果控件自身或者父控件作为图层绘制，同时标记图层中需要重绘的区域
+    rc.Intersect(m_pRichEdit->GetRect());
+    if (!rc.IsEmpty()) {
+        m_pRichEdit->InvalidateRect(rc);
+    }
 }
 
 void RichEditHost::TxViewChange(BOOL /*fUpdate*/)
@@ -95,6 +95,9 @@ RichEdit::RichEdit(Window* pWindow) :
     m_nFocusBottomBorderSize(0)
 {
     m_pTextData = new RichEditData(this);
+
+    //光标和选择区域不随内容平移，滚动时不复用已经绘制的内容
+    SetScrollBlitEnabled(false);
 }
 
 RichEdit::~RichEdit()
@@ -2269,6 +2272,9 @@ void RichEdit::SetPromptTextId(const DString& strTextId)
 {
     if (m_sPromptTextId != strTextId) {
         m_sPromptTextId = strTextId;
+        if (!strTextId.empty()) {
+            RegisterLangControl();
+        }
         Invalidate();
     }
 }
@@ -185,6 +185,9 @@ RichEdit::RichEdit(Window* pWindow) :
     //这个标记必须为false，否则绘制有问题
     SetUseCache(false);
 
+    //文本由RichEdit自行绘制，滚动时不复用已经绘制的内容
+    SetScrollBlitEnabled(false);
+
     //创建RichEditHost接口
     m_pRichHost = new RichEditHost(this);
     ASSERT(m_pRichHost->GetTextServices() != nullptr);
@@ -2665,8 +2668,11 @@ void RichEdit::SetUTF8PromptText(const std::string& strText)
 
 void RichEdit::SetPromptTextId(const DString& strTextId)
 {
-    if (m_sPromptTextId == strTextId) {
+    if (m_sPromptTextId != strTextId) {
         m_sPromptTextId = strTextId;
+        if (!strTextId.empty()) {
+            RegisterLangControl();
+        }
         Invalidate();
     }
 }
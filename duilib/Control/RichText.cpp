@@ -10,6 +10,12 @@
 
 namespace ui 
 {
+/** 是否为换行符（由"<br/>"节点生成）
+*/
+static inline bool IsLineBreak(const RichTextData& textData)
+{
+    return (textData.m_textView.size() == 1) && (textData.m_textView[0] == L'\n');
+}
 
 RichText::RichText(Window* pWindow) :
     Control(pWindow),
@@ -135,6 +141,15 @@ void RichText::ChangeDpiScale(uint32_t nOldDpiScale, uint32_t nNewDpiScale)
     BaseClass::ChangeDpiScale(nOldDpiScale, nNewDpiScale);
 }
 
+void RichText::OnLanguageChanged()
+{
+    if (!m_richTextId.empty()) {
+        //清除语言文件名，下次绘制或者估算大小时按文本ID重新解析
+        m_langFileName.clear();
+        RelayoutOrRedraw();
+    }
+}
+
 void RichText::Redraw()
 {
     //重新绘制
@@ -186,21 +201,16 @@ void RichText::CalcDestRect(IRender* pRender, const UiRect& rc, UiRect& rect)
     }
     rect.Clear();
     if (!m_textData.empty()) {
-        std::vector<RichTextData> richTextData;
-        richTextData.reserve(m_textData.size());
-        const uint16_t nTextStyle = GetTextStyle();
-        for (const RichTextData& textData : m_textData) {
-            richTextData.push_back(textData);
-            //计算时需要带上绘制文字的属性信息
-            richTextData[richTextData.size() - 1].m_textStyle = nTextStyle;
-        }
-        IRenderFactory* pRenderFactory = GlobalManager::Instance().GetRenderFactory();
-        std::vector<std::vector<UiRect>> richTextRects;
-        pRender->MeasureRichText(rc, UiSize(), pRenderFactory, richTextData, &richTextRects);
-        ASSERT(richTextRects.size() == m_textData.size());
-        if (richTextRects.size() == m_textData.size()) {
+        UpdateLayoutCache(pRender, rc.Width());
+        const std::vector<std::vector<UiRect>>& cachedRects = m_layoutCache.m_textRects;
+        if (cachedRects.size() == m_textData.size()) {
             for (size_t index = 0; index < m_textData.size(); ++index) {
-                m_textData[index].m_textRects.swap(richTextRects[index]);
+                //缓存中的区域是相对于文本区域左上角的坐标
+                std::vector<UiRect>& textRects = m_textData[index].m_textRects;
+                textRects = cachedRects[index];
+                for (UiRect& textRect : textRects) {
+                    textRect.Offset(rc.left, rc.top);
+                }
             }
         }
     }
@@ -211,6 +221,86 @@ void RichText::CalcDestRect(IRender* pRender, const UiRect& rc, UiRect& rect)
     }
 }
 
+void RichText::UpdateLayoutCache(IRender* pRender, int32_t nWidth)
+{
+    TextLayoutCache& cache = m_layoutCache;
+    const uint16_t nTextStyle = GetTextStyle();
+    const uint32_t nDpi = Dpi().GetDPI();
+    if ((cache.m_nWidth != nWidth) || (cache.m_nDpi != nDpi) || (cache.m_textStyle != nTextStyle) ||
+        (cache.m_textRects.size() > m_textData.size())) {
+        cache.m_nWidth = nWidth;
+        cache.m_nDpi = nDpi;
+        cache.m_textStyle = nTextStyle;
+        cache.m_textRects.clear();
+    }
+    const size_t nCachedCount = cache.m_textRects.size();
+    const size_t nCount = m_textData.size();
+    if (nCachedCount == nCount) {
+        return;
+    }
+
+    //计算的起始位置：已计算部分中最后一个换行符之后的元素（换行后的布局与之前的文本无关，只需要纵向平移），
+    //换行符本身保留缓存的绘制区域（如果从换行符开始计算，换行符会被当作行首元素，位置与缓存不一致），
+    //换行符后第一个有绘制区域的元素作为锚点，用于确定纵向的偏移
+    size_t nStartIndex = 0;
+    size_t nAnchorIndex = 0;
+    bool bHasAnchor = false;
+    size_t nNextBreakIndex = nCachedCount;
+    for (size_t index = nCachedCount; (index > 0) && !bHasAnchor; --index) {
+        const size_t nBreakIndex = index - 1;
+        if (!IsLineBreak(m_textData[nBreakIndex])) {
+            continue;
+        }
+        for (size_t nIndex = nBreakIndex + 1; nIndex < nNextBreakIndex; ++nIndex) {
+            if (!cache.m_textRects[nIndex].empty()) {
+                nStartIndex = nBreakIndex + 1;
+                nAnchorIndex = nIndex;
+                bHasAnchor = true;
+                break;
+            }
+        }
+        nNextBreakIndex = nBreakIndex;
+    }
+
+    std::vector<RichTextData> richTextData;
+    richTextData.reserve(nCount - nStartIndex);
+    for (size_t index = nStartIndex; index < nCount; ++index) {
+        richTextData.push_back(m_textData[index]);
+        //计算时需要带上绘制文字的属性信息
+        richTextData[richTextData.size() - 1].m_textStyle = nTextStyle;
+    }
+    IRenderFactory* pRenderFactory = GlobalManager::Instance().GetRenderFactory();
+    std::vector<std::vector<UiRect>> richTextRects;
+    const UiRect rcMeasure(0, 0, nWidth, INT32_MAX);
+    pRender->MeasureRichText(rcMeasure, UiSize(), pRenderFactory, richTextData, &richTextRects);
+    ASSERT(richTextRects.size() == richTextData.size());
+    if (richTextRects.size() != richTextData.size()) {
+        cache.m_textRects.clear();
+        return;
+    }
+    int32_t nOffsetY = 0;
+    if (bHasAnchor) {
+        const std::vector<UiRect>& anchorRects = richTextRects[nAnchorIndex - nStartIndex];
+        if (anchorRects.empty()) {
+            //与缓存的结果不一致，全部重新计算
+            cache.m_textRects.clear();
+            UpdateLayoutCache(pRender, nWidth);
+            return;
+        }
+        nOffsetY = cache.m_textRects[nAnchorIndex].front().top - anchorRects.front().top;
+    }
+    cache.m_textRects.resize(nCount);
+    for (size_t index = nStartIndex; index < nCount; ++index) {
+        std::vector<UiRect>& textRects = cache.m_textRects[index];
+        textRects.swap(richTextRects[index - nStartIndex]);
+        if (nOffsetY != 0) {
+            for (UiRect& textRect : textRects) {
+                textRect.Offset(0, nOffsetY);
+            }
+        }
+    }
+}
+
 UiSize RichText::EstimateText(UiSize szAvailable)
 {
     UiSize fixedSize;
@@ -436,13 +526,35 @@ void RichText::CheckParseText()
     }
 
     if (m_textData.empty()) {
-        ParseText(m_textData);
+        ParseText(m_textData, m_textSliceDataIndex);
         m_nTextDataDPI = Dpi().GetDPI();
         m_spDrawRichTextCache.reset();
+        m_layoutCache.m_textRects.clear();
     }
 }
 
-bool RichText::ParseText(std::vector<RichTextDataEx>& outTextData) const
+bool RichText::ParseText(std::vector<RichTextDataEx>& outTextData, std::vector<size_t>& outSliceDataIndex) const
+{
+    RichTextDataEx parentTextData;
+    if (!GetDefaultTextData(parentTextData)) {
+        return false;
+    }
+
+    std::vector<RichTextDataEx> textData;
+    std::vector<size_t> sliceDataIndex;
+    sliceDataIndex.reserve(m_textSlice.size());
+    for (const RichTextSlice& textSlice : m_textSlice) {
+        sliceDataIndex.push_back(textData.size());
+        if (!ParseTextSlice(textSlice, parentTextData, textData)) {
+            return false;
+        }
+    }
+    outTextData.swap(textData);
+    outSliceDataIndex.swap(sliceDataIndex);
+    return true;
+}
+
+bool RichText::GetDefaultTextData(RichTextDataEx& parentTextData) const
 {
     //默认字体
     DString sFontId = GetFontId();
@@ -452,7 +564,6 @@ bool RichText::ParseText(std::vector<RichTextDataEx>& outTextData) const
         return false;
     }
 
-    RichTextDataEx parentTextData;
     //默认文本颜色
     parentTextData.m_textColor = GetUiColor(GetTextColor());
     if (parentTextData.m_textColor.IsEmpty()) {
@@ -467,15 +578,6 @@ bool RichText::ParseText(std::vector<RichTextDataEx>& outTextData) const
     parentTextData.m_pFontInfo->m_bStrikeOut = pFont->IsStrikeOut();
     parentTextData.m_fRowSpacingMul = m_fRowSpacingMul;
     parentTextData.m_textStyle = GetTextStyle();
-
-    std::vector<RichTextDataEx> textData;
-
-    for (const RichTextSlice& textSlice : m_textSlice) {
-        if (!ParseTextSlice(textSlice, parentTextData, textData)) {
-            return false;
-        }
-    }
-    outTextData.swap(textData);
     return true;
 }
 
@@ -627,6 +729,11 @@ DString RichText::TrimText(const DString::value_type* text)
 bool RichText::DoSetText(const DString& richText)
 {
     Clear();
+    return ParseRichText(richText);
+}
+
+bool RichText::ParseRichText(const DString& richText)
+{
     //XML解析的内容，全部封装在WindowBuilder这个类中，以避免到处使用XML解析器，从而降低代码维护复杂度
     bool bResult = true;
     if (!richText.empty()) {
@@ -656,6 +763,7 @@ bool RichText::SetTextId(const DString& richTextId)
     m_richTextId = richTextId;
     if (!m_richTextId.empty()) {
         m_langFileName = GlobalManager::Instance().GetLanguageFileName();
+        RegisterLangControl();
     }
     else {
         m_langFileName.clear();
@@ -663,9 +771,58 @@ bool RichText::SetTextId(const DString& richTextId)
     return bRet;
 }
 
+bool RichText::AppendText(const DString& richText)
+{
+    //新的文本片段在AppendTextSlice中逐个解析，已有的文本片段不需要重新解析
+    bool bResult = ParseRichText(richText);
+    if (bResult) {
+        RelayoutOrRedraw();
+    }
+    return bResult;
+}
+
+bool RichText::ReplaceText(size_t nSliceIndex, const DString& richText)
+{
+    ASSERT(nSliceIndex <= m_textSlice.size());
+    if (nSliceIndex > m_textSlice.size()) {
+        return false;
+    }
+    TruncateTextSlice(nSliceIndex);
+    return AppendText(richText);
+}
+
+size_t RichText::GetTextSliceCount() const
+{
+    return m_textSlice.size();
+}
+
+void RichText::TruncateTextSlice(size_t nSliceIndex)
+{
+    if (nSliceIndex >= m_textSlice.size()) {
+        return;
+    }
+    if (!m_textData.empty() && (m_textSliceDataIndex.size() == m_textSlice.size())) {
+        //删除对应的解析数据和布局缓存，之前的数据保持不变
+        const size_t nDataIndex = m_textSliceDataIndex[nSliceIndex];
+        m_textData.erase(m_textData.begin() + nDataIndex, m_textData.end());
+        m_textSliceDataIndex.resize(nSliceIndex);
+        if (m_layoutCache.m_textRects.size() > nDataIndex) {
+            m_layoutCache.m_textRects.resize(nDataIndex);
+        }
+    }
+    else {
+        m_textData.clear();
+    }
+    m_textSlice.erase(m_textSlice.begin() + nSliceIndex, m_textSlice.end());
+    m_spDrawRichTextCache.reset();
+    Invalidate();
+}
+
 void RichText::Clear()
 {
     m_textData.clear();
+    m_textSliceDataIndex.clear();
+    m_layoutCache.m_textRects.clear();
     m_spDrawRichTextCache.reset();
     if (!m_textSlice.empty()) {
         m_textSlice.clear();
@@ -757,16 +914,27 @@ VerAlignType RichText::GetVAlignType() const
 
 void RichText::AppendTextSlice(const RichTextSlice&& textSlice)
 {
-    m_textSlice.emplace_back(textSlice);
-    m_textData.clear();
-    m_spDrawRichTextCache.reset();
+    AppendTextSlice(textSlice);
 }
 
 void RichText::AppendTextSlice(const RichTextSlice& textSlice)
 {
+    //如果已有的解析数据有效，只解析新的文本片段（m_textSlice为deque，已有数据引用的字符串地址不变）
+    const bool bTextDataValid = !m_textData.empty() &&
+                                (m_textSliceDataIndex.size() == m_textSlice.size()) &&
+                                (m_nTextDataDPI == Dpi().GetDPI());
     m_textSlice.emplace_back(textSlice);
-    m_textData.clear();
     m_spDrawRichTextCache.reset();
+    RichTextDataEx parentTextData;
+    if (bTextDataValid && GetDefaultTextData(parentTextData)) {
+        m_textSliceDataIndex.push_back(m_textData.size());
+        if (!ParseTextSlice(m_textSlice.back(), parentTextData, m_textData)) {
+            m_textData.clear();
+        }
+    }
+    else {
+        m_textData.clear();
+    }
 }
 
 DString RichText::ToString() const
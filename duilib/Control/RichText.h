@@ -3,6 +3,7 @@
 
 #include "duilib/Core/Control.h"
 #include "duilib/Render/IRender.h"
+#include <deque>
 
 namespace ui 
 {
@@ -86,6 +87,10 @@ public:
     */
     virtual void ChangeDpiScale(uint32_t nOldDpiScale, uint32_t nNewDpiScale) override;
 
+    /** 语言发生变化，按文本ID重新解析文本并更新布局
+    */
+    virtual void OnLanguageChanged() override;
+
     /** 计算文本区域大小（宽和高）
      *  @param [in] szAvailable 可用大小，不包含内边距，不包含外边距
      *  @return 控件的文本估算大小，包含内边距(Box)，不包含外边距
@@ -166,6 +171,23 @@ public:
     */
     bool SetTextId(const DString& richTextId);
 
+    /** 追加格式的文本：只解析和计算新追加的部分，已有的文本不需要重新解析和计算（适用于流式显示的聊天消息等场景）
+    *   注意：增量计算只适用于文本的解析和布局估算（EstimateText、CalcDestRect），
+    *         绘制缓存（DrawRichTextCache）仍需要在下次绘制时按完整的文本重新生成
+    * @param [in] richText 追加的带有格式的文本内容（作为独立的格式文本解析，不能与已有文本中的节点嵌套）
+    */
+    bool AppendText(const DString& richText);
+
+    /** 替换从指定文本片段开始的所有文本，该文本片段之前的文本保持不变，不需要重新解析和计算
+    * @param [in] nSliceIndex 起始的文本片段下标，取值范围：[0, GetTextSliceCount()]
+    * @param [in] richText 新的带有格式的文本内容
+    */
+    bool ReplaceText(size_t nSliceIndex, const DString& richText);
+
+    /** 获取文本片段的个数（顶层节点的个数）
+    */
+    size_t GetTextSliceCount() const;
+
     /** 清空原来的格式文本
     */
     void Clear();
@@ -206,9 +228,24 @@ private:
     */
     bool DoSetText(const DString& richText);
 
+    /** 解析格式的文本，并追加到文本片段中
+    * @param [in] richText 带有格式的文本内容
+    */
+    bool ParseRichText(const DString& richText);
+
+    /** 删除从指定下标开始的所有文本片段
+    */
+    void TruncateTextSlice(size_t nSliceIndex);
+
     /** 解析格式化文本, 生成解析后的数据结构
+    * @param [out] outTextData 返回解析后的数据
+    * @param [out] outSliceDataIndex 返回每个文本片段在outTextData中的起始下标
+    */
+    bool ParseText(std::vector<RichTextDataEx>& outTextData, std::vector<size_t>& outSliceDataIndex) const;
+
+    /** 获取默认的文本属性（默认字体、文本颜色等），作为顶层文本片段的父对象信息
     */
-    bool ParseText(std::vector<RichTextDataEx>& outTextData) const;
+    bool GetDefaultTextData(RichTextDataEx& textData) const;
 
     /** 检查按需解析文本
     */
@@ -239,6 +276,11 @@ private:
     */
     void CalcDestRect(IRender* pRender, const UiRect& rc, UiRect& rect);
 
+    /** 更新文本布局缓存，只计算缓存中没有的部分
+    * @param [in] nWidth 文本区域的宽度
+    */
+    void UpdateLayoutCache(IRender* pRender, int32_t nWidth);
+
 private:
     //鼠标消息（返回true：表示消息已处理；返回false：则表示消息未处理，需转发给父控件）
     virtual bool ButtonDown(const EventArgs& msg) override;
@@ -273,14 +315,30 @@ private:
     */
     float m_fRowSpacingMul;
 
-    /** 绘制的文本内容（解析前）
+    /** 绘制的文本内容（解析前），解析后的数据引用其中的字符串，追加时已有元素的地址不能变化
     */
-    std::vector<RichTextSlice> m_textSlice;
+    std::deque<RichTextSlice> m_textSlice;
 
     /** 绘制的文本内容（解析后）
     */
     std::vector<RichTextDataEx> m_textData;
 
+    /** 每个文本片段在m_textData中的起始下标（与m_textSlice一一对应）
+    */
+    std::vector<size_t> m_textSliceDataIndex;
+
+    /** 文本布局缓存：m_textData中每个元素的绘制区域（相对于文本区域的左上角）
+    *   在文本区域的宽度、DPI和文本属性不变时复用，追加文本时只计算新增的部分
+    */
+    struct TextLayoutCache
+    {
+        int32_t m_nWidth = -1;      //文本区域的宽度
+        uint32_t m_nDpi = 0;        //DPI
+        uint16_t m_textStyle = 0;   //文本属性
+        std::vector<std::vector<UiRect>> m_textRects; //已经计算的绘制区域，对应m_textData的前N个元素
+    };
+    TextLayoutCache m_layoutCache;
+
     /** 解析文本对应的DPI值
     */
     uint32_t m_nTextDataDPI;
@@ -226,6 +226,16 @@ void Slider::PaintBkColor(IRender* pRender)
     SetRect(rc);
 }
 
+bool Slider::GetOpaqueRect(UiRect& rcOpaque) const
+{
+    //背景颜色只填充进度条区域
+    if (!BaseClass::GetOpaqueRect(rcOpaque)) {
+        return false;
+    }
+    rcOpaque.Deflate(m_rcProgressBarPadding);
+    return !rcOpaque.IsEmpty();
+}
+
 void Slider::PaintStateImages(IRender* pRender)
 {
     UiRect rc = GetRect();
@@ -22,6 +22,7 @@ public:
     virtual void SetAttribute(const DString& strName, const DString& strValue) override;
     virtual void PaintStateImages(IRender* pRender) override;
     virtual void PaintBkColor(IRender* pRender) override;
+    virtual bool GetOpaqueRect(UiRect& rcOpaque) const override;
     virtual void ClearImageCache() override;
 
     /** DPI发生变化，更新控件大小和布局
@@ -1,5 +1,6 @@
 #include "TreeView.h"
 #include "duilib/Core/ScrollBar.h"
+#include <unordered_set>
 
 namespace ui
 {
@@ -408,6 +409,121 @@ bool TreeNode::AddChildNodeAt(TreeNode* pTreeNode, const size_t iIndex)
         return false;
     }
 
+    InitChildNode(pTreeNode);
+
+    //添加到ListBox容器中
+    size_t nInsertIndex = GetChildNodeInsertIndex();
+    ASSERT(nInsertIndex <= m_pTreeView->ListBox::GetItemCount());
+    m_aTreeNodes.insert(m_aTreeNodes.begin() + iIndex, pTreeNode);
+    bool bAdded = m_pTreeView->ListBox::AddItemAt(pTreeNode, nInsertIndex);
+    if (bAdded) {
+        if (SupportCheckedMode()) {
+            //新添加的节点状态，跟随父节点
+            pTreeNode->SetChecked(IsChecked());
+            //更新节点的勾选状态
+            UpdateSelfCheckStatus();
+            UpdateParentCheckStatus(false);
+        }
+    }
+    else {
+        //添加失败的话，移除
+        auto iter = std::find(m_aTreeNodes.begin(), m_aTreeNodes.end(), pTreeNode);
+        if (iter != m_aTreeNodes.end()) {
+            m_aTreeNodes.erase(iter);
+        }
+    }
+    return bAdded;
+}
+
+bool TreeNode::AddChildNodes(const std::vector<TreeNode*>& treeNodes)
+{
+    return AddChildNodesAt(treeNodes, GetChildNodeCount());
+}
+
+bool TreeNode::AddChildNodesAt(const std::vector<TreeNode*>& treeNodes, const size_t iIndex)
+{
+    ASSERT(m_pTreeView != nullptr);
+    if (m_pTreeView == nullptr) {
+        return false;
+    }
+    ASSERT(iIndex <= m_aTreeNodes.size());
+    if (iIndex > m_aTreeNodes.size()) {
+        return false;
+    }
+    ASSERT(m_uDepth < UINT16_MAX);//最大为65535个层级
+    if (m_uDepth >= UINT16_MAX) {
+        return false;
+    }
+    //过滤无效的节点和重复的节点
+    bool bRet = true;
+    std::unordered_set<TreeNode*> nodeSet(m_aTreeNodes.begin(), m_aTreeNodes.end());
+    std::vector<TreeNode*> newNodes;
+    std::vector<Control*> newControls;
+    newNodes.reserve(treeNodes.size());
+    newControls.reserve(treeNodes.size());
+    for (TreeNode* pTreeNode : treeNodes) {
+        ASSERT(pTreeNode != nullptr);
+        if ((pTreeNode == nullptr) || !nodeSet.insert(pTreeNode).second) {
+            bRet = false;
+            continue;
+        }
+        InitChildNode(pTreeNode);
+        newNodes.push_back(pTreeNode);
+        newControls.push_back(pTreeNode);
+    }
+    if (newNodes.empty()) {
+        return bRet;
+    }
+
+    //添加到ListBox容器中：插入位置只需计算一次，子项的索引号在全部插入后统一更新
+    AutoBoxUpdate autoUpdate(m_pTreeView);
+    size_t nInsertIndex = GetChildNodeInsertIndex();
+    ASSERT(nInsertIndex <= m_pTreeView->ListBox::GetItemCount());
+    m_aTreeNodes.insert(m_aTreeNodes.begin() + iIndex, newNodes.begin(), newNodes.end());
+    if (!m_pTreeView->ListBox::AddItemsAt(newControls, nInsertIndex)) {
+        //添加失败的节点，移除
+        bRet = false;
+        for (TreeNode* pTreeNode : newNodes) {
+            if (pTreeNode->GetListBoxIndex() == Box::InvalidIndex) {
+                auto iter = std::find(m_aTreeNodes.begin(), m_aTreeNodes.end(), pTreeNode);
+                if (iter != m_aTreeNodes.end()) {
+                    m_aTreeNodes.erase(iter);
+                }
+            }
+        }
+    }
+    if (SupportCheckedMode()) {
+        //新添加的节点状态，跟随父节点
+        const bool bChecked = IsChecked();
+        for (TreeNode* pTreeNode : newNodes) {
+            if (pTreeNode->GetParentNode() == this) {
+                pTreeNode->SetChecked(bChecked);
+            }
+        }
+        //更新节点的勾选状态
+        UpdateSelfCheckStatus();
+        UpdateParentCheckStatus(false);
+    }
+    return bRet;
+}
+
+size_t TreeNode::GetChildNodeInsertIndex() const
+{
+    size_t nInsertIndex = GetDescendantNodeMaxListBoxIndex();
+    if (!Box::IsValidItemIndex(nInsertIndex)) {
+        //第一个节点
+        nInsertIndex = 0;
+    }
+    else {
+        //不是第一个节点时，插入位置需要放在所有子孙节点的后面
+        nInsertIndex += 1;
+    }
+    return nInsertIndex;
+}
+
+void TreeNode::InitChildNode(TreeNode* pTreeNode)
+{
+    ASSERT((pTreeNode != nullptr) && (m_pTreeView != nullptr));
     pTreeNode->m_uDepth = m_uDepth + 1;
     pTreeNode->SetParentNode(this);
     pTreeNode->SetTreeView(m_pTreeView);
@@ -441,37 +557,6 @@ bool TreeNode::AddChildNodeAt(TreeNode* pTreeNode, const size_t iIndex)
 
     //是否显示图标
     pTreeNode->SetEnableIcon(m_pTreeView->IsEnableIcon());
-
-    //添加到ListBox容器中
-    size_t nInsertIndex = GetDescendantNodeMaxListBoxIndex();
-    if (!Box::IsValidItemIndex(nInsertIndex)) {
-        //第一个节点
-        nInsertIndex = 0;
-    }
-    else {
-        //不是第一个节点时，插入位置需要放在所有子孙节点的后面
-        nInsertIndex += 1;
-    }
-    ASSERT(nInsertIndex <= m_pTreeView->ListBox::GetItemCount());
-    m_aTreeNodes.insert(m_aTreeNodes.begin() + iIndex, pTreeNode);
-    bool bAdded = m_pTreeView->ListBox::AddItemAt(pTreeNode, nInsertIndex);
-    if (bAdded) {
-        if (SupportCheckedMode()) {
-            //新添加的节点状态，跟随父节点
-            pTreeNode->SetChecked(IsChecked());
-            //更新节点的勾选状态
-            UpdateSelfCheckStatus();
-            UpdateParentCheckStatus(false);
-        }
-    }
-    else {
-        //添加失败的话，移除
-        auto iter = std::find(m_aTreeNodes.begin(), m_aTreeNodes.end(), pTreeNode);
-        if (iter != m_aTreeNodes.end()) {
-            m_aTreeNodes.erase(iter);
-        }
-    }
-    return bAdded;
 }
 
 #ifdef DUILIB_BUILD_FOR_WIN
@@ -1522,6 +1607,12 @@ bool TreeView::AddItemAt(Control* /*pControl*/, size_t /*iIndex*/)
     return false;
 }
 
+bool TreeView::AddItemsAt(const std::vector<Control*>& /*controls*/, size_t /*iIndex*/)
+{
+    ASSERT(0);
+    return false;
+}
+
 bool TreeView::RemoveItem(Control* /*pControl*/)
 {
     ASSERT(0);
@@ -78,6 +78,19 @@ public:
      */
     bool AddChildNodeAt(TreeNode* pTreeNode, const size_t iIndex);
 
+    /** 在最后面批量添加子节点（插入位置只计算一次，添加完成后统一更新勾选状态和布局）
+     * @param[in] treeNodes 子节点指针列表
+     * @return 全部添加成功返回 true，有节点添加失败返回 false
+     */
+    bool AddChildNodes(const std::vector<TreeNode*>& treeNodes);
+
+    /** 在指定位置批量添加子节点（插入位置只计算一次，添加完成后统一更新勾选状态和布局）
+     * @param[in] treeNodes 子节点指针列表
+     * @param[in] iIndex 第一个子节点的插入位置
+     * @return 全部添加成功返回 true，有节点添加失败返回 false
+     */
+    bool AddChildNodesAt(const std::vector<TreeNode*>& treeNodes, const size_t iIndex);
+
     /** 从指定位置移除一个子节点
      * @param[in] iIndex 要移除的子节点索引
      * @return 成功返回 true，失败返回 false
@@ -252,6 +265,14 @@ private:
      */
     bool RemoveChildNodeAt(size_t iIndex, bool bUpdateCheckStatus);
 
+    /** 初始化新添加的子节点（层级、事件、内边距和样式等）
+    */
+    void InitChildNode(TreeNode* pTreeNode);
+
+    /** 获取新添加的子节点在ListBox中的插入位置（放在所有子孙节点的后面）
+    */
+    size_t GetChildNodeInsertIndex() const;
+
     /** 根据当前的配置，调整展开标志关联的内边距(可重入函数，多次调用无副作用)
     */
     void AdjustExpandImagePadding();
@@ -493,6 +514,7 @@ private:
     //以下函数故意私有化，表明禁止使用；应该使用TreeNode中的相关函数
     bool AddItem(Control* pControl) override;
     bool AddItemAt(Control* pControl, size_t iIndex) override;
+    bool AddItemsAt(const std::vector<Control*>& controls, size_t iIndex) override;
     bool RemoveItem(Control* pControl) override;
     bool RemoveItemAt(size_t iIndex) override;
     void RemoveAllItems() override;
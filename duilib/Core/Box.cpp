@@ -1,9 +1,81 @@
 #include "Box.h"
 #include "duilib/Core/Window.h"
+#include "duilib/Core/BoxSpatialIndex.h"
 #include "duilib/Utils/StringUtil.h"
 
 namespace ui
 {
+/** 遮挡剔除时，最多使用的遮挡区域个数
+*/
+static constexpr size_t kMaxOccluderCount = 32;
+
+/** 判断覆盖时，未覆盖区域最多拆分的矩形个数，超过时按未覆盖处理
+*/
+static constexpr size_t kMaxUncoveredCount = 32;
+
+/** 判断矩形区域是否被一组矩形完全覆盖（逐个减去覆盖矩形，看是否有剩余区域）
+*/
+static bool IsRectCovered(const UiRect& rcTarget, const UiRect* pOccluders, size_t nOccluderCount)
+{
+    if (rcTarget.IsEmpty()) {
+        return true;
+    }
+    UiRect uncovered[2][kMaxUncoveredCount];
+    size_t nCount = 1;
+    uncovered[0][0] = rcTarget;
+    size_t nCurrent = 0;
+    UiRect rcCommon;
+    for (size_t nOccluder = 0; nOccluder < nOccluderCount; ++nOccluder) {
+        const UiRect& rcOccluder = pOccluders[nOccluder];
+        const UiRect* pRects = uncovered[nCurrent];
+        UiRect* pPieces = uncovered[1 - nCurrent];
+        size_t nPieceCount = 0;
+        for (size_t i = 0; i < nCount; ++i) {
+            const UiRect& rc = pRects[i];
+            UiRect pieces[4];
+            size_t nNewCount = 0;
+            if (!UiRect::Intersect(rcCommon, rc, rcOccluder)) {
+                pieces[nNewCount++] = rc;
+            }
+            else {
+                //减去相交部分，剩余部分拆分为上下左右（最多）四个矩形
+                if (rc.top < rcCommon.top) {
+                    pieces[nNewCount++] = UiRect(rc.left, rc.top, rc.right, rcCommon.top);
+                }
+                if (rcCommon.bottom < rc.bottom) {
+                    pieces[nNewCount++] = UiRect(rc.left, rcCommon.bottom, rc.right, rc.bottom);
+                }
+                if (rc.left < rcCommon.left) {
+                    pieces[nNewCount++] = UiRect(rc.left, rcCommon.top, rcCommon.left, rcCommon.bottom);
+                }
+                if (rcCommon.right < rc.right) {
+                    pieces[nNewCount++] = UiRect(rcCommon.right, rcCommon.top, rc.right, rcCommon.bottom);
+                }
+            }
+            if ((nPieceCount + nNewCount) > kMaxUncoveredCount) {
+                return false;
+            }
+            for (size_t j = 0; j < nNewCount; ++j) {
+                pPieces[nPieceCount++] = pieces[j];
+            }
+        }
+        if (nPieceCount == 0) {
+            return true;
+        }
+        nCount = nPieceCount;
+        nCurrent = 1 - nCurrent;
+    }
+    return false;
+}
+
+/** 子控件是否可以参与遮挡剔除（绘制内容不会超出自身的矩形区域）
+*/
+static bool IsOcclusionCullable(const Control* pControl)
+{
+    return pControl->IsClip() && !pControl->HasBoxShadow() &&
+           (pControl->GetRenderOffset().x == 0) && (pControl->GetRenderOffset().y == 0);
+}
+
 Box::Box(Window* pWindow, Layout* pLayout) :
     Control(pWindow),
     m_pLayout(pLayout),
@@ -11,7 +83,10 @@ Box::Box(Window* pWindow, Layout* pLayout) :
     m_bMouseChildEnabled(true),
     m_items(),
     m_nDropInId(0),
-    m_nDragOutId(0)
+    m_nDragOutId(0),
+    m_bPaintOrderDirty(true),
+    m_bArrangePending(false),
+    m_nUpdateCount(0)
 {
     ASSERT(m_pLayout != nullptr);
     if (m_pLayout) {
@@ -53,6 +128,9 @@ void Box::SetAttribute(const DString& strName, const DString& strValue)
         uint8_t nValue = ui::TruncateToUInt8(StringUtil::StringToInt32(strValue));
         SetDropInId(nValue);
     }
+    else if (strName == _T("spatial_index")) {
+        SetEnableSpatialIndex(strValue == _T("true"));
+    }
     else {
         Control::SetAttribute(strName, strValue);
     }
@@ -100,6 +178,10 @@ void Box::SetWindow(Window* pWindow)
 void Box::SetPos(UiRect rc)
 {
     Control::SetPos(rc);
+    if (m_pSpatialIndex != nullptr) {
+        //布局整体变化，在下次查询前重建索引
+        m_pSpatialIndex->SetDirty();
+    }
     if (m_pLayout != nullptr) {
         m_pLayout->ArrangeChild(m_items, rc);    
     }
@@ -121,6 +203,19 @@ UiRect Box::GetRectWithoutPadding() const
     return rc;
 }
 
+void Box::Paint(IRender* pRender, const UiRect& rcPaint)
+{
+    //绘制缓存只保存容器自身的绘制内容，不能省略；box-shadow会超出矩形区域绘制，也不能省略
+    if (!IsUseCache() && !HasBoxShadow() && IsPaintOccludedByItems(rcPaint)) {
+        //容器自身的绘制内容被不透明的子控件完全覆盖，只需要更新绘制区域
+        UiRect rcTemp;
+        UiRect::Intersect(rcTemp, rcPaint, GetRect());
+        SetPaintRect(rcTemp);
+        return;
+    }
+    BaseClass::Paint(pRender, rcPaint);
+}
+
 void Box::PaintChild(IRender* pRender, const UiRect& rcPaint)
 {
     UiRect rcTemp;
@@ -128,39 +223,126 @@ void Box::PaintChild(IRender* pRender, const UiRect& rcPaint)
         return;
     }
 
-    std::vector<Control*> delayItems;
-    for (auto pControl : m_items) {
-        if (pControl == nullptr) {
-            continue;
-        }
-        if (!pControl->IsVisible()) {
-            continue;
+    for (Control* pControl : GetPaintItems(rcTemp)) {
+        pControl->AlphaPaint(pRender, rcPaint);
+    }
+
+    if ((pRender != nullptr) && IsShowFocusRect() && IsFocused()) {
+        DoPaintFocusRect(pRender);    //绘制焦点状态
+    }
+}
+
+const std::vector<Control*>& Box::GetPaintItems(const UiRect& rcPaint)
+{
+    m_paintItems.clear();
+    UiRect rcTemp;
+    const BoxSpatialIndex* pSpatialIndex = GetSpatialIndex();
+    if (pSpatialIndex != nullptr) {
+        //通过空间索引，只访问与绘制区域相交的子控件
+        std::vector<size_t> itemIndexList;
+        pSpatialIndex->QueryRect(rcPaint, itemIndexList);
+        for (size_t nIndex : itemIndexList) {
+            Control* pControl = (nIndex < m_items.size()) ? m_items[nIndex] : nullptr;
+            if ((pControl != nullptr) && (pControl->GetPaintOrder() == 0) && pControl->IsVisible()) {
+                m_paintItems.push_back(pControl);
+            }
         }
-        if (pControl->GetPaintOrder() != 0) {
-            //设置了绘制顺序， 放入延迟绘制列表
-            delayItems.push_back(pControl);
-            continue;
+    }
+    else {
+        for (Control* pControl : m_items) {
+            if ((pControl == nullptr) || (pControl->GetPaintOrder() != 0) || !pControl->IsVisible()) {
+                continue;
+            }
+            if (!UiRect::Intersect(rcTemp, rcPaint, pControl->GetRect())) {
+                //完全在绘制区域以外
+                continue;
+            }
+            m_paintItems.push_back(pControl);
         }
-        pControl->AlphaPaint(pRender, rcPaint);
     }
 
-    if (!delayItems.empty()) {
-        std::sort(delayItems.begin(), delayItems.end(), [](const Control* a, const Control* b) {
+    //设置了绘制顺序的子控件，在最后按绘制顺序绘制
+    if (m_bPaintOrderDirty) {
+        m_bPaintOrderDirty = false;
+        m_paintOrderItems.clear();
+        for (Control* pControl : m_items) {
+            if ((pControl != nullptr) && (pControl->GetPaintOrder() != 0)) {
+                m_paintOrderItems.push_back(pControl);
+            }
+        }
+        std::stable_sort(m_paintOrderItems.begin(), m_paintOrderItems.end(), [](const Control* a, const Control* b) {
             return a->GetPaintOrder() < b->GetPaintOrder();
             });
-        //绘制延迟绘制的控件
-        for (auto pControl : delayItems) {
-            if (pControl != nullptr) {
-                pControl->AlphaPaint(pRender, rcPaint);
-            }            
+    }
+    for (Control* pControl : m_paintOrderItems) {
+        if (pControl->IsVisible() && UiRect::Intersect(rcTemp, rcPaint, pControl->GetRect())) {
+            m_paintItems.push_back(pControl);
         }
     }
+    CullOccludedPaintItems(rcPaint);
+    return m_paintItems;
+}
 
-    if ((pRender != nullptr) && IsShowFocusRect() && IsFocused()) {
-        DoPaintFocusRect(pRender);    //绘制焦点状态
+void Box::CullOccludedPaintItems(const UiRect& rcPaint)
+{
+    if (m_paintItems.size() < 2) {
+        return;
+    }
+    UiRect occluders[kMaxOccluderCount];
+    size_t nOccluderCount = 0;
+    UiRect rcItem;
+    UiRect rcOpaque;
+    bool bCulled = false;
+    //从前往后（绘制顺序的倒序）
+    for (size_t nIndex = m_paintItems.size(); nIndex > 0; --nIndex) {
+        Control* pControl = m_paintItems[nIndex - 1];
+        if ((nOccluderCount > 0) && IsOcclusionCullable(pControl) &&
+            UiRect::Intersect(rcItem, rcPaint, pControl->GetRect()) &&
+            IsRectCovered(rcItem, occluders, nOccluderCount)) {
+            //被前面的不透明子控件完全覆盖
+            m_paintItems[nIndex - 1] = nullptr;
+            bCulled = true;
+            continue;
+        }
+        if ((nOccluderCount < kMaxOccluderCount) && pControl->GetOpaqueRect(rcOpaque) &&
+            rcOpaque.Intersect(rcPaint)) {
+            occluders[nOccluderCount++] = rcOpaque;
+        }
+    }
+    if (bCulled) {
+        m_paintItems.erase(std::remove(m_paintItems.begin(), m_paintItems.end(), nullptr), m_paintItems.end());
     }
 }
 
+bool Box::IsRectOccludedByItems(const UiRect& rcTarget, const UiRect& rcClip) const
+{
+    UiRect occluders[kMaxOccluderCount];
+    size_t nOccluderCount = 0;
+    UiRect rcOpaque;
+    for (const Control* pControl : m_items) {
+        if ((pControl == nullptr) || !pControl->GetOpaqueRect(rcOpaque)) {
+            continue;
+        }
+        if (!rcOpaque.Intersect(rcTarget) || !rcOpaque.Intersect(rcClip)) {
+            continue;
+        }
+        occluders[nOccluderCount++] = rcOpaque;
+        if (nOccluderCount == kMaxOccluderCount) {
+            break;
+        }
+    }
+    return (nOccluderCount > 0) && IsRectCovered(rcTarget, occluders, nOccluderCount);
+}
+
+bool Box::IsPaintOccludedByItems(const UiRect& rcPaint)
+{
+    UiRect rcTarget;
+    if (!UiRect::Intersect(rcTarget, rcPaint, GetRect())) {
+        return false;
+    }
+    return IsRectOccludedByItems(rcTarget, GetRect());
+}
+
 void Box::PaintFocusRect(IRender* /*pRender*/)
 {
 }
@@ -303,7 +485,32 @@ Control* Box::FindControlInItems(const std::vector<Control*>& items,
     UiPoint boxPt(ptMouse);
     boxPt.Offset(scrollPos);
     UiRect rc = GetRectWithoutPadding();
-    if ((uFlags & UIFIND_TOP_FIRST) != 0) {
+    const BoxSpatialIndex* pSpatialIndex = nullptr;
+    if (((uFlags & UIFIND_HITTEST) != 0) && (&items == &m_items)) {
+        pSpatialIndex = GetSpatialIndex();
+    }
+    if (pSpatialIndex != nullptr) {
+        //通过空间索引查找：只有区域包含该点的子控件才可能命中，查找顺序与遍历时一致
+        std::vector<size_t> itemIndexList;
+        pSpatialIndex->QueryPoint(boxPt, itemIndexList);
+        const size_t nCount = itemIndexList.size();
+        for (size_t i = 0; i < nCount; ++i) {
+            const size_t nIndex = ((uFlags & UIFIND_TOP_FIRST) != 0) ? itemIndexList[nCount - 1 - i] : itemIndexList[i];
+            if ((nIndex >= items.size()) || (items[nIndex] == nullptr)) {
+                continue;
+            }
+            Control* pControl = items[nIndex]->FindControl(Proc, pProcData, uFlags, boxPt);
+            if (pControl != nullptr) {
+                if (!pControl->IsFloat() && !rc.ContainsPt(ptMouse)) {
+                    continue;
+                }
+                else {
+                    return pControl;
+                }
+            }
+        }
+    }
+    else if ((uFlags & UIFIND_TOP_FIRST) != 0) {
         //倒序
         for (int32_t it = (int32_t)items.size() - 1; it >= 0; --it) {
             if (items[it] == nullptr) {
@@ -430,6 +637,7 @@ bool Box::SetItemIndex(Control* pControl, size_t iIndex)
             Arrange();            
             m_items.erase(it);
             m_items.insert(m_items.begin() + iIndex, pControl);
+            OnItemsChanged();
             return true;
         }
     }
@@ -462,6 +670,7 @@ bool Box::DoAddItemAt(Control* pControl, size_t iIndex)
         return false;
     }
     m_items.insert(m_items.begin() + iIndex, pControl);
+    OnItemsChanged();
     Window* pWindow = GetWindow();
     if (pWindow != nullptr) {
         pWindow->InitControls(pControl);
@@ -507,6 +716,7 @@ bool Box::DoRemoveItem(Control* pControl)
     for (auto it = m_items.begin(); it != m_items.end(); ++it) {
         if (*it == pControl) {
             m_items.erase(it);
+            OnItemsChanged();
             if (m_bAutoDestroyChild) {
                 if (pControl) {
                     if (pControl->HasDestroyEventCallback()) {
@@ -522,10 +732,37 @@ bool Box::DoRemoveItem(Control* pControl)
     return false;
 }
 
+bool Box::AddItems(const std::vector<Control*>& controls)
+{
+    return AddItemsAt(controls, m_items.size());
+}
+
+bool Box::AddItemsAt(const std::vector<Control*>& controls, size_t iIndex)
+{
+    ASSERT(iIndex <= m_items.size());
+    if (iIndex > m_items.size()) {
+        return false;
+    }
+    m_items.reserve(m_items.size() + controls.size());
+    AutoBoxUpdate autoUpdate(this);
+    bool bRet = true;
+    size_t nIndex = iIndex;
+    for (Control* pControl : controls) {
+        if (AddItemAt(pControl, nIndex)) {
+            ++nIndex;
+        }
+        else {
+            bRet = false;
+        }
+    }
+    return bRet;
+}
+
 void Box::RemoveAllItems()
 {
     std::vector<Control*> items;
     items.swap(m_items);
+    OnItemsChanged();
     if (m_bAutoDestroyChild) {
         for(Control* pControl : items) {
             delete pControl;
@@ -567,6 +804,16 @@ void Box::ClearImageCache()
     }
 }
 
+void Box::GetLoadedImages(std::vector<Image*>& imageList) const
+{
+    BaseClass::GetLoadedImages(imageList);
+    for (Control* pControl : m_items) {
+        if (pControl != nullptr) {
+            pControl->GetLoadedImages(imageList);
+        }
+    }
+}
+
 uint32_t Box::GetControlFlags() const
 {
     return UIFLAG_DEFAULT; // Box 默认不支持 TAB 切换焦点
@@ -592,4 +839,125 @@ uint8_t Box::GetDragOutId() const
     return m_nDragOutId;
 }
 
+void Box::SetEnableSpatialIndex(bool bEnable)
+{
+    if (bEnable == IsEnableSpatialIndex()) {
+        return;
+    }
+    if (bEnable) {
+        m_pSpatialIndex = std::make_unique<BoxSpatialIndex>();
+    }
+    else {
+        m_pSpatialIndex.reset();
+    }
+}
+
+bool Box::IsEnableSpatialIndex() const
+{
+    return m_pSpatialIndex != nullptr;
+}
+
+void Box::OnChildPaintOrderChanged()
+{
+    m_bPaintOrderDirty = true;
+}
+
+void Box::BeginUpdate()
+{
+    //嵌套层数不会达到计数器的上限，BeginUpdate与EndUpdate必须一一对应，不能忽略任何一次调用
+    ASSERT(m_nUpdateCount < UINT32_MAX);
+    if (m_nUpdateCount++ == 0) {
+        OnBeginUpdate();
+    }
+}
+
+void Box::EndUpdate()
+{
+    ASSERT(m_nUpdateCount > 0);
+    if (m_nUpdateCount == 0) {
+        return;
+    }
+    if (--m_nUpdateCount == 0) {
+        OnEndUpdate();
+    }
+}
+
+bool Box::IsUpdating() const
+{
+    return m_nUpdateCount > 0;
+}
+
+void Box::Arrange()
+{
+    if (IsUpdating()) {
+        m_bArrangePending = true;
+        return;
+    }
+    BaseClass::Arrange();
+}
+
+void Box::OnBeginUpdate()
+{
+}
+
+void Box::OnEndUpdate()
+{
+    if (m_bArrangePending) {
+        m_bArrangePending = false;
+        Arrange();
+    }
+}
+
+void Box::OnItemsChanged()
+{
+    if (m_pSpatialIndex != nullptr) {
+        m_pSpatialIndex->SetDirty();
+    }
+    m_bPaintOrderDirty = true;
+}
+
+void Box::OnChildRectChanged(const PlaceHolder* pChild)
+{
+    if ((m_pSpatialIndex == nullptr) || m_pSpatialIndex->IsDirty() || (pChild == nullptr)) {
+        return;
+    }
+    const size_t nCount = m_items.size();
+    for (size_t nIndex = 0; nIndex < nCount; ++nIndex) {
+        if (m_items[nIndex] == pChild) {
+            m_pSpatialIndex->UpdateItem(nIndex, pChild, pChild->GetRect());
+            return;
+        }
+    }
+    //子控件列表与索引不一致
+    m_pSpatialIndex->SetDirty();
+}
+
+const BoxSpatialIndex* Box::GetSpatialIndex()
+{
+    if (m_pSpatialIndex == nullptr) {
+        return nullptr;
+    }
+    //子类可能直接修改了m_items，数量不一致时也需要重建
+    if (m_pSpatialIndex->IsDirty() || (m_pSpatialIndex->GetItemCount() != m_items.size())) {
+        m_pSpatialIndex->Rebuild(m_items);
+    }
+    return m_pSpatialIndex.get();
+}
+
+AutoBoxUpdate::AutoBoxUpdate(Box* pBox):
+    m_pBox(pBox)
+{
+    ASSERT(m_pBox != nullptr);
+    if (m_pBox != nullptr) {
+        m_pBox->BeginUpdate();
+    }
+}
+
+AutoBoxUpdate::~AutoBoxUpdate()
+{
+    if (m_pBox != nullptr) {
+        m_pBox->EndUpdate();
+    }
+}
+
 } // namespace ui
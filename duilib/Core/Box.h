@@ -3,9 +3,11 @@
 
 #include "duilib/Box/Layout.h"
 #include "duilib/Core/Control.h"
+#include <memory>
 
 namespace ui 
 {
+class BoxSpatialIndex;
 
 /////////////////////////////////////////////////////////////////////////////////////
 //
@@ -33,6 +35,7 @@ public:
     virtual void SetParent(Box* pParent) override;
     virtual void SetWindow(Window* pWindow) override;
     virtual void SetAttribute(const DString& strName, const DString& strValue) override;
+    virtual void Paint(IRender* pRender, const UiRect& rcPaint) override;
     virtual void PaintChild(IRender* pRender, const UiRect& rcPaint) override;
     virtual void PaintFocusRect(IRender* pRender) override;
     virtual void SetEnabled(bool bEnabled) override;
@@ -41,6 +44,7 @@ public:
                                  const UiPoint& ptMouse = UiPoint(),
                                  const UiPoint& scrollPos = UiPoint()) override;
     virtual void ClearImageCache() override;
+    virtual void GetLoadedImages(std::vector<Image*>& imageList) const override;
     virtual uint32_t GetControlFlags() const override;
 
     /** 设置控件位置（子类可改变行为）
@@ -126,6 +130,42 @@ public:
      */
     virtual void RemoveAllItems();
 
+    /** 在最后批量添加控件（预先分配空间，全部添加完成后进行一次布局）
+     * @param[in] controls 控件指针列表
+     * @return 返回 true 为全部添加成功，false 为有控件添加失败
+     */
+    bool AddItems(const std::vector<Control*>& controls);
+
+    /** 向指定位置批量添加控件（预先分配空间，全部添加完成后进行一次布局）
+     * @param[in] controls 控件指针列表
+     * @param[in] iIndex 第一个控件的插入位置
+     * @return 返回 true 为全部添加成功，false 为有控件添加失败
+     */
+    virtual bool AddItemsAt(const std::vector<Control*>& controls, size_t iIndex);
+
+    /** @} */
+
+public:
+    /** @name 批量更新
+    * @{
+    */
+    /** 开始批量更新：在对应的EndUpdate调用之前，推迟容器的布局重排（可嵌套调用）
+    *   用于连续添加、删除大量子控件时，避免每次操作都进行布局和重绘，也可使用AutoBoxUpdate辅助类
+    */
+    void BeginUpdate();
+
+    /** 结束批量更新：最外层的EndUpdate调用后，统一进行一次布局重排和重绘
+    */
+    void EndUpdate();
+
+    /** 是否正在批量更新
+    */
+    bool IsUpdating() const;
+
+    /** 重排布局（批量更新期间推迟到EndUpdate时进行）
+    */
+    virtual void Arrange() override;
+
     /** @} */
 
 public:
@@ -202,6 +242,25 @@ public:
     */
     uint8_t GetDragOutId() const;
 
+public:
+    /** 设置是否启用子控件的空间索引（适用于子控件数量很多的容器，比如大量浮动控件组成的画布）：
+    *   启用后，鼠标命中测试和绘制时只访问相关区域内的子控件，不再遍历所有子控件
+    */
+    void SetEnableSpatialIndex(bool bEnable);
+
+    /** 是否启用子控件的空间索引
+    */
+    bool IsEnableSpatialIndex() const;
+
+    /** 子控件的位置发生变化（由子控件调用，用于更新空间索引）
+    * @param [in] pChild 子控件的接口
+    */
+    void OnChildRectChanged(const PlaceHolder* pChild);
+
+    /** 子控件的绘制顺序发生变化（由子控件调用，用于更新按绘制顺序排列的子控件列表）
+    */
+    void OnChildPaintOrderChanged();
+
 protected:
 
     /** 查找控件, 子控件列表由外部传入
@@ -212,6 +271,45 @@ protected:
                                 const UiPoint& ptMouse, 
                                 const UiPoint& scrollPos);
 
+    /** 获取空间索引（如果需要，先重建索引），未启用时返回nullptr
+    */
+    const BoxSpatialIndex* GetSpatialIndex();
+
+    /** 子控件列表发生变化（子类直接修改m_items后，需要调用此函数）
+    */
+    void OnItemsChanged();
+
+    /** 开始批量更新（最外层的BeginUpdate调用时触发）
+    */
+    virtual void OnBeginUpdate();
+
+    /** 结束批量更新（最外层的EndUpdate调用时触发），子类可在此执行推迟的刷新操作
+    */
+    virtual void OnEndUpdate();
+
+    /** 获取需要绘制的子控件，按绘制顺序排列（跳过不可见的子控件和完全在绘制区域以外的子控件）
+    * @param [in] rcPaint 绘制区域（子控件的坐标系）
+    * @return 返回的列表在下次调用前有效
+    */
+    const std::vector<Control*>& GetPaintItems(const UiRect& rcPaint);
+
+    /** 判断容器自身的绘制区域是否被不透明的子控件完全覆盖（完全覆盖时，容器自身的背景等内容不需要绘制）
+    * @param [in] rcPaint 绘制区域（与GetRect()的坐标系相同）
+    */
+    virtual bool IsPaintOccludedByItems(const UiRect& rcPaint);
+
+    /** 判断指定区域是否被不透明的子控件完全覆盖
+    * @param [in] rcTarget 需要判断的区域（子控件的坐标系）
+    * @param [in] rcClip 子控件绘制时的裁剪区域（子控件的坐标系）
+    */
+    bool IsRectOccludedByItems(const UiRect& rcTarget, const UiRect& rcClip) const;
+
+private:
+    /** 遮挡剔除：从前往后检查需要绘制的子控件，去掉被前面的不透明子控件完全覆盖的子控件
+    * @param [in] rcPaint 绘制区域（子控件的坐标系）
+    */
+    void CullOccludedPaintItems(const UiRect& rcPaint);
+
 private:
     /**@brief 向指定位置添加一个控件
      * @param[in] pControl 控件指针
@@ -244,6 +342,38 @@ private:
 
     //是否支持拖拽拖出该容器：如果不等于0，支持拖出，否则不支持拖出（拖出到DropInId==DragOutId的容器）
     uint8_t m_nDragOutId;
+
+    //子控件的空间索引（未启用时为nullptr）
+    std::unique_ptr<BoxSpatialIndex> m_pSpatialIndex;
+
+    //设置了绘制顺序的子控件，按绘制顺序排列（子控件列表或者绘制顺序变化后重建）
+    std::vector<Control*> m_paintOrderItems;
+
+    //按绘制顺序排列的子控件列表是否需要重建
+    bool m_bPaintOrderDirty;
+
+    //批量更新期间，是否有推迟的布局重排
+    bool m_bArrangePending;
+
+    //批量更新的嵌套层数（BeginUpdate的调用次数）
+    uint32_t m_nUpdateCount;
+
+    //需要绘制的子控件（避免每次绘制时分配内存）
+    std::vector<Control*> m_paintItems;
+};
+
+/** 容器批量更新的辅助类：构造时调用BeginUpdate，析构时调用EndUpdate（容器的生命周期需要长于该对象）
+*/
+class UILIB_API AutoBoxUpdate
+{
+public:
+    explicit AutoBoxUpdate(Box* pBox);
+    ~AutoBoxUpdate();
+    AutoBoxUpdate(const AutoBoxUpdate&) = delete;
+    AutoBoxUpdate& operator=(const AutoBoxUpdate&) = delete;
+
+private:
+    Box* m_pBox;
 };
 
 } // namespace ui
@@ -0,0 +1,232 @@
+#include "BoxSpatialIndex.h"
+#include "duilib/Core/Control.h"
+#include <cmath>
+
+namespace ui
+{
+/** 网格的最大行数和列数
+*/
+static constexpr int32_t kMaxGridCount = 256;
+
+/** 子控件覆盖的网格数超过该值时，不放入网格
+*/
+static constexpr int32_t kMaxItemCells = 64;
+
+/** 重建后单独更新的最大次数（布局整体变化时，避免逐个更新）
+*/
+static constexpr size_t kMaxUpdateCount = 32;
+
+BoxSpatialIndex::BoxSpatialIndex():
+    m_nCellWidth(1),
+    m_nCellHeight(1),
+    m_nColumns(0),
+    m_nRows(0),
+    m_nUpdateCount(0),
+    m_bDirty(true)
+{
+}
+
+void BoxSpatialIndex::SetDirty()
+{
+    m_bDirty = true;
+}
+
+bool BoxSpatialIndex::IsDirty() const
+{
+    return m_bDirty;
+}
+
+void BoxSpatialIndex::Rebuild(const std::vector<Control*>& items)
+{
+    const size_t nCount = items.size();
+    m_itemControls.assign(items.begin(), items.end());
+    m_itemRects.resize(nCount);
+    m_itemLarge.assign(nCount, false);
+    m_largeItems.clear();
+    m_cells.clear();
+    m_rcBounds.Clear();
+    m_nUpdateCount = 0;
+    m_bDirty = false;
+
+    size_t nValidCount = 0;
+    for (size_t nIndex = 0; nIndex < nCount; ++nIndex) {
+        m_itemRects[nIndex].Clear();
+        if (items[nIndex] != nullptr) {
+            m_itemRects[nIndex] = items[nIndex]->GetRect();
+            if (!m_itemRects[nIndex].IsEmpty()) {
+                m_rcBounds.Union(m_itemRects[nIndex]);
+                ++nValidCount;
+            }
+        }
+    }
+    if (nValidCount == 0) {
+        m_nColumns = 0;
+        m_nRows = 0;
+        return;
+    }
+
+    //网格数量与子控件数量相当，按区域的宽高比分配行数和列数
+    const double fWidth = std::max(m_rcBounds.Width(), 1);
+    const double fHeight = std::max(m_rcBounds.Height(), 1);
+    int32_t nColumns = (int32_t)std::lround(std::sqrt((double)nValidCount * fWidth / fHeight));
+    nColumns = std::clamp(nColumns, 1, kMaxGridCount);
+    int32_t nRows = (int32_t)((nValidCount + nColumns - 1) / nColumns);
+    nRows = std::clamp(nRows, 1, kMaxGridCount);
+    m_nCellWidth = std::max((m_rcBounds.Width() + nColumns - 1) / nColumns, 1);
+    m_nCellHeight = std::max((m_rcBounds.Height() + nRows - 1) / nRows, 1);
+    m_nColumns = (m_rcBounds.Width() + m_nCellWidth - 1) / m_nCellWidth;
+    m_nRows = (m_rcBounds.Height() + m_nCellHeight - 1) / m_nCellHeight;
+    m_nColumns = std::max(m_nColumns, 1);
+    m_nRows = std::max(m_nRows, 1);
+    m_cells.resize((size_t)m_nColumns * m_nRows);
+
+    for (size_t nIndex = 0; nIndex < nCount; ++nIndex) {
+        InsertItem(nIndex);
+    }
+}
+
+size_t BoxSpatialIndex::GetItemCount() const
+{
+    return m_itemControls.size();
+}
+
+bool BoxSpatialIndex::UpdateItem(size_t nIndex, const PlaceHolder* pControl, const UiRect& rcItem)
+{
+    if (m_bDirty) {
+        return false;
+    }
+    if ((nIndex >= m_itemControls.size()) || (m_itemControls[nIndex] != pControl) ||
+        (m_nColumns == 0) || (++m_nUpdateCount > kMaxUpdateCount)) {
+        m_bDirty = true;
+        return false;
+    }
+    if (m_itemRects[nIndex].Equals(rcItem)) {
+        return true;
+    }
+    RemoveItem(nIndex);
+    m_itemRects[nIndex] = rcItem;
+    InsertItem(nIndex);
+    return true;
+}
+
+void BoxSpatialIndex::QueryPoint(const UiPoint& pt, std::vector<size_t>& itemIndexList) const
+{
+    itemIndexList.clear();
+    if (m_nColumns == 0) {
+        return;
+    }
+    int32_t nColumnBegin = 0;
+    int32_t nRowBegin = 0;
+    int32_t nColumnEnd = 0;
+    int32_t nRowEnd = 0;
+    GetCellRange(UiRect(pt.x, pt.y, pt.x + 1, pt.y + 1), nColumnBegin, nRowBegin, nColumnEnd, nRowEnd);
+    const std::vector<uint32_t>& cell = m_cells[(size_t)nRowBegin * m_nColumns + nColumnBegin];
+    for (uint32_t nIndex : cell) {
+        if (m_itemRects[nIndex].ContainsPt(pt)) {
+            itemIndexList.push_back(nIndex);
+        }
+    }
+    for (uint32_t nIndex : m_largeItems) {
+        if (m_itemRects[nIndex].ContainsPt(pt)) {
+            itemIndexList.push_back(nIndex);
+        }
+    }
+    std::sort(itemIndexList.begin(), itemIndexList.end());
+}
+
+void BoxSpatialIndex::QueryRect(const UiRect& rc, std::vector<size_t>& itemIndexList) const
+{
+    itemIndexList.clear();
+    if ((m_nColumns == 0) || rc.IsEmpty()) {
+        return;
+    }
+    int32_t nColumnBegin = 0;
+    int32_t nRowBegin = 0;
+    int32_t nColumnEnd = 0;
+    int32_t nRowEnd = 0;
+    GetCellRange(rc, nColumnBegin, nRowBegin, nColumnEnd, nRowEnd);
+    UiRect rcTemp;
+    for (int32_t nRow = nRowBegin; nRow <= nRowEnd; ++nRow) {
+        for (int32_t nColumn = nColumnBegin; nColumn <= nColumnEnd; ++nColumn) {
+            const std::vector<uint32_t>& cell = m_cells[(size_t)nRow * m_nColumns + nColumn];
+            for (uint32_t nIndex : cell) {
+                if (UiRect::Intersect(rcTemp, m_itemRects[nIndex], rc)) {
+                    itemIndexList.push_back(nIndex);
+                }
+            }
+        }
+    }
+    for (uint32_t nIndex : m_largeItems) {
+        if (UiRect::Intersect(rcTemp, m_itemRects[nIndex], rc)) {
+            itemIndexList.push_back(nIndex);
+        }
+    }
+    //跨越多个网格的子控件会重复出现
+    std::sort(itemIndexList.begin(), itemIndexList.end());
+    itemIndexList.erase(std::unique(itemIndexList.begin(), itemIndexList.end()), itemIndexList.end());
+}
+
+void BoxSpatialIndex::GetCellRange(const UiRect& rc, int32_t& nColumnBegin, int32_t& nRowBegin,
+                                   int32_t& nColumnEnd, int32_t& nRowEnd) const
+{
+    //rc为左闭右开区间，超出网格覆盖区域的部分归入边缘的网格
+    nColumnBegin = std::clamp((int32_t)(((int64_t)rc.left - m_rcBounds.left) / m_nCellWidth), 0, m_nColumns - 1);
+    nRowBegin = std::clamp((int32_t)(((int64_t)rc.top - m_rcBounds.top) / m_nCellHeight), 0, m_nRows - 1);
+    nColumnEnd = std::clamp((int32_t)(((int64_t)rc.right - 1 - m_rcBounds.left) / m_nCellWidth), 0, m_nColumns - 1);
+    nRowEnd = std::clamp((int32_t)(((int64_t)rc.bottom - 1 - m_rcBounds.top) / m_nCellHeight), 0, m_nRows - 1);
+}
+
+void BoxSpatialIndex::InsertItem(size_t nIndex)
+{
+    const UiRect& rcItem = m_itemRects[nIndex];
+    if (rcItem.IsEmpty()) {
+        return;
+    }
+    int32_t nColumnBegin = 0;
+    int32_t nRowBegin = 0;
+    int32_t nColumnEnd = 0;
+    int32_t nRowEnd = 0;
+    GetCellRange(rcItem, nColumnBegin, nRowBegin, nColumnEnd, nRowEnd);
+    if ((nColumnEnd - nColumnBegin + 1) * (nRowEnd - nRowBegin + 1) > kMaxItemCells) {
+        m_itemLarge[nIndex] = true;
+        m_largeItems.push_back((uint32_t)nIndex);
+        return;
+    }
+    for (int32_t nRow = nRowBegin; nRow <= nRowEnd; ++nRow) {
+        for (int32_t nColumn = nColumnBegin; nColumn <= nColumnEnd; ++nColumn) {
+            m_cells[(size_t)nRow * m_nColumns + nColumn].push_back((uint32_t)nIndex);
+        }
+    }
+}
+
+void BoxSpatialIndex::RemoveItem(size_t nIndex)
+{
+    const UiRect& rcItem = m_itemRects[nIndex];
+    if (rcItem.IsEmpty()) {
+        return;
+    }
+    if (m_itemLarge[nIndex]) {
+        m_itemLarge[nIndex] = false;
+        auto iter = std::find(m_largeItems.begin(), m_largeItems.end(), (uint32_t)nIndex);
+        if (iter != m_largeItems.end()) {
+            m_largeItems.erase(iter);
+        }
+        return;
+    }
+    int32_t nColumnBegin = 0;
+    int32_t nRowBegin = 0;
+    int32_t nColumnEnd = 0;
+    int32_t nRowEnd = 0;
+    GetCellRange(rcItem, nColumnBegin, nRowBegin, nColumnEnd, nRowEnd);
+    for (int32_t nRow = nRowBegin; nRow <= nRowEnd; ++nRow) {
+        for (int32_t nColumn = nColumnBegin; nColumn <= nColumnEnd; ++nColumn) {
+            std::vector<uint32_t>& cell = m_cells[(size_t)nRow * m_nColumns + nColumn];
+            auto iter = std::find(cell.begin(), cell.end(), (uint32_t)nIndex);
+            if (iter != cell.end()) {
+                cell.erase(iter);
+            }
+        }
+    }
+}
+
+} // namespace ui
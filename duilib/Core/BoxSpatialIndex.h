@@ -0,0 +1,123 @@
+#ifndef UI_CORE_BOX_SPATIAL_INDEX_H_
+#define UI_CORE_BOX_SPATIAL_INDEX_H_
+
+#include "duilib/Core/UiRect.h"
+#include "duilib/Core/UiPoint.h"
+#include <vector>
+
+namespace ui
+{
+class Control;
+class PlaceHolder;
+
+/** 容器子控件的空间索引（均匀网格），用于子控件数量很多的容器（比如大量浮动控件组成的画布）：
+*   按坐标点查找子控件（鼠标命中测试）、按矩形区域查找子控件（绘制时跳过不可见的子控件），
+*   只需要访问相关网格中的子控件，不需要遍历所有子控件；
+*   子控件的位置变化后，可单独更新该子控件的索引，布局整体变化后标记为脏，在下次查询前重建
+*/
+class BoxSpatialIndex
+{
+public:
+    BoxSpatialIndex();
+    BoxSpatialIndex(const BoxSpatialIndex&) = delete;
+    BoxSpatialIndex& operator=(const BoxSpatialIndex&) = delete;
+
+public:
+    /** 标记索引需要重建
+    */
+    void SetDirty();
+
+    /** 索引是否需要重建
+    */
+    bool IsDirty() const;
+
+    /** 按子控件列表重建索引，时间复杂度O(n)
+    * @param [in] items 容器的子控件列表
+    */
+    void Rebuild(const std::vector<Control*>& items);
+
+    /** 获取索引中的子控件数量
+    */
+    size_t GetItemCount() const;
+
+    /** 更新一个子控件的位置
+    * @param [in] nIndex 子控件的索引号
+    * @param [in] pControl 子控件的接口
+    * @param [in] rcItem 子控件新的位置
+    * @return 成功返回true；如果连续更新的次数太多，或者子控件不匹配，标记为需要重建并返回false
+    */
+    bool UpdateItem(size_t nIndex, const PlaceHolder* pControl, const UiRect& rcItem);
+
+    /** 查找包含指定点的子控件
+    * @param [in] pt 坐标点（容器子控件的坐标系）
+    * @param [out] itemIndexList 返回子控件的索引号，按索引号从小到大排序
+    */
+    void QueryPoint(const UiPoint& pt, std::vector<size_t>& itemIndexList) const;
+
+    /** 查找与指定矩形区域相交的子控件
+    * @param [in] rc 矩形区域（容器子控件的坐标系）
+    * @param [out] itemIndexList 返回子控件的索引号，按索引号从小到大排序
+    */
+    void QueryRect(const UiRect& rc, std::vector<size_t>& itemIndexList) const;
+
+private:
+    /** 获取矩形区域覆盖的网格范围（超出范围的部分归入边缘的网格）
+    */
+    void GetCellRange(const UiRect& rc, int32_t& nColumnBegin, int32_t& nRowBegin,
+                      int32_t& nColumnEnd, int32_t& nRowEnd) const;
+
+    /** 将一个子控件加入网格
+    */
+    void InsertItem(size_t nIndex);
+
+    /** 将一个子控件从网格中移除
+    */
+    void RemoveItem(size_t nIndex);
+
+private:
+    /** 子控件的接口
+    */
+    std::vector<const Control*> m_itemControls;
+
+    /** 子控件的位置（空矩形表示不在网格中）
+    */
+    std::vector<UiRect> m_itemRects;
+
+    /** 子控件是否覆盖的网格太多（这类子控件不放入网格，每次查询都检查）
+    */
+    std::vector<bool> m_itemLarge;
+
+    /** 每个网格中的子控件索引号
+    */
+    std::vector<std::vector<uint32_t>> m_cells;
+
+    /** 覆盖网格太多的子控件索引号
+    */
+    std::vector<uint32_t> m_largeItems;
+
+    /** 网格覆盖的区域
+    */
+    UiRect m_rcBounds;
+
+    /** 网格的宽度和高度
+    */
+    int32_t m_nCellWidth;
+    int32_t m_nCellHeight;
+
+    /** 网格的列数和行数
+    */
+    int32_t m_nColumns;
+    int32_t m_nRows;
+
+    /** 重建后单独更新的次数
+    */
+    size_t m_nUpdateCount;
+
+    /** 是否需要重建
+    */
+    bool m_bDirty;
+};
+
+} // namespace ui
+
+#endif // UI_CORE_BOX_SPATIAL_INDEX_H_
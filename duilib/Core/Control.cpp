@@ -16,8 +16,13 @@
 
 namespace ui 
 {
+/** 作为图层绘制的控件数量（为0时，不需要逐级标记图层的脏区域）
+*/
+static size_t s_nLayerCount = 0;
+
 Control::Control(Window* pWindow) :
     PlaceHolder(pWindow),
+    m_nLayerBytes(0),
     m_bContextMenuUsed(false),
     m_bMouseFocused(false),
     m_bNoFocus(false),
@@ -30,7 +35,9 @@ Control::Control(Window* pWindow) :
     m_uUserDataID((size_t)-1),
     m_bShowFocusRect(false),
     m_nPaintOrder(0),
-    m_bBordersOnTop(true)
+    m_bBordersOnTop(true),
+    m_bLayerEnabled(false),
+    m_bLangControl(false)
 {
 }
 
@@ -41,6 +48,11 @@ Control::~Control()
         m_animationManager->Clear(this);
     }    
     m_animationManager.reset();
+    SetLayerEnabled(false);
+    if (m_bLangControl) {
+        GlobalManager::Instance().Lang().RemoveLangControl(this);
+        m_bLangControl = false;
+    }
 
     Window* pWindow = GetWindow();
     if (pWindow) {
@@ -379,6 +391,9 @@ void Control::SetAttribute(const DString& strName, const DString& strValue)
     else if (strName == _T("cache")) {
         SetUseCache(strValue == _T("true"));
     }
+    else if (strName == _T("layer")) {
+        SetLayerEnabled(strValue == _T("true"));
+    }
     else if ((strName == _T("no_focus")) || (strName == _T("nofocus"))) {
         SetNoFocus();
     }
@@ -465,6 +480,19 @@ void Control::SetAttribute(const DString& strName, const DString& strValue)
     }
 }
 
+void Control::OnLanguageChanged()
+{
+    Invalidate();
+}
+
+void Control::RegisterLangControl()
+{
+    if (!m_bLangControl) {
+        m_bLangControl = true;
+        GlobalManager::Instance().Lang().AddLangControl(this);
+    }
+}
+
 void Control::ChangeDpiScale(uint32_t nOldDpiScale, uint32_t nNewDpiScale)
 {
     ASSERT(nNewDpiScale == Dpi().GetScale());
@@ -631,6 +659,11 @@ AnimationManager& Control::GetAnimationManager()
     return *m_animationManager;
 }
 
+bool Control::IsAnimationPlaying() const
+{
+    return (m_animationManager != nullptr) && m_animationManager->IsAnimationPlaying();
+}
+
 DString Control::GetBkColor() const
 {
     return (m_pBkColorData != nullptr) ? m_pBkColorData->m_strBkColor.c_str() : DString();
@@ -1483,6 +1516,9 @@ void Control::SetVisible(bool bVisible)
     }
     bool v = IsVisible();
     BaseClass::SetVisible(bVisible);
+    if (IsVisible() != v) {
+        MarkLayerDirty(GetRect(), false, nullptr);
+    }
 
     if (!IsVisible()) {
         EnsureNoFocus();
@@ -1632,11 +1668,24 @@ void Control::SetPos(UiRect rc)
         invalidateRc = rc;
     }
 
+    const UiRect rcOld = GetRect();
     SetRect(rc);
     if (GetWindow() == nullptr) {
         return;
     }
     invalidateRc.Union(GetRect());
+    if (s_nLayerCount > 0) {
+        //只是平移时，子控件随图层整体平移，图层内容不变
+        const bool bMoveOnly = isPosChanged && (rcOld.Width() == rc.Width()) && (rcOld.Height() == rc.Height());
+        const UiPoint moveOffset(rc.left - rcOld.left, rc.top - rcOld.top);
+        if (IsLayerEnabled()) {
+            m_layerMoveOffset = bMoveOnly ? moveOffset : UiPoint();
+            if (!bMoveOnly) {
+                m_rcLayerDirty = UiRect(0, 0, rc.Width(), rc.Height());
+            }
+        }
+        MarkLayerDirty(invalidateRc, false, bMoveOnly ? &moveOffset : nullptr);
+    }
     bool needInvalidate = true;
     UiRect rcTemp;
     UiRect rcParent;
@@ -2546,6 +2595,13 @@ void Control::AlphaPaint(IRender* pRender, const UiRect& rcPaint)
     //当前控件是否设置了透明度（透明度值不是255）
     const bool isAlpha = IsAlpha();
 
+    //作为图层绘制(如果存在box-shadow，不能作为图层绘制，原因同绘制缓存)
+    if (IsLayerEnabled() && !HasBoxShadow()) {
+        if (PaintLayer(pRender, rcPaint, bRoundClip)) {
+            return;
+        }
+    }
+
     //是否使用绘制缓存(如果存在box-shadow，就不能使用绘制缓存，因为box-shadow绘制的时候是超出GetRect来绘制外部阴影的)
     const bool isUseCache = IsUseCache() && !HasBoxShadow();
 
@@ -2669,6 +2725,93 @@ std::unique_ptr<AutoClip> Control::CreateRoundClip(IRender* pRender, const UiRec
     return std::make_unique<AutoClip>(pRender, rc, fRoundWidth, fRoundHeight, bRoundClip);
 }
 
+bool Control::PaintLayer(IRender* pRender, const UiRect& rcPaint, bool bRoundClip)
+{
+    const UiRect& rcRect = GetRect();
+    const UiSize size(rcRect.Width(), rcRect.Height());
+    m_layerMoveOffset = UiPoint();
+
+    //图层位图占用的内存，超出上限时释放图层位图，直接绘制
+    const size_t nLayerBytes = (size_t)size.cx * (size_t)size.cy * sizeof(uint32_t);
+    if (nLayerBytes != m_nLayerBytes) {
+        ReleaseLayer();
+        if (!GlobalManager::Instance().AllocLayerMemory(nLayerBytes)) {
+            return false;
+        }
+        m_nLayerBytes = nLayerBytes;
+    }
+    IRender* pLayerRender = GetRender();
+    ASSERT(pLayerRender != nullptr);
+    if (pLayerRender == nullptr) {
+        return false;
+    }
+    if ((size.cx != pLayerRender->GetWidth()) || (size.cy != pLayerRender->GetHeight())) {
+        if (!pLayerRender->Resize(size.cx, size.cy)) {
+            ASSERT(!"pLayerRender->Resize failed!");
+            ReleaseLayer();
+            return false;
+        }
+        m_rcLayerDirty = UiRect(0, 0, size.cx, size.cy);
+    }
+
+    //重绘图层中的脏区域（图层位图的坐标系与控件的坐标系相差控件的左上角坐标）
+    UiRect rcDirty = m_rcLayerDirty;
+    m_rcLayerDirty.Clear();
+    if (rcDirty.Intersect(UiRect(0, 0, size.cx, size.cy))) {
+        if (pLayerRender->GetRenderBackendType() == RenderBackendType::kRaster_BackendType) {
+            pLayerRender->ClearRect(rcDirty, UiColor());
+        }
+        else {
+            rcDirty = UiRect(0, 0, size.cx, size.cy);
+            pLayerRender->Clear(UiColor());
+        }
+        rcDirty.Offset(rcRect.left, rcRect.top);
+
+        UiPoint ptOldOrg = pLayerRender->OffsetWindowOrg(UiPoint(rcRect.left, rcRect.top));
+        {
+            AutoClip dirtyClip(pLayerRender, rcDirty, true);
+            std::unique_ptr<AutoClip> roundClip = CreateRoundClip(pLayerRender, rcRect, bRoundClip);
+            Paint(pLayerRender, rcDirty);
+            PaintChild(pLayerRender, rcDirty);
+            if (IsBordersOnTop()) {
+                PaintBorder(pLayerRender);     //绘制边框
+            }
+        }
+        pLayerRender->SetWindowOrg(ptOldOrg);
+    }
+
+    //合成：绘制偏移和透明度只影响合成，不影响图层内容
+    UiRect rcDest = rcRect;
+    rcDest.Offset(-m_renderOffset.x, -m_renderOffset.y);
+    UiRect rcBlend;
+    if (!UiRect::Intersect(rcBlend, rcDest, rcPaint)) {
+        return true;
+    }
+    AutoClip clip(pRender, rcRect, IsClip());
+    std::unique_ptr<AutoClip> roundClip = CreateRoundClip(pRender, rcRect, bRoundClip);
+    pRender->AlphaBlend(rcBlend.left,
+                        rcBlend.top,
+                        rcBlend.Width(),
+                        rcBlend.Height(),
+                        pLayerRender,
+                        rcBlend.left - rcDest.left,
+                        rcBlend.top - rcDest.top,
+                        rcBlend.Width(),
+                        rcBlend.Height(),
+                        static_cast<uint8_t>(m_nAlpha));
+    return true;
+}
+
+void Control::ReleaseLayer()
+{
+    if (m_nLayerBytes != 0) {
+        GlobalManager::Instance().FreeLayerMemory(m_nLayerBytes);
+        m_nLayerBytes = 0;
+        m_render.reset();
+    }
+    m_rcLayerDirty = UiRect(0, 0, GetRect().Width(), GetRect().Height());
+}
+
 void Control::SetPaintRect(const UiRect& rect)
 { 
     m_rcPaint = rect; 
@@ -3265,7 +3408,12 @@ void Control::SetAlpha(int64_t alpha)
     ASSERT(alpha >= 0 && alpha <= 255);
     if (m_nAlpha != (uint8_t)alpha) {
         m_nAlpha = (uint8_t)alpha;
-        Invalidate();
+        if (IsLayerEnabled()) {
+            InvalidateLayerComposite();
+        }
+        else {
+            Invalidate();
+        }
     }
 }
 
@@ -3290,7 +3438,12 @@ void Control::SetRenderOffset(UiPoint renderOffset, bool bNeedDpiScale)
     }    
     if (m_renderOffset != renderOffset) {
         m_renderOffset = renderOffset;
-        Invalidate();
+        if (IsLayerEnabled()) {
+            InvalidateLayerComposite();
+        }
+        else {
+            Invalidate();
+        }
     }    
 }
 
@@ -3299,7 +3452,12 @@ void Control::SetRenderOffsetX(int64_t renderOffsetX)
     int32_t x = TruncateToInt32(renderOffsetX);
     if (m_renderOffset.x != x) {
         m_renderOffset.x = x;
-        Invalidate();
+        if (IsLayerEnabled()) {
+            InvalidateLayerComposite();
+        }
+        else {
+            Invalidate();
+        }
     }
 }
 
@@ -3308,7 +3466,12 @@ void Control::SetRenderOffsetY(int64_t renderOffsetY)
     int32_t y = TruncateToInt32(renderOffsetY);
     if (m_renderOffset.y != y) {
         m_renderOffset.y = y;
-        Invalidate();
+        if (IsLayerEnabled()) {
+            InvalidateLayerComposite();
+        }
+        else {
+            Invalidate();
+        }
     }
 }
 
@@ -3424,6 +3587,22 @@ void Control::ClearImageCache()
     }
 }
 
+void Control::GetLoadedImages(std::vector<Image*>& imageList) const
+{
+    std::vector<Image*> allImages;
+    if (m_pImageMap != nullptr) {
+        m_pImageMap->GetAllImages(allImages);
+    }
+    if (m_pBkImage != nullptr) {
+        allImages.push_back(m_pBkImage.get());
+    }
+    for (Image* pImage : allImages) {
+        if ((pImage != nullptr) && (pImage->GetImageCache() != nullptr)) {
+            imageList.push_back(pImage);
+        }
+    }
+}
+
 void Control::AttachEvent(EventType type, const EventCallback& callback)
 {
     EventMap& attachEventMap = GetAttachEventMap();
@@ -3439,13 +3618,9 @@ void Control::DetachEvent(EventType type)
         return;
     }
     EventMap& attachEventMap = GetAttachEventMap();
-    auto event = attachEventMap.find(type);
-    if (event != attachEventMap.end()) {
-        attachEventMap.erase(event);
-    }
+    attachEventMap.Remove(type);
     if ((type == kEventContextMenu) || (type == kEventAll)) {
-        if ((attachEventMap.find(kEventAll) == attachEventMap.end()) &&
-            (attachEventMap.find(kEventContextMenu) == attachEventMap.end())) {
+        if (!attachEventMap.HasEvent(kEventAll) && !attachEventMap.HasEvent(kEventContextMenu)) {
             SetContextMenuUsed(false);
         }
     }
@@ -3463,10 +3638,7 @@ void Control::DetachXmlEvent(EventType type)
         return;
     }
     EventMap& xmlEventMap = GetXmlEventMap();
-    auto event = xmlEventMap.find(type);
-    if (event != xmlEventMap.end()) {
-        xmlEventMap.erase(event);
-    }
+    xmlEventMap.Remove(type);
 }
 
 void Control::AttachBubbledEvent(EventType eventType, const EventCallback& callback)
@@ -3481,10 +3653,7 @@ void Control::DetachBubbledEvent(EventType eventType)
         return;
     }
     EventMap& bubbledEventMap = GetBubbledEventMap();
-    auto event = bubbledEventMap.find(eventType);
-    if (event != bubbledEventMap.end()) {
-        bubbledEventMap.erase(eventType);
-    }
+    bubbledEventMap.Remove(eventType);
 }
 
 void Control::AttachXmlBubbledEvent(EventType eventType, const EventCallback& callback)
@@ -3499,10 +3668,7 @@ void Control::DetachXmlBubbledEvent(EventType eventType)
         return;
     }
     EventMap& xmlBubbledEventMap = GetXmlBubbledEventMap();
-    auto event = xmlBubbledEventMap.find(eventType);
-    if (event != xmlBubbledEventMap.end())    {
-        xmlBubbledEventMap.erase(eventType);
-    }
+    xmlBubbledEventMap.Remove(eventType);
 }
 
 bool Control::FireAllEvents(const EventArgs& msg)
@@ -3510,43 +3676,47 @@ bool Control::FireAllEvents(const EventArgs& msg)
     if (msg.IsSenderExpired()) {
         return false;
     }
+    if (m_pEventMapData == nullptr) {
+        //没有注册任何事件回调函数
+        return true;
+    }
     std::weak_ptr<WeakFlag> weakflag = GetWeakFlag();
     bool bRet = true;//当值为false时，就不再调用回调函数和处理函数
 
     if (msg.GetSender() == this) {
         //备注：EventMap 和 XmlEventMap里面的回调函数，需要校验消息的发送者是否为控件自身
-        if (bRet && HasAttachEventMap() && !GetAttachEventMap().empty()) {
+        if (bRet && HasAttachEventMap() && GetAttachEventMap().HasEventOrAll(msg.eventType)) {
             const EventMap& attachEventMap = GetAttachEventMap();
-            auto callback = attachEventMap.find(msg.eventType);
-            if (callback != attachEventMap.end()) {
-                bRet = callback->second(msg);
+            const CEventSource* pEventSource = attachEventMap.Find(msg.eventType);
+            if (pEventSource != nullptr) {
+                bRet = (*pEventSource)(msg);
             }
             if (weakflag.expired() || msg.IsSenderExpired()) {
                 return false;
             }
 
-            callback = attachEventMap.find(kEventAll);
-            if (callback != attachEventMap.end()) {
-                bRet = callback->second(msg);
+            pEventSource = attachEventMap.Find(kEventAll);
+            if (pEventSource != nullptr) {
+                bRet = (*pEventSource)(msg);
             }
             if (weakflag.expired() || msg.IsSenderExpired()) {
                 return false;
             }
         }
 
-        if (bRet && HasXmlEventMap() && !GetXmlEventMap().empty()) {
+        if (bRet && HasXmlEventMap() && GetXmlEventMap().HasEventOrAll(msg.eventType)) {
             const EventMap& xmlEventMap = GetXmlEventMap();
-            auto callback = xmlEventMap.find(msg.eventType);
-            if (callback != xmlEventMap.end()) {
-                bRet = callback->second(msg);
+            const CEventSource* pEventSource = xmlEventMap.Find(msg.eventType);
+            if (pEventSource != nullptr) {
+                bRet = (*pEventSource)(msg);
             }
             if (weakflag.expired() || msg.IsSenderExpired()) {
                 return false;
             }
 
-            callback = xmlEventMap.find(kEventAll);
-            if (callback != xmlEventMap.end()) {
-                bRet = callback->second(msg);
+            pEventSource = xmlEventMap.Find(kEventAll);
+            if (pEventSource != nullptr) {
+                bRet = (*pEventSource)(msg);
             }
             if (weakflag.expired() || msg.IsSenderExpired()) {
                 return false;
@@ -3555,38 +3725,38 @@ bool Control::FireAllEvents(const EventArgs& msg)
     }
 
     //备注：BubbledEventMap 和 XmlBubbledEventMap里面的回调函数，不需要校验消息的发送者是否为控件自身
-    if (bRet && HasBubbledEventMap() && !GetBubbledEventMap().empty()) {
+    if (bRet && HasBubbledEventMap() && GetBubbledEventMap().HasEventOrAll(msg.eventType)) {
         const EventMap& bubbledEventMap = GetBubbledEventMap();
-        auto callback = bubbledEventMap.find(msg.eventType);
-        if (callback != bubbledEventMap.end()) {
-            bRet = callback->second(msg);
+        const CEventSource* pEventSource = bubbledEventMap.Find(msg.eventType);
+        if (pEventSource != nullptr) {
+            bRet = (*pEventSource)(msg);
         }
         if (weakflag.expired() || msg.IsSenderExpired()) {
             return false;
         }
 
-        callback = bubbledEventMap.find(kEventAll);
-        if (callback != bubbledEventMap.end()) {
-            bRet = callback->second(msg);
+        pEventSource = bubbledEventMap.Find(kEventAll);
+        if (pEventSource != nullptr) {
+            bRet = (*pEventSource)(msg);
         }
         if (weakflag.expired() || msg.IsSenderExpired()) {
             return false;
         }
     }
 
-    if (bRet && HasXmlBubbledEventMap() && !GetXmlBubbledEventMap().empty()) {
+    if (bRet && HasXmlBubbledEventMap() && GetXmlBubbledEventMap().HasEventOrAll(msg.eventType)) {
         const EventMap& xmlBubbledEventMap = GetXmlBubbledEventMap();
-        auto callback = xmlBubbledEventMap.find(msg.eventType);
-        if (callback != xmlBubbledEventMap.end()) {
-            bRet = callback->second(msg);
+        const CEventSource* pEventSource = xmlBubbledEventMap.Find(msg.eventType);
+        if (pEventSource != nullptr) {
+            bRet = (*pEventSource)(msg);
         }
         if (weakflag.expired() || msg.IsSenderExpired()) {
             return false;
         }
 
-        callback = xmlBubbledEventMap.find(kEventAll);
-        if (callback != xmlBubbledEventMap.end()) {
-            bRet = callback->second(msg);
+        pEventSource = xmlBubbledEventMap.Find(kEventAll);
+        if (pEventSource != nullptr) {
+            bRet = (*pEventSource)(msg);
         }
         if (weakflag.expired() || msg.IsSenderExpired()) {
             return false;
@@ -3740,7 +3910,13 @@ bool Control::ClientToScreen(UiPoint& pt)
 
 void Control::SetPaintOrder(uint8_t nPaintOrder)
 {
+    if (m_nPaintOrder == nPaintOrder) {
+        return;
+    }
     m_nPaintOrder = nPaintOrder;
+    if (GetParent() != nullptr) {
+        GetParent()->OnChildPaintOrderChanged();
+    }
 }
 
 uint8_t Control::GetPaintOrder() const
@@ -3748,9 +3924,115 @@ uint8_t Control::GetPaintOrder() const
     return m_nPaintOrder;
 }
 
+void Control::SetLayerEnabled(bool bLayer)
+{
+    if (m_bLayerEnabled == bLayer) {
+        return;
+    }
+    m_bLayerEnabled = bLayer;
+    if (bLayer) {
+        ++s_nLayerCount;
+        m_rcLayerDirty = UiRect(0, 0, GetRect().Width(), GetRect().Height());
+    }
+    else {
+        ASSERT(s_nLayerCount > 0);
+        --s_nLayerCount;
+        ReleaseLayer();
+        m_rcLayerDirty.Clear();
+    }
+}
+
+bool Control::IsLayerEnabled() const
+{
+    return m_bLayerEnabled;
+}
+
+bool Control::GetOpaqueRect(UiRect& rcOpaque) const
+{
+    if (!IsVisible() || (m_nAlpha != 255) || (m_renderOffset.x != 0) || (m_renderOffset.y != 0)) {
+        return false;
+    }
+    if ((m_pBkColorData == nullptr) || m_pBkColorData->m_strBkColor.empty() || ShouldBeRoundRectFill()) {
+        return false;
+    }
+    if (GetUiColor(m_pBkColorData->m_strBkColor.c_str()).GetA() != 255) {
+        return false;
+    }
+    if (!m_pBkColorData->m_strBkColor2.empty()) {
+        UiColor dwBackColor2 = GetUiColor(m_pBkColorData->m_strBkColor2.c_str());
+        if (!dwBackColor2.IsEmpty() && (dwBackColor2.GetA() != 255)) {
+            return false;
+        }
+    }
+    //背景颜色的填充范围，与PaintBkColor函数保持一致
+    rcOpaque = GetRect();
+    if ((m_pBorderData != nullptr) && (m_pBorderData->m_rcBorderSize.left > 0.001f) &&
+        IsFloatEqual(m_pBorderData->m_rcBorderSize.left, m_pBorderData->m_rcBorderSize.right) &&
+        IsFloatEqual(m_pBorderData->m_rcBorderSize.left, m_pBorderData->m_rcBorderSize.top) &&
+        IsFloatEqual(m_pBorderData->m_rcBorderSize.left, m_pBorderData->m_rcBorderSize.bottom)) {
+        const int32_t nBorderSize = static_cast<int32_t>(m_pBorderData->m_rcBorderSize.left) / 2;
+        rcOpaque.Deflate(nBorderSize, nBorderSize, nBorderSize, nBorderSize);
+    }
+    return !rcOpaque.IsEmpty();
+}
+
+void Control::Invalidate()
+{
+    if (IsVisible()) {
+        MarkLayerDirty(GetRect(), true, nullptr);
+    }
+    BaseClass::Invalidate();
+}
+
+void Control::InvalidateRect(const UiRect& rc)
+{
+    if (IsVisible()) {
+        UiRect rcDirty = GetRect();
+        if (!rc.IsEmpty()) {
+            rcDirty.Intersect(rc);
+        }
+        MarkLayerDirty(rcDirty, true, nullptr);
+    }
+    BaseClass::InvalidateRect(rc);
+}
+
+void Control::InvalidateLayerComposite()
+{
+    if (IsVisible()) {
+        MarkLayerDirty(GetRect(), false, nullptr);
+    }
+    BaseClass::Invalidate();
+}
+
+void Control::MarkLayerDirty(const UiRect& rcDirty, bool bIncludeSelf, const UiPoint* pMoveOffset)
+{
+    if ((s_nLayerCount == 0) || rcDirty.IsEmpty()) {
+        return;
+    }
+    //rcDirty转换为客户区坐标，再转换为各个图层位图的坐标
+    const UiPoint scrollOffset = GetScrollOffsetInScrollBox();
+    Control* pLayer = bIncludeSelf ? this : GetParent();
+    for (; pLayer != nullptr; pLayer = pLayer->GetParent()) {
+        if (!pLayer->IsLayerEnabled()) {
+            continue;
+        }
+        if ((pMoveOffset != nullptr) && (pLayer->m_layerMoveOffset == *pMoveOffset)) {
+            //随图层整体平移
+            continue;
+        }
+        const UiRect& rcLayer = pLayer->GetRect();
+        const UiPoint layerOffset = pLayer->GetScrollOffsetInScrollBox();
+        UiRect rc = rcDirty;
+        rc.Offset(layerOffset.x - scrollOffset.x - rcLayer.left, layerOffset.y - scrollOffset.y - rcLayer.top);
+        if (rc.Intersect(UiRect(0, 0, rcLayer.Width(), rcLayer.Height()))) {
+            pLayer->m_rcLayerDirty.Union(rc);
+        }
+    }
+}
+
 IFont* Control::GetIFontById(const DString& strFontId) const
 {
-    return GlobalManager::Instance().Font().GetIFont(strFontId, this->Dpi());
+    return GlobalManager::Instance().Font().GetIFont(strFontId, this->Dpi().GetScale(), m_fontHandleCache);
 }
 
 bool Control::HasDestroyEventCallback() const
@@ -3758,8 +4040,7 @@ bool Control::HasDestroyEventCallback() const
     if (m_pEventMapData == nullptr) {
         return false;
     }
-    const EventMap& eventMap = m_pEventMapData->m_attachEvent;
-    return eventMap.find(kEventDestroy) != eventMap.end();
+    return m_pEventMapData->m_attachEvent.HasEvent(kEventDestroy);
 }
 
 EventMap& Control::GetAttachEventMap()
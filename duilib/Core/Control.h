@@ -5,6 +5,7 @@
 #include "duilib/Core/BoxShadow.h"
 #include "duilib/Utils/Delegate.h"
 #include "duilib/Core/Keyboard.h"
+#include "duilib/Core/FontManager.h"
 #include <map>
 #include <memory>
 
@@ -521,6 +522,15 @@ public:
      */
     virtual void SetPos(UiRect rc) override;
 
+    /** 重绘控件（如果控件自身或者父控件作为图层绘制，同时标记图层中需要重绘的区域）
+    */
+    virtual void Invalidate() override;
+
+    /** 重绘控件的指定区域（如果控件自身或者父控件作为图层绘制，同时标记图层中需要重绘的区域）
+    * @param [in] rc 需要重绘的区域
+    */
+    virtual void InvalidateRect(const UiRect& rc) override;
+
     /** 计算控件大小(宽和高)
         如果设置了图片并设置 width 或 height 任意一项为 auto，将根据图片大小和文本大小来计算最终大小
      *  @param [in] szAvailable 可用大小，不包含内边距，不包含外边距
@@ -734,6 +744,10 @@ public:
      */
     AnimationManager& GetAnimationManager();
 
+    /** @brief 是否有正在播放的动画（淡入淡出、鼠标悬停等）
+     */
+    bool IsAnimationPlaying() const;
+
     /// 图片缓存
     /**@brief 根据图片路径, 加载图片信息到缓存中。
      *        加载策略：如果图片没有加载则执行加载图片；如果图片路径发生变化，则重新加载该图片。
@@ -745,6 +759,11 @@ public:
      */
     virtual void ClearImageCache();
 
+    /** 获取已经加载了图片数据的图片（DPI变化时，用于预加载新DPI下的图片）
+    * @param [out] imageList 返回图片列表（追加到列表尾部）
+    */
+    virtual void GetLoadedImages(std::vector<Image*>& imageList) const;
+
     /** 屏幕坐标转换为客户区坐标
     */
     virtual bool ScreenToClient(UiPoint& pt);
@@ -759,6 +778,10 @@ public:
     */
     virtual void ChangeDpiScale(uint32_t nOldDpiScale, uint32_t nNewDpiScale);
 
+    /** 语言发生变化，更新控件大小和布局（仅调用过RegisterLangControl的控件会收到此通知）
+    */
+    virtual void OnLanguageChanged();
+
 public:
     /** 监听控件所有事件
      * @param[in] callback 事件处理的回调函数，请参考 EventCallback 声明
@@ -984,6 +1007,10 @@ protected:
     //处理放弃控件焦点相关逻辑 
     void EnsureNoFocus();
 
+    /** 注册为多语言控件（控件使用了多语言字符串ID时调用），切换语言时会调用OnLanguageChanged
+    */
+    void RegisterLangControl();
+
     /** 判断消息是否为应过滤掉的消息, 辅助函数
     *   如果当前控件是 !IsEnabled() || !IsMouseEnabled() || !IsKeyboardEnabled() 状态，
         并且消息是鼠标、键盘消息，返回true，否则返回false
@@ -1210,6 +1237,27 @@ public:
     */
     uint8_t GetPaintOrder() const;
 
+    /** 设置是否作为图层绘制：控件及其子控件绘制到持久保存的图层位图中，
+    *   位置、透明度、绘制偏移（比如淡入淡出、滑动动画）变化时只需要重新合成图层，内容变化时只重绘图层中的脏区域
+    * @param [in] bLayer true表示作为图层绘制，false表示直接绘制
+    */
+    void SetLayerEnabled(bool bLayer);
+
+    /** 是否作为图层绘制
+    */
+    bool IsLayerEnabled() const;
+
+    /** 获取控件绘制后完全不透明的区域（用于遮挡剔除：被完全覆盖的控件不需要绘制）
+    *   不透明的条件：设置了不透明的背景颜色，控件不透明，没有绘制偏移，没有圆角
+    * @param [out] rcOpaque 返回不透明的区域（与GetRect()的坐标系相同）
+    * @return 如果没有不透明的区域，返回false
+    */
+    virtual bool GetOpaqueRect(UiRect& rcOpaque) const;
+
+    /** 是否含有BoxShadow
+    */
+    bool HasBoxShadow() const;
+
     /** 获取一个字体ID对应的字体数据接口
     * @param[in] strFontId 要设置的字体ID，该字体ID必须在 global.xml 中存在
     * @return 成功返回字体接口，外部调用不需要释放资源；如果失败则返回nullptr
@@ -1222,10 +1270,6 @@ private:
     */
     UiColor GetUiColorByName(const DString& colorName) const;
 
-    /** 是否含有BoxShadow
-    */
-    bool HasBoxShadow() const;
-
     /** 设置控件状态的值，并触发状态变化事件
      * @param[in] controlState 要设置的控件状态，请参考 `ControlStateType` 枚举
      */
@@ -1235,6 +1279,26 @@ private:
     */
     int8_t GetColor2Direction(const UiString& bkColor2Direction) const;
 
+    /** 作为图层绘制：重绘图层中的脏区域，然后合成到目标上
+    * @return 如果图层不可用（比如超出图层内存上限），返回false
+    */
+    bool PaintLayer(IRender* pRender, const UiRect& rcPaint, bool bRoundClip);
+
+    /** 释放图层位图及其占用的内存
+    */
+    void ReleaseLayer();
+
+    /** 标记图层中需要重绘的区域（逐级标记作为图层绘制的控件）
+    * @param [in] rcDirty 需要重绘的区域（与GetRect()的坐标系相同）
+    * @param [in] bIncludeSelf 是否标记控件自身的图层
+    * @param [in] pMoveOffset 控件位置的平移量（仅平移时有效），与图层的平移量相同时，图层内容不变，不需要标记
+    */
+    void MarkLayerDirty(const UiRect& rcDirty, bool bIncludeSelf, const UiPoint* pMoveOffset);
+
+    /** 仅合成变化（透明度、绘制偏移）时的重绘：图层内容不变，只标记父控件图层
+    */
+    void InvalidateLayerComposite();
+
 private:
     /** 获取AttachXXX接口的监听事件管理器
     */
@@ -1380,6 +1444,18 @@ private:
     /** 控件播放动画时的渲染偏移(X坐标偏移和Y坐标偏移)
     */
     UiPoint m_renderOffset;
+
+    /** 图层中需要重绘的区域（图层位图的坐标系）
+    */
+    UiRect m_rcLayerDirty;
+
+    /** 图层最近一次平移的偏移量（子控件随图层整体平移时，图层内容不变），绘制后清零
+    */
+    UiPoint m_layerMoveOffset;
+
+    /** 图层位图占用的内存（单位：字节）
+    */
+    size_t m_nLayerBytes;
     
     /** 控件的绘制区域
     */
@@ -1397,6 +1473,10 @@ private:
     */
     size_t m_uUserDataID;
 
+    /** 字体句柄缓存(GetIFontById使用，避免每次绘制文字时按字体ID字符串查找字体)
+    */
+    mutable FontHandleCache m_fontHandleCache;
+
 private:
     /** 边框圆角大小(与m_rcBorderSize联合应用)或者阴影的圆角大小(与m_boxShadow联合应用)
         仅当 m_rcBorderSize 四个边框值都有效, 并且都相同时
@@ -1441,6 +1521,12 @@ private:
 
     //边框是否在顶层（即先绘制子控件，后绘制边框，避免边框被子控件覆盖）
     bool m_bBordersOnTop;
+
+    //是否作为图层绘制
+    bool m_bLayerEnabled;
+
+    //是否已经注册为多语言控件
+    bool m_bLangControl;
 };
 
 } // namespace ui
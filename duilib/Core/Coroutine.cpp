@@ -0,0 +1,89 @@
+#include "Coroutine.h"
+#include "duilib/Core/GlobalManager.h"
+
+namespace ui
+{
+void UiTaskPromise::unhandled_exception() noexcept
+{
+    //协程中不允许抛出异常
+    ASSERT(0);
+}
+
+void UiTaskPromise::BindWeakFlag(const std::weak_ptr<WeakFlag>& weakFlag)
+{
+    m_weakFlag = weakFlag;
+    m_bHasWeakFlag = true;
+}
+
+bool UiTaskPromise::IsCancelled() const
+{
+    return m_bHasWeakFlag && m_weakFlag.expired();
+}
+
+void UiTaskPromise::Resume(UiTaskHandle handle)
+{
+    if (handle.promise().IsCancelled()) {
+        //绑定的对象已经销毁，销毁协程（协程内的局部变量正常析构）
+        handle.destroy();
+    }
+    else {
+        handle.resume();
+    }
+}
+
+int32_t GetCoroutineResumeThread()
+{
+    int32_t nThreadIdentifier = GlobalManager::Instance().Thread().GetCurrentThreadIdentifier();
+    if (nThreadIdentifier == kThreadNone) {
+        nThreadIdentifier = kThreadUI;
+    }
+    return nThreadIdentifier;
+}
+
+ResumeOnAwaiter::ResumeOnAwaiter(int32_t nThreadIdentifier):
+    m_nThreadIdentifier(nThreadIdentifier)
+{
+}
+
+bool ResumeOnAwaiter::await_ready() const
+{
+    //已经在目标线程中，不需要切换线程
+    return GlobalManager::Instance().Thread().GetCurrentThreadIdentifier() == m_nThreadIdentifier;
+}
+
+void ResumeOnAwaiter::await_suspend(UiTaskHandle handle) const
+{
+    size_t nTaskId = GlobalManager::Instance().Thread().PostTask(m_nThreadIdentifier, [handle]() {
+            UiTaskPromise::Resume(handle);
+        });
+    if (nTaskId == 0) {
+        //目标线程不存在，取消协程
+        handle.destroy();
+    }
+}
+
+DelayAwaiter::DelayAwaiter(uint32_t nDelayMs):
+    m_nDelayMs(nDelayMs)
+{
+}
+
+void DelayAwaiter::await_suspend(UiTaskHandle handle) const
+{
+    //定时器回调在UI线程中执行，如果协程在其他线程中等待，需要切换回原线程
+    const int32_t nThreadIdentifier = GetCoroutineResumeThread();
+    auto timerCallback = [handle, nThreadIdentifier]() {
+            if (nThreadIdentifier == kThreadUI) {
+                UiTaskPromise::Resume(handle);
+            }
+            else if (GlobalManager::Instance().Thread().PostTask(nThreadIdentifier, [handle]() { UiTaskPromise::Resume(handle); }) == 0) {
+                handle.destroy();
+            }
+        };
+    TimerManager& timerManager = GlobalManager::Instance().Timer();
+    size_t nTimerId = timerManager.AddTimer(timerManager.GetWeakFlag(), timerCallback, (m_nDelayMs > 0) ? m_nDelayMs : 1, 1);
+    if (nTimerId == 0) {
+        handle.destroy();
+    }
+}
+
+}//namespace ui
@@ -0,0 +1,215 @@
+#ifndef UI_CORE_COROUTINE_H_
+#define UI_CORE_COROUTINE_H_
+
+#include "duilib/Core/ThreadManager.h"
+#include <coroutine>
+#include <type_traits>
+
+namespace ui
+{
+class UiTaskPromise;
+
+/** 协程句柄类型
+*/
+typedef std::coroutine_handle<UiTaskPromise> UiTaskHandle;
+
+/** UI协程任务（C++20协程的返回类型），协程在调用时立即开始执行，执行完成后自动释放
+*   在协程中可使用以下等待操作：
+*       co_await ui::ResumeOn(ui::kThreadWorker);   //切换到工作线程继续执行
+*       co_await ui::ResumeOn(ui::kThreadUI);       //切换到UI线程继续执行
+*       co_await ui::DelayFor(100);                 //等待100毫秒后，在原线程继续执行
+*       auto value = co_await taskFuture;           //等待异步任务(TaskFuture)完成，在原线程继续执行
+*   自动取消机制：如果协程的第一个Control/Window(或其他SupportWeakCallback的子类)类型的参数（对于成员函数，即this对象）已经销毁，
+*               协程在下一次恢复执行时自动取消（协程内的局部变量正常析构）
+*   示例：
+*       ui::UiTask MyForm::LoadImageAsync(ui::FilePath filePath)
+*       {
+*           co_await ui::ResumeOn(ui::kThreadWorker);
+*           std::vector<uint8_t> fileData;
+*           ui::FileUtil::ReadFileData(filePath, fileData);
+*           co_await ui::ResumeOn(ui::kThreadUI);
+*           //此处MyForm对象一定有效（如果窗口已经关闭，协程已经自动取消）
+*           ...
+*       }
+*/
+class UILIB_API UiTask
+{
+public:
+    typedef UiTaskPromise promise_type;
+};
+
+/** UI协程任务的promise类型
+*/
+class UILIB_API UiTaskPromise
+{
+public:
+    UiTaskPromise() = default;
+
+    /** 根据协程的参数构造，使用第一个支持weak_ptr回调的参数，作为自动取消的标志
+    */
+    template<typename TFirst, typename... Args>
+    explicit UiTaskPromise(TFirst& first, Args&... args)
+    {
+        TryBindWeakFlag(first);
+        (TryBindWeakFlag(args), ...);
+    }
+
+public:
+    UiTask get_return_object() noexcept { return UiTask(); }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept;
+
+public:
+    /** 绑定自动取消的标志，标志失效后协程不再恢复执行
+    */
+    void BindWeakFlag(const std::weak_ptr<WeakFlag>& weakFlag);
+
+    /** 协程是否已经取消（绑定的对象已经销毁）
+    */
+    bool IsCancelled() const;
+
+    /** 恢复协程的执行：如果协程已经取消，则销毁协程
+    */
+    static void Resume(UiTaskHandle handle);
+
+private:
+    template<typename T>
+    void TryBindWeakFlag(T& arg)
+    {
+        typedef typename std::remove_cv<typename std::remove_pointer<T>::type>::type ObjectType;
+        if (m_bHasWeakFlag || !std::is_base_of<SupportWeakCallback, ObjectType>::value) {
+            return;
+        }
+        if constexpr (std::is_base_of<SupportWeakCallback, ObjectType>::value) {
+            if constexpr (std::is_pointer<T>::value) {
+                if (arg != nullptr) {
+                    BindWeakFlag(const_cast<ObjectType*>(arg)->GetWeakFlag());
+                }
+            }
+            else {
+                BindWeakFlag(const_cast<ObjectType&>(arg).GetWeakFlag());
+            }
+        }
+    }
+
+private:
+    /** 自动取消的标志
+    */
+    std::weak_ptr<WeakFlag> m_weakFlag;
+
+    /** 是否绑定了自动取消的标志
+    */
+    bool m_bHasWeakFlag = false;
+};
+
+/** 切换线程的等待对象：co_await ResumeOn(nThreadIdentifier)
+*/
+class UILIB_API ResumeOnAwaiter
+{
+public:
+    explicit ResumeOnAwaiter(int32_t nThreadIdentifier);
+
+    bool await_ready() const;
+    void await_suspend(UiTaskHandle handle) const;
+    void await_resume() const noexcept {}
+
+private:
+    /** 目标线程的线程标识ID
+    */
+    int32_t m_nThreadIdentifier;
+};
+
+/** 切换到指定线程继续执行协程（如果当前已经在该线程中，则直接继续执行）
+* @param [in] nThreadIdentifier 线程标识ID，比如kThreadUI、kThreadWorker、kThreadPool等
+*/
+inline ResumeOnAwaiter ResumeOn(int32_t nThreadIdentifier)
+{
+    return ResumeOnAwaiter(nThreadIdentifier);
+}
+
+/** 延迟的等待对象：co_await DelayFor(nDelayMs)
+*/
+class UILIB_API DelayAwaiter
+{
+public:
+    explicit DelayAwaiter(uint32_t nDelayMs);
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(UiTaskHandle handle) const;
+    void await_resume() const noexcept {}
+
+private:
+    /** 延迟的时间（单位：毫秒）
+    */
+    uint32_t m_nDelayMs;
+};
+
+/** 延迟一段时间后，在原线程中继续执行协程（基于TimerManager实现）
+* @param [in] nDelayMs 延迟的时间（单位：毫秒）
+*/
+inline DelayAwaiter DelayFor(uint32_t nDelayMs)
+{
+    return DelayAwaiter(nDelayMs);
+}
+
+/** 获取恢复协程所用的线程标识ID（当前线程，如果当前线程不是注册的线程，则使用UI线程）
+*/
+UILIB_API int32_t GetCoroutineResumeThread();
+
+/** 异步任务的等待对象：co_await taskFuture
+*/
+template<typename T>
+class TaskFutureAwaiter
+{
+public:
+    explicit TaskFutureAwaiter(const TaskFuture<T>& future):
+        m_future(future)
+    {
+    }
+
+    bool await_ready() const
+    {
+        return m_future.IsReady();
+    }
+
+    void await_suspend(UiTaskHandle handle) const
+    {
+        ASSERT(m_future.IsValid());
+        if (!m_future.IsValid()) {
+            //任务发送失败，结果永远不会就绪，取消协程
+            handle.destroy();
+            return;
+        }
+        m_future.Then(GetCoroutineResumeThread(), [handle](const auto&... /*value*/) {
+                UiTaskPromise::Resume(handle);
+            });
+    }
+
+    decltype(auto) await_resume() const
+    {
+        if constexpr (std::is_void<T>::value) {
+            m_future.Wait();
+        }
+        else {
+            return m_future.Get();
+        }
+    }
+
+private:
+    /** 等待的异步任务
+    */
+    TaskFuture<T> m_future;
+};
+
+/** 支持在UI协程中等待异步任务：auto value = co_await taskFuture;
+*/
+template<typename T>
+TaskFutureAwaiter<T> operator co_await(const TaskFuture<T>& future)
+{
+    return TaskFutureAwaiter<T>(future);
+}
+
+}
+#endif //UI_CORE_COROUTINE_H_
@@ -9,6 +9,7 @@ namespace ui
 {
 
 FontManager::FontManager():
+    m_nGeneration(1),
     m_bDefaultFontInited(false)
 {
 }
@@ -44,6 +45,9 @@ bool FontManager::AddFont(const DString& fontId, const UiFont& fontInfo, bool bD
         //默认字体ID
         m_defaultFontId = fontId;
     }
+    //该字体ID原来可能指向默认字体，需要重新解析
+    RemoveFontAliases();
+    ++m_nGeneration;
     return true;
 }
 
@@ -69,11 +73,7 @@ void FontManager::SetDefaultFontFamilyNames(const DString& defaultFontFamilyName
 
 DString FontManager::GetDpiFontId(const DString& fontId, uint32_t nZoomPercent) const
 {
-    DString dpiFontId;
-    if (!fontId.empty()) {
-        dpiFontId = fontId + _T("@") + StringUtil::UInt32ToString(nZoomPercent);
-    }
-    return dpiFontId;
+    return fontId + _T("@") + StringUtil::UInt32ToString(nZoomPercent);
 }
 
 IFont* FontManager::GetIFont(const DString& fontId, const DpiManager& dpi)
@@ -82,58 +82,104 @@ IFont* FontManager::GetIFont(const DString& fontId, const DpiManager& dpi)
 }
 
 IFont* FontManager::GetIFont(const DString& fontId, uint32_t nZoomPercent)
+{
+    return GetIFontByHandle(GetFontHandle(fontId, nZoomPercent));
+}
+
+IFont* FontManager::GetIFont(const DString& fontId, uint32_t nZoomPercent, FontHandleCache& cache)
+{
+    if ((cache.m_nGeneration != m_nGeneration) ||
+        (cache.m_nZoomPercent != nZoomPercent) ||
+        (cache.m_fontId != fontId)) {
+        cache.m_nFontHandle = GetFontHandle(fontId, nZoomPercent);
+        cache.m_nGeneration = m_nGeneration;
+        cache.m_nZoomPercent = nZoomPercent;
+        cache.m_fontId = fontId;
+    }
+    return GetIFontByHandle(cache.m_nFontHandle);
+}
+
+uint32_t FontManager::GetFontHandle(const DString& fontId, uint32_t nZoomPercent)
 {
     ASSERT(nZoomPercent != 0);
     if (nZoomPercent == 0) {
         nZoomPercent = 100;
     }
     //先在缓存中查找
-    IFont* pFont = nullptr;
-    if (!fontId.empty()) {        
-        DString dpiFontId = GetDpiFontId(fontId, nZoomPercent);
-        auto iter = m_fontMap.find(dpiFontId);
-        if (iter != m_fontMap.end()) {
-            pFont = iter->second;
-        }
-    }
-    if (pFont == nullptr) {
-        auto iter = m_fontIdMap.find(fontId);
-        if ((iter == m_fontIdMap.end()) && !m_defaultFontId.empty()) {
-            //没有这个字体ID，使用默认的字体ID
-            DString dpiFontId = GetDpiFontId(m_defaultFontId, nZoomPercent);
-            auto pos = m_fontMap.find(dpiFontId);
-            if (pos != m_fontMap.end()) {
-                pFont = pos->second;
-            }
-        }
-    }
-    if (pFont != nullptr) {
-        //使用缓存中已经创建好的字体数据
-        return pFont;
+    const DString dpiFontId = GetDpiFontId(fontId, nZoomPercent);
+    auto iter = m_fontHandleMap.find(dpiFontId);
+    if (iter != m_fontHandleMap.end()) {
+        return iter->second;
     }
 
-    //缓存中不存在，需要创建字体
-    UiFont fontInfo;
     DString realFontId = fontId;
-    auto iter = m_fontIdMap.find(realFontId);
-    if (iter == m_fontIdMap.end()) {
+    if (m_fontIdMap.find(realFontId) == m_fontIdMap.end()) {
+        //没有这个字体ID，使用默认的字体ID
         realFontId = m_defaultFontId;
-        iter = m_fontIdMap.find(realFontId);
-        if (iter != m_fontIdMap.end()) {
-            fontInfo = iter->second;
-        }
-        else {
+        if (m_fontIdMap.find(realFontId) == m_fontIdMap.end()) {
             realFontId.clear();
         }
     }
-    else {
-        fontInfo = iter->second;
-    }
     ASSERT(!realFontId.empty());
     if (realFontId.empty()) {
         //无此字体ID
+        return InvalidFontHandle;
+    }
+
+    uint32_t nFontHandle = InvalidFontHandle;
+    const DString realDpiFontId = GetDpiFontId(realFontId, nZoomPercent);
+    iter = m_fontHandleMap.find(realDpiFontId);
+    if (iter != m_fontHandleMap.end()) {
+        nFontHandle = iter->second;
+    }
+    else {
+        //分配新的字体句柄，字体数据在首次使用时创建
+        if (!m_freeFontHandles.empty()) {
+            nFontHandle = m_freeFontHandles.back();
+            m_freeFontHandles.pop_back();
+        }
+        else {
+            nFontHandle = (uint32_t)m_fontHandles.size();
+            m_fontHandles.push_back(FontHandleData());
+        }
+        FontHandleData& handleData = m_fontHandles[nFontHandle];
+        handleData.m_fontId = realFontId;
+        handleData.m_nZoomPercent = nZoomPercent;
+        handleData.m_pFont = nullptr;
+        m_fontHandleMap[realDpiFontId] = nFontHandle;
+    }
+    if (realFontId != fontId) {
+        //字体ID的别名，指向默认字体
+        m_fontHandleMap[dpiFontId] = nFontHandle;
+    }
+    return nFontHandle;
+}
+
+IFont* FontManager::GetIFontByHandle(uint32_t nFontHandle)
+{
+    if (nFontHandle >= m_fontHandles.size()) {
+        return nullptr;
+    }
+    FontHandleData& handleData = m_fontHandles[nFontHandle];
+    if ((handleData.m_pFont == nullptr) && !handleData.m_fontId.empty()) {
+        handleData.m_pFont = CreateIFont(handleData.m_fontId, handleData.m_nZoomPercent);
+    }
+    return handleData.m_pFont;
+}
+
+uint32_t FontManager::GetFontGeneration() const
+{
+    return m_nGeneration;
+}
+
+IFont* FontManager::CreateIFont(const DString& fontId, uint32_t nZoomPercent)
+{
+    auto iter = m_fontIdMap.find(fontId);
+    ASSERT(iter != m_fontIdMap.end());
+    if (iter == m_fontIdMap.end()) {
         return nullptr;
     }
+    UiFont fontInfo = iter->second;
     IRenderFactory* pRenderFactory = GlobalManager::Instance().GetRenderFactory();
     ASSERT(pRenderFactory != nullptr);
     if (pRenderFactory == nullptr) {
@@ -160,7 +206,6 @@ IFont* FontManager::GetIFont(const DString& fontId, uint32_t nZoomPercent)
         }
     }
 
-    DString dpiFontId = GetDpiFontId(realFontId, nZoomPercent);
     if (fontInfo.m_fontName.empty() || 
         StringUtil::IsEqualNoCase(fontInfo.m_fontName.c_str(), _T("system"))) {
         if (!m_defaultFontFamilyNames.empty()) {
@@ -180,7 +225,7 @@ IFont* FontManager::GetIFont(const DString& fontId, uint32_t nZoomPercent)
         }
     }
 
-    pFont = pRenderFactory->CreateIFont();
+    IFont* pFont = pRenderFactory->CreateIFont();
     ASSERT(pFont != nullptr);
     if (pFont == nullptr) {
         return nullptr;
@@ -192,10 +237,38 @@ IFont* FontManager::GetIFont(const DString& fontId, uint32_t nZoomPercent)
         pFont = nullptr;
         return nullptr;
     }
-    m_fontMap.insert(std::make_pair(dpiFontId, pFont));
     return pFont;
 }
 
+void FontManager::FreeFontHandle(uint32_t nFontHandle)
+{
+    ASSERT(nFontHandle < m_fontHandles.size());
+    if (nFontHandle >= m_fontHandles.size()) {
+        return;
+    }
+    FontHandleData& handleData = m_fontHandles[nFontHandle];
+    if (handleData.m_pFont != nullptr) {
+        delete handleData.m_pFont;//IFont指针
+        handleData.m_pFont = nullptr;
+    }
+    handleData.m_fontId.clear();
+    m_freeFontHandles.push_back(nFontHandle);
+}
+
+void FontManager::RemoveFontAliases()
+{
+    auto iter = m_fontHandleMap.begin();
+    while (iter != m_fontHandleMap.end()) {
+        const FontHandleData& handleData = m_fontHandles[iter->second];
+        if (iter->first != GetDpiFontId(handleData.m_fontId, handleData.m_nZoomPercent)) {
+            iter = m_fontHandleMap.erase(iter);
+        }
+        else {
+            ++iter;
+        }
+    }
+}
+
 bool FontManager::HasFontId(const DString& fontId) const
 {
     auto pos = m_fontIdMap.find(fontId);
@@ -210,19 +283,24 @@ bool FontManager::RemoveFontId(const DString& fontId)
         return false;
     }
     bool bDeleted = false;
-    const DString zoomFontId = fontId + _T("@");
-    auto iter = m_fontMap.begin();
-    while (iter != m_fontMap.end()) {
-        if (iter->first.find(zoomFontId) == 0) {
+    const uint32_t nHandleCount = (uint32_t)m_fontHandles.size();
+    for (uint32_t nFontHandle = 0; nFontHandle < nHandleCount; ++nFontHandle) {
+        if (m_fontHandles[nFontHandle].m_fontId == fontId) {
             //匹配到字体ID
-            if (iter->second != nullptr) {
-                delete iter->second;//IFont指针
-            }
+            FreeFontHandle(nFontHandle);
             bDeleted = true;
-            iter = m_fontMap.erase(iter);
         }
-        else {
-            ++iter;
+    }
+    if (bDeleted) {
+        //删除指向已释放句柄的映射
+        auto iter = m_fontHandleMap.begin();
+        while (iter != m_fontHandleMap.end()) {
+            if (m_fontHandles[iter->second].m_fontId.empty()) {
+                iter = m_fontHandleMap.erase(iter);
+            }
+            else {
+                ++iter;
+            }
         }
     }
     auto pos = m_fontIdMap.find(fontId);
@@ -230,6 +308,9 @@ bool FontManager::RemoveFontId(const DString& fontId)
         m_fontIdMap.erase(pos);
         bDeleted = true;
     }
+    if (bDeleted) {
+        ++m_nGeneration;
+    }
     return bDeleted;
 }
 
@@ -237,15 +318,15 @@ bool FontManager::RemoveIFont(const DString& fontId, uint32_t nZoomPercent)
 {
     bool bDeleted = false;
     if (!fontId.empty()) {
-        DString realFontId = GetDpiFontId(fontId, nZoomPercent);
-        auto iter = m_fontMap.find(realFontId);
-        if (iter != m_fontMap.end()) {
-            //匹配到字体ID
-            if (iter->second != nullptr) {
-                delete iter->second;//IFont指针
+        auto iter = m_fontHandleMap.find(GetDpiFontId(fontId, nZoomPercent));
+        if (iter != m_fontHandleMap.end()) {
+            //匹配到字体ID（句柄仍然有效，字体数据在下次使用时重新创建）
+            FontHandleData& handleData = m_fontHandles[iter->second];
+            if ((handleData.m_fontId == fontId) && (handleData.m_pFont != nullptr)) {
+                delete handleData.m_pFont;//IFont指针
+                handleData.m_pFont = nullptr;
+                bDeleted = true;
             }
-            bDeleted = true;
-            m_fontMap.erase(iter);
         }
     }
     return bDeleted;
@@ -253,15 +334,18 @@ bool FontManager::RemoveIFont(const DString& fontId, uint32_t nZoomPercent)
 
 void FontManager::RemoveAllFonts()
 {
-    for (auto fontInfo : m_fontMap) {
-        IFont* pFont = fontInfo.second;
-        if (pFont != nullptr) {
-            delete pFont;
+    for (FontHandleData& handleData : m_fontHandles) {
+        if (handleData.m_pFont != nullptr) {
+            delete handleData.m_pFont;
+            handleData.m_pFont = nullptr;
         }
     }
-    m_fontMap.clear();
+    m_fontHandles.clear();
+    m_freeFontHandles.clear();
+    m_fontHandleMap.clear();
     m_defaultFontId.clear();
     m_fontIdMap.clear();
+    ++m_nGeneration;
 
     IFontMgr* pFontMgr = nullptr;
     IRenderFactory* pRenderFactory = GlobalManager::Instance().GetRenderFactory();
@@ -20,6 +20,17 @@ struct FontSizeInfo
     float fDpiFontSize = 0; //单位：像素，已做DPI自适应
 };
 
+/** 字体句柄缓存：保存字体ID解析后的字体句柄，字体ID、缩放比例和字体代数都未变化时，
+*   直接按句柄获取字体接口，避免每次按字符串查找
+*/
+struct FontHandleCache
+{
+    UiString m_fontId;              //字体ID
+    uint32_t m_nZoomPercent = 0;    //字体大小缩放百分比
+    uint32_t m_nGeneration = 0;     //解析字体句柄时的字体代数
+    uint32_t m_nFontHandle = (uint32_t)-1;  //字体句柄
+};
+
 /** 字体管理器
 */
 class UILIB_API FontManager
@@ -52,6 +63,36 @@ public:
     */
     IFont* GetIFont(const DString& fontId, uint32_t nZoomPercent);
 
+    /** 获取字体接口, 优先使用缓存中的字体句柄，缓存失效时重新解析字体句柄并更新缓存
+    * @param [in] fontId 字体ID
+    * @param [in] nZoomPercent 字体大小缩放百分比，用于对字体大小进行缩放，举例：100代表100%，200代表200%
+    * @param [in,out] cache 字体句柄缓存（一般保存在控件中）
+    * @return 成功返回字体接口，外部调用不需要释放资源；如果失败则返回nullptr
+    */
+    IFont* GetIFont(const DString& fontId, uint32_t nZoomPercent, FontHandleCache& cache);
+
+public:
+    /** 无效的字体句柄
+    */
+    static constexpr uint32_t InvalidFontHandle = (uint32_t)-1;
+
+    /** 获取字体句柄（字体ID与缩放比例对应的整型索引号），如果找不到字体ID，那么使用m_defaultFontId字体
+    * @param [in] fontId 字体ID
+    * @param [in] nZoomPercent 字体大小缩放百分比，举例：100代表100%，200代表200%
+    * @return 成功返回字体句柄，失败返回InvalidFontHandle；字体代数变化后，原来的句柄需要重新获取
+    */
+    uint32_t GetFontHandle(const DString& fontId, uint32_t nZoomPercent);
+
+    /** 按字体句柄获取字体接口（直接按数组下标访问，字体数据在首次使用时创建）
+    * @param [in] nFontHandle 字体句柄，由GetFontHandle函数返回
+    * @return 成功返回字体接口，外部调用不需要释放资源；如果失败则返回nullptr
+    */
+    IFont* GetIFontByHandle(uint32_t nFontHandle);
+
+    /** 获取字体代数：添加或者删除字体ID时递增，用于判断已保存的字体句柄是否仍然有效
+    */
+    uint32_t GetFontGeneration() const;
+
     /** 是否包含该字体ID
     * @param [in] fontId 指定字体的ID标记
     */
@@ -111,14 +152,47 @@ private:
     */
     DString GetDpiFontId(const DString& fontId, uint32_t nZoomPercent) const;
 
+    /** 按字体ID和缩放比例创建字体接口
+    */
+    IFont* CreateIFont(const DString& fontId, uint32_t nZoomPercent);
+
+    /** 释放一个字体句柄（句柄号放入空闲列表，可被重新分配）
+    */
+    void FreeFontHandle(uint32_t nFontHandle);
+
+    /** 删除所有字体ID的别名（找不到字体ID时，指向默认字体的句柄映射）
+    */
+    void RemoveFontAliases();
+
 private:
+    /** 字体句柄对应的数据
+    */
+    struct FontHandleData
+    {
+        DString m_fontId;           //实际的字体ID，为空表示句柄已释放
+        uint32_t m_nZoomPercent;    //字体大小缩放百分比
+        IFont* m_pFont;             //字体接口，首次使用时创建
+    };
+
     /** 自定义字体数据：Key时FontID，Value是字体描述信息
     */
     std::unordered_map<DString, UiFont> m_fontIdMap;
 
-    /** 自定义字体信息：Key是FontId
+    /** 字体句柄映射：Key是"字体ID@缩放比例"，Value是字体句柄
+    */
+    std::unordered_map<DString, uint32_t> m_fontHandleMap;
+
+    /** 字体句柄表，下标是字体句柄
+    */
+    std::vector<FontHandleData> m_fontHandles;
+
+    /** 已释放的字体句柄
+    */
+    std::vector<uint32_t> m_freeFontHandles;
+
+    /** 字体代数
     */
-    std::unordered_map<DString, IFont*> m_fontMap;
+    uint32_t m_nGeneration;
 
     /** 默认字体ID
     */
@@ -16,6 +16,7 @@ namespace ui
 */
 enum ThreadIdentifier
 {
+    kThreadPool     = -2,   //线程池(多个工作线程，任务窃取调度，需调用ThreadManager::StartThreadPool启动)
     kThreadNone     = -1,   //无线程标识ID
     kThreadUI       = 0,    //UI线程
     kThreadWorker   = 1,    //工作线程(duilib库内部用该线程加载多帧图片)
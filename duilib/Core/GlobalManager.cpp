@@ -20,7 +20,10 @@ namespace ui
 {
 
 GlobalManager::GlobalManager():
-    m_platformData(nullptr)
+    m_platformData(nullptr),
+    m_nLayerMemoryLimit(256 * 1024 * 1024),
+    m_nLayerMemoryUsage(0),
+    m_nRasterTileCount(0)
 {
 }
 
@@ -326,22 +329,18 @@ bool GlobalManager::ReloadLanguage(const FilePath& languagePath,
 
     ASSERT(bReadOk && "ReloadLanguage");
     if (bReadOk && bInvalidate) {
-        //刷新界面显示
+        //更新窗口标题栏文本
         std::vector<WindowWeakFlag> windowList = m_windowList;
         for (const WindowWeakFlag& windowFlag : windowList) {
-            Box* pBox = nullptr;
             if ((windowFlag.m_pWindow != nullptr) && !windowFlag.m_weakFlag.expired()) {
-                pBox = windowFlag.m_pWindow->GetRoot();
                 if (windowFlag.m_pWindow->GetText().empty() && 
                     !windowFlag.m_pWindow->GetTextId().empty()) {
-                    //更新窗口标题栏文本
                     windowFlag.m_pWindow->SetTextId(windowFlag.m_pWindow->GetTextId());
                 }
             }
-            if ((pBox != nullptr) && !windowFlag.m_weakFlag.expired()) {
-                pBox->Invalidate();
-            }
         }
+        //只更新使用了多语言字符串ID的控件（重新计算大小和重绘），其他控件不受影响
+        m_langManager.NotifyLanguageChanged();
     }
     return bReadOk;
 }
@@ -566,6 +565,48 @@ void GlobalManager::RemoveAllClasss()
     m_globalClass.clear();
 }
 
+void GlobalManager::SetLayerMemoryLimit(size_t nLimitBytes)
+{
+    m_nLayerMemoryLimit = nLimitBytes;
+}
+
+size_t GlobalManager::GetLayerMemoryLimit() const
+{
+    return m_nLayerMemoryLimit;
+}
+
+size_t GlobalManager::GetLayerMemoryUsage() const
+{
+    return m_nLayerMemoryUsage;
+}
+
+bool GlobalManager::AllocLayerMemory(size_t nBytes)
+{
+    AssertUIThread();
+    if ((m_nLayerMemoryUsage + nBytes) > m_nLayerMemoryLimit) {
+        return false;
+    }
+    m_nLayerMemoryUsage += nBytes;
+    return true;
+}
+
+void GlobalManager::FreeLayerMemory(size_t nBytes)
+{
+    AssertUIThread();
+    ASSERT(m_nLayerMemoryUsage >= nBytes);
+    m_nLayerMemoryUsage -= std::min(m_nLayerMemoryUsage, nBytes);
+}
+
+void GlobalManager::SetRasterTileCount(uint32_t nTileCount)
+{
+    m_nRasterTileCount = nTileCount;
+}
+
+uint32_t GlobalManager::GetRasterTileCount() const
+{
+    return m_nRasterTileCount;
+}
+
 ColorManager& GlobalManager::Color()
 {
     return m_colorManager;
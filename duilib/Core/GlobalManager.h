@@ -124,6 +124,7 @@ public:
                    如果为相对路径，则对应于压缩包中的相对路径
      * @param [in] languageFileName 当前使用语言文件的文件名（不含路径）
      * @param [in] bInvalidate 是否刷新界面显示：true表示更新完语言文件后刷新界面显示，false表示不刷新界面显示
+     *             刷新时只更新使用了多语言字符串ID的控件（重新计算大小和重绘），语言文件加载失败时保留原来的语言
      */
     bool ReloadLanguage(const FilePath& languagePath = FilePath(),
                         const DString& languageFileName = _T("zh_CN.txt"),
@@ -170,6 +171,41 @@ public:
      */
     void RemoveAllClasss();
 
+public:
+    /** 设置图层位图占用内存的上限（所有窗口的图层控件共享），超出上限时，图层控件不保留图层位图，直接绘制
+    * @param [in] nLimitBytes 内存上限（单位：字节）
+    */
+    void SetLayerMemoryLimit(size_t nLimitBytes);
+
+    /** 获取图层位图占用内存的上限（单位：字节）
+    */
+    size_t GetLayerMemoryLimit() const;
+
+    /** 获取图层位图当前占用的内存（单位：字节）
+    */
+    size_t GetLayerMemoryUsage() const;
+
+    /** 申请图层位图的内存（控件内部调用）
+    * @param [in] nBytes 需要的内存（单位：字节）
+    * @return 未超出上限返回true，超出上限返回false
+    */
+    bool AllocLayerMemory(size_t nBytes);
+
+    /** 释放图层位图的内存（控件内部调用）
+    * @param [in] nBytes 释放的内存（单位：字节）
+    */
+    void FreeLayerMemory(size_t nBytes);
+
+    /** 设置大面积绘制时（比如窗口大小变化、切换主题）并行光栅化的分块数，仅CPU绘制时有效
+    *   绘制时先录制绘制命令，再分块在线程池中并行光栅化，需要先启动线程池（ThreadManager::StartThreadPool）
+    * @param [in] nTileCount 分块数，0或者1表示不启用（默认不启用）
+    */
+    void SetRasterTileCount(uint32_t nTileCount);
+
+    /** 获取大面积绘制时并行光栅化的分块数
+    */
+    uint32_t GetRasterTileCount() const;
+
 public:
     /** 获取绘制接口类对象
     */
@@ -383,6 +419,15 @@ private:
     /** 退出时要执行的函数
     */
     std::vector<std::function<void()>> m_atExitFunctions;
+
+    /** 图层位图占用内存的上限和当前占用的内存
+    */
+    size_t m_nLayerMemoryLimit;
+    size_t m_nLayerMemoryUsage;
+
+    /** 大面积绘制时并行光栅化的分块数
+    */
+    uint32_t m_nRasterTileCount;
 };
 
 } // namespace ui
@@ -4,6 +4,7 @@
 #include "duilib/Core/GlobalManager.h"
 #include "duilib/Core/DpiManager.h"
 #include "duilib/Core/Window.h"
+#include "duilib/Core/Box.h"
 #include "duilib/Utils/StringUtil.h"
 #include "duilib/Utils/FileUtil.h"
 
@@ -15,7 +16,7 @@ namespace ui
 struct LoadImageParam
 {
     explicit LoadImageParam(const ImageLoadAttribute& loadAtrribute):
-        m_nThreadIdentifier(-1),
+        m_nThreadIdentifier(kThreadNone),
         m_nFrameCount(0),
         m_imageLoadAtrribute(loadAtrribute),
         m_bEnableImageDpiScale(false),
@@ -32,9 +33,37 @@ struct LoadImageParam
     uint32_t m_nWindowDpiScale;
 };
 
+/** 一次预加载的所有图片（窗口DPI变化时提交的一批图片）
+*/
+struct PrefetchImageBatch
+{
+    Window* m_pWindow = nullptr;
+    std::weak_ptr<WeakFlag> m_windowFlag;   //窗口的生命周期标志
+    size_t m_nPendingCount = 0;             //尚未完成的图片个数
+    std::vector<std::shared_ptr<ImageInfo>> m_savedImages; //已经保存到缓存中的图片
+};
+
+/** 预加载的图片（窗口DPI变化时，在线程池中解码新DPI下的图片）
+*/
+struct ImageManager::PrefetchImageItem
+{
+    DString m_loadKey;
+    DString m_imageKey;
+    uint32_t m_nWindowDpiScale = 0;
+    bool m_isDpiScaledImageFile = false;
+    std::unique_ptr<ImageInfo> m_imageInfo; //在子线程中解码的图片数据
+    TaskFuture<bool> m_result;
+    std::shared_ptr<PrefetchImageBatch> m_spBatch;
+};
+
+/** 窗口DPI变化后，旧DPI下的图片在缓存中保留的时间（毫秒）
+*/
+static constexpr int32_t kRetainImageMs = 10 * 1000;
+
 ImageManager::ImageManager():
     m_bDpiScaleAllImages(true),
-    m_bAutoMatchScaleImage(true)
+    m_bAutoMatchScaleImage(true),
+    m_nNextRetainId(1)
 {
 }
 
@@ -62,6 +91,12 @@ std::shared_ptr<ImageInfo> ImageManager::GetImage(const Window* pWindow,
         }
     }    
 
+    //预加载的图片已经解码完成，直接使用（未完成时不等待，按正常流程加载）
+    std::shared_ptr<ImageInfo> prefetchImage = TakePrefetchImage(loadKey);
+    if (prefetchImage != nullptr) {
+        return prefetchImage;
+    }
+
     //重新加载资源    
     std::unique_ptr<ImageInfo> imageInfo;
     bool isIcon = false;
@@ -75,35 +110,12 @@ std::shared_ptr<ImageInfo> ImageManager::GetImage(const Window* pWindow,
     std::shared_ptr<LoadImageParam> spLoadImageParam;
     bool isDpiScaledImageFile = false; //该图片是否为DPI自适应的图片（不是DPI为96的原始图片）
     if (!isIcon) {
-        DString imageFullPath = loadAtrribute.GetImageFullPath();
         bool isUseZip = GlobalManager::Instance().Zip().IsUseZip();
-        DString dpiImageFullPath;
-        uint32_t nImageDpiScale = 0;
-        //仅在DPI缩放图片功能开启的情况下，查找对应DPI的图片是否存在
         const bool bEnableImageDpiScale = IsDpiScaleAllImages();
-        if (bEnableImageDpiScale && GetDpiScaleImageFullPath(dpi.GetScale(), isUseZip, imageFullPath, dpiImageFullPath, nImageDpiScale)) {
-            //标记DPI自适应图片属性，如果路径不同，说明已经选择了对应DPI下的文件
-            isDpiScaledImageFile = true;
-            imageFullPath = dpiImageFullPath;
-            ASSERT(!imageFullPath.empty());
-            ASSERT(nImageDpiScale > 100);
-        }
-        else {
-            nImageDpiScale = 100; //原始图片，未经DPI缩放
-            isDpiScaledImageFile = false;
-        }
-        //加载图片的KEY
-        ImageLoadAttribute realLoadAttribute = loadAtrribute;
-        realLoadAttribute.SetImageFullPath(imageFullPath);
+        DString imageFullPath;
         DString imageKey;
-        if (isDpiScaledImageFile) {
-            //有对应DPI的图片文件
-            imageKey = realLoadAttribute.GetCacheKey(nImageDpiScale);
-        }
-        else {
-            //无对应DPI缩放比的图片文件
-            imageKey = realLoadAttribute.GetCacheKey(0);
-        }
+        uint32_t nImageDpiScale = 0;
+        GetImageFileInfo(dpi.GetScale(), loadAtrribute, imageFullPath, imageKey, nImageDpiScale, isDpiScaledImageFile);
 
         //根据imageKey查询缓存
         if (!imageKey.empty()) {
@@ -135,11 +147,15 @@ std::shared_ptr<ImageInfo> ImageManager::GetImage(const Window* pWindow,
             if (isDpiScaledImageFile) {
                 imageLoadAtrribute.SetNeedDpiScale(false);
             }
-            const int32_t nThreadIdentifier = ThreadIdentifier::kThreadWorker;
+            //优先使用线程池加载多帧图片，如果线程池未启动，则使用Worker线程
+            int32_t nThreadIdentifier = ThreadIdentifier::kThreadPool;
+            if (!GlobalManager::Instance().Thread().HasThread(nThreadIdentifier)) {
+                nThreadIdentifier = ThreadIdentifier::kThreadWorker;
+            }
             bool bLoadAllFrames = true;
             bool bHasWorkerThread = GlobalManager::Instance().Thread().HasThread(nThreadIdentifier);
             if (bHasWorkerThread) {
-                //如果存在Worker线程，则采用多线程异步加载多帧图片（如GIF图片等）
+                //如果存在Worker线程或者线程池，则采用多线程异步加载多帧图片（如GIF图片等）
                 bLoadAllFrames = false;
             }
             uint32_t nFrameCount = 0;
@@ -168,44 +184,266 @@ std::shared_ptr<ImageInfo> ImageManager::GetImage(const Window* pWindow,
         DString imageKey = imageInfo->GetImageKey();
         uint32_t nWindowDpiScale = dpi.GetScale();
         sharedImage = SaveImageInfo(imageInfo.release(), loadKey, nWindowDpiScale, isDpiScaledImageFile);
-        if ((spLoadImageParam != nullptr) && (spLoadImageParam->m_nThreadIdentifier >= 0)) {
+        if ((spLoadImageParam != nullptr) && (spLoadImageParam->m_nThreadIdentifier != kThreadNone)) {
             //启动多线程加载多帧图片, 在子线程中加载完成后，更新图片数据
-            auto loadImageTask = [this, spLoadImageParam, loadKey, imageKey, nWindowDpiScale, isDpiScaledImageFile, asyncLoadCallback]() {
+            auto loadImageTask = [this, spLoadImageParam]() {
                     //该函数的代码在子线程中执行
                     uint32_t nFrameCount = 0;
                     ImageDecoder imageDecoder;
-                    std::unique_ptr<ImageInfo> pNewImageInfo = nullptr;
-                    pNewImageInfo = imageDecoder.LoadImageData(spLoadImageParam->m_fileData,
-                                                               spLoadImageParam->m_imageLoadAtrribute,
-                                                               spLoadImageParam->m_bEnableImageDpiScale,
-                                                               spLoadImageParam->m_nImageDpiScale,
-                                                               spLoadImageParam->m_nWindowDpiScale,
-                                                               true, nFrameCount);
-                    if ((pNewImageInfo != nullptr) && (&GlobalManager::Instance().Image() == this)) {
-                        //发送到UI线程，更新图片数据，然后刷新界面显示
-                        std::shared_ptr<ImageInfo> spNewSharedImage;
-                        spNewSharedImage.reset(pNewImageInfo.release());
-                        auto updateUiTask = [this, spNewSharedImage, loadKey, imageKey, nWindowDpiScale, isDpiScaledImageFile, asyncLoadCallback]() {
-                                //该函数的代码在UI线程中执行                                
-                                if (&GlobalManager::Instance().Image() == this) {
-                                    bool bUpdated = UpdateImageInfo(spNewSharedImage, loadKey, imageKey, nWindowDpiScale, isDpiScaledImageFile);
-                                    //ASSERT_UNUSED_VARIABLE(bUpdated);
-                                    if (bUpdated && (asyncLoadCallback != nullptr)) {
-                                        //加载成功后，回调函数
-                                        asyncLoadCallback();
-                                    }
-                                }
-                            };
-
-                        GlobalManager::Instance().Thread().PostTask(ui::kThreadUI, updateUiTask);
+                    std::shared_ptr<ImageInfo> spNewSharedImage;
+                    if (&GlobalManager::Instance().Image() == this) {
+                        spNewSharedImage = imageDecoder.LoadImageData(spLoadImageParam->m_fileData,
+                                                                      spLoadImageParam->m_imageLoadAtrribute,
+                                                                      spLoadImageParam->m_bEnableImageDpiScale,
+                                                                      spLoadImageParam->m_nImageDpiScale,
+                                                                      spLoadImageParam->m_nWindowDpiScale,
+                                                                      true, nFrameCount);
                     }
+                    return spNewSharedImage;
                 };
-            GlobalManager::Instance().Thread().PostTask(spLoadImageParam->m_nThreadIdentifier, loadImageTask);
+            auto updateUiTask = [this, loadKey, imageKey, nWindowDpiScale, isDpiScaledImageFile, asyncLoadCallback](const std::shared_ptr<ImageInfo>& spNewSharedImage) {
+                    //该函数的代码在UI线程中执行，更新图片数据，然后刷新界面显示
+                    if ((spNewSharedImage != nullptr) && (&GlobalManager::Instance().Image() == this)) {
+                        bool bUpdated = UpdateImageInfo(spNewSharedImage, loadKey, imageKey, nWindowDpiScale, isDpiScaledImageFile);
+                        //ASSERT_UNUSED_VARIABLE(bUpdated);
+                        if (bUpdated && (asyncLoadCallback != nullptr)) {
+                            //加载成功后，回调函数
+                            asyncLoadCallback();
+                        }
+                    }
+                };
+            GlobalManager::Instance().Thread().PostTaskFuture(spLoadImageParam->m_nThreadIdentifier, loadImageTask)
+                                               .Then(ui::kThreadUI, updateUiTask);
         }
     }
     return sharedImage;
 }
 
+void ImageManager::GetImageFileInfo(uint32_t nWindowDpiScale, const ImageLoadAttribute& loadAtrribute,
+                                    DString& imageFullPath, DString& imageKey,
+                                    uint32_t& nImageDpiScale, bool& isDpiScaledImageFile) const
+{
+    imageFullPath = loadAtrribute.GetImageFullPath();
+    bool isUseZip = GlobalManager::Instance().Zip().IsUseZip();
+    DString dpiImageFullPath;
+    nImageDpiScale = 0;
+    //仅在DPI缩放图片功能开启的情况下，查找对应DPI的图片是否存在
+    if (IsDpiScaleAllImages() && GetDpiScaleImageFullPath(nWindowDpiScale, isUseZip, imageFullPath, dpiImageFullPath, nImageDpiScale)) {
+        //标记DPI自适应图片属性，如果路径不同，说明已经选择了对应DPI下的文件
+        isDpiScaledImageFile = true;
+        imageFullPath = dpiImageFullPath;
+        ASSERT(!imageFullPath.empty());
+        ASSERT(nImageDpiScale > 100);
+    }
+    else {
+        nImageDpiScale = 100; //原始图片，未经DPI缩放
+        isDpiScaledImageFile = false;
+    }
+    //加载图片的KEY：包含窗口的DPI缩放百分比，同一个图片在不同DPI下的数据可以同时存在于缓存中
+    ImageLoadAttribute realLoadAttribute = loadAtrribute;
+    realLoadAttribute.SetImageFullPath(imageFullPath);
+    imageKey = realLoadAttribute.GetCacheKey(nWindowDpiScale);
+}
+
+std::shared_ptr<ImageInfo> ImageManager::FindImage(const DString& loadKey) const
+{
+    auto iter = m_loadKeyMap.find(loadKey);
+    if (iter != m_loadKeyMap.end()) {
+        auto it = m_imageMap.find(iter->second);
+        if (it != m_imageMap.end()) {
+            return it->second.lock();
+        }
+    }
+    return nullptr;
+}
+
+size_t ImageManager::PrefetchImages(Window* pWindow, const std::vector<Image*>& imageList)
+{
+    GlobalManager::Instance().AssertUIThread();
+    ASSERT(pWindow != nullptr);
+    if ((pWindow == nullptr) || imageList.empty()) {
+        return 0;
+    }
+    //旧DPI下的图片，保留一段时间（窗口可能很快被拖回原来的显示器）
+    std::vector<std::shared_ptr<ImageInfo>> retainImages;
+    for (const Image* pImage : imageList) {
+        if ((pImage != nullptr) && (pImage->GetImageCache() != nullptr)) {
+            retainImages.push_back(pImage->GetImageCache());
+        }
+    }
+    RetainImages(retainImages);
+
+    int32_t nThreadIdentifier = ThreadIdentifier::kThreadPool;
+    if (!GlobalManager::Instance().Thread().HasThread(nThreadIdentifier)) {
+        nThreadIdentifier = ThreadIdentifier::kThreadWorker;
+    }
+    if (!GlobalManager::Instance().Thread().HasThread(nThreadIdentifier)) {
+        //没有工作线程，在绘制时按需加载
+        return 0;
+    }
+
+    const uint32_t nWindowDpiScale = pWindow->Dpi().GetScale();
+    const bool isUseZip = GlobalManager::Instance().Zip().IsUseZip();
+    const bool bEnableImageDpiScale = IsDpiScaleAllImages();
+    IconManager& iconManager = GlobalManager::Instance().Icon();
+    std::shared_ptr<PrefetchImageBatch> spBatch = std::make_shared<PrefetchImageBatch>();
+    spBatch->m_pWindow = pWindow;
+    spBatch->m_windowFlag = pWindow->GetWeakFlag();
+    std::unordered_map<DString, bool> prefetchKeys;
+    size_t nPrefetchCount = 0;
+    for (const Image* pImage : imageList) {
+        if (pImage == nullptr) {
+            continue;
+        }
+        //与Control::LoadImageData的逻辑保持一致（ICON图片由绘制时加载）
+        DString sImagePath = pImage->GetImagePath();
+        if (sImagePath.empty() || iconManager.IsIconString(sImagePath)) {
+            continue;
+        }
+        FilePath imageFilePath = GlobalManager::Instance().GetExistsResFullPath(pWindow->GetResourcePath(),
+                                                                               pWindow->GetXmlPath(),
+                                                                               FilePath(sImagePath));
+        if (imageFilePath.IsEmpty()) {
+            continue;
+        }
+        ImageLoadAttribute loadAtrribute = pImage->GetImageLoadAttribute();
+        loadAtrribute.SetImageFullPath(imageFilePath.ToString());
+        DString loadKey = loadAtrribute.GetCacheKey(nWindowDpiScale);
+        if (!prefetchKeys.emplace(loadKey, true).second || (FindImage(loadKey) != nullptr) ||
+            (m_prefetchItems.find(loadKey) != m_prefetchItems.end())) {
+            //重复的图片，缓存中已经存在，或者正在预加载
+            continue;
+        }
+
+        std::shared_ptr<PrefetchImageItem> spItem = std::make_shared<PrefetchImageItem>();
+        DString imageFullPath;
+        uint32_t nImageDpiScale = 0;
+        GetImageFileInfo(nWindowDpiScale, loadAtrribute, imageFullPath,
+                         spItem->m_imageKey, nImageDpiScale, spItem->m_isDpiScaledImageFile);
+        spItem->m_loadKey = loadKey;
+        spItem->m_nWindowDpiScale = nWindowDpiScale;
+        spItem->m_spBatch = spBatch;
+
+        //压缩包中的数据在UI线程中读取（压缩包的接口不支持多线程），磁盘文件在子线程中读取
+        std::shared_ptr<std::vector<uint8_t>> spFileData = std::make_shared<std::vector<uint8_t>>();
+        FilePath realFilePath(imageFullPath);
+        const bool bReadFromZip = isUseZip && !realFilePath.IsAbsolutePath();
+        if (bReadFromZip) {
+            GlobalManager::Instance().Zip().GetZipData(realFilePath, *spFileData);
+            if (spFileData->empty()) {
+                continue;
+            }
+        }
+        ImageLoadAttribute imageLoadAtrribute(loadAtrribute);
+        if (spItem->m_isDpiScaledImageFile) {
+            imageLoadAtrribute.SetNeedDpiScale(false);
+        }
+        auto loadImageTask = [spItem, spFileData, bReadFromZip, realFilePath, imageLoadAtrribute,
+                              bEnableImageDpiScale, nImageDpiScale, nWindowDpiScale]() {
+                //该函数的代码在子线程中执行
+                if (!bReadFromZip) {
+                    FileUtil::ReadFileData(realFilePath, *spFileData);
+                }
+                if (!spFileData->empty()) {
+                    //只解码第一帧（与GetImage一致）
+                    uint32_t nFrameCount = 0;
+                    ImageDecoder imageDecoder;
+                    spItem->m_imageInfo = imageDecoder.LoadImageData(*spFileData, imageLoadAtrribute,
+                                                                     bEnableImageDpiScale, nImageDpiScale, nWindowDpiScale,
+                                                                     false, nFrameCount);
+                    if (nFrameCount > 1) {
+                        //多帧图片由GetImage按正常流程加载（其余各帧需要异步加载，并在完成后通知控件）
+                        spItem->m_imageInfo.reset();
+                    }
+                }
+                return spItem->m_imageInfo != nullptr;
+            };
+        auto updateUiTask = [this, spItem](const bool& /*bLoaded*/) {
+                //该函数的代码在UI线程中执行
+                if (&GlobalManager::Instance().Image() == this) {
+                    OnPrefetchImageLoaded(spItem);
+                }
+            };
+        spItem->m_result = GlobalManager::Instance().Thread().PostTaskFuture(nThreadIdentifier, loadImageTask);
+        if (spItem->m_result.IsValid()) {
+            m_prefetchItems[loadKey] = spItem;
+            ++spBatch->m_nPendingCount;
+            ++nPrefetchCount;
+            spItem->m_result.Then(kThreadUI, updateUiTask);
+        }
+    }
+    return nPrefetchCount;
+}
+
+std::shared_ptr<ImageInfo> ImageManager::TakePrefetchImage(const DString& loadKey)
+{
+    auto iter = m_prefetchItems.find(loadKey);
+    if ((iter == m_prefetchItems.end()) || !iter->second->m_result.IsReady()) {
+        return nullptr;
+    }
+    std::shared_ptr<PrefetchImageItem> spItem = iter->second;
+    m_prefetchItems.erase(iter);
+    return SavePrefetchImage(spItem);
+}
+
+std::shared_ptr<ImageInfo> ImageManager::SavePrefetchImage(const std::shared_ptr<PrefetchImageItem>& spItem)
+{
+    if (spItem->m_imageInfo == nullptr) {
+        //解码失败，或者已经保存
+        return nullptr;
+    }
+    std::shared_ptr<ImageInfo> sharedImage = FindImage(spItem->m_loadKey);
+    if (sharedImage == nullptr) {
+        spItem->m_imageInfo->SetImageKey(spItem->m_imageKey);
+        sharedImage = SaveImageInfo(spItem->m_imageInfo.release(), spItem->m_loadKey,
+                                    spItem->m_nWindowDpiScale, spItem->m_isDpiScaledImageFile);
+    }
+    else {
+        //绘制时已经按正常流程加载
+        spItem->m_imageInfo.reset();
+    }
+    if (sharedImage != nullptr) {
+        //在控件重新获取图片之前，保持图片有效
+        spItem->m_spBatch->m_savedImages.push_back(sharedImage);
+    }
+    return sharedImage;
+}
+
+void ImageManager::OnPrefetchImageLoaded(const std::shared_ptr<PrefetchImageItem>& spItem)
+{
+    auto iter = m_prefetchItems.find(spItem->m_loadKey);
+    if ((iter != m_prefetchItems.end()) && (iter->second == spItem)) {
+        m_prefetchItems.erase(iter);
+    }
+    SavePrefetchImage(spItem);
+
+    PrefetchImageBatch& batch = *spItem->m_spBatch;
+    ASSERT(batch.m_nPendingCount > 0);
+    if ((batch.m_nPendingCount == 0) || (--batch.m_nPendingCount > 0)) {
+        return;
+    }
+    //这一批图片全部完成：重绘窗口，使用新DPI下的图片
+    const bool bImageSaved = !batch.m_savedImages.empty();
+    RetainImages(batch.m_savedImages);
+    if (bImageSaved && !batch.m_windowFlag.expired() && (batch.m_pWindow->GetRoot() != nullptr)) {
+        batch.m_pWindow->GetRoot()->Invalidate();
+    }
+}
+
+void ImageManager::RetainImages(std::vector<std::shared_ptr<ImageInfo>>& images)
+{
+    if (images.empty()) {
+        return;
+    }
+    const size_t nRetainId = m_nNextRetainId++;
+    m_retainedImages[nRetainId].swap(images);
+    GlobalManager::Instance().Thread().PostDelayedTask(kThreadUI, [this, nRetainId]() {
+            if (&GlobalManager::Instance().Image() == this) {
+                m_retainedImages.erase(nRetainId);
+            }
+        }, kRetainImageMs);
+}
+
 std::shared_ptr<ImageInfo> ImageManager::SaveImageInfo(ImageInfo* pImageInfo, const DString& loadKey, uint32_t nWindowDpiScale, bool isDpiScaledImageFile)
 {
     if (pImageInfo == nullptr) {
@@ -326,7 +564,8 @@ void ImageManager::OnImageInfoDestroy(ImageInfo* pImageInfo)
             }
             if (!imageKey.empty()) {
                 auto it = imageManager.m_imageMap.find(imageKey);
-                if (it != imageManager.m_imageMap.end()) {
+                if ((it != imageManager.m_imageMap.end()) && it->second.expired()) {
+                    //只删除该图片自身的记录（该Key可能已经对应新加载的图片）
                     imageManager.m_imageMap.erase(it);
                 }
             }
@@ -341,6 +580,8 @@ void ImageManager::OnImageInfoDestroy(ImageInfo* pImageInfo)
 
 void ImageManager::RemoveAllImages()
 {
+    m_prefetchItems.clear();
+    m_retainedImages.clear();
     m_imageMap.clear();
 }
 
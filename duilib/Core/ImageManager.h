@@ -5,10 +5,12 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <map>
 #include <memory>
 
 namespace ui 
 {
+class Image;
 class ImageInfo;
 class ImageLoadAttribute;
 class DpiManager;
@@ -39,6 +41,16 @@ public:
      */
     void RemoveAllImages();
 
+    /** 窗口DPI变化时，预加载新DPI下的图片：在线程池中并行解码（只解码第一帧，与GetImage一致），同时将旧DPI下的图片短暂保留在缓存中
+    *   （窗口在不同DPI的显示器之间来回拖动时，不需要重新加载图片）
+    *   该函数不等待解码完成：每个图片解码完成后，在UI线程中保存到缓存，全部完成后重绘窗口；
+    *   如果绘制时图片尚未解码完成，GetImage按正常流程加载，不等待预加载的结果
+    * @param [in] pWindow 关联的窗口，窗口的DPI已经更新为新的值
+    * @param [in] imageList 窗口中已经加载的图片（在旧DPI下加载的）
+    * @return 返回提交解码任务的图片个数，如果线程池和Worker线程均未启动，不预加载，返回0
+    */
+    size_t PrefetchImages(Window* pWindow, const std::vector<Image*>& imageList);
+
     /** 设置是否默认对所有图片在加载时根据DPI进行缩放，这个是全局属性，默认为true，应用于所有图片
        （设置为true后，也可以通过在xml中，使用"dpiscale='false'"属性关闭某个图片的DPI自动缩放）
     */
@@ -118,6 +130,42 @@ private:
                       const ImageLoadAttribute& loadAtrribute,
                       std::unique_ptr<ImageInfo>& imageInfo) const;
 
+    /** 查找实际加载的图片文件（可能是对应DPI的图片文件），并生成图片的Key
+    * @param [in] nWindowDpiScale 窗口的DPI缩放百分比
+    * @param [in] loadAtrribute 图片的加载属性
+    * @param [out] imageFullPath 返回实际加载的图片文件路径
+    * @param [out] imageKey 返回图片的Key
+    * @param [out] nImageDpiScale 返回图片文件对应的DPI缩放百分比
+    * @param [out] isDpiScaledImageFile 返回是否为DPI自适应的图片（不是DPI为96的原始图片）
+    */
+    void GetImageFileInfo(uint32_t nWindowDpiScale, const ImageLoadAttribute& loadAtrribute,
+                          DString& imageFullPath, DString& imageKey,
+                          uint32_t& nImageDpiScale, bool& isDpiScaledImageFile) const;
+
+    /** 在缓存中查找图片
+    */
+    std::shared_ptr<ImageInfo> FindImage(const DString& loadKey) const;
+
+    /** 保留一组图片（持有引用，避免图片被释放），一段时间后自动释放
+    */
+    void RetainImages(std::vector<std::shared_ptr<ImageInfo>>& images);
+
+    /** 预加载的图片
+    */
+    struct PrefetchImageItem;
+
+    /** 获取已经解码完成的预加载图片（未完成时不等待，返回nullptr）
+    */
+    std::shared_ptr<ImageInfo> TakePrefetchImage(const DString& loadKey);
+
+    /** 将预加载的图片保存到缓存中
+    */
+    std::shared_ptr<ImageInfo> SavePrefetchImage(const std::shared_ptr<PrefetchImageItem>& spItem);
+
+    /** 预加载的图片解码完成（在UI线程中执行）
+    */
+    void OnPrefetchImageLoaded(const std::shared_ptr<PrefetchImageItem>& spItem);
+
 private:
     /** 是否默认对所有图片在加载时根据DPI进行缩放，这个是全局属性，默认为true，应用于所有图片
        （设置为true后，也可以通过在xml中，使用"dpiscale='false'"属性关闭某个图片的DPI自动缩放）
@@ -135,6 +183,18 @@ private:
     /** 图片资源Key映射表（图片的加载Key与图片Key）
     */
     std::unordered_map <DString, DString> m_loadKeyMap;
+
+    /** 正在预加载的图片（Key为图片的加载Key）
+    */
+    std::unordered_map<DString, std::shared_ptr<PrefetchImageItem>> m_prefetchItems;
+
+    /** 保留的图片（Key为保留的批次ID），到期后自动释放
+    */
+    std::map<size_t, std::vector<std::shared_ptr<ImageInfo>>> m_retainedImages;
+
+    /** 保留图片的下一个批次ID
+    */
+    size_t m_nNextRetainId;
 };
 
 }
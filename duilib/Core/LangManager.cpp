@@ -1,114 +1,72 @@
 #include "LangManager.h"
-#include "duilib/Utils/StringUtil.h"
 #include "duilib/Utils/StringConvert.h"
 #include "duilib/Utils/FileUtil.h"
+#include "duilib/Core/Control.h"
+#include "duilib/Core/ScopedLock.h"
 
 namespace ui 
 {
+/** 字符串的解码状态
+*/
+static constexpr uint8_t kStringUnresolved = 0; //未查找
+static constexpr uint8_t kStringFound = 1;      //已解码
+static constexpr uint8_t kStringNotFound = 2;   //不存在
+
 LangManager::LangManager()
 {
 };
 
 LangManager::~LangManager()
 {
-    m_stringTable.clear();
+    m_spStringTable.reset();
+    m_stringHandleMap.clear();
+    m_stringIds.clear();
+    m_langControls.clear();
 };
 
 bool LangManager::LoadStringTable(const FilePath& strFilePath)
 {
-    m_stringTable.clear();
-    std::vector<uint8_t> fileData;
-    FileUtil::ReadFileData(strFilePath, fileData);
-    ASSERT(!fileData.empty());
-    if (fileData.empty()) {
+    //加载时只建立索引，字符串在首次使用时解码（编译格式的文件以内存映射方式打开）
+    std::shared_ptr<StringTable> spStringTable = std::make_shared<StringTable>();
+    bool bRet = spStringTable->m_table.LoadFile(strFilePath);
+    ASSERT(bRet);
+    if (!bRet) {
         return false;
     }
-    return LoadStringTable(fileData);
+    //新的映射表生成完成后再整体替换，替换前的映射表始终保持完整
+    ScopedLock stringGuard(m_stringMutex);
+    m_spStringTable = spStringTable;
+    return true;
 }
 
 bool LangManager::LoadStringTable(const std::vector<uint8_t>& fileData)
 {
-    std::vector<DString> string_list;
-    if (fileData.empty()) {
+    std::shared_ptr<StringTable> spStringTable = std::make_shared<StringTable>();
+    if (!spStringTable->m_table.LoadData(fileData)) {
         return false;
     }
-    size_t bomSize = 0;
-    if ((fileData.size() >= 3)   &&
-        (fileData.at(0) == 0xEF) &&
-        (fileData.at(1) == 0xBB) &&
-        (fileData.at(2) == 0xBF) ) {
-        //跳过UTF8的BOM头
-        bomSize = 3;
-    }
-    std::string fragment((const char*)fileData.data() + bomSize, fileData.size() - bomSize);
-    StringUtil::ReplaceAll("\r\n", "\n", fragment);
-    StringUtil::ReplaceAll("\r", "\n", fragment);
-    fragment.append("\n");
-    std::string src;
-    DString string_resourse;
-    for (const auto& it : fragment)    {
-        if (it == '\0' || it == '\n') {
-            if (!src.empty()) {
-                string_resourse.clear();
-                string_resourse = StringConvert::UTF8ToT(src);
-                string_resourse = StringUtil::Trim(string_resourse);
-                if (!string_resourse.empty()) {
-                    string_list.push_back(string_resourse);
-                }
-                src.clear();
-            }
-            continue;
-        }
-        src.push_back(it);
-    }
-    AnalyzeStringTable(string_list);
+    ScopedLock stringGuard(m_stringMutex);
+    m_spStringTable = spStringTable;
     return true;
 }
 
 void LangManager::ClearStringTable()
 {
-    m_stringTable.clear();
+    ScopedLock stringGuard(m_stringMutex);
+    m_spStringTable.reset();
 }
 
-bool LangManager::AnalyzeStringTable(const std::vector<DString>& list)
+bool LangManager::CompileStringTable(const FilePath& textFilePath, const FilePath& compiledFilePath)
 {
-    int    nCount = (int)list.size();
-    if (nCount <= 0) {
+    std::vector<uint8_t> textData;
+    if (!FileUtil::ReadFileData(textFilePath, textData) || textData.empty()) {
         return false;
     }
-    DString id;
-    DString strResource;
-    for (int i = 0; i < nCount; ++i) {
-        const DString& strSrc = list[i];
-        if (strSrc.empty() || strSrc.at(0) == _T(';')) {
-            //注释以";"开头
-            continue;
-        }
-        size_t pos = strSrc.find(_T('='));
-        if (pos == DString::npos) {
-            //无分隔符，忽略
-            continue;
-        }
-
-        id = strSrc.substr(0, pos);
-        if (!id.empty()) {
-            id = StringUtil::Trim(id);
-        }
-        if ((pos + 1) < strSrc.size()) {
-            strResource = strSrc.substr(pos + 1);
-            strResource = StringUtil::Trim(strResource);
-            //将\n和\r替换为真实的换行符、回车符
-            StringUtil::ReplaceAll(_T("\\r"), _T("\r"), strResource);
-            StringUtil::ReplaceAll(_T("\\n"), _T("\n"), strResource);
-        }
-        else {
-            strResource.clear();
-        }
-        if (!id.empty()) {
-            m_stringTable[id] = strResource;
-        }
+    std::vector<uint8_t> compiledData;
+    if (!LangStringTable::CompileStringTable(textData, compiledData)) {
+        return false;
     }
-    return true;
+    return FileUtil::WriteFileData(compiledFilePath, compiledData);
 }
 
 DString LangManager::GetStringViaID(const DString& id)
@@ -117,15 +75,90 @@ DString LangManager::GetStringViaID(const DString& id)
     if (id.empty()) {
         return text;
     }
-    auto it = m_stringTable.find(id);
-    if (it == m_stringTable.end()) {
+    ScopedLock stringGuard(m_stringMutex);
+    const uint32_t handle = DoGetStringHandle(id);
+    if (!FindStringViaHandle(handle)) {
         ASSERT(!"MultiLang::GetStringViaID failed!");
         return text;
     }
     else {
-        text = it->second;
+        text = m_spStringTable->m_strings[handle];
     }
     return text;
 }
 
+uint32_t LangManager::GetStringHandle(const DString& id)
+{
+    ScopedLock stringGuard(m_stringMutex);
+    return DoGetStringHandle(id);
+}
+
+uint32_t LangManager::DoGetStringHandle(const DString& id)
+{
+    if (id.empty()) {
+        return InvalidStringHandle;
+    }
+    auto it = m_stringHandleMap.find(id);
+    if (it != m_stringHandleMap.end()) {
+        return it->second;
+    }
+    const uint32_t handle = (uint32_t)m_stringIds.size();
+    m_stringHandleMap[id] = handle;
+    m_stringIds.push_back(StringConvert::TToUTF8(id));
+    return handle;
+}
+
+const DString& LangManager::GetStringViaHandle(uint32_t handle) const
+{
+    static const DString emptyString;
+    ScopedLock stringGuard(m_stringMutex);
+    if (!FindStringViaHandle(handle)) {
+        return emptyString;
+    }
+    return m_spStringTable->m_strings[handle];
+}
+
+bool LangManager::FindStringViaHandle(uint32_t handle) const
+{
+    StringTable* pStringTable = m_spStringTable.get();
+    if ((pStringTable == nullptr) || (handle >= m_stringIds.size())) {
+        return false;
+    }
+    if (handle >= pStringTable->m_states.size()) {
+        pStringTable->m_states.resize(m_stringIds.size(), kStringUnresolved);
+        pStringTable->m_strings.resize(m_stringIds.size());
+    }
+    uint8_t& state = pStringTable->m_states[handle];
+    if (state == kStringUnresolved) {
+        //首次访问时查找并解码
+        bool bFound = pStringTable->m_table.FindString(m_stringIds[handle], pStringTable->m_strings[handle]);
+        state = bFound ? kStringFound : kStringNotFound;
+    }
+    return state == kStringFound;
+}
+
+void LangManager::AddLangControl(Control* pControl)
+{
+    ASSERT(pControl != nullptr);
+    if (pControl != nullptr) {
+        m_langControls.insert(pControl);
+    }
+}
+
+void LangManager::RemoveLangControl(Control* pControl)
+{
+    m_langControls.erase(pControl);
+}
+
+void LangManager::NotifyLanguageChanged()
+{
+    //回调过程中可能有控件被销毁或者新注册，所以先复制一份，回调前再检查是否仍然有效
+    std::vector<Control*> langControls(m_langControls.begin(), m_langControls.end());
+    for (Control* pControl : langControls) {
+        if (m_langControls.find(pControl) != m_langControls.end()) {
+            pControl->OnLanguageChanged();
+        }
+    }
+}
+
 }//namespace ui 
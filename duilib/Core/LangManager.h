@@ -1,13 +1,18 @@
 #ifndef UI_CORE_MULTILANG_H_
 #define UI_CORE_MULTILANG_H_
 
-#include "duilib/Utils/FilePath.h"
+#include "duilib/Core/LangStringTable.h"
 #include <string>
 #include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace ui 
 {
+class Control;
 
 /** 多语言的支持
 */
@@ -20,7 +25,9 @@ public:
     LangManager& operator = (const LangManager&) = delete;
 
 public:
-    /** 从本地文件加载所有语言映射表
+    /** 从本地文件加载所有语言映射表（加载成功后整体替换当前的映射表，加载失败时保留当前的映射表）
+     *  语言文件可以是文本格式，也可以是由CompileStringTable生成的编译格式（加载时无需解析），字符串在首次使用时才解码；
+     *  编译格式的文件以内存映射方式打开，在映射表被替换或者清除之前，文件不能被修改或者替换
      * @param[in] strFilePath 语言文件的完整路径
      */
     bool LoadStringTable(const FilePath& strFilePath);
@@ -34,23 +41,90 @@ public:
     */
     void ClearStringTable();
 
+    /** 将文本格式的语言文件转换为编译格式（编译格式的文件包含排好序的索引，加载时无需解析）
+     * @param[in] textFilePath 文本格式的语言文件的完整路径
+     * @param[in] compiledFilePath 生成的编译格式的语言文件的完整路径
+     */
+    static bool CompileStringTable(const FilePath& textFilePath, const FilePath& compiledFilePath);
+
 public:
-    /** 根据ID获取指定语言的字符串
+    /** 根据ID获取指定语言的字符串（线程安全）
      * @param[in] id 指定字符串 ID
      * @return 返回 ID 对应的语言字符串
      */
     DString GetStringViaID(const DString& id);
 
+    /** 无效的字符串句柄
+    */
+    static constexpr uint32_t InvalidStringHandle = (uint32_t)-1;
+
+    /** 获取字符串ID的句柄（同一个ID总是返回相同的句柄，切换语言后句柄仍然有效，线程安全）
+     * @param[in] id 指定字符串 ID
+     * @return 返回字符串ID的句柄，如果ID为空返回InvalidStringHandle
+     */
+    uint32_t GetStringHandle(const DString& id);
+
+    /** 根据句柄获取当前语言的字符串（无需查找映射表，也不复制字符串，线程安全）
+     * @param[in] handle 字符串ID的句柄，由GetStringHandle返回
+     * @return 返回当前语言的字符串的引用，在下次加载语言映射表之前有效；如果不存在，返回空串
+     */
+    const DString& GetStringViaHandle(uint32_t handle) const;
+
+public:
+    /** 注册使用了多语言字符串ID的控件，切换语言时会调用该控件的OnLanguageChanged函数
+    */
+    void AddLangControl(Control* pControl);
+
+    /** 注销使用了多语言字符串ID的控件（控件销毁时调用）
+    */
+    void RemoveLangControl(Control* pControl);
+
+    /** 通知所有注册的控件：语言已经切换（只更新这些控件的布局和显示）
+    */
+    void NotifyLanguageChanged();
+
 private:
-    /** 分析语言映射表内容
-     * @param[in] list 读取出来的映射表内容列表
+    /** 语言映射表
+    */
+    struct StringTable
+    {
+        //字符串索引
+        LangStringTable m_table;
+        //已解码的字符串，以字符串ID的句柄为下标（使用deque，扩充时已有元素的地址不变）
+        std::deque<DString> m_strings;
+        //字符串的解码状态，以字符串ID的句柄为下标
+        std::vector<uint8_t> m_states;
+    };
+
+    /** 查找并解码句柄对应的字符串（首次访问时解码，调用时需要持有m_stringMutex锁）
+     * @return 如果字符串存在，返回true，字符串保存在m_spStringTable->m_strings[handle]中
      */
-    bool AnalyzeStringTable(const std::vector<DString>& list);
+    bool FindStringViaHandle(uint32_t handle) const;
+
+    /** 获取字符串ID的句柄（调用时需要持有m_stringMutex锁）
+    */
+    uint32_t DoGetStringHandle(const DString& id);
 
 private:
-    /** 字符串的ID和取值映射表
+    /** 字符串ID和句柄的映射表（句柄只增不减）
+    */
+    std::unordered_map<DString, uint32_t> m_stringHandleMap;
+
+    /** 字符串ID（UTF8编码），以句柄为下标
+    */
+    std::vector<std::string> m_stringIds;
+
+    /** 当前语言的映射表（加载时生成新的映射表，完成后整体替换）
+    */
+    std::shared_ptr<StringTable> m_spStringTable;
+
+    /** 字符串句柄和映射表的多线程同步（字符串在首次访问时解码，查询函数也会修改数据）
+    */
+    mutable std::mutex m_stringMutex;
+
+    /** 使用了多语言字符串ID的控件
     */
-    std::unordered_map<DString, DString> m_stringTable;
+    std::unordered_set<Control*> m_langControls;
 };
 
 }
@@ -0,0 +1,336 @@
+#include "LangStringTable.h"
+#include "duilib/Utils/StringUtil.h"
+#include "duilib/Utils/StringConvert.h"
+#include <algorithm>
+#include <cstring>
+
+namespace ui 
+{
+/** 编译格式的文件头
+*/
+struct LangStringTableHeader
+{
+    char m_magic[4];            //文件标识："DLST"
+    uint32_t m_nVersion;        //版本号
+    uint32_t m_nCount;          //字符串的个数
+    uint32_t m_nIndexOffset;    //索引在文件中的偏移
+};
+
+/** 编译格式的文件标识和版本号
+*/
+static constexpr char kCompiledMagic[4] = { 'D', 'L', 'S', 'T' };
+static constexpr uint32_t kCompiledVersion = 1;
+
+/** 是否为空白字符（与StringUtil::Trim的规则一致）
+*/
+static inline bool IsSpaceChar(uint8_t ch)
+{
+    return (ch == 0x20) || (ch <= 0x1D);
+}
+
+LangStringTable::LangStringTable():
+    m_pData(nullptr),
+    m_nSize(0),
+    m_pIndex(nullptr),
+    m_nIndexCount(0),
+    m_bTextFormat(false)
+{
+}
+
+LangStringTable::~LangStringTable()
+{
+    Clear();
+}
+
+bool LangStringTable::LoadFile(const FilePath& filePath)
+{
+    Clear();
+    if (!m_fileMapping.Open(filePath)) {
+        return false;
+    }
+    const uint8_t* pData = m_fileMapping.GetData();
+    const size_t nSize = m_fileMapping.GetSize();
+    if (IsCompiledData(pData, nSize)) {
+        //编译格式：直接使用映射的数据，字符串在查找时解码
+        m_pData = pData;
+        m_nSize = nSize;
+    }
+    else {
+        //文本格式：加载时需要完整扫描一遍，复制数据后关闭文件，避免文件被修改或者替换后访问失效的映射
+        if ((pData != nullptr) && (nSize > 0)) {
+            m_fileData.assign(pData, pData + nSize);
+        }
+        m_fileMapping.Close();
+        m_pData = m_fileData.data();
+        m_nSize = m_fileData.size();
+    }
+    if (!BuildIndex()) {
+        Clear();
+        return false;
+    }
+    return true;
+}
+
+bool LangStringTable::LoadData(const std::vector<uint8_t>& fileData)
+{
+    Clear();
+    if (fileData.empty()) {
+        return false;
+    }
+    m_fileData = fileData;
+    m_pData = m_fileData.data();
+    m_nSize = m_fileData.size();
+    if (!BuildIndex()) {
+        Clear();
+        return false;
+    }
+    return true;
+}
+
+void LangStringTable::Clear()
+{
+    m_fileMapping.Close();
+    m_fileData.clear();
+    m_textIndex.clear();
+    m_pData = nullptr;
+    m_nSize = 0;
+    m_pIndex = nullptr;
+    m_nIndexCount = 0;
+    m_bTextFormat = false;
+}
+
+size_t LangStringTable::GetCount() const
+{
+    return m_nIndexCount;
+}
+
+bool LangStringTable::BuildIndex()
+{
+    if ((m_pData == nullptr) || (m_nSize == 0)) {
+        return false;
+    }
+    if (IsCompiledData(m_pData, m_nSize)) {
+        m_bTextFormat = false;
+        return CheckCompiledData(m_pData, m_nSize);
+    }
+    m_bTextFormat = true;
+    return ParseTextData(m_pData, m_nSize);
+}
+
+bool LangStringTable::IsCompiledData(const uint8_t* pData, size_t nSize)
+{
+    return (pData != nullptr) && (nSize >= sizeof(LangStringTableHeader)) &&
+           (::memcmp(pData, kCompiledMagic, sizeof(kCompiledMagic)) == 0);
+}
+
+bool LangStringTable::CheckCompiledData(const uint8_t* pData, size_t nSize)
+{
+    //只校验文件头，索引项在查找时校验，加载时不需要遍历数据
+    LangStringTableHeader header;
+    ::memcpy(&header, pData, sizeof(header));
+    ASSERT(header.m_nVersion == kCompiledVersion);
+    if (header.m_nVersion != kCompiledVersion) {
+        return false;
+    }
+    if ((header.m_nIndexOffset % alignof(IndexEntry)) != 0 ||
+        (header.m_nIndexOffset < sizeof(LangStringTableHeader)) ||
+        (header.m_nIndexOffset > nSize) ||
+        (header.m_nCount > (nSize - header.m_nIndexOffset) / sizeof(IndexEntry))) {
+        ASSERT(!"LangStringTable: invalid compiled data!");
+        return false;
+    }
+    m_pIndex = (const IndexEntry*)(pData + header.m_nIndexOffset);
+    m_nIndexCount = header.m_nCount;
+    return true;
+}
+
+bool LangStringTable::ParseTextData(const uint8_t* pData, size_t nSize)
+{
+    size_t nPos = 0;
+    if ((nSize >= 3) && (pData[0] == 0xEF) && (pData[1] == 0xBB) && (pData[2] == 0xBF)) {
+        //跳过UTF8的BOM头
+        nPos = 3;
+    }
+    ASSERT(nSize <= UINT32_MAX);
+    if (nSize > UINT32_MAX) {
+        return false;
+    }
+    m_textIndex.clear();
+    while (nPos < nSize) {
+        //一行的范围：以"\r"、"\n"或者"\0"结束
+        size_t nLineBegin = nPos;
+        while ((nPos < nSize) && (pData[nPos] != '\r') && (pData[nPos] != '\n') && (pData[nPos] != '\0')) {
+            ++nPos;
+        }
+        size_t nLineEnd = nPos;
+        ++nPos;
+
+        while ((nLineBegin < nLineEnd) && IsSpaceChar(pData[nLineBegin])) {
+            ++nLineBegin;
+        }
+        if ((nLineBegin == nLineEnd) || (pData[nLineBegin] == ';')) {
+            //空行或者注释（注释以";"开头）
+            continue;
+        }
+        const uint8_t* pSep = (const uint8_t*)::memchr(pData + nLineBegin, '=', nLineEnd - nLineBegin);
+        if (pSep == nullptr) {
+            //无分隔符，忽略
+            continue;
+        }
+        size_t nIdEnd = (size_t)(pSep - pData);
+        size_t nValueBegin = nIdEnd + 1;
+        while ((nIdEnd > nLineBegin) && IsSpaceChar(pData[nIdEnd - 1])) {
+            --nIdEnd;
+        }
+        if (nIdEnd == nLineBegin) {
+            //ID为空，忽略
+            continue;
+        }
+        while ((nValueBegin < nLineEnd) && IsSpaceChar(pData[nValueBegin])) {
+            ++nValueBegin;
+        }
+        while ((nLineEnd > nValueBegin) && IsSpaceChar(pData[nLineEnd - 1])) {
+            --nLineEnd;
+        }
+        IndexEntry entry;
+        entry.m_nIdOffset = (uint32_t)nLineBegin;
+        entry.m_nIdLength = (uint32_t)(nIdEnd - nLineBegin);
+        entry.m_nValueOffset = (uint32_t)nValueBegin;
+        entry.m_nValueLength = (uint32_t)(nLineEnd - nValueBegin);
+        entry.m_nHash = HashId((const char*)pData + entry.m_nIdOffset, entry.m_nIdLength);
+        m_textIndex.push_back(entry);
+    }
+
+    //按哈希值排序，相同的ID按在文件中的位置排序，重复的ID保留最后一个
+    std::sort(m_textIndex.begin(), m_textIndex.end(), [pData](const IndexEntry& a, const IndexEntry& b) {
+            if (a.m_nHash != b.m_nHash) {
+                return a.m_nHash < b.m_nHash;
+            }
+            int nRet = std::string_view((const char*)pData + a.m_nIdOffset, a.m_nIdLength).compare(
+                       std::string_view((const char*)pData + b.m_nIdOffset, b.m_nIdLength));
+            if (nRet != 0) {
+                return nRet < 0;
+            }
+            return a.m_nIdOffset < b.m_nIdOffset;
+        });
+    size_t nCount = 0;
+    for (size_t nIndex = 0; nIndex < m_textIndex.size(); ++nIndex) {
+        const IndexEntry& entry = m_textIndex[nIndex];
+        if ((nIndex + 1) < m_textIndex.size()) {
+            const IndexEntry& next = m_textIndex[nIndex + 1];
+            if ((next.m_nHash == entry.m_nHash) && (next.m_nIdLength == entry.m_nIdLength) &&
+                (::memcmp(pData + next.m_nIdOffset, pData + entry.m_nIdOffset, entry.m_nIdLength) == 0)) {
+                continue;
+            }
+        }
+        m_textIndex[nCount++] = entry;
+    }
+    m_textIndex.resize(nCount);
+    m_pIndex = m_textIndex.data();
+    m_nIndexCount = m_textIndex.size();
+    return true;
+}
+
+const LangStringTable::IndexEntry* LangStringTable::FindEntry(const std::string& id) const
+{
+    if ((m_pIndex == nullptr) || (m_nIndexCount == 0) || id.empty()) {
+        return nullptr;
+    }
+    const uint32_t nHash = HashId(id.c_str(), id.size());
+    const IndexEntry* pBegin = m_pIndex;
+    const IndexEntry* pEnd = m_pIndex + m_nIndexCount;
+    const IndexEntry* pEntry = std::lower_bound(pBegin, pEnd, nHash, [](const IndexEntry& entry, uint32_t nHash) {
+            return entry.m_nHash < nHash;
+        });
+    for (; (pEntry != pEnd) && (pEntry->m_nHash == nHash); ++pEntry) {
+        if (((uint64_t)pEntry->m_nIdOffset + pEntry->m_nIdLength > m_nSize) ||
+            ((uint64_t)pEntry->m_nValueOffset + pEntry->m_nValueLength > m_nSize)) {
+            ASSERT(!"LangStringTable: invalid index entry!");
+            return nullptr;
+        }
+        if ((pEntry->m_nIdLength == id.size()) &&
+            (::memcmp(m_pData + pEntry->m_nIdOffset, id.c_str(), id.size()) == 0)) {
+            return pEntry;
+        }
+    }
+    return nullptr;
+}
+
+bool LangStringTable::FindString(const std::string& id, DString& value) const
+{
+    value.clear();
+    const IndexEntry* pEntry = FindEntry(id);
+    if (pEntry == nullptr) {
+        return false;
+    }
+    if (pEntry->m_nValueLength > 0) {
+        value = StringConvert::UTF8ToT((const DUTF8Char*)m_pData + pEntry->m_nValueOffset, pEntry->m_nValueLength);
+        if (m_bTextFormat) {
+            //将\n和\r替换为真实的换行符、回车符
+            StringUtil::ReplaceAll(_T("\\r"), _T("\r"), value);
+            StringUtil::ReplaceAll(_T("\\n"), _T("\n"), value);
+        }
+    }
+    return true;
+}
+
+bool LangStringTable::CompileStringTable(const std::vector<uint8_t>& textData, std::vector<uint8_t>& compiledData)
+{
+    compiledData.clear();
+    LangStringTable table;
+    if (!table.LoadData(textData) || !table.m_bTextFormat) {
+        return false;
+    }
+    //文件布局：文件头 + 索引 + 字符串数据（UTF8编码，已处理转义）
+    const size_t nCount = table.m_textIndex.size();
+    const size_t nIndexOffset = sizeof(LangStringTableHeader);
+    std::vector<IndexEntry> index(table.m_textIndex);
+    std::string blob;
+    std::string value;
+    size_t nDataOffset = nIndexOffset + nCount * sizeof(IndexEntry);
+    for (IndexEntry& entry : index) {
+        value.assign((const char*)table.m_pData + entry.m_nValueOffset, entry.m_nValueLength);
+        StringUtil::ReplaceAll("\\r", "\r", value);
+        StringUtil::ReplaceAll("\\n", "\n", value);
+
+        const size_t nIdOffset = nDataOffset + blob.size();
+        blob.append((const char*)table.m_pData + entry.m_nIdOffset, entry.m_nIdLength);
+        const size_t nValueOffset = nDataOffset + blob.size();
+        blob.append(value);
+        if ((nValueOffset + value.size()) > UINT32_MAX) {
+            return false;
+        }
+        entry.m_nIdOffset = (uint32_t)nIdOffset;
+        entry.m_nValueOffset = (uint32_t)nValueOffset;
+        entry.m_nValueLength = (uint32_t)value.size();
+    }
+
+    LangStringTableHeader header;
+    ::memcpy(header.m_magic, kCompiledMagic, sizeof(kCompiledMagic));
+    header.m_nVersion = kCompiledVersion;
+    header.m_nCount = (uint32_t)nCount;
+    header.m_nIndexOffset = (uint32_t)nIndexOffset;
+
+    compiledData.resize(nDataOffset + blob.size());
+    ::memcpy(compiledData.data(), &header, sizeof(header));
+    if (nCount > 0) {
+        ::memcpy(compiledData.data() + nIndexOffset, index.data(), nCount * sizeof(IndexEntry));
+    }
+    if (!blob.empty()) {
+        ::memcpy(compiledData.data() + nDataOffset, blob.data(), blob.size());
+    }
+    return true;
+}
+
+uint32_t LangStringTable::HashId(const char* id, size_t length)
+{
+    //FNV-1a
+    uint32_t nHash = 2166136261u;
+    for (size_t i = 0; i < length; ++i) {
+        nHash ^= (uint8_t)id[i];
+        nHash *= 16777619u;
+    }
+    return nHash;
+}
+
+}//namespace ui 
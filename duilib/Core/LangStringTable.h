@@ -0,0 +1,125 @@
+#ifndef UI_CORE_LANG_STRING_TABLE_H_
+#define UI_CORE_LANG_STRING_TABLE_H_
+
+#include "duilib/Utils/FileMapping.h"
+#include <string>
+#include <vector>
+
+namespace ui 
+{
+
+/** 语言字符串表的索引（字符串ID和字符串都保存为UTF8编码，按需解码为DString）
+*   支持两种数据格式：
+*   1. 文本格式（"ID=字符串"，每行一条，";"开头的行为注释）：加载时扫描一遍建立索引，不做编码转换；
+*   2. 编译格式（由CompileStringTable从文本格式生成）：文件中已经包含排好序的索引，加载时只校验文件头，
+*      配合内存映射文件使用，启动时几乎没有解析开销（加载期间文件不能被修改或者替换）
+*   查找时按字符串ID的哈希值二分查找
+*/
+class LangStringTable
+{
+public:
+    LangStringTable();
+    ~LangStringTable();
+    LangStringTable(const LangStringTable&) = delete;
+    LangStringTable& operator = (const LangStringTable&) = delete;
+
+public:
+    /** 从本地文件加载（自动识别文本格式和编译格式）
+    *   编译格式的文件保持内存映射直到Clear或者重新加载，在此期间文件不能被修改或者替换；
+    *   文本格式的文件复制一份数据后即关闭，加载后可以修改或者替换文件
+    * @param [in] filePath 语言文件的完整路径
+    */
+    bool LoadFile(const FilePath& filePath);
+
+    /** 从内存中加载（复制一份数据，自动识别文本格式和编译格式）
+    * @param [in] fileData 语言文件的数据
+    */
+    bool LoadData(const std::vector<uint8_t>& fileData);
+
+    /** 清除数据
+    */
+    void Clear();
+
+    /** 获取字符串的个数
+    */
+    size_t GetCount() const;
+
+    /** 查找字符串
+    * @param [in] id 字符串ID（UTF8编码）
+    * @param [out] value 返回解码后的字符串
+    * @return 如果不存在该ID，返回false
+    */
+    bool FindString(const std::string& id, DString& value) const;
+
+    /** 将文本格式的语言文件转换为编译格式
+    * @param [in] textData 文本格式的语言文件数据
+    * @param [out] compiledData 返回编译格式的数据
+    */
+    static bool CompileStringTable(const std::vector<uint8_t>& textData, std::vector<uint8_t>& compiledData);
+
+private:
+    /** 索引项（编译格式的文件中直接保存该结构）
+    */
+    struct IndexEntry
+    {
+        uint32_t m_nHash;          //字符串ID的哈希值
+        uint32_t m_nIdOffset;      //字符串ID在数据中的偏移
+        uint32_t m_nIdLength;      //字符串ID的长度（字节）
+        uint32_t m_nValueOffset;   //字符串在数据中的偏移
+        uint32_t m_nValueLength;   //字符串的长度（字节）
+    };
+
+    /** 根据已经设置的数据建立索引
+    */
+    bool BuildIndex();
+
+    /** 是否为编译格式的数据（检查文件标识）
+    */
+    static bool IsCompiledData(const uint8_t* pData, size_t nSize);
+
+    /** 解析文本格式，建立索引
+    */
+    bool ParseTextData(const uint8_t* pData, size_t nSize);
+
+    /** 校验编译格式的文件头和索引
+    */
+    bool CheckCompiledData(const uint8_t* pData, size_t nSize);
+
+    /** 查找索引项
+    */
+    const IndexEntry* FindEntry(const std::string& id) const;
+
+    /** 计算字符串ID的哈希值
+    */
+    static uint32_t HashId(const char* id, size_t length);
+
+private:
+    /** 内存映射文件（从本地文件加载编译格式时使用）
+    */
+    FileMapping m_fileMapping;
+
+    /** 文件数据（从内存中加载，或者从本地文件加载文本格式时使用）
+    */
+    std::vector<uint8_t> m_fileData;
+
+    /** 数据的起始地址和长度
+    */
+    const uint8_t* m_pData;
+    size_t m_nSize;
+
+    /** 索引，按哈希值排序：文本格式时指向m_textIndex，编译格式时指向文件数据中的索引
+    */
+    const IndexEntry* m_pIndex;
+    size_t m_nIndexCount;
+
+    /** 文本格式的索引
+    */
+    std::vector<IndexEntry> m_textIndex;
+
+    /** 是否为文本格式（文本格式的字符串需要在解码时处理"\r"和"\n"转义）
+    */
+    bool m_bTextFormat;
+};
+
+}
+#endif //UI_CORE_LANG_STRING_TABLE_H_
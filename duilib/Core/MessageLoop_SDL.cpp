@@ -5,10 +5,19 @@
 
 #include "NativeWindow_SDL.h"
 #include <SDL3/SDL.h>
+#include <algorithm>
 
 namespace ui
 {
 std::unordered_map<uint32_t, SDLUserMessageCallback> MessageLoop_SDL::s_userMsgCallbacks;
+std::vector<uint32_t> MessageLoop_SDL::s_paintWindowIds;
+uint64_t MessageLoop_SDL::s_nNextFrameTime = 0;
+uint64_t MessageLoop_SDL::s_nFrameInterval = 0;
+int32_t MessageLoop_SDL::s_nMaxFrameRate = 0;
+
+/** 获取不到显示器刷新率时，使用的默认刷新率
+*/
+static constexpr float kDefaultRefreshRate = 60.0f;
 
 MessageLoop_SDL::MessageLoop_SDL()
 {
@@ -40,7 +49,7 @@ bool MessageLoop_SDL::CheckInitSDL(const DString& videoDriverName)
         //1. SDL_EVENT_USER + 0:  MessageLoop_SDL::PostNoneEvent 函数占用
         //2. SDL_EVENT_USER + 1:  duilib\Core\FrameworkThread.cpp WM_USER_DEFINED_MSG 消息占用
         //3. SDL_EVENT_USER + 2:  duilib\Core\TimerManager.cpp WM_USER_DEFINED_TIMER 占用
-        //4. SDL_EVENT_USER + 3:  duilib\Core\NativeWindow_SDL.cpp WM_USER_PAINT_MSG 占用
+        //4. SDL_EVENT_USER + 3:  保留（原NativeWindow_SDL.cpp WM_USER_PAINT_MSG 占用，现由消息循环的绘制队列代替）
     }
     return bRet;
 }
@@ -60,7 +69,7 @@ int32_t MessageLoop_SDL::Run()
     while (bKeepGoing) {
 
         /* run through all pending events until we run out. */
-        while (bKeepGoing && SDL_WaitEvent(&sdlEvent)) {
+        while (bKeepGoing && WaitEvent(sdlEvent)) {
             switch (sdlEvent.type) {
             case SDL_EVENT_QUIT:  /* triggers on last window close and other things. End the program. */
                 bKeepGoing = false;
@@ -113,7 +122,7 @@ void MessageLoop_SDL::RunDoModal(NativeWindow_SDL& nativeWindow, bool bCloseByEs
     while (bKeepGoing) {
 
         /* run through all pending events until we run out. */
-        while (bKeepGoing && SDL_WaitEvent(&sdlEvent)) {
+        while (bKeepGoing && WaitEvent(sdlEvent)) {
             switch (sdlEvent.type) {
             case SDL_EVENT_QUIT:  /* triggers on last window close and other things. End the program. */
                 bKeepGoing = false;
@@ -176,7 +185,7 @@ void MessageLoop_SDL::RunUserLoop(bool& bTerminate)
     while (bKeepGoing) {
 
         /* run through all pending events until we run out. */
-        while (bKeepGoing && SDL_WaitEvent(&sdlEvent)) {
+        while (bKeepGoing && WaitEvent(sdlEvent)) {
             switch (sdlEvent.type) {
             case SDL_EVENT_QUIT:  /* triggers on last window close and other things. End the program. */
                 bKeepGoing = false;
@@ -279,6 +288,91 @@ void MessageLoop_SDL::RemoveUserMessageCallback(uint32_t msgId)
     }
 }
 
+void MessageLoop_SDL::SchedulePaint(uint32_t windowID)
+{
+    ASSERT(windowID != 0);
+    if (windowID == 0) {
+        return;
+    }
+    //窗口自身有等待绘制的标志，每帧只会加入一次，队列很短
+    if (std::find(s_paintWindowIds.begin(), s_paintWindowIds.end(), windowID) == s_paintWindowIds.end()) {
+        s_paintWindowIds.push_back(windowID);
+    }
+}
+
+void MessageLoop_SDL::SetMaxFrameRate(int32_t nMaxFrameRate)
+{
+    ASSERT(nMaxFrameRate >= 0);
+    if (nMaxFrameRate < 0) {
+        nMaxFrameRate = 0;
+    }
+    s_nMaxFrameRate = nMaxFrameRate;
+}
+
+int32_t MessageLoop_SDL::GetMaxFrameRate()
+{
+    return s_nMaxFrameRate;
+}
+
+bool MessageLoop_SDL::WaitEvent(SDL_Event& sdlEvent)
+{
+    while (true) {
+        if (s_paintWindowIds.empty()) {
+            //没有等待绘制的窗口，一直等待消息
+            return SDL_WaitEvent(&sdlEvent);
+        }
+        const uint64_t nNow = SDL_GetTicksNS();
+        //优先处理输入消息，消息队列为空时再绘制；但如果绘制已经推迟超过一帧，先绘制，避免持续输入时界面不刷新
+        if (nNow < s_nNextFrameTime + s_nFrameInterval) {
+            if (SDL_PollEvent(&sdlEvent)) {
+                return true;
+            }
+        }
+        if (nNow >= s_nNextFrameTime) {
+            PaintPendingWindows();
+            continue;
+        }
+        //未到下一帧的绘制时间，等待消息或者超时
+        const uint64_t nWaitNS = s_nNextFrameTime - nNow;
+        const int32_t nWaitMS = (int32_t)std::max<uint64_t>(nWaitNS / SDL_NS_PER_MS, 1);
+        if (SDL_WaitEventTimeout(&sdlEvent, nWaitMS)) {
+            return true;
+        }
+    }
+}
+
+void MessageLoop_SDL::PaintPendingWindows()
+{
+    //绘制过程中可能再次调用Invalidate（比如动画）：PaintWindow在绘制前已清除窗口的等待绘制标志，
+    //所以这些窗口会重新加入绘制队列，在下一帧绘制
+    std::vector<uint32_t> windowIds;
+    windowIds.swap(s_paintWindowIds);
+    const uint64_t nFrameStart = SDL_GetTicksNS();
+    float fRefreshRate = 0;
+    for (uint32_t windowID : windowIds) {
+        NativeWindow_SDL* pWindow = NativeWindow_SDL::GetWindowFromID(windowID);
+        if ((pWindow == nullptr) || !pWindow->IsPaintPending()) {
+            //窗口已经销毁，或者已经同步绘制过
+            continue;
+        }
+        SDL_Window* sdlWindow = (SDL_Window*)pWindow->GetWindowHandle();
+        const SDL_DisplayMode* pDisplayMode = SDL_GetCurrentDisplayMode(SDL_GetDisplayForWindow(sdlWindow));
+        if ((pDisplayMode != nullptr) && (pDisplayMode->refresh_rate > fRefreshRate)) {
+            fRefreshRate = pDisplayMode->refresh_rate;
+        }
+        pWindow->PaintWindow(false);
+    }
+    if (fRefreshRate <= 0) {
+        fRefreshRate = kDefaultRefreshRate;
+    }
+    //帧间隔：不超过显示器的刷新率，同时不超过设置的最大帧率
+    s_nFrameInterval = (uint64_t)(SDL_NS_PER_SECOND / fRefreshRate);
+    if (s_nMaxFrameRate > 0) {
+        s_nFrameInterval = std::max<uint64_t>(s_nFrameInterval, SDL_NS_PER_SECOND / (uint64_t)s_nMaxFrameRate);
+    }
+    s_nNextFrameTime = nFrameStart + s_nFrameInterval;
+}
+
 void MessageLoop_SDL::OnUserEvent(const SDL_Event& sdlEvent)
 {
     if ((sdlEvent.type <= SDL_EVENT_USER) || (sdlEvent.type >= SDL_EVENT_LAST)) {
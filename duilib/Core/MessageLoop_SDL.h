@@ -4,6 +4,7 @@
 #include "duilib/duilib_defs.h"
 #include <functional>
 #include <unordered_map>
+#include <vector>
 
 #if defined(DUILIB_BUILD_FOR_SDL)
 
@@ -79,15 +80,55 @@ public:
     */
     static bool CheckInitSDL(const DString& videoDriverName = _T(""));
 
+public:
+    /** 将窗口加入绘制队列，在处理完当前的输入消息后绘制（每帧最多绘制一次）
+    * @param [in] windowID 窗口的ID(SDL_WindowID)
+    */
+    static void SchedulePaint(uint32_t windowID);
+
+    /** 设置最大帧率（每秒绘制的次数），实际帧率同时不超过显示器的刷新率
+    * @param [in] nMaxFrameRate 最大帧率，0表示不限制（仅按显示器的刷新率限制）
+    */
+    static void SetMaxFrameRate(int32_t nMaxFrameRate);
+
+    /** 获取最大帧率
+    */
+    static int32_t GetMaxFrameRate();
+
 private:
     /** 处理用户自定义消息
     */
     static void OnUserEvent(const SDL_Event& sdlEvent);
 
+    /** 获取下一个消息，等待期间按帧绘制队列中的窗口
+    * @param [out] sdlEvent 返回消息
+    */
+    static bool WaitEvent(SDL_Event& sdlEvent);
+
+    /** 绘制队列中的窗口，并计算下一帧的时间
+    */
+    static void PaintPendingWindows();
+
 private:
     /** 自定义消息映射
     */
     static std::unordered_map<uint32_t, SDLUserMessageCallback> s_userMsgCallbacks;
+
+    /** 等待绘制的窗口ID
+    */
+    static std::vector<uint32_t> s_paintWindowIds;
+
+    /** 下一帧的最早绘制时间(纳秒)
+    */
+    static uint64_t s_nNextFrameTime;
+
+    /** 帧间隔(纳秒)
+    */
+    static uint64_t s_nFrameInterval;
+
+    /** 最大帧率，0表示不限制
+    */
+    static int32_t s_nMaxFrameRate;
 };
 
 } // namespace ui
@@ -16,10 +16,6 @@
     #include "SDL_MacOS.h"
 #endif
 
-/** 主动绘制
-*/
-#define WM_USER_PAINT_MSG (SDL_EVENT_USER + 3)
-
 namespace ui {
 
 //窗口指针与SDL窗口ID的映射关系，用于转接消息
@@ -319,10 +315,6 @@ bool NativeWindow_SDL::OnSDLWindowEvent(const SDL_Event& sdlEvent)
     case SDL_EVENT_WINDOW_EXPOSED:
         //异步窗口绘制消息: 系统发生的消息已经进行了同步绘制，此处不重新绘制
         break;
-    case WM_USER_PAINT_MSG:
-        //主动发起的窗口绘制消息
-        PaintWindow(false);
-        break;
     case SDL_EVENT_WINDOW_MOUSE_ENTER:
         //不需要处理，Windows没有这个消息
         break;
@@ -567,7 +559,8 @@ NativeWindow_SDL::NativeWindow_SDL(INativeWindow* pOwner):
     m_bFakeModal(false),
     m_bDoModal(false),
     m_bFullScreen(false),
-    m_ptLastMousePos(-1, -1)
+    m_ptLastMousePos(-1, -1),
+    m_bPaintPending(false)
 {
     ASSERT(m_pOwner != nullptr);    
 }
@@ -2149,25 +2142,6 @@ bool NativeWindow_SDL::IsCaptured() const
     return m_bMouseCapture;
 }
 
-struct NativeWindowExposedEvent
-{
-    SDL_Window* m_sdlWindow = nullptr;
-    bool m_bFoundExposedEvent = false;
-};
-
-static bool SDLCALL FilterNativeWindowExposedEvent(void* userdata, SDL_Event* event)
-{
-    if ((userdata != nullptr) && (event != nullptr)) {
-        NativeWindowExposedEvent* data = (NativeWindowExposedEvent*)userdata;
-        if (!data->m_bFoundExposedEvent && (event->type == WM_USER_PAINT_MSG)) {
-            if (data->m_sdlWindow == SDL_GetWindowFromEvent(event)) {
-                data->m_bFoundExposedEvent = true;
-            }
-        }
-    }
-    return true;
-}
-
 void NativeWindow_SDL::Invalidate(const UiRect& rcItem)
 {
     if (m_rcUpdateRect.IsZero()) {
@@ -2177,41 +2151,35 @@ void NativeWindow_SDL::Invalidate(const UiRect& rcItem)
         m_rcUpdateRect.Union(rcItem);
     }
 
-    //暂时没有此功能, 只能发送一个绘制消息，触发界面绘制
-    if (m_sdlWindow != nullptr) {
-        NativeWindowExposedEvent data;
-        data.m_bFoundExposedEvent = false;
-        data.m_sdlWindow = m_sdlWindow;
-        SDL_FilterEvents(FilterNativeWindowExposedEvent, &data);
-        if (!data.m_bFoundExposedEvent) {
-            //如果队列中没有该窗口的绘制消息，则添加一个；但如果有的话，就不重复添加，避免重复绘制而影响性能
-            SDL_Event sdlEvent;
-            sdlEvent.type = WM_USER_PAINT_MSG;
-            sdlEvent.common.timestamp = 0;
-            sdlEvent.user.data1 = 0;
-            sdlEvent.user.data2 = 0;
-            sdlEvent.user.windowID = SDL_GetWindowID(m_sdlWindow);
-            bool nRet = SDL_PushEvent(&sdlEvent);
-            ASSERT_UNUSED_VARIABLE(nRet);
-        }
+    //加入消息循环的绘制队列：多次调用只加入一次，由消息循环在处理完输入消息后按帧绘制
+    if ((m_sdlWindow != nullptr) && !m_bPaintPending) {
+        m_bPaintPending = true;
+        MessageLoop_SDL::SchedulePaint(SDL_GetWindowID(m_sdlWindow));
     }
 }
 
 void NativeWindow_SDL::PaintWindow(bool bPaintAll)
 {
     PerformanceStat statPerformance(_T("PaintWindow, NativeWindow_SDL::PaintWindow(Total)"));
-    if (bPaintAll) {
-        //绘制全部
-        m_rcUpdateRect.Clear();
-    }
     INativeWindow* pOwner = m_pOwner;
     ASSERT(pOwner != nullptr);
     if (pOwner == nullptr) {
+        m_rcUpdateRect.Clear();
+        m_bPaintPending = false;
         return;
     }
     //接口的生命周期标志
     std::weak_ptr<WeakFlag> ownerFlag = pOwner->GetWeakFlag();
     bool bPaint = pOwner->OnNativePreparePaint();
+
+    //取出本次需要绘制的区域（bPaintAll为true时绘制全部），并清除等待绘制的标志：
+    //绘制过程中产生的重绘请求（比如动画、异步加载的图片），会重新加入绘制队列，在下一帧绘制
+    m_rcPaintRect.Clear();
+    if (!bPaintAll) {
+        m_rcPaintRect = m_rcUpdateRect;
+    }
+    m_rcUpdateRect.Clear();
+    m_bPaintPending = false;
     if (bPaint && !ownerFlag.expired()) {
         IRender* pRender = pOwner->OnNativeGetRender();
         ASSERT(pRender != nullptr);
@@ -2224,12 +2192,17 @@ void NativeWindow_SDL::PaintWindow(bool bPaintAll)
             bPaint = pRender->PaintAndSwapBuffers(&renderPaint);
         }
     }
-    m_rcUpdateRect.Clear();
+    m_rcPaintRect.Clear();
 }
 
 const UiRect& NativeWindow_SDL::GetUpdateRect() const
 {
-    return m_rcUpdateRect;
+    return m_rcPaintRect;
+}
+
+bool NativeWindow_SDL::IsPaintPending() const
+{
+    return m_bPaintPending;
 }
 
 void NativeWindow_SDL::SetImeOpenStatus(bool bOpen)
@@ -517,10 +517,14 @@ public:
     */
     void PaintWindow(bool bPaintAll);
 
-    /** 窗口更新的区域（需要绘制）
+    /** 正在绘制的区域（仅在PaintWindow绘制过程中有效，为空表示绘制全部）
     */
     const UiRect& GetUpdateRect() const;
 
+    /** 是否有等待绘制的区域（调用Invalidate以后，到下一帧绘制之前）
+    */
+    bool IsPaintPending() const;
+
     /** 设置输入法的开关状态（关闭再打开以后，能够保持原输入法状态）
     * @param [in] bOpen true标识打开输入法，false标识关闭输入法
     */
@@ -694,6 +698,14 @@ private:
     /** 窗口更新的区域（需要绘制）
     */
     UiRect m_rcUpdateRect;
+
+    /** 正在绘制的区域（绘制开始时从m_rcUpdateRect中取出）
+    */
+    UiRect m_rcPaintRect;
+
+    /** 是否有等待绘制的区域（已经加入消息循环的绘制队列）
+    */
+    bool m_bPaintPending;
 };
 
 /** 定义别名
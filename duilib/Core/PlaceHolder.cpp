@@ -472,6 +472,10 @@ void PlaceHolder::Arrange()
 void PlaceHolder::ArrangeAncestor()
 {
     SetReEstimateSize(true);
+    if ((m_pWindow != nullptr) && m_pWindow->IsArrangeDeferred()) {
+        //窗口统一进行布局
+        return;
+    }
     if ((m_pWindow == nullptr) || (m_pWindow->GetRoot() == nullptr)) {
         if (GetParent()) {
             GetParent()->ArrangeSelf();
@@ -502,6 +506,10 @@ void PlaceHolder::ArrangeSelf()
         return;
     }
     SetReEstimateSize(true);
+    if ((m_pWindow != nullptr) && m_pWindow->IsArrangeDeferred()) {
+        //窗口统一进行布局
+        return;
+    }
     m_bIsArranged = true;
     Invalidate();
 
@@ -533,11 +541,17 @@ void PlaceHolder::SetArranged(bool bArranged)
 void PlaceHolder::SetRect(const UiRect& rc)
 {
     //所有调整矩形区域的操作，最终都会通过这里设置
+    bool bRectChanged = false;
     if (!m_uiRect.Equals(rc)) {
         //区域变化，标注绘制缓存脏标记位
         SetCacheDirty(true);
+        bRectChanged = true;
     }
     m_uiRect = rc;
+    if (bRectChanged && (GetParent() != nullptr)) {
+        //通知父容器更新子控件的空间索引
+        GetParent()->OnChildRectChanged(this);
+    }
     if ((GetParent() != nullptr) && IsFloat()) {
         //浮动控件，则需要记录和父控件相对位置和大小
         UiRect rcParent = GetParent()->GetRect();
@@ -574,6 +588,10 @@ void PlaceHolder::Invalidate()
     }
 
     SetCacheDirty(true);
+    if ((m_pWindow != nullptr) && m_pWindow->IsArrangeDeferred()) {
+        //窗口统一进行重绘
+        return;
+    }
     UiRect rcInvalidate = GetPos();    
     ui::UiPoint scrollBoxOffset = GetScrollOffsetInScrollBox();
     rcInvalidate.Offset(-scrollBoxOffset.x, -scrollBoxOffset.y);
@@ -673,6 +673,12 @@ void ScrollBar::HandleEvent(const EventArgs& msg)
     }
 }
 
+bool ScrollBar::GetOpaqueRect(UiRect& /*rcOpaque*/) const
+{
+    //滚动条不绘制背景颜色
+    return false;
+}
+
 void ScrollBar::Paint(IRender* pRender, const UiRect& rcPaint)
 {
     UiRect paintRect = GetPaintRect();
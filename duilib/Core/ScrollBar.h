@@ -35,6 +35,7 @@ public:
     virtual void HandleEvent(const EventArgs& msg) override;
     virtual void SetAttribute(const DString& strName, const DString& strValue) override;
     virtual void Paint(IRender* pRender, const UiRect& rcPaint) override;
+    virtual bool GetOpaqueRect(UiRect& rcOpaque) const override;
     virtual void ClearImageCache() override;
 
     /** DPI发生变化，更新控件大小和布局
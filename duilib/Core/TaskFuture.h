@@ -0,0 +1,307 @@
+#ifndef UI_CORE_TASK_FUTURE_H_
+#define UI_CORE_TASK_FUTURE_H_
+
+//该文件由ThreadManager.h包含，不需要直接包含该文件
+#include "duilib/Core/ThreadManager.h"
+#include <optional>
+#include <type_traits>
+
+namespace ui
+{
+/** 异步任务结果的共享数据（由TaskFuture持有，线程安全）
+*/
+template<typename T>
+class TaskFutureState
+{
+public:
+    /** 结果值的存储类型（void类型的任务，使用bool作为完成标志）
+    */
+    typedef typename std::conditional<std::is_void<T>::value, bool, T>::type ValueType;
+
+    explicit TaskFutureState(ThreadManager* pThreadManager):
+        m_pThreadManager(pThreadManager),
+        m_bCancelled(false)
+    {
+    }
+    TaskFutureState(const TaskFutureState&) = delete;
+    TaskFutureState& operator = (const TaskFutureState&) = delete;
+
+    /** 设置结果值，并执行所有后续任务
+    */
+    void SetValue(ValueType&& value)
+    {
+        std::vector<StdClosure> continuations;
+        {
+            std::lock_guard<std::mutex> threadGuard(m_mutex);
+            ASSERT(!m_value.has_value() && !m_bCancelled);
+            if (m_value.has_value() || m_bCancelled) {
+                return;
+            }
+            m_value.emplace(std::move(value));
+            continuations.swap(m_continuations);
+        }
+        m_cv.notify_all();
+        for (const StdClosure& continuation : continuations) {
+            continuation();
+        }
+    }
+
+    /** 标记为已取消（任务未能执行，比如任务发送失败、线程池已停止），唤醒等待的线程，并释放所有后续任务
+    *   如果结果已经就绪，不做任何处理
+    */
+    void SetCancelled()
+    {
+        std::vector<StdClosure> continuations;
+        {
+            std::lock_guard<std::mutex> threadGuard(m_mutex);
+            if (m_value.has_value() || m_bCancelled) {
+                return;
+            }
+            m_bCancelled = true;
+            continuations.swap(m_continuations);
+        }
+        m_cv.notify_all();
+        //后续任务不再执行，在不加锁的状态释放（后续任务的结果也随之标记为取消）
+        continuations.clear();
+    }
+
+    /** 添加一个后续任务（如果结果已经就绪，立即执行；如果已经取消，不执行）
+    */
+    void AddContinuation(const StdClosure& continuation)
+    {
+        {
+            std::lock_guard<std::mutex> threadGuard(m_mutex);
+            if (m_bCancelled) {
+                return;
+            }
+            if (!m_value.has_value()) {
+                m_continuations.push_back(continuation);
+                return;
+            }
+        }
+        continuation();
+    }
+
+    /** 结果是否已经就绪
+    */
+    bool IsReady() const
+    {
+        std::lock_guard<std::mutex> threadGuard(m_mutex);
+        return m_value.has_value();
+    }
+
+    /** 是否已经取消
+    */
+    bool IsCancelled() const
+    {
+        std::lock_guard<std::mutex> threadGuard(m_mutex);
+        return m_bCancelled;
+    }
+
+    /** 等待结果就绪或者取消（阻塞）
+    * @return 结果就绪返回true，已经取消返回false
+    */
+    bool Wait() const
+    {
+        std::unique_lock<std::mutex> threadGuard(m_mutex);
+        m_cv.wait(threadGuard, [this]() { return m_value.has_value() || m_bCancelled; });
+        return m_value.has_value();
+    }
+
+    /** 获取结果值（结果必须已经就绪）
+    */
+    const ValueType& GetValue() const
+    {
+        std::lock_guard<std::mutex> threadGuard(m_mutex);
+        ASSERT(m_value.has_value());
+        return *m_value;
+    }
+
+    /** 获取线程管理器
+    */
+    ThreadManager* GetThreadManager() const
+    {
+        return m_pThreadManager;
+    }
+
+private:
+    /** 线程管理器（用于将后续任务发送到指定的线程）
+    */
+    ThreadManager* m_pThreadManager;
+
+    /** 结果值（设置后不再修改）
+    */
+    std::optional<ValueType> m_value;
+
+    /** 是否已经取消（取消后不会再设置结果值）
+    */
+    bool m_bCancelled;
+
+    /** 结果就绪后需要执行的后续任务
+    */
+    std::vector<StdClosure> m_continuations;
+
+    /** 多线程同步机制
+    */
+    mutable std::mutex m_mutex;
+    mutable std::condition_variable m_cv;
+};
+
+/** 任务未执行就被释放时，将共享数据标记为取消（由任务函数持有，任务函数的所有副本释放时检查）
+*/
+template<typename T>
+class TaskFutureCancelGuard
+{
+public:
+    explicit TaskFutureCancelGuard(const std::shared_ptr<TaskFutureState<T>>& spState):
+        m_spState(spState)
+    {
+    }
+    ~TaskFutureCancelGuard()
+    {
+        m_spState->SetCancelled();
+    }
+    TaskFutureCancelGuard(const TaskFutureCancelGuard&) = delete;
+    TaskFutureCancelGuard& operator = (const TaskFutureCancelGuard&) = delete;
+
+private:
+    std::shared_ptr<TaskFutureState<T>> m_spState;
+};
+
+/** 执行任务函数，并将结果设置到共享数据中
+*/
+template<typename R, typename TFunc, typename... Args>
+void InvokeTaskAndSetValue(TaskFutureState<R>& state, TFunc& func, Args&&... args)
+{
+    if constexpr (std::is_void<R>::value) {
+        func(std::forward<Args>(args)...);
+        state.SetValue(true);
+    }
+    else {
+        state.SetValue(func(std::forward<Args>(args)...));
+    }
+}
+
+/** 异步任务的结果（由ThreadManager::PostTaskFuture返回）
+*   可以阻塞等待结果，也可以通过Then函数指定在某个线程（比如kThreadUI）中处理结果
+*/
+template<typename T>
+class TaskFuture
+{
+public:
+    typedef std::shared_ptr<TaskFutureState<T>> StatePtr;
+
+    TaskFuture() = default;
+    explicit TaskFuture(const StatePtr& spState):
+        m_spState(spState)
+    {
+    }
+
+    /** 是否为有效的结果对象（任务发送失败时，返回的结果对象无效）
+    */
+    bool IsValid() const
+    {
+        return m_spState != nullptr;
+    }
+
+    /** 结果是否已经就绪
+    */
+    bool IsReady() const
+    {
+        return (m_spState != nullptr) && m_spState->IsReady();
+    }
+
+    /** 任务是否已经取消（任务发送失败、线程池已停止或者任务被取消，任务不会再执行）
+    */
+    bool IsCancelled() const
+    {
+        return (m_spState != nullptr) && m_spState->IsCancelled();
+    }
+
+    /** 等待任务执行完成（阻塞，注意不要在UI线程中等待耗时任务）
+    * @return 任务执行完成返回true，任务已经取消返回false
+    */
+    bool Wait() const
+    {
+        ASSERT(m_spState != nullptr);
+        if (m_spState != nullptr) {
+            return m_spState->Wait();
+        }
+        return false;
+    }
+
+    /** 等待任务执行完成，并返回任务的结果（阻塞，注意不要在UI线程中等待耗时任务）
+    *   如果任务已经取消，返回默认构造的值
+    */
+    template<typename U = T, typename = typename std::enable_if<!std::is_void<U>::value>::type>
+    const U& Get() const
+    {
+        ASSERT(m_spState != nullptr);
+        if ((m_spState != nullptr) && m_spState->Wait()) {
+            return m_spState->GetValue();
+        }
+        static const U s_defaultValue = U();
+        return s_defaultValue;
+    }
+
+    /** 任务完成后，在指定线程中执行后续任务
+    * @param [in] nThreadIdentifier 执行后续任务的线程标识ID，比如kThreadUI
+    * @param [in] func 后续任务，函数原型：R Func(const T& value)，如果T为void，函数原型为：R Func()
+    *                  如需在控件或者窗口销毁后自动取消，可使用ToWeakCallback或者UiBind对函数进行包装
+    * @return 返回后续任务的结果，可以继续调用Then形成任务链
+    */
+    template<typename TFunc>
+    auto Then(int32_t nThreadIdentifier, TFunc func) const
+    {
+        typedef typename std::conditional<std::is_void<T>::value,
+                                          std::invoke_result<TFunc>,
+                                          std::invoke_result<TFunc, const typename TaskFutureState<T>::ValueType&>>::type::type R;
+        typedef std::shared_ptr<TaskFutureState<R>> NextStatePtr;
+        ASSERT(m_spState != nullptr);
+        if (m_spState == nullptr) {
+            return TaskFuture<R>();
+        }
+        ThreadManager* pThreadManager = m_spState->GetThreadManager();
+        NextStatePtr spNextState = std::make_shared<TaskFutureState<R>>(pThreadManager);
+        StatePtr spState = m_spState;
+        //后续任务未执行就被释放时（发送失败、线程退出等），后续任务的结果标记为取消
+        auto spCancelGuard = std::make_shared<TaskFutureCancelGuard<R>>(spNextState);
+        StdClosure runTask = [spState, spNextState, spCancelGuard, func]() mutable {
+                if constexpr (std::is_void<T>::value) {
+                    InvokeTaskAndSetValue(*spNextState, func);
+                }
+                else {
+                    InvokeTaskAndSetValue(*spNextState, func, spState->GetValue());
+                }
+            };
+        m_spState->AddContinuation([pThreadManager, nThreadIdentifier, runTask]() {
+                pThreadManager->PostTask(nThreadIdentifier, runTask);
+            });
+        return TaskFuture<R>(spNextState);
+    }
+
+private:
+    /** 共享数据
+    */
+    StatePtr m_spState;
+};
+
+template<typename TFunc>
+auto ThreadManager::PostTaskFuture(int32_t nThreadIdentifier, TFunc func)
+    -> TaskFuture<typename std::invoke_result<TFunc>::type>
+{
+    typedef typename std::invoke_result<TFunc>::type R;
+    std::shared_ptr<TaskFutureState<R>> spState = std::make_shared<TaskFutureState<R>>(this);
+    //任务未执行就被释放时（线程池停止、任务被取消等），结果标记为取消，避免等待的线程永远阻塞
+    auto spCancelGuard = std::make_shared<TaskFutureCancelGuard<R>>(spState);
+    StdClosure task = [spState, spCancelGuard, func]() mutable {
+            InvokeTaskAndSetValue(*spState, func);
+        };
+    if (PostTask(nThreadIdentifier, task) == 0) {
+        return TaskFuture<R>();
+    }
+    return TaskFuture<R>(spState);
+}
+
+}
+#endif //UI_CORE_TASK_FUTURE_H_
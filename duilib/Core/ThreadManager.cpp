@@ -35,6 +35,9 @@ bool ThreadManager::RegisterThread(int32_t nThreadIdentifier, FrameworkThread* p
 bool ThreadManager::HasThread(int32_t nThreadIdentifier) const
 {
     ScopedLock threadGuard(m_threadMutex);
+    if (nThreadIdentifier == kThreadPool) {
+        return (m_spThreadPool != nullptr) && m_spThreadPool->IsRunning();
+    }
     auto iter = m_threadsMap.find(nThreadIdentifier);
     return iter != m_threadsMap.end();
 }
@@ -57,6 +60,9 @@ int32_t ThreadManager::GetCurrentThreadIdentifier() const
     int32_t nThreadIdentifier = kThreadNone;
     std::thread::id currentThreadId = std::this_thread::get_id();
     ScopedLock threadGuard(m_threadMutex);
+    if ((m_spThreadPool != nullptr) && m_spThreadPool->IsPoolThread()) {
+        return kThreadPool;
+    }
     for (auto iter = m_threadsMap.begin(); iter != m_threadsMap.end(); ++iter) {
         FrameworkThreadPtr spFrameworkThread = iter->second;
         if (spFrameworkThread == nullptr) {
@@ -70,12 +76,61 @@ int32_t ThreadManager::GetCurrentThreadIdentifier() const
     return nThreadIdentifier;
 }
 
+bool ThreadManager::StartThreadPool(uint32_t nThreadCount)
+{
+    ScopedLock threadGuard(m_threadMutex);
+    ASSERT(m_spThreadPool == nullptr);
+    if (m_spThreadPool != nullptr) {
+        return false;
+    }
+    std::shared_ptr<ThreadPool> spThreadPool = std::make_shared<ThreadPool>();
+    if (!spThreadPool->Start(nThreadCount)) {
+        return false;
+    }
+    m_spThreadPool = spThreadPool;
+    return true;
+}
+
+void ThreadManager::StopThreadPool()
+{
+    std::shared_ptr<ThreadPool> spThreadPool;
+    {
+        ScopedLock threadGuard(m_threadMutex);
+        spThreadPool.swap(m_spThreadPool);
+    }
+    //在不加锁的状态停止线程池（线程池中正在执行的任务可能会调用本类的函数），避免死锁
+    if (spThreadPool != nullptr) {
+        spThreadPool->Stop();
+    }
+}
+
+uint32_t ThreadManager::GetThreadPoolSize() const
+{
+    ScopedLock threadGuard(m_threadMutex);
+    if (m_spThreadPool != nullptr) {
+        return m_spThreadPool->GetThreadCount();
+    }
+    return 0;
+}
+
+std::shared_ptr<ThreadPool> ThreadManager::GetThreadPool() const
+{
+    ScopedLock threadGuard(m_threadMutex);
+    return m_spThreadPool;
+}
+
 size_t ThreadManager::PostTask(int32_t nThreadIdentifier, const StdClosure& task)
 {
     ASSERT(task != nullptr);
     if (task == nullptr) {
         return 0;
     }
+    if (nThreadIdentifier == kThreadPool) {
+        std::shared_ptr<ThreadPool> spThreadPool = GetThreadPool();
+        size_t nTaskId = (spThreadPool != nullptr) ? spThreadPool->PostTask(task) : 0;
+        ASSERT(nTaskId != 0);
+        return nTaskId;
+    }
     size_t nTaskId = 0;
     ScopedLock threadGuard(m_threadMutex);
     auto iter = m_threadsMap.find(nThreadIdentifier);
@@ -98,6 +153,12 @@ size_t ThreadManager::PostDelayedTask(int32_t nThreadIdentifier, const StdClosur
     if (task == nullptr) {
         return 0;
     }
+    if (nThreadIdentifier == kThreadPool) {
+        std::shared_ptr<ThreadPool> spThreadPool = GetThreadPool();
+        size_t nTaskId = (spThreadPool != nullptr) ? spThreadPool->PostDelayedTask(task, nDelayMs) : 0;
+        ASSERT(nTaskId != 0);
+        return nTaskId;
+    }
     size_t nTaskId = 0;
     ScopedLock threadGuard(m_threadMutex);
     auto iter = m_threadsMap.find(nThreadIdentifier);
@@ -118,6 +179,12 @@ size_t ThreadManager::PostRepeatedTask(int32_t nThreadIdentifier, const StdClosu
     if (task == nullptr) {
         return 0;
     }
+    if (nThreadIdentifier == kThreadPool) {
+        std::shared_ptr<ThreadPool> spThreadPool = GetThreadPool();
+        size_t nTaskId = (spThreadPool != nullptr) ? spThreadPool->PostRepeatedTask(task, nIntervalMs, nTimes) : 0;
+        ASSERT(nTaskId != 0);
+        return nTaskId;
+    }
     size_t nTaskId = 0;
     ScopedLock threadGuard(m_threadMutex);
     auto iter = m_threadsMap.find(nThreadIdentifier);
@@ -133,6 +200,11 @@ size_t ThreadManager::PostRepeatedTask(int32_t nThreadIdentifier, const StdClosu
 
 bool ThreadManager::CancelTask(size_t nTaskId)
 {
+    //在不加锁的状态取消线程池的任务（取消定时任务时需要访问定时器），避免锁的嵌套
+    std::shared_ptr<ThreadPool> spThreadPool = GetThreadPool();
+    if ((spThreadPool != nullptr) && spThreadPool->CancelTask(nTaskId)) {
+        return true;
+    }
     bool bCancelTask = false;
     ScopedLock threadGuard(m_threadMutex);
     for (auto iter = m_threadsMap.begin(); iter != m_threadsMap.end(); ++iter) {
@@ -150,6 +222,7 @@ bool ThreadManager::CancelTask(size_t nTaskId)
 
 void ThreadManager::Clear()
 {
+    StopThreadPool();
     ScopedLock threadGuard(m_threadMutex);
     m_threadsMap.clear();
 }
@@ -2,11 +2,15 @@
 #define UI_CORE_THREAD_MANAGER_H_
 
 #include "duilib/Core/FrameworkThread.h"
+#include "duilib/Core/ThreadPool.h"
 #include "duilib/Core/ControlPtrT.h"
 #include <map>
+#include <type_traits>
 
 namespace ui 
 {
+template<typename T> class TaskFuture;
+
 /** 线程管理器，用以支持线程间通信
 */
 class UILIB_API ThreadManager
@@ -25,7 +29,7 @@ public:
     bool RegisterThread(int32_t nThreadIdentifier, FrameworkThread* pThread);
 
     /** 判断是否包含指定标识符的线程
-    * @param [in] nThreadIdentifier 线程标识ID
+    * @param [in] nThreadIdentifier 线程标识ID（如果为kThreadPool，表示线程池是否已经启动）
     */
     bool HasThread(int32_t nThreadIdentifier) const;
 
@@ -35,10 +39,23 @@ public:
     bool UnregisterThread(int32_t nThreadIdentifier);
 
     /** 获取当前线程的线程标识ID
-    * @return 成功返回线程标识ID，失败则返回kThreadNone(值为-1)
+    * @return 成功返回线程标识ID，失败则返回kThreadNone(值为-1)，如果是线程池的工作线程，返回kThreadPool
     */
     int32_t GetCurrentThreadIdentifier() const;
 
+    /** 启动线程池，启动后可以使用线程标识ID：kThreadPool发送任务
+    * @param [in] nThreadCount 工作线程的个数，如果为0表示按CPU逻辑核心数创建
+    */
+    bool StartThreadPool(uint32_t nThreadCount = 0);
+
+    /** 停止线程池（同步等待工作线程退出，未执行的任务将被丢弃）
+    */
+    void StopThreadPool();
+
+    /** 获取线程池的工作线程个数，如果线程池未启动，返回0
+    */
+    uint32_t GetThreadPoolSize() const;
+
 public:
     /** 向线程发送一个任务，立即执行
     * @param [in] nThreadIdentifier 线程标识ID
@@ -47,6 +64,16 @@ public:
     */
     size_t PostTask(int32_t nThreadIdentifier, const StdClosure& task);
 
+    /** 向线程发送一个有返回值的任务，立即执行
+    * @param [in] nThreadIdentifier 线程标识ID
+    * @param [in] func 任务函数，函数原型：R Func()
+    * @return 返回任务的结果（如果发送失败，返回的结果对象IsValid()为false）
+    *         可以通过结果对象的Then函数，在任务完成后将结果发送到指定线程（比如kThreadUI）中处理
+    */
+    template<typename TFunc>
+    auto PostTaskFuture(int32_t nThreadIdentifier, TFunc func)
+        -> TaskFuture<typename std::invoke_result<TFunc>::type>;
+
     /** 向线程发送一个任务，延迟执行
     * @param [in] nThreadIdentifier 线程标识ID
     * @param [in] task 任务回调函数
@@ -89,6 +116,11 @@ public:
     */
     void SetMainThreadExit();
 
+private:
+    /** 获取线程池（线程安全）
+    */
+    std::shared_ptr<ThreadPool> GetThreadPool() const;
+
 private:
     /** 线程对象的智能指针
     */
@@ -98,6 +130,10 @@ private:
     */
     std::map<int32_t, FrameworkThreadPtr> m_threadsMap;
 
+    /** 线程池（线程标识ID：kThreadPool）
+    */
+    std::shared_ptr<ThreadPool> m_spThreadPool;
+
     /** 多线程同步锁
     */
     mutable std::mutex m_threadMutex;
@@ -112,4 +148,7 @@ private:
 };
 
 }
+
+#include "duilib/Core/TaskFuture.h"
+
 #endif //UI_CORE_THREAD_MANAGER_H_
@@ -0,0 +1,306 @@
+#include "ThreadPool.h"
+#include "duilib/Core/GlobalManager.h"
+#include "duilib/Core/ScopedLock.h"
+
+namespace ui
+{
+/** 当前线程所属的线程池，以及在线程池中的序号（仅工作线程中有效）
+*/
+static thread_local const ThreadPool* s_pCurrentThreadPool = nullptr;
+static thread_local size_t s_nCurrentWorkerIndex = 0;
+
+ThreadPool::ThreadPool():
+    m_bRunning(false),
+    m_nPendingTasks(0),
+    m_nNextQueue(0)
+{
+}
+
+ThreadPool::~ThreadPool()
+{
+    Stop();
+}
+
+bool ThreadPool::Start(uint32_t nThreadCount)
+{
+    ASSERT(!m_bRunning);
+    if (m_bRunning) {
+        return false;
+    }
+    if (nThreadCount == 0) {
+        nThreadCount = std::thread::hardware_concurrency();
+        if (nThreadCount == 0) {
+            nThreadCount = 2;
+        }
+    }
+    ScopedLock queuesGuard(m_queuesMutex);
+    m_bRunning = true;
+    m_nPendingTasks = 0;
+    m_queues.clear();
+    for (uint32_t nIndex = 0; nIndex < nThreadCount; ++nIndex) {
+        m_queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    //先创建完所有队列，再启动线程（工作线程窃取任务时会访问其他线程的队列）
+    for (uint32_t nIndex = 0; nIndex < nThreadCount; ++nIndex) {
+        m_threads.emplace_back(&ThreadPool::WorkerThreadProc, this, (size_t)nIndex);
+    }
+    return true;
+}
+
+void ThreadPool::Stop()
+{
+    ASSERT(!IsPoolThread());
+    {
+        //在m_queuesMutex锁内修改运行状态：此后PushTask和CancelTask不会再访问队列
+        ScopedLock queuesGuard(m_queuesMutex);
+        ScopedLock waitGuard(m_waitMutex);
+        m_bRunning = false;
+    }
+    m_cv.notify_all();
+    //等待线程退出时不能持有m_queuesMutex锁（正在执行的任务可能会调用PushTask）
+    for (std::thread& thread : m_threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    m_threads.clear();
+
+    //未执行的任务在不加锁的状态释放（任务释放时，关联的TaskFuture会被标记为取消）
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    {
+        ScopedLock queuesGuard(m_queuesMutex);
+        queues.swap(m_queues);
+        m_nPendingTasks = 0;
+    }
+    std::map<size_t, TimerTaskInfo> timerTasks;
+    {
+        ScopedLock timerTaskGuard(m_timerTaskMutex);
+        timerTasks.swap(m_timerTasks);
+    }
+    for (auto iter = timerTasks.begin(); iter != timerTasks.end(); ++iter) {
+        if (iter->second.m_nTimerId != 0) {
+            GlobalManager::Instance().Timer().RemoveTimer(iter->second.m_nTimerId);
+        }
+    }
+}
+
+bool ThreadPool::IsRunning() const
+{
+    return m_bRunning;
+}
+
+uint32_t ThreadPool::GetThreadCount() const
+{
+    ScopedLock queuesGuard(m_queuesMutex);
+    return (uint32_t)m_queues.size();
+}
+
+bool ThreadPool::IsPoolThread() const
+{
+    return s_pCurrentThreadPool == this;
+}
+
+int32_t ThreadPool::GetCurrentWorkerIndex() const
+{
+    if (s_pCurrentThreadPool == this) {
+        return (int32_t)s_nCurrentWorkerIndex;
+    }
+    return -1;
+}
+
+size_t ThreadPool::PostTask(const StdClosure& task)
+{
+    ASSERT(task != nullptr);
+    if ((task == nullptr) || !m_bRunning) {
+        return 0;
+    }
+    size_t nTaskId = GlobalManager::Instance().Thread().GetNextTaskId();
+    if (!PushTask(nTaskId, task)) {
+        return 0;
+    }
+    return nTaskId;
+}
+
+size_t ThreadPool::PostDelayedTask(const StdClosure& task, int32_t nDelayMs)
+{
+    return PostRepeatedTask(task, (nDelayMs < 1) ? 1 : nDelayMs, 1);
+}
+
+size_t ThreadPool::PostRepeatedTask(const StdClosure& task, int32_t nIntervalMs, int32_t nTimes)
+{
+    ASSERT((task != nullptr) && (nIntervalMs > 0) && (nTimes != 0));
+    if ((task == nullptr) || (nIntervalMs <= 0) || (nTimes == 0) || !m_bRunning) {
+        return 0;
+    }
+    if (nTimes < 0) {
+        nTimes = -1;
+    }
+    size_t nTaskId = GlobalManager::Instance().Thread().GetNextTaskId();
+    {
+        ScopedLock timerTaskGuard(m_timerTaskMutex);
+        TimerTaskInfo& taskInfo = m_timerTasks[nTaskId];
+        taskInfo.m_task = task;
+        taskInfo.m_nTimes = nTimes;
+        taskInfo.m_nTotalExecTimes = 0;
+        taskInfo.m_nTimerId = 0;
+    }
+    //生成一个定时器，用来触发任务执行（定时器回调在UI线程中执行，只负责将任务放入工作队列）
+    auto timerCallback = UiBind(&ThreadPool::OnTimerTask, this, nTaskId);
+    size_t nTimerId = GlobalManager::Instance().Timer().AddTimer(GetWeakFlag(), timerCallback, nIntervalMs, nTimes);
+    ASSERT(nTimerId > 0);
+
+    ScopedLock timerTaskGuard(m_timerTaskMutex);
+    auto iter = m_timerTasks.find(nTaskId);
+    if (iter != m_timerTasks.end()) {
+        iter->second.m_nTimerId = nTimerId;
+    }
+    return nTaskId;
+}
+
+bool ThreadPool::CancelTask(size_t nTaskId)
+{
+    //取消的任务在不加锁的状态释放，定时器也在不加锁的状态删除，避免锁的嵌套
+    StdClosure cancelledTask;
+    size_t nTimerId = 0;
+    bool bTimerTask = false;
+    {
+        ScopedLock timerTaskGuard(m_timerTaskMutex);
+        auto iter = m_timerTasks.find(nTaskId);
+        if (iter != m_timerTasks.end()) {
+            nTimerId = iter->second.m_nTimerId;
+            cancelledTask.swap(iter->second.m_task);
+            m_timerTasks.erase(iter);
+            bTimerTask = true;
+        }
+    }
+    if (bTimerTask) {
+        if (nTimerId != 0) {
+            GlobalManager::Instance().Timer().RemoveTimer(nTimerId);
+        }
+        return true;
+    }
+    {
+        ScopedLock queuesGuard(m_queuesMutex);
+        if (!m_bRunning) {
+            return false;
+        }
+        for (std::unique_ptr<WorkerQueue>& spQueue : m_queues) {
+            ScopedLock queueGuard(spQueue->m_mutex);
+            for (auto iter = spQueue->m_tasks.begin(); iter != spQueue->m_tasks.end(); ++iter) {
+                if (iter->m_nTaskId == nTaskId) {
+                    cancelledTask.swap(iter->m_task);
+                    spQueue->m_tasks.erase(iter);
+                    --m_nPendingTasks;
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+void ThreadPool::OnTimerTask(size_t nTaskId)
+{
+    StdClosure task;
+    {
+        ScopedLock timerTaskGuard(m_timerTaskMutex);
+        auto iter = m_timerTasks.find(nTaskId);
+        if (iter == m_timerTasks.end()) {
+            //任务已经取消
+            return;
+        }
+        TimerTaskInfo& taskInfo = iter->second;
+        task = taskInfo.m_task;
+        taskInfo.m_nTotalExecTimes++;
+        if ((taskInfo.m_nTimes >= 0) && (taskInfo.m_nTotalExecTimes >= taskInfo.m_nTimes)) {
+            //已经执行完成
+            m_timerTasks.erase(iter);
+        }
+    }
+    if (task != nullptr) {
+        PushTask(nTaskId, task);
+    }
+}
+
+bool ThreadPool::PushTask(size_t nTaskId, const StdClosure& task)
+{
+    //持有m_queuesMutex锁期间，Stop不会释放队列
+    ScopedLock queuesGuard(m_queuesMutex);
+    if (!m_bRunning || m_queues.empty()) {
+        return false;
+    }
+    size_t nQueueIndex = 0;
+    if (IsPoolThread()) {
+        //工作线程中产生的子任务，放入当前线程的队列，优先由本线程执行
+        nQueueIndex = s_nCurrentWorkerIndex;
+    }
+    else {
+        nQueueIndex = m_nNextQueue++ % m_queues.size();
+    }
+    WorkerQueue& workerQueue = *m_queues[nQueueIndex];
+    {
+        ScopedLock queueGuard(workerQueue.m_mutex);
+        PoolTask poolTask;
+        poolTask.m_nTaskId = nTaskId;
+        poolTask.m_task = task;
+        workerQueue.m_tasks.push_back(std::move(poolTask));
+        ++m_nPendingTasks;
+    }
+    queuesGuard.Unlock();
+    {
+        //加锁后再通知，避免工作线程在检查条件与进入等待之间丢失通知
+        ScopedLock waitGuard(m_waitMutex);
+    }
+    m_cv.notify_one();
+    return true;
+}
+
+bool ThreadPool::PopTask(size_t nWorkerIndex, PoolTask& poolTask)
+{
+    const size_t nQueueCount = m_queues.size();
+    //本线程的队列：从队尾取（最近放入的任务，数据在缓存中的可能性大）
+    {
+        WorkerQueue& workerQueue = *m_queues[nWorkerIndex];
+        ScopedLock queueGuard(workerQueue.m_mutex);
+        if (!workerQueue.m_tasks.empty()) {
+            poolTask = std::move(workerQueue.m_tasks.back());
+            workerQueue.m_tasks.pop_back();
+            --m_nPendingTasks;
+            return true;
+        }
+    }
+    //其他线程的队列：从队首窃取（最早放入的任务）
+    for (size_t nOffset = 1; nOffset < nQueueCount; ++nOffset) {
+        WorkerQueue& workerQueue = *m_queues[(nWorkerIndex + nOffset) % nQueueCount];
+        ScopedLock queueGuard(workerQueue.m_mutex);
+        if (!workerQueue.m_tasks.empty()) {
+            poolTask = std::move(workerQueue.m_tasks.front());
+            workerQueue.m_tasks.pop_front();
+            --m_nPendingTasks;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::WorkerThreadProc(size_t nWorkerIndex)
+{
+    s_pCurrentThreadPool = this;
+    s_nCurrentWorkerIndex = nWorkerIndex;
+    while (m_bRunning) {
+        PoolTask poolTask;
+        if (PopTask(nWorkerIndex, poolTask)) {
+            if (poolTask.m_task != nullptr) {
+                poolTask.m_task();
+            }
+            continue;
+        }
+        std::unique_lock<std::mutex> waitGuard(m_waitMutex);
+        m_cv.wait(waitGuard, [this]() {
+                return !m_bRunning || (m_nPendingTasks > 0);
+            });
+    }
+    s_pCurrentThreadPool = nullptr;
+}
+
+}//namespace ui
@@ -0,0 +1,164 @@
+#ifndef UI_CORE_THREAD_POOL_H_
+#define UI_CORE_THREAD_POOL_H_
+
+#include "duilib/Core/Callback.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <map>
+
+namespace ui
+{
+/** 线程池（多个工作线程，每个线程有自己的任务队列，空闲时从其他线程的队列中窃取任务）
+*   适合执行CPU密集型的任务，比如图片解码、排序、文本测量等，可充分利用多核CPU
+*   通过ThreadManager使用时，线程标识ID为：kThreadPool
+*/
+class UILIB_API ThreadPool : public virtual SupportWeakCallback
+{
+public:
+    ThreadPool();
+    virtual ~ThreadPool() override;
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator = (const ThreadPool&) = delete;
+
+public:
+    /** 启动线程池
+    * @param [in] nThreadCount 工作线程的个数，如果为0表示按CPU逻辑核心数创建
+    */
+    bool Start(uint32_t nThreadCount = 0);
+
+    /** 停止线程池（同步停止，等待所有工作线程退出，未执行的任务将被丢弃）
+    */
+    void Stop();
+
+    /** 是否正在运行中
+    */
+    bool IsRunning() const;
+
+    /** 获取工作线程的个数
+    */
+    uint32_t GetThreadCount() const;
+
+    /** 判断当前线程是否为本线程池的工作线程
+    */
+    bool IsPoolThread() const;
+
+    /** 获取当前线程在线程池中的序号
+    * @return 如果当前线程是本线程池的工作线程，返回序号(从0开始)，否则返回-1
+    */
+    int32_t GetCurrentWorkerIndex() const;
+
+public:
+    /** 向线程池发送一个任务，立即执行
+    *   如果在工作线程中调用，任务放入当前线程的队列，否则按轮询方式放入各个工作线程的队列
+    * @param [in] task 任务回调函数
+    * @return 成功返回任务ID(大于0)，如果失败则返回0
+    */
+    size_t PostTask(const StdClosure& task);
+
+    /** 向线程池发送一个任务，延迟执行
+    * @param [in] task 任务回调函数
+    * @param [in] nDelayMs 延迟的时间（单位：毫秒）
+    * @return 成功返回任务ID(大于0)，如果失败则返回0
+    */
+    size_t PostDelayedTask(const StdClosure& task, int32_t nDelayMs);
+
+    /** 向线程池发送一个任务，可定时重复执行
+    * @param [in] task 任务回调函数
+    * @param [in] nIntervalMs 间隔的时间（单位：毫秒）
+    * @param [in] nTimes 重复的次数，如果为-1表示一直执行
+    * @return 成功返回任务ID(大于0)，如果失败则返回0
+    */
+    size_t PostRepeatedTask(const StdClosure& task, int32_t nIntervalMs, int32_t nTimes = -1);
+
+    /** 取消一个任务（已经开始执行的任务无法取消）
+    * @param [in] nTaskId 任务ID，即上面的PostXXX函数的返回值
+    * @return 取消成功返回true，否则返回false
+    */
+    bool CancelTask(size_t nTaskId);
+
+private:
+    /** 任务信息
+    */
+    struct PoolTask
+    {
+        size_t m_nTaskId = 0;   //任务ID
+        StdClosure m_task;      //任务回调函数
+    };
+
+    /** 每个工作线程的任务队列（本线程从队尾取任务，其他线程从队首窃取任务）
+    */
+    struct WorkerQueue
+    {
+        std::deque<PoolTask> m_tasks;
+        std::mutex m_mutex;
+    };
+
+    /** 将任务放入队列，并唤醒工作线程
+    */
+    bool PushTask(size_t nTaskId, const StdClosure& task);
+
+    /** 从队列中取出一个任务（优先取本线程的任务，如果没有则从其他线程窃取）
+    */
+    bool PopTask(size_t nWorkerIndex, PoolTask& poolTask);
+
+    /** 定时器触发时，将定时任务放入队列
+    */
+    void OnTimerTask(size_t nTaskId);
+
+    /** 工作线程的线程函数
+    */
+    void WorkerThreadProc(size_t nWorkerIndex);
+
+private:
+    /** 工作线程
+    */
+    std::vector<std::thread> m_threads;
+
+    /** 每个工作线程的任务队列(与m_threads一一对应)
+    */
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+
+    /** 任务队列列表的多线程同步锁（保护m_queues的创建和释放，以及m_bRunning的修改）
+    *   工作线程只在Start和Stop之间访问m_queues，不需要加此锁
+    */
+    mutable std::mutex m_queuesMutex;
+
+    /** 是否正在运行中
+    */
+    std::atomic<bool> m_bRunning;
+
+    /** 等待执行的任务个数
+    */
+    std::atomic<size_t> m_nPendingTasks;
+
+    /** 下一个放入任务的队列序号（轮询）
+    */
+    std::atomic<size_t> m_nNextQueue;
+
+    /** 工作线程空闲时的等待机制
+    */
+    std::mutex m_waitMutex;
+    std::condition_variable m_cv;
+
+    /** 延迟执行和重复执行的任务(由定时器触发，触发后放入工作队列)
+    */
+    struct TimerTaskInfo
+    {
+        StdClosure m_task;              //任务回调函数
+        int32_t m_nTimes = 0;           //任务重复执行的次数，如果为-1表示一直执行
+        int32_t m_nTotalExecTimes = 0;  //任务总计执行的次数
+        size_t m_nTimerId = 0;          //触发任务的定时器ID
+    };
+    std::map<size_t, TimerTaskInfo> m_timerTasks;
+
+    /** 定时任务的多线程同步锁
+    */
+    std::mutex m_timerTaskMutex;
+};
+
+}
+#endif //UI_CORE_THREAD_POOL_H_
@@ -3,22 +3,19 @@
 
 #include "duilib/Core/Callback.h"
 #include "duilib/Core/ThreadMessage.h"
-#include <queue>
-#include <set>
+#include "duilib/Core/TimerWheel.h"
 #include <chrono>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <atomic>
 
 namespace ui 
 {
 
-/** 定时器回调函数原型：void FunctionName();
-*/
-typedef std::function<void()> TimerCallback;
-class TimerInfo;
-
 /** 定时器管理器
+*   所有定时器由分层时间轮管理（添加和删除的时间复杂度为O(1)），后台线程推进时间轮，
+*   同一时刻到期的定时器，批量发送到UI线程执行
 */
 class TimerManager: public SupportWeakCallback
 {
@@ -52,6 +49,16 @@ public:
     */
     void RemoveTimer(size_t nTimerId);
 
+    /** 设置按帧对齐的时间间隔，设置后定时器的到期时间向上对齐到该间隔的整数倍，
+    *   使得动画等定时器合并到同一帧中批量触发，减少唤醒次数
+    * @param [in] nFrameIntervalMs 帧间隔（单位：毫秒），比如16表示按60帧/秒对齐，为0表示不对齐（默认）
+    */
+    void SetFrameAlignedInterval(uint32_t nFrameIntervalMs);
+
+    /** 获取按帧对齐的时间间隔（单位：毫秒），为0表示不对齐
+    */
+    uint32_t GetFrameAlignedInterval() const;
+
     /** 关闭定时器管理器，释放资源
      */
     void Clear();
@@ -65,13 +72,13 @@ private:
     */
     void Poll();
 
-    /** 是否定时器任务已经被取消
+    /** 获取当前时间对应的时间轮刻度（单位：毫秒）
     */
-    bool IsTimerRemoved(size_t nTimerId) const;
+    uint64_t GetCurrentTick() const;
 
-    /** 移除已经取消的定时器任务ID
+    /** 计算定时器的到期刻度（如果开启了按帧对齐，到期刻度向上对齐）
     */
-    void ClearRemovedTimerId(size_t nTimerId);
+    uint64_t CalcExpireTick(uint32_t uElapseMs) const;
 
 private:
     /** 消息窗口函数
@@ -81,15 +88,19 @@ private:
 private:
     /** 所有注册的定时器
     */
-    std::priority_queue<TimerInfo> m_aTimers;
+    TimerWheel m_timerWheel;
+
+    /** 时间轮刻度的起始时间
+    */
+    std::chrono::steady_clock::time_point m_startTime;
 
     /** 下一个定时器任务ID
     */
     size_t m_nNextTimerId;
 
-    /** 移除的定时器任务ID
+    /** 按帧对齐的时间间隔（单位：毫秒）
     */
-    std::set<size_t> m_removedTimerIds;
+    std::atomic<uint32_t> m_nFrameIntervalMs;
 
 private:
     /** 是否正在运行中
@@ -0,0 +1,219 @@
+#include "TimerWheel.h"
+
+namespace ui
+{
+
+TimerWheel::TimerWheel():
+    m_nCurrentTick(0),
+    m_nPendingTimerCount(0)
+{
+}
+
+size_t TimerWheel::GetSlotIndex(uint64_t nExpireTick) const
+{
+    if (nExpireTick < m_nCurrentTick) {
+        //已经过期的定时器，放在当前刻度的槽中
+        nExpireTick = m_nCurrentTick;
+    }
+    uint64_t nDelta = nExpireTick - m_nCurrentTick;
+    if (nDelta < kRootSlots) {
+        return (size_t)(nExpireTick & (kRootSlots - 1));
+    }
+    size_t nSlotBase = kRootSlots;
+    size_t nShift = kRootBits;
+    for (size_t nLevel = 1; nLevel < kLevels; ++nLevel) {
+        const uint64_t nLevelRange = (uint64_t)1 << (nShift + kLevelBits);
+        if (nLevel == (kLevels - 1)) {
+            //超出时间轮范围的定时器，放在最高层，降级时再重新计算位置
+            if (nDelta >= nLevelRange) {
+                nExpireTick = m_nCurrentTick + nLevelRange - 1;
+            }
+            return nSlotBase + (size_t)((nExpireTick >> nShift) & (kLevelSlots - 1));
+        }
+        if (nDelta < nLevelRange) {
+            return nSlotBase + (size_t)((nExpireTick >> nShift) & (kLevelSlots - 1));
+        }
+        nSlotBase += kLevelSlots;
+        nShift += kLevelBits;
+    }
+    ASSERT(0);
+    return 0;
+}
+
+void TimerWheel::InsertTimer(TimerList& fromList, TimerList::iterator iter)
+{
+    const size_t nSlot = GetSlotIndex(iter->m_nExpireTick);
+    TimerList& slotList = m_slots[nSlot];
+    slotList.splice(slotList.end(), fromList, iter);
+
+    TimerLocation& location = m_timerLocations[iter->m_nTimerId];
+    location.m_iter = iter;
+    location.m_nSlot = nSlot;
+    location.m_bRemoved = false;
+    ++m_nPendingTimerCount;
+}
+
+void TimerWheel::AddTimer(TimerInfo&& timerInfo)
+{
+    ASSERT(m_timerLocations.find(timerInfo.m_nTimerId) == m_timerLocations.end());
+    TimerList timers;
+    timers.push_back(std::move(timerInfo));
+    InsertTimer(timers, timers.begin());
+}
+
+bool TimerWheel::RemoveTimer(size_t nTimerId)
+{
+    auto iter = m_timerLocations.find(nTimerId);
+    if (iter == m_timerLocations.end()) {
+        return false;
+    }
+    TimerLocation& location = iter->second;
+    if (location.m_nSlot == kExecutingSlot) {
+        //执行中，只做标记，由执行方删除
+        location.m_bRemoved = true;
+        return true;
+    }
+    if (location.m_nSlot == kExpiredSlot) {
+        m_expiredTimers.erase(location.m_iter);
+    }
+    else {
+        ASSERT(location.m_nSlot < kTotalSlots);
+        m_slots[location.m_nSlot].erase(location.m_iter);
+        ASSERT(m_nPendingTimerCount > 0);
+        --m_nPendingTimerCount;
+    }
+    m_timerLocations.erase(iter);
+    return true;
+}
+
+size_t TimerWheel::Cascade(size_t nLevel)
+{
+    ASSERT((nLevel > 0) && (nLevel < kLevels));
+    const size_t nShift = kRootBits + (nLevel - 1) * kLevelBits;
+    const size_t nIndex = (size_t)((m_nCurrentTick >> nShift) & (kLevelSlots - 1));
+    TimerList& slotList = m_slots[kRootSlots + (nLevel - 1) * kLevelSlots + nIndex];
+    if (!slotList.empty()) {
+        TimerList timers;
+        timers.splice(timers.end(), slotList);
+        ASSERT(m_nPendingTimerCount >= timers.size());
+        m_nPendingTimerCount -= timers.size();
+        while (!timers.empty()) {
+            InsertTimer(timers, timers.begin());
+        }
+    }
+    return nIndex;
+}
+
+void TimerWheel::Advance(uint64_t nNowTick)
+{
+    while (m_nCurrentTick <= nNowTick) {
+        if (m_nPendingTimerCount == 0) {
+            //时间轮为空，直接跳到目标刻度
+            m_nCurrentTick = nNowTick + 1;
+            break;
+        }
+        const size_t nIndex = (size_t)(m_nCurrentTick & (kRootSlots - 1));
+        if (nIndex == 0) {
+            //第1层转完一圈，将高层的定时器降级
+            for (size_t nLevel = 1; nLevel < kLevels; ++nLevel) {
+                if (Cascade(nLevel) != 0) {
+                    break;
+                }
+            }
+        }
+        TimerList& slotList = m_slots[nIndex];
+        if (!slotList.empty()) {
+            for (TimerInfo& timerInfo : slotList) {
+                m_timerLocations[timerInfo.m_nTimerId].m_nSlot = kExpiredSlot;
+            }
+            ASSERT(m_nPendingTimerCount >= slotList.size());
+            m_nPendingTimerCount -= slotList.size();
+            m_expiredTimers.splice(m_expiredTimers.end(), slotList);
+        }
+        ++m_nCurrentTick;
+    }
+}
+
+bool TimerWheel::HasExpiredTimers() const
+{
+    return !m_expiredTimers.empty();
+}
+
+void TimerWheel::TakeExpiredTimers(TimerList& timers)
+{
+    for (TimerInfo& timerInfo : m_expiredTimers) {
+        m_timerLocations[timerInfo.m_nTimerId].m_nSlot = kExecutingSlot;
+    }
+    timers.splice(timers.end(), m_expiredTimers);
+}
+
+void TimerWheel::RescheduleTimer(TimerList& timers, TimerList::iterator iter)
+{
+    InsertTimer(timers, iter);
+}
+
+void TimerWheel::EraseTimer(TimerList& timers, TimerList::iterator iter)
+{
+    m_timerLocations.erase(iter->m_nTimerId);
+    timers.erase(iter);
+}
+
+bool TimerWheel::IsTimerRemoved(size_t nTimerId) const
+{
+    auto iter = m_timerLocations.find(nTimerId);
+    if (iter == m_timerLocations.end()) {
+        return true;
+    }
+    return iter->second.m_bRemoved;
+}
+
+uint64_t TimerWheel::GetNextTick() const
+{
+    if (m_nPendingTimerCount == 0) {
+        return UINT64_MAX;
+    }
+    uint64_t nNextTick = UINT64_MAX;
+    //第1层：最近的一个非空槽，即为到期时间
+    for (uint64_t nOffset = 0; nOffset < kRootSlots; ++nOffset) {
+        const uint64_t nTick = m_nCurrentTick + nOffset;
+        if (!m_slots[(size_t)(nTick & (kRootSlots - 1))].empty()) {
+            nNextTick = nTick;
+            break;
+        }
+    }
+    //其他层：最近的一个非空槽，降级的时间
+    size_t nSlotBase = kRootSlots;
+    size_t nShift = kRootBits;
+    for (size_t nLevel = 1; nLevel < kLevels; ++nLevel) {
+        const uint64_t nFirstRound = (m_nCurrentTick + ((uint64_t)1 << nShift) - 1) >> nShift;
+        for (uint64_t nRound = nFirstRound; nRound < nFirstRound + kLevelSlots; ++nRound) {
+            if (!m_slots[nSlotBase + (size_t)(nRound & (kLevelSlots - 1))].empty()) {
+                const uint64_t nTick = nRound << nShift;
+                if (nTick < nNextTick) {
+                    nNextTick = nTick;
+                }
+                break;
+            }
+        }
+        nSlotBase += kLevelSlots;
+        nShift += kLevelBits;
+    }
+    return nNextTick;
+}
+
+size_t TimerWheel::GetPendingTimerCount() const
+{
+    return m_nPendingTimerCount;
+}
+
+void TimerWheel::Clear()
+{
+    for (TimerList& slotList : m_slots) {
+        slotList.clear();
+    }
+    m_expiredTimers.clear();
+    m_timerLocations.clear();
+    m_nPendingTimerCount = 0;
+}
+
+} // namespace ui
@@ -0,0 +1,180 @@
+#ifndef UI_CORE_TIMER_WHEEL_H_
+#define UI_CORE_TIMER_WHEEL_H_
+
+#include "duilib/Core/Callback.h"
+#include <list>
+#include <array>
+#include <unordered_map>
+
+namespace ui
+{
+
+/** 定时器回调函数原型：void FunctionName();
+*/
+typedef std::function<void()> TimerCallback;
+
+/** 定时器的数据
+*/
+class TimerInfo
+{
+public:
+    //定时器ID
+    size_t m_nTimerId = 0;
+
+    //定时器回调函数
+    TimerCallback timerCallback;
+
+    //取消定时器同步机制
+    std::weak_ptr<WeakFlag> weakFlag;
+
+    //定时器间隔：（单位：毫秒）
+    uint32_t uElapseMs = 0;
+
+    //重复次数
+    uint32_t uRepeatTime = 0;
+
+    //定时器的触发时间（时间轮的刻度，单位：毫秒）
+    uint64_t m_nExpireTick = 0;
+};
+
+/** 分层时间轮（添加和删除定时器的时间复杂度为O(1)）
+*   时间轮的刻度为1毫秒，共5层：第1层256个槽，其余每层64个槽，可覆盖32位的毫秒数
+*   同一个刻度到期的定时器，一次性批量取出
+*   该类不是线程安全的，由TimerManager加锁使用
+*/
+class TimerWheel
+{
+public:
+    typedef std::list<TimerInfo> TimerList;
+
+    TimerWheel();
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator = (const TimerWheel&) = delete;
+
+public:
+    /** 添加一个定时器（按m_nExpireTick放入对应的槽中）
+    */
+    void AddTimer(TimerInfo&& timerInfo);
+
+    /** 删除一个定时器
+    *   如果定时器正在执行中（已经通过TakeExpiredTimers取出），只做删除标记
+    * @return 如果找到该定时器返回true，否则返回false
+    */
+    bool RemoveTimer(size_t nTimerId);
+
+    /** 推进时间轮到指定刻度，到期的定时器放入到期队列
+    * @param [in] nNowTick 当前时间的刻度
+    */
+    void Advance(uint64_t nNowTick);
+
+    /** 是否有已经到期的定时器
+    */
+    bool HasExpiredTimers() const;
+
+    /** 取出所有已经到期的定时器（批量），取出后状态为执行中
+    * @param [out] timers 返回到期的定时器
+    */
+    void TakeExpiredTimers(TimerList& timers);
+
+    /** 将一个执行中的定时器重新放回时间轮（重复执行的定时器，需要先设置新的m_nExpireTick）
+    * @param [in] timers TakeExpiredTimers返回的定时器列表
+    * @param [in] iter 需要放回的定时器
+    */
+    void RescheduleTimer(TimerList& timers, TimerList::iterator iter);
+
+    /** 删除一个执行中的定时器（执行完成或者已经取消）
+    * @param [in] timers TakeExpiredTimers返回的定时器列表
+    * @param [in] iter 需要删除的定时器
+    */
+    void EraseTimer(TimerList& timers, TimerList::iterator iter);
+
+    /** 执行中的定时器是否已经被取消
+    */
+    bool IsTimerRemoved(size_t nTimerId) const;
+
+    /** 获取下一个需要处理的刻度（定时器到期，或者需要将高层的定时器降级）
+    * @return 如果时间轮中没有定时器，返回UINT64_MAX
+    */
+    uint64_t GetNextTick() const;
+
+    /** 获取时间轮中等待到期的定时器个数（不含已到期和执行中的定时器）
+    */
+    size_t GetPendingTimerCount() const;
+
+    /** 清空所有定时器
+    */
+    void Clear();
+
+private:
+    /** 根据到期时间，计算定时器所在的槽的序号
+    */
+    size_t GetSlotIndex(uint64_t nExpireTick) const;
+
+    /** 将一个定时器节点移动到对应的槽中
+    */
+    void InsertTimer(TimerList& fromList, TimerList::iterator iter);
+
+    /** 将高层的一个槽中的定时器，降级放入低层的槽中
+    * @param [in] nLevel 层的序号（从1开始）
+    * @return 返回该层当前槽的序号
+    */
+    size_t Cascade(size_t nLevel);
+
+private:
+    /** 第1层的槽个数（位数）
+    */
+    static constexpr size_t kRootBits = 8;
+    static constexpr size_t kRootSlots = 1 << kRootBits;
+
+    /** 其他层的槽个数（位数）
+    */
+    static constexpr size_t kLevelBits = 6;
+    static constexpr size_t kLevelSlots = 1 << kLevelBits;
+
+    /** 层数
+    */
+    static constexpr size_t kLevels = 5;
+
+    /** 槽的总个数
+    */
+    static constexpr size_t kTotalSlots = kRootSlots + (kLevels - 1) * kLevelSlots;
+
+    /** 定时器节点的位置：到期队列、执行中
+    */
+    static constexpr size_t kExpiredSlot = kTotalSlots;
+    static constexpr size_t kExecutingSlot = kTotalSlots + 1;
+
+    /** 定时器节点的位置信息
+    */
+    struct TimerLocation
+    {
+        TimerList::iterator m_iter;     //定时器节点
+        size_t m_nSlot = 0;             //所在的槽的序号
+        bool m_bRemoved = false;        //执行中的定时器是否已经被取消
+    };
+
+private:
+    /** 所有的槽（各层依次排列）
+    */
+    std::array<TimerList, kTotalSlots> m_slots;
+
+    /** 已经到期，等待执行的定时器
+    */
+    TimerList m_expiredTimers;
+
+    /** 定时器ID与位置的映射表
+    */
+    std::unordered_map<size_t, TimerLocation> m_timerLocations;
+
+    /** 下一个需要处理的刻度
+    */
+    uint64_t m_nCurrentTick;
+
+    /** 时间轮中等待到期的定时器个数
+    */
+    size_t m_nPendingTimerCount;
+};
+
+} // namespace ui
+
+#endif // UI_CORE_TIMER_WHEEL_H_
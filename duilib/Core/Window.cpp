@@ -8,12 +8,17 @@
 #include "duilib/Core/WindowMessage.h"
 #include "duilib/Render/IRender.h"
 #include "duilib/Render/AutoClip.h"
+#include "duilib/Animation/AnimationClock.h"
 #include "duilib/Utils/PerformanceUtil.h"
 #include "duilib/Utils/FilePathUtil.h"
 #include "duilib/Utils/AttributeUtil.h"
 
 namespace ui
 {
+/** 绘制区域的面积（像素数）不小于该值时，才录制绘制命令并分块并行光栅化
+*/
+static constexpr int64_t kMinRecordPaintArea = 512 * 512;
+
 Window::Window() :
     m_pRoot(nullptr),
     m_pFocus(nullptr),
@@ -24,6 +29,8 @@ Window::Window() :
     m_bFirstLayout(true),
     m_bWindowFirstShown(false),
     m_bIsArranged(false),
+    m_bArrangeDeferred(false),
+    m_bScrollInvalidating(false),
     m_bPostQuitMsgWhenClosed(false),
     m_renderBackendType(RenderBackendType::kRaster_BackendType),
     m_bWindowAttributesApplied(false)
@@ -427,6 +434,7 @@ void Window::ClearWindow(bool bSendClose)
     RemoveAllOptionGroups();
 
     m_toolTip.reset();
+    m_animationClock.reset();
     m_shadow.reset();
     m_render.reset();
     m_controlFinder.Clear();
@@ -1046,7 +1054,16 @@ void Window::OnDpiScaleChanged(uint32_t nOldDpiScale, uint32_t nNewDpiScale)
 
     Box* pRoot = GetRoot();
     if (pRoot != nullptr) {
+        //预加载新DPI下的图片：在线程池中解码，与控件DPI属性的更新并行执行（不等待解码完成，完成后在UI线程中保存到缓存）
+        ImageManager& imageManager = GlobalManager::Instance().Image();
+        std::vector<Image*> imageList;
+        pRoot->GetLoadedImages(imageList);
+        imageManager.PrefetchImages(this, imageList);
+
+        //更新控件的DPI关联属性时，不逐个进行布局重排和重绘，全部更新完成后统一布局
+        m_bArrangeDeferred = true;
         pRoot->ChangeDpiScale(nOldDpiScale, nNewDpiScale);
+        m_bArrangeDeferred = false;
         pRoot->Arrange();
         Invalidate(pRoot->GetPos());
     }
@@ -1233,6 +1250,119 @@ bool Window::OnPreparePaint()
     return true;
 }
 
+bool Window::OnPreInvalidate(const UiRect& rcItem)
+{
+    if (m_bScrollInvalidating) {
+        return true;
+    }
+    if (rcItem.IsEmpty()) {
+        return true;
+    }
+    if (!m_rcScrollArrange.IsEmpty() && m_rcScrollArrange.ContainsRect(rcItem)) {
+        //滚动后重新布局产生的重绘请求（子控件整体平移），平移后的内容已经复用，无需重绘
+        //与滚动区域部分相交的重绘请求（比如边缘处的内容变化）仍需正常处理
+        return false;
+    }
+    //记录需要重绘的区域（数量过多时合并为一个区域）
+    for (const UiRect& rc : m_invalidatedRects) {
+        if (rc.ContainsRect(rcItem)) {
+            return true;
+        }
+    }
+    const size_t nMaxInvalidatedRects = 16;
+    if (m_invalidatedRects.size() >= nMaxInvalidatedRects) {
+        UiRect rcUnion = rcItem;
+        for (const UiRect& rc : m_invalidatedRects) {
+            rcUnion.Union(rc);
+        }
+        m_invalidatedRects.clear();
+        m_invalidatedRects.push_back(rcUnion);
+    }
+    else {
+        m_invalidatedRects.push_back(rcItem);
+    }
+    return true;
+}
+
+bool Window::ScrollWindowRect(const UiRect& rcScroll, int32_t dx, int32_t dy)
+{
+    GlobalManager::Instance().AssertUIThread();
+    if (!IsWindow() || !IsWindowFirstShown() || (m_render == nullptr)) {
+        return false;
+    }
+    if (!IsWindowVisible() || IsWindowMinimized()) {
+        return false;
+    }
+    if (m_render->GetRenderBackendType() != RenderBackendType::kRaster_BackendType) {
+        //目前只支持CPU绘制
+        return false;
+    }
+    if ((m_renderOffset.x != 0) || (m_renderOffset.y != 0)) {
+        return false;
+    }
+    if (rcScroll.IsEmpty() || ((dx == 0) && (dy == 0))) {
+        return false;
+    }
+    const UiSize szRender(m_render->GetWidth(), m_render->GetHeight());
+    if (!UiRect(0, 0, szRender.cx, szRender.cy).ContainsRect(rcScroll)) {
+        return false;
+    }
+    if (!m_scrollRects.empty() && ((m_szScrollRender.cx != szRender.cx) || (m_szScrollRender.cy != szRender.cy))) {
+        return false;
+    }
+    //该区域内有未完成的重绘请求（平移前的坐标），不能平移
+    UiRect rcTemp;
+    for (const UiRect& rc : m_invalidatedRects) {
+        if (UiRect::Intersect(rcTemp, rc, rcScroll)) {
+            return false;
+        }
+    }
+    ScrollRectInfo* pScrollInfo = nullptr;
+    for (ScrollRectInfo& scrollInfo : m_scrollRects) {
+        if (scrollInfo.m_rcScroll.Equals(rcScroll)) {
+            pScrollInfo = &scrollInfo;
+        }
+        else if (UiRect::Intersect(rcTemp, scrollInfo.m_rcScroll, rcScroll)) {
+            return false;
+        }
+    }
+    if (pScrollInfo != nullptr) {
+        //同一个区域多次滚动，合并平移距离
+        dx += pScrollInfo->m_dx;
+        dy += pScrollInfo->m_dy;
+    }
+    if ((std::abs(dx) >= rcScroll.Width()) || (std::abs(dy) >= rcScroll.Height())) {
+        return false;
+    }
+    if (pScrollInfo != nullptr) {
+        pScrollInfo->m_dx = dx;
+        pScrollInfo->m_dy = dy;
+    }
+    else {
+        ScrollRectInfo scrollInfo;
+        scrollInfo.m_rcScroll = rcScroll;
+        scrollInfo.m_dx = dx;
+        scrollInfo.m_dy = dy;
+        m_scrollRects.push_back(scrollInfo);
+    }
+    m_szScrollRender = szRender;
+
+    m_bScrollInvalidating = true;
+    Invalidate(rcScroll);
+    m_bScrollInvalidating = false;
+    return true;
+}
+
+void Window::BeginScrollArrange(const UiRect& rcScroll)
+{
+    m_rcScrollArrange = rcScroll;
+}
+
+void Window::EndScrollArrange()
+{
+    m_rcScrollArrange.Clear();
+}
+
 bool Window::IsWindowFirstShown() const
 {
     return m_bWindowFirstShown;
@@ -1270,6 +1400,91 @@ bool Window::Paint(const UiRect& rcPaint)
         return false;
     }
 
+    std::vector<UiRect> paintRects;
+    if (!ApplyScrollRects(pRender, rcPaint, paintRects)) {
+        paintRects.clear();
+        paintRects.push_back(rcPaint);
+    }
+    for (const UiRect& rc : paintRects) {
+        PaintRect(pRender, rc);
+    }
+    return true;
+}
+
+bool Window::ApplyScrollRects(IRender* pRender, const UiRect& rcPaint, std::vector<UiRect>& paintRects)
+{
+    std::vector<ScrollRectInfo> scrollRects;
+    scrollRects.swap(m_scrollRects);
+    std::vector<UiRect> invalidatedRects;
+    invalidatedRects.swap(m_invalidatedRects);
+    if (scrollRects.empty()) {
+        return false;
+    }
+    if ((m_szScrollRender.cx != pRender->GetWidth()) || (m_szScrollRender.cy != pRender->GetHeight())) {
+        //绘制引擎的大小发生变化，原有的内容已经无效
+        return false;
+    }
+    if ((m_renderOffset.x != 0) || (m_renderOffset.y != 0)) {
+        return false;
+    }
+    //所有需要更新的区域都在本次绘制的范围内，才能只绘制部分区域
+    for (const ScrollRectInfo& scrollInfo : scrollRects) {
+        if (!rcPaint.ContainsRect(scrollInfo.m_rcScroll)) {
+            return false;
+        }
+    }
+    for (const UiRect& rc : invalidatedRects) {
+        if (!rcPaint.ContainsRect(rc)) {
+            return false;
+        }
+    }
+
+    //先平移，然后重绘新露出的区域
+    PerformanceStat statPerformance(_T("PaintWindow, Window::Paint ScrollRect"));
+    for (const ScrollRectInfo& scrollInfo : scrollRects) {
+        const UiRect& rcScroll = scrollInfo.m_rcScroll;
+        if (!pRender->ScrollRect(rcScroll, scrollInfo.m_dx, scrollInfo.m_dy)) {
+            paintRects.push_back(rcScroll);
+            continue;
+        }
+        UiRect rcRest = rcScroll;
+        if (scrollInfo.m_dy > 0) {
+            paintRects.push_back(UiRect(rcScroll.left, rcScroll.top, rcScroll.right, rcScroll.top + scrollInfo.m_dy));
+            rcRest.top += scrollInfo.m_dy;
+        }
+        else if (scrollInfo.m_dy < 0) {
+            paintRects.push_back(UiRect(rcScroll.left, rcScroll.bottom + scrollInfo.m_dy, rcScroll.right, rcScroll.bottom));
+            rcRest.bottom += scrollInfo.m_dy;
+        }
+        if (scrollInfo.m_dx > 0) {
+            paintRects.push_back(UiRect(rcRest.left, rcRest.top, rcRest.left + scrollInfo.m_dx, rcRest.bottom));
+        }
+        else if (scrollInfo.m_dx < 0) {
+            paintRects.push_back(UiRect(rcRest.right + scrollInfo.m_dx, rcRest.top, rcRest.right, rcRest.bottom));
+        }
+    }
+    //平移后产生的重绘请求，坐标均为平移后的坐标
+    paintRects.insert(paintRects.end(), invalidatedRects.begin(), invalidatedRects.end());
+
+    //去掉空的区域和被其他区域包含的区域
+    for (size_t nIndex = 0; nIndex < paintRects.size(); ++nIndex) {
+        bool bRemove = paintRects[nIndex].IsEmpty();
+        for (size_t nOther = 0; !bRemove && (nOther < paintRects.size()); ++nOther) {
+            if ((nOther != nIndex) && paintRects[nOther].ContainsRect(paintRects[nIndex])) {
+                //两个区域相同时，保留后面的
+                bRemove = (nOther > nIndex) || !paintRects[nOther].Equals(paintRects[nIndex]);
+            }
+        }
+        if (bRemove) {
+            paintRects.erase(paintRects.begin() + nIndex);
+            --nIndex;
+        }
+    }
+    return true;
+}
+
+void Window::PaintRect(IRender* pRender, const UiRect& rcPaint)
+{
     //开始绘制前，去掉alpha通道
     if (IsLayeredWindow()) {
         PerformanceStat statPerformance(_T("PaintWindow, Window::Paint ClearAlpha"));
@@ -1279,10 +1494,22 @@ bool Window::Paint(const UiRect& rcPaint)
     // 绘制    
     if (m_pRoot->IsVisible()) {
         PerformanceStat statPerformance(_T("PaintWindow, Window::Paint Paint/PaintChild"));
-        AutoClip rectClip(pRender, rcPaint, true);
-        UiPoint ptOldWindOrg = pRender->OffsetWindowOrg(m_renderOffset);
-        m_pRoot->AlphaPaint(pRender, rcPaint);
-        pRender->SetWindowOrg(ptOldWindOrg);
+        auto paintRoot = [this, pRender, &rcPaint]() {
+                AutoClip rectClip(pRender, rcPaint, true);
+                UiPoint ptOldWindOrg = pRender->OffsetWindowOrg(m_renderOffset);
+                m_pRoot->AlphaPaint(pRender, rcPaint);
+                pRender->SetWindowOrg(ptOldWindOrg);
+            };
+        //大面积绘制时，先录制绘制命令，再分块并行光栅化
+        const uint32_t nTileCount = GlobalManager::Instance().GetRasterTileCount();
+        const bool bRecord = (nTileCount > 1) &&
+                             ((int64_t)rcPaint.Width() * rcPaint.Height() >= kMinRecordPaintArea) &&
+                             pRender->BeginRecord(rcPaint);
+        paintRoot();
+        if (bRecord && !pRender->EndRecord(nTileCount)) {
+            //录制过程中有不能录制的操作（比如直接写入像素数据），重新直接绘制
+            paintRoot();
+        }
     }
     else {
         UiColor bkColor = UiColor(UiColors::LightGray);
@@ -1325,7 +1552,6 @@ bool Window::Paint(const UiRect& rcPaint)
         }
     }
 #endif
-    return true;
 }
 
 LRESULT Window::OnSetFocusMsg(WindowBase* /*pLostFocusWindow*/, const NativeMsg& nativeMsg, bool& bHandled)
@@ -2267,8 +2493,17 @@ void Window::SetArrange(bool bArrange)
     m_bIsArranged = bArrange;
 }
 
+bool Window::IsArrangeDeferred() const
+{
+    return m_bArrangeDeferred;
+}
+
 bool Window::SendNotify(EventType eventType, WPARAM wParam, LPARAM lParam)
 {
+    if (!m_OnEvent.HasEventOrAll(eventType)) {
+        //没有注册该事件的回调函数
+        return true;
+    }
     EventArgs msg;
     msg.SetSender(nullptr);
     msg.eventType = eventType;
@@ -2277,17 +2512,17 @@ bool Window::SendNotify(EventType eventType, WPARAM wParam, LPARAM lParam)
     msg.lParam = lParam;
 
     std::weak_ptr<WeakFlag> windowFlag = GetWeakFlag();
-    auto callback = m_OnEvent.find(msg.eventType);
-    if (callback != m_OnEvent.end()) {
-        callback->second(msg);
+    const CEventSource* pEventSource = m_OnEvent.Find(msg.eventType);
+    if (pEventSource != nullptr) {
+        (*pEventSource)(msg);
     }
     if (windowFlag.expired()) {
         return false;
     }
 
-    callback = m_OnEvent.find(kEventAll);
-    if (callback != m_OnEvent.end()) {
-        callback->second(msg);
+    pEventSource = m_OnEvent.Find(kEventAll);
+    if (pEventSource != nullptr) {
+        (*pEventSource)(msg);
     }
 
     return true;
@@ -2306,6 +2541,14 @@ ui::IRender* Window::GetRender() const
     return m_render.get();
 }
 
+AnimationClock& Window::GetAnimationClock()
+{
+    if (m_animationClock == nullptr) {
+        m_animationClock = std::make_unique<AnimationClock>(this);
+    }
+    return *m_animationClock;
+}
+
 class RenderWindowDpi: public IRenderDpi
 {
 public:
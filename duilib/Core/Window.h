@@ -17,6 +17,7 @@ class Box;
 class Control;
 class ToolTip;
 class WindowBuilder;
+class AnimationClock;
 
 /** 窗口类
 *  //外部调用需要初始化的基本流程:
@@ -263,6 +264,10 @@ public:
     */
     void SetArrange(bool bArrange);
 
+    /** 是否暂停控件的布局重排和重绘（DPI变化时，所有控件更新完成后，统一进行一次布局）
+    */
+    bool IsArrangeDeferred() const;
+
     /** 清理图片缓存
     */
     void ClearImageCache();
@@ -427,6 +432,29 @@ public:
     */
     std::shared_ptr<IRenderDpi> GetRenderDpi();
 
+    /** 获取窗口的动画时钟（窗口内的所有动画共用一个定时器，每帧统一触发）
+    */
+    AnimationClock& GetAnimationClock();
+
+    /** 滚动时复用已经绘制的内容：在下次绘制时，将窗口内的一个矩形区域平移，只重绘新露出的区域
+    *   仅CPU绘制时支持；如果该区域内有未完成的重绘请求，或者当前不支持平移，返回false，调用方需要自行重绘该区域
+    * @param [in] rcScroll 需要平移的矩形区域（客户区坐标）
+    * @param [in] dx 横向平移的距离，正数表示向右平移
+    * @param [in] dy 纵向平移的距离，正数表示向下平移
+    * @return 成功返回true，失败返回false
+    */
+    bool ScrollWindowRect(const UiRect& rcScroll, int32_t dx, int32_t dy);
+
+    /** 开始滚动后的重新布局：在EndScrollArrange()之前，完全在rcScroll范围内的重绘请求将被忽略
+    *   （用于虚表滚动时，子控件整体平移产生的重绘请求，平移后的内容已经由ScrollWindowRect复用）
+    * @param [in] rcScroll 滚动的矩形区域（客户区坐标）
+    */
+    void BeginScrollArrange(const UiRect& rcScroll);
+
+    /** 结束滚动后的重新布局
+    */
+    void EndScrollArrange();
+
     /** 设置窗口的属性是否已经设置完成(避免重复设置窗口属性)
     */
     void SetWindowAttributesApplied(bool bApplied);
@@ -517,6 +545,12 @@ protected:
     */
     virtual bool OnPreparePaint() override;
 
+    /** 发出重绘消息前的回调
+    * @param [in] rcItem 重绘范围，为客户区坐标
+    * @return 返回true表示继续发出重绘消息，返回false表示忽略本次重绘
+    */
+    virtual bool OnPreInvalidate(const UiRect& rcItem) override;
+
     /** 窗口的层窗口属性发生变化
     */
     virtual void OnLayeredWindowChanged() override;
@@ -949,6 +983,20 @@ private:
     */
     bool Paint(const UiRect& rcPaint);
 
+    /** 绘制一个矩形区域（完整重绘该区域）
+    * @param [in] pRender 绘制引擎接口
+    * @param [in] rcPaint 需要绘制的矩形区域
+    */
+    void PaintRect(IRender* pRender, const UiRect& rcPaint);
+
+    /** 执行滚动平移，并计算需要重绘的区域
+    * @param [in] pRender 绘制引擎接口
+    * @param [in] rcPaint 本次绘制更新的矩形区域
+    * @param [out] paintRects 返回需要重绘的区域
+    * @return 如果可以只绘制部分区域返回true，否则返回false（需要完整绘制rcPaint）
+    */
+    bool ApplyScrollRects(IRender* pRender, const UiRect& rcPaint, std::vector<UiRect>& paintRects);
+
     /** 调整Render的尺寸，与当前客户区的大小一致
     */
     bool ResizeRenderToClientSize() const;
@@ -1001,6 +1049,9 @@ private:
     //布局是否变化，如果变化(true)则需要重新计算布局
     bool m_bIsArranged;
 
+    //是否暂停控件的布局重排和重绘
+    bool m_bArrangeDeferred;
+
     //布局是否需要初始化
     bool m_bFirstLayout;
 
@@ -1016,6 +1067,31 @@ private:
     //绘制引擎
     std::unique_ptr<IRender> m_render;
 
+private:
+    /** 等待执行的滚动平移
+    */
+    struct ScrollRectInfo
+    {
+        UiRect m_rcScroll;
+        int32_t m_dx = 0;
+        int32_t m_dy = 0;
+    };
+
+    //等待执行的滚动平移（在下次绘制时执行）
+    std::vector<ScrollRectInfo> m_scrollRects;
+
+    //自上次绘制以来，需要重绘的区域
+    std::vector<UiRect> m_invalidatedRects;
+
+    //滚动后重新布局的区域，该区域内的重绘请求被忽略
+    UiRect m_rcScrollArrange;
+
+    //是否正在为滚动平移发出重绘消息
+    bool m_bScrollInvalidating;
+
+    //发起滚动平移时，绘制引擎的大小
+    UiSize m_szScrollRender;
+
 private:
     /** 每个窗口的资源路径(相对于资源根目录的路径)
     */
@@ -1054,6 +1130,10 @@ private:
     */
     std::unique_ptr<ToolTip> m_toolTip;
 
+    /** 窗口的动画时钟
+    */
+    std::unique_ptr<AnimationClock> m_animationClock;
+
     /** 窗口关闭的时候，发送退出消息循环的请求
     */
     bool m_bPostQuitMsgWhenClosed;
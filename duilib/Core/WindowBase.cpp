@@ -581,7 +581,9 @@ void WindowBase::ClearWindowRgn(bool bRedraw)
 void WindowBase::Invalidate(const UiRect& rcItem)
 {
     GlobalManager::Instance().AssertUIThread();
-    m_pNativeWindow->Invalidate(rcItem);
+    if (OnPreInvalidate(rcItem)) {
+        m_pNativeWindow->Invalidate(rcItem);
+    }
 }
 
 bool WindowBase::UpdateWindow() const
@@ -598,6 +598,12 @@ protected:
     */
     virtual bool OnPreparePaint() = 0;
 
+    /** 发出重绘消息前的回调
+    * @param [in] rcItem 重绘范围，为客户区坐标
+    * @return 返回true表示继续发出重绘消息，返回false表示忽略本次重绘
+    */
+    virtual bool OnPreInvalidate(const UiRect& rcItem) = 0;
+
     /** 窗口的层窗口属性发生变化
     */
     virtual void OnLayeredWindowChanged() = 0;
@@ -1,6 +1,8 @@
 #include "ImageGif.h"
 #include "duilib/Core/Control.h"
 #include "duilib/Core/GlobalManager.h"
+#include "duilib/Core/Window.h"
+#include "duilib/Animation/AnimationClock.h"
 #include "duilib/Image/Image.h"
 #include "duilib/Render/AutoClip.h"
 #include "duilib/Render/IRender.h"
@@ -14,7 +16,8 @@ ImageGif::ImageGif():
     m_bAutoPlay(true),
     m_nCycledCount(0),
     m_nMaxPlayCount(-1),
-    m_nVirtualEventGifStop(1)
+    m_nVirtualEventGifStop(1),
+    m_bUseAnimationClock(false)
 {
 }
 
@@ -78,6 +81,21 @@ bool ImageGif::StartGifPlay(GifFrameType nStartFrame, int32_t nPlayCount)
     m_nCycledCount = 0;
     m_bPlayingGif = true;
     RedrawImage();
+    return StartPlayTimer(nTimerInterval);
+}
+
+bool ImageGif::StartPlayTimer(int32_t nTimerInterval)
+{
+    m_gifWeakFlag.Cancel();
+    Window* pWindow = (m_pControl != nullptr) ? m_pControl->GetWindow() : nullptr;
+    if ((pWindow != nullptr) && pWindow->IsWindow()) {
+        //由窗口的动画时钟统一驱动，与窗口内的其他动画合并绘制，窗口隐藏时自动降低频率
+        m_bUseAnimationClock = true;
+        m_nextFrameTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(nTimerInterval);
+        auto tickCallback = UiBind(&ImageGif::OnAnimationClockTick, this);
+        return pWindow->GetAnimationClock().AddAnimation(m_gifWeakFlag.GetWeakFlag(), tickCallback) != 0;
+    }
+    m_bUseAnimationClock = false;
     auto gifPlayCallback = UiBind(&ImageGif::PlayGif, this);
     bool bRet = GlobalManager::Instance().Timer().AddTimer(m_gifWeakFlag.GetWeakFlag(),
                                                            gifPlayCallback,
@@ -85,6 +103,13 @@ bool ImageGif::StartGifPlay(GifFrameType nStartFrame, int32_t nPlayCount)
     return bRet;
 }
 
+void ImageGif::OnAnimationClockTick()
+{
+    if (std::chrono::steady_clock::now() >= m_nextFrameTime) {
+        PlayGif();
+    }
+}
+
 bool ImageGif::PlayGif()
 {
     //定时器触发，播放下一帧
@@ -113,12 +138,16 @@ bool ImageGif::PlayGif()
         return false;
     }
     bool bRet = true;
-    if (nPreTimerInterval != nNowTimerInterval) {
-        m_gifWeakFlag.Cancel();
-        auto gifPlayCallback = UiBind(&ImageGif::PlayGif, this);
-        bRet = GlobalManager::Instance().Timer().AddTimer(m_gifWeakFlag.GetWeakFlag(),
-                                                          gifPlayCallback,
-                                                          nNowTimerInterval) != 0;
+    if (m_bUseAnimationClock) {
+        //计算下一帧的播放时间，如果落后太多（比如窗口隐藏时帧率降低），不追帧
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        m_nextFrameTime += std::chrono::milliseconds(nNowTimerInterval);
+        if (m_nextFrameTime < now) {
+            m_nextFrameTime = now + std::chrono::milliseconds(nNowTimerInterval);
+        }
+    }
+    else if (nPreTimerInterval != nNowTimerInterval) {
+        bRet = StartPlayTimer(nNowTimerInterval);
     }
     if (bRet) {
         m_pImage->SetCurrentFrame(nFrameIndex);
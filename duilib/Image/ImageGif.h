@@ -5,6 +5,7 @@
 #include "duilib/Utils/Delegate.h"
 #include "duilib/Core/Callback.h"
 #include <map>
+#include <chrono>
 
 namespace ui 
 {
@@ -77,6 +78,15 @@ private:
     */
     bool PlayGif();
 
+    /** 启动播放定时器（优先使用窗口的动画时钟，窗口不存在时使用独立的定时器）
+    * @param [in] nTimerInterval 下一帧的时间间隔（毫秒）
+    */
+    bool StartPlayTimer(int32_t nTimerInterval);
+
+    /** 窗口动画时钟的帧回调函数（到达下一帧的时间时，播放下一帧）
+    */
+    void OnAnimationClockTick();
+
     /** 重绘图片
     */
     void RedrawImage();
@@ -125,6 +135,14 @@ private:
     /** GIF背景图片播放完成事件的ID
     */
     const int32_t m_nVirtualEventGifStop;
+
+    /** 是否使用窗口的动画时钟驱动播放
+    */
+    bool m_bUseAnimationClock;
+
+    /** 使用动画时钟时，下一帧的播放时间
+    */
+    std::chrono::steady_clock::time_point m_nextFrameTime;
 };
 
 } // namespace ui
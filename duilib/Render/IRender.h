@@ -779,6 +779,14 @@ public:
                         IRender* pSrcRender, int32_t xSrc, int32_t ySrc,
                         RopMode rop) = 0;
 
+    /** 在画布内平移一个矩形区域的像素（滚动时复用已经绘制的内容，平移后只需要重绘新露出的区域）
+    * @param [in] rcScroll 需要平移的矩形区域（画布坐标，不受视区原点和剪辑区域的影响）
+    * @param [in] dx 横向平移的距离，正数表示向右平移
+    * @param [in] dy 纵向平移的距离，正数表示向下平移
+    * @return 成功返回true；如果不支持（比如GPU绘制）或者平移的距离超出区域范围，返回false
+    */
+    virtual bool ScrollRect(const UiRect& rcScroll, int32_t dx, int32_t dy) = 0;
+
     /** 函数将一个位图从源矩形复制到目标矩形中，并拉伸或压缩位图以适应目标矩形的尺寸（如有必要）。 
         系统根据当前在目标设备上下文中设置的拉伸模式拉伸或压缩位图。
     * @param [in] xDest 目标矩形左上角的 x 坐标
@@ -1317,6 +1325,17 @@ public:
     */
     virtual bool PaintAndSwapBuffers(IRenderPaint* pRenderPaint) = 0;
 
+    /** 开始录制绘制命令：之后的绘制命令只录制不执行，结束录制时再分块光栅化
+    * @param [in] rcPaint 需要绘制的区域（画布坐标）
+    * @return 成功返回true；如果不支持（比如GPU绘制），返回false，此时按原来的方式直接绘制
+    */
+    virtual bool BeginRecord(const UiRect& rcPaint) = 0;
+
+    /** 结束录制，将录制的绘制命令按行分块光栅化到绘制区域，结果与直接绘制完全相同
+    * @param [in] nTileCount 分块的个数，分块在线程池（kThreadPool）中并行光栅化，线程池未启动时在当前线程中依次光栅化
+    * @return 成功返回true；如果录制过程中有不能录制的操作（比如直接读写像素数据），返回false，调用方需要重新直接绘制该区域
+    */
+    virtual bool EndRecord(uint32_t nTileCount) = 0;
 };
 
 /** 渲染接口管理，用于创建Font、Pen、Brush、Path、Matrix、Bitmap、Render等渲染实现对象
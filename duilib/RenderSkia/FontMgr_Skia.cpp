@@ -1,5 +1,7 @@
 #include "FontMgr_Skia.h"
+#include "SkTextGlyphCache.h"
 #include "duilib/Utils/StringConvert.h"
+#include "duilib/Utils/StringUtil.h"
 #include "duilib/Utils/PerformanceUtil.h"
 
 #include "SkiaHeaderBegin.h"
@@ -25,6 +27,11 @@
 #include "SkiaHeaderEnd.h"
 
 #include <map>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 
 namespace ui
 {
@@ -169,11 +176,155 @@ private:
 
 class FontMgr_Skia::TImpl
 {
+public:
+    TImpl():
+        m_bFontNamesReady(false),
+        m_bStopIndex(false)
+    {
+    }
+
+    ~TImpl()
+    {
+        m_bStopIndex = true;
+        WaitFontAliasIndex();
+    }
+
+    /** 建立系统字体的名称索引（在后台线程中执行，字体很多时，逐个获取字体名称比较耗时）：
+    *   先建立字体名称的索引，完成后立即可用；再建立字体其他名称的索引，只有按字体名称查找失败时才需要等待
+    */
+    void BuildFontNameIndex()
+    {
+        const int nCountFamilies = (m_pSkFontMgr != nullptr) ? m_pSkFontMgr->countFamilies() : 0;
+        m_systemFontNames.reserve((size_t)std::max(nCountFamilies, 0));
+        m_systemFontNameIndex.reserve((size_t)std::max(nCountFamilies, 0));
+        for (int nIndex = 0; nIndex < nCountFamilies; ++nIndex) {
+            SkString fontFamilyName;
+            m_pSkFontMgr->getFamilyName(nIndex, &fontFamilyName);
+            m_systemFontNames.push_back(StringConvert::UTF8ToT(fontFamilyName.c_str()));
+            const DString& fontName = m_systemFontNames.back();
+            if (!fontName.empty()) {
+                //名称不区分大小写，同名时保留第一个
+                m_systemFontNameIndex.emplace(StringUtil::MakeLowerString(fontName), fontName);
+            }
+        }
+        //字体名称的索引已经建立完成，此后不再修改
+        {
+            std::lock_guard<std::mutex> threadGuard(m_fontNamesMutex);
+            m_bFontNamesReady = true;
+        }
+        m_fontNamesCond.notify_all();
+
+        //字体的其他名称（比如中文字体的英文名称、本地化名称）：需要逐个创建字体，部分系统（比如fontconfig）会打开每个字体文件，比较耗时
+        for (int nIndex = 0; (nIndex < nCountFamilies) && !m_bStopIndex; ++nIndex) {
+            if (!m_systemFontNames[nIndex].empty()) {
+                AddFontNameAliases(nIndex, m_systemFontNames[nIndex]);
+            }
+        }
+    }
+
+    /** 将字体的所有名称（字体管理器返回的各语言的名称）加入其他名称的索引，指向该字体的名称
+    * @param [in] nIndex 字体在SkFontMgr中的序号
+    * @param [in] fontName 字体名称
+    */
+    void AddFontNameAliases(int nIndex, const DString& fontName)
+    {
+        sk_sp<SkFontStyleSet> spFontStyleSet = m_pSkFontMgr->createStyleSet(nIndex);
+        if (spFontStyleSet == nullptr) {
+            return;
+        }
+        sk_sp<SkTypeface> spTypeface = spFontStyleSet->matchStyle(SkFontStyle::Normal());
+        if (spTypeface == nullptr) {
+            return;
+        }
+        SkTypeface::LocalizedStrings* pFamilyNames = spTypeface->createFamilyNameIterator();
+        if (pFamilyNames == nullptr) {
+            return;
+        }
+        SkTypeface::LocalizedString familyName;
+        while (pFamilyNames->next(&familyName)) {
+            DString aliasName = StringConvert::UTF8ToT(familyName.fString.c_str());
+            if (!aliasName.empty()) {
+                //与字体名称相同的，不需要加入
+                DString lowerAliasName = StringUtil::MakeLowerString(aliasName);
+                if (m_systemFontNameIndex.find(lowerAliasName) == m_systemFontNameIndex.end()) {
+                    m_systemFontAliasIndex.emplace(lowerAliasName, fontName);
+                }
+            }
+        }
+        pFamilyNames->unref();
+    }
+
+    /** 等待系统字体名称的索引建立完成（不包含字体的其他名称）
+    */
+    void WaitFontNameIndex()
+    {
+        std::unique_lock<std::mutex> threadGuard(m_fontNamesMutex);
+        m_fontNamesCond.wait(threadGuard, [this]() { return m_bFontNamesReady || !m_indexThread.joinable(); });
+    }
+
+    /** 等待系统字体其他名称的索引建立完成（只在UI线程中调用）
+    */
+    void WaitFontAliasIndex()
+    {
+        if (m_indexThread.joinable()) {
+            m_indexThread.join();
+        }
+    }
+
+    /** 查找系统字体
+    * @param [in] fontName 字体名称（不区分大小写），也可以是字体的其他名称（比如英文名称或者本地化名称）
+    * @param [out] systemFontName 返回系统字体的名称
+    */
+    bool FindSystemFontName(const DString& fontName, DString& systemFontName)
+    {
+        WaitFontNameIndex();
+        const DString lowerFontName = StringUtil::MakeLowerString(fontName);
+        auto iter = m_systemFontNameIndex.find(lowerFontName);
+        if (iter != m_systemFontNameIndex.end()) {
+            systemFontName = iter->second;
+            return true;
+        }
+        //不是字体名称，需要等待其他名称的索引建立完成后再查找
+        WaitFontAliasIndex();
+        iter = m_systemFontAliasIndex.find(lowerFontName);
+        if (iter != m_systemFontAliasIndex.end()) {
+            systemFontName = iter->second;
+            return true;
+        }
+        return false;
+    }
+
 public:
     /** Skia的字体管理器
     */
     sk_sp<SkFontMgr> m_pSkFontMgr;
 
+    /** 系统字体的名称列表（与SkFontMgr中的字体序号一致）
+    */
+    std::vector<DString> m_systemFontNames;
+
+    /** 系统字体的名称索引：小写的字体名称 -> 字体名称
+    */
+    std::unordered_map<DString, DString> m_systemFontNameIndex;
+
+    /** 系统字体其他名称的索引：小写的其他名称（比如英文名称或者本地化名称） -> 字体名称
+    */
+    std::unordered_map<DString, DString> m_systemFontAliasIndex;
+
+    /** 建立系统字体名称索引的后台线程
+    */
+    std::thread m_indexThread;
+
+    /** 字体名称的索引是否已经建立完成（m_systemFontNames和m_systemFontNameIndex可用）
+    */
+    bool m_bFontNamesReady;
+    std::mutex m_fontNamesMutex;
+    std::condition_variable m_fontNamesCond;
+
+    /** 是否停止建立其他名称的索引（退出时）
+    */
+    std::atomic<bool> m_bStopIndex;
+
     /** 从文件加载的字体列表
     */
     FontFileManager m_fontFileMgr;
@@ -204,10 +355,18 @@ FontMgr_Skia::FontMgr_Skia()
 #endif
 
     ASSERT(m_impl->m_pSkFontMgr != nullptr);
+    //字体中缺失的字符，通过该字体管理器查询回退字体
+    SkTextGlyphCache::Instance().SetFontMgr(m_impl->m_pSkFontMgr);
+
+    //在后台建立系统字体的名称索引，首次使用时如果未完成，再等待
+    if (m_impl->m_pSkFontMgr != nullptr) {
+        m_impl->m_indexThread = std::thread(&TImpl::BuildFontNameIndex, m_impl);
+    }
 }
 
 FontMgr_Skia::~FontMgr_Skia()
 {
+    SkTextGlyphCache::Instance().SetFontMgr(nullptr);
     if (m_impl != nullptr) {
         delete m_impl;
         m_impl = nullptr;
@@ -216,10 +375,8 @@ FontMgr_Skia::~FontMgr_Skia()
 
 uint32_t FontMgr_Skia::GetFontCount() const
 {
-    uint32_t nFontCount = 0;
-    if (m_impl->m_pSkFontMgr != nullptr) {
-        nFontCount = (uint32_t)m_impl->m_pSkFontMgr->countFamilies();
-    }
+    m_impl->WaitFontNameIndex();
+    uint32_t nFontCount = (uint32_t)m_impl->m_systemFontNames.size();
     nFontCount += m_impl->m_fontFileMgr.GetFontCont();
     return nFontCount;
 }
@@ -237,13 +394,12 @@ bool FontMgr_Skia::GetFontName(uint32_t nIndex, DString& fontName) const
     if (nIndex >= nFontCount) {
         return false;
     }
-    if (nIndex < (uint32_t)m_impl->m_pSkFontMgr->countFamilies()) {
-        SkString fontFamilyName;
-        m_impl->m_pSkFontMgr->getFamilyName((int)nIndex, &fontFamilyName);
-        fontName = StringConvert::UTF8ToT(fontFamilyName.c_str());
+    const uint32_t nSystemFontCount = (uint32_t)m_impl->m_systemFontNames.size();
+    if (nIndex < nSystemFontCount) {
+        fontName = m_impl->m_systemFontNames[nIndex];
     }
     else {
-        uint32_t nFontFileIndex = nIndex - (uint32_t)m_impl->m_pSkFontMgr->countFamilies();
+        uint32_t nFontFileIndex = nIndex - nSystemFontCount;
         fontName = m_impl->m_fontFileMgr.GetFontName(nFontFileIndex);
     }
 
@@ -260,17 +416,8 @@ bool FontMgr_Skia::HasFontName(const DString& fontName) const
     if (m_impl->m_pSkFontMgr == nullptr) {
         return false;
     }
-    bool bFound = false;
-    std::string fontFamily = StringConvert::TToUTF8(fontName); //转换为UTF8格式
-    int nCountFamilies = m_impl->m_pSkFontMgr->countFamilies();
-    for (int nIndex = 0; nIndex < nCountFamilies; ++nIndex) {
-        SkString fontFamilyName;
-        m_impl->m_pSkFontMgr->getFamilyName((int)nIndex, &fontFamilyName);
-        if (!fontFamilyName.isEmpty() && (fontFamily == fontFamilyName.c_str())) {
-            bFound = true;
-            break;
-        }
-    }
+    DString systemFontName;
+    bool bFound = m_impl->FindSystemFontName(fontName, systemFontName);
     if (!bFound) {
         bFound = m_impl->m_fontFileMgr.HasFontName(fontName);
     }
@@ -279,7 +426,12 @@ bool FontMgr_Skia::HasFontName(const DString& fontName) const
 
 void FontMgr_Skia::SetDefaultFontName(const DString& fontName)
 {
-    if (HasFontName(fontName)) {
+    DString systemFontName;
+    if (m_impl->FindSystemFontName(fontName, systemFontName)) {
+        //使用系统字体的名称（名称不区分大小写）
+        m_impl->m_defaultFontName = systemFontName;
+    }
+    else if (HasFontName(fontName)) {
         //字体必须存在
         m_impl->m_defaultFontName = fontName;
     }
@@ -333,6 +485,7 @@ void FontMgr_Skia::ClearFontFiles()
 void FontMgr_Skia::ClearFontCache()
 {
     m_impl->m_fontStyleSetMap.clear();
+    SkTextGlyphCache::Instance().Clear();
 }
 
 SkFont* FontMgr_Skia::CreateSkFont(const UiFont& fontInfo)
@@ -364,25 +517,34 @@ SkFont* FontMgr_Skia::CreateSkFont(const UiFont& fontInfo)
         return nullptr;
     }
 
-    //需要创建的字体列表（包含默认字体）
-    std::vector<DString> fontNameList;
-    if (!fontInfo.m_fontName.empty() && HasFontName(fontInfo.m_fontName.c_str())) {
-        fontNameList.push_back(fontInfo.m_fontName.c_str());
+    //需要创建的字体列表（包含默认字体），每项为：字体名称 + 对应的系统字体名称（不是系统字体时为空）
+    std::vector<std::pair<DString, DString>> fontNameList;
+    const DString inFontName = fontInfo.m_fontName.c_str();
+    DString systemFontName;
+    if (m_impl->FindSystemFontName(inFontName, systemFontName) || m_impl->m_fontFileMgr.HasFontName(inFontName)) {
+        fontNameList.push_back({ inFontName, systemFontName });
     }
-    if (!m_impl->m_defaultFontName.empty() && (m_impl->m_defaultFontName != fontInfo.m_fontName) && HasFontName(m_impl->m_defaultFontName)) {
-        fontNameList.push_back(m_impl->m_defaultFontName);
+    if (!m_impl->m_defaultFontName.empty() && (m_impl->m_defaultFontName != inFontName)) {
+        systemFontName.clear();
+        if (m_impl->FindSystemFontName(m_impl->m_defaultFontName, systemFontName) || m_impl->m_fontFileMgr.HasFontName(m_impl->m_defaultFontName)) {
+            fontNameList.push_back({ m_impl->m_defaultFontName, systemFontName });
+        }
     }
 
     sk_sp<SkTypeface> spTypeface;
-    for (const DString& inFontName : fontNameList) {
+    for (const std::pair<DString, DString>& fontNamePair : fontNameList) {
         //优先检查外部加载的字体是否满足要求, 如果未能匹配，再通过系统字体创建
-        spTypeface = m_impl->m_fontFileMgr.MakeTypeface(inFontName.c_str(), fontStyle);
+        spTypeface = m_impl->m_fontFileMgr.MakeTypeface(fontNamePair.first, fontStyle);
         if (spTypeface != nullptr) {
             break;
         }
+        if (fontNamePair.second.empty()) {
+            //不是系统字体
+            continue;
+        }
 
-        //使用FontMgr接口创建字体
-        std::string fontName = StringConvert::TToUTF8(inFontName);
+        //使用FontMgr接口创建字体（使用系统字体的名称，大小写不同的名称共用一个缓存）
+        std::string fontName = StringConvert::TToUTF8(fontNamePair.second);
         ASSERT(!fontName.empty());
         if (fontName.empty()) {
             continue;
@@ -5,12 +5,14 @@
 #include "duilib/RenderSkia/Matrix_Skia.h"
 #include "duilib/RenderSkia/Font_Skia.h"
 #include "duilib/RenderSkia/SkTextBox.h"
+#include "duilib/RenderSkia/SkTextGlyphCache.h"
 #include "duilib/RenderSkia/DrawSkiaImage.h"
 #include "duilib/Render/BitmapAlpha.h"
 
 #include "duilib/Utils/StringUtil.h"
 #include "duilib/Utils/PerformanceUtil.h"
 #include "duilib/Core/SharePtr.h"
+#include "duilib/Core/GlobalManager.h"
 
 #include "SkiaHeaderBegin.h"
 
@@ -20,6 +22,8 @@
 #include "include/core/SkImage.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkSurface.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkPictureRecorder.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkRegion.h"
@@ -36,11 +40,20 @@
 
 #include <unordered_set>
 #include <unordered_map>
+#include <cstdlib>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
 
 namespace ui {
 
 Render_Skia::Render_Skia():
-    m_saveCount(0)
+    m_saveCount(0),
+    m_pSkRecorder(nullptr),
+    m_pRecordCanvas(nullptr),
+    m_bRecordCanceled(false),
+    m_bRecordDisabled(false)
 {
     m_pSkPointOrg = new SkPoint;
     m_pSkPointOrg->iset(0, 0);
@@ -51,6 +64,11 @@ Render_Skia::Render_Skia():
 
 Render_Skia::~Render_Skia()
 {
+    if (m_pSkRecorder != nullptr) {
+        delete m_pSkRecorder;
+        m_pSkRecorder = nullptr;
+        m_pRecordCanvas = nullptr;
+    }
     if (m_pSkPaint) {
         delete m_pSkPaint;
         m_pSkPaint = nullptr;
@@ -95,6 +113,9 @@ void* Render_Skia::GetPixelBits() const
 
 void Render_Skia::Clear(const UiColor& uiColor)
 {
+    if (CancelRecord()) {
+        return;
+    }
     void* pPixelBits = GetPixelBits();
     if (pPixelBits != nullptr) {
         uint32_t nARGB = uiColor.GetARGB();
@@ -119,6 +140,9 @@ void Render_Skia::Clear(const UiColor& uiColor)
 
 void Render_Skia::ClearRect(const UiRect& rcDirty, const UiColor& uiColor)
 {
+    if (CancelRecord()) {
+        return;
+    }
     void* pPixelBits = GetPixelBits();
     if (pPixelBits != nullptr) {
         uint32_t nARGB = uiColor.GetARGB();
@@ -126,7 +150,7 @@ void Render_Skia::ClearRect(const UiRect& rcDirty, const UiColor& uiColor)
         const int32_t nTop = std::max((int32_t)rcDirty.top, 0);
         const int32_t nRight = std::min((int32_t)rcDirty.right, (int32_t)GetWidth());
         const int32_t nBottom = std::min((int32_t)rcDirty.bottom, (int32_t)GetHeight());
-        const int32_t nWidth = nRight - nLeft;
+        const int32_t nWidth = GetWidth(); //每行的像素数
         for (int32_t i = nTop; i < nBottom; i++) {
             for (int32_t j = nLeft; j < nRight; j++) {
                 uint32_t* color = (uint32_t*)pPixelBits + (i * nWidth + j);
@@ -143,6 +167,9 @@ IBitmap* Render_Skia::MakeImageSnapshot()
     if ((nWidth <= 0) || (nHeight <= 0)) {
         return nullptr;
     }
+    if (CancelRecord()) {
+        return nullptr;
+    }
     void* pPixelBits = GetPixelBits();
     if (pPixelBits == nullptr) {
         return nullptr;
@@ -157,6 +184,9 @@ IBitmap* Render_Skia::MakeImageSnapshot()
 
 void Render_Skia::ClearAlpha(const UiRect& rcDirty, uint8_t alpha)
 {
+    if (CancelRecord()) {
+        return;
+    }
     void* pPixelBits = GetPixelBits();
     if (pPixelBits != nullptr) {
         BitmapAlpha bitmapAlpha((uint8_t*)pPixelBits, GetWidth(), GetHeight(), sizeof(uint32_t));
@@ -166,6 +196,9 @@ void Render_Skia::ClearAlpha(const UiRect& rcDirty, uint8_t alpha)
 
 void Render_Skia::RestoreAlpha(const UiRect& rcDirty, const UiPadding& rcShadowPadding, uint8_t alpha)
 {
+    if (CancelRecord()) {
+        return;
+    }
     void* pPixelBits = GetPixelBits();
     if (pPixelBits != nullptr) {
         BitmapAlpha bitmapAlpha((uint8_t*)pPixelBits, GetWidth(), GetHeight(), sizeof(uint32_t));
@@ -175,6 +208,9 @@ void Render_Skia::RestoreAlpha(const UiRect& rcDirty, const UiPadding& rcShadowP
 
 void Render_Skia::RestoreAlpha(const UiRect& rcDirty, const UiPadding& rcShadowPadding)
 {
+    if (CancelRecord()) {
+        return;
+    }
     void* pPixelBits = GetPixelBits();
     if (pPixelBits != nullptr) {
         BitmapAlpha bitmapAlpha((uint8_t*)pPixelBits, GetWidth(), GetHeight(), sizeof(uint32_t));
@@ -306,6 +342,10 @@ bool Render_Skia::BitBlt(int32_t x, int32_t y, int32_t cx, int32_t cy, IRender*
     if (pSkiaRender == nullptr) {
         return false;
     }
+    if (pSkiaRender->CancelRecord()) {
+        //源画布正在录制，像素数据尚未绘制
+        return false;
+    }
     SkSurface* skSurface = pSkiaRender->GetSkSurface();
     ASSERT(skSurface != nullptr);
     if (skSurface == nullptr) {
@@ -337,6 +377,47 @@ bool Render_Skia::BitBlt(int32_t x, int32_t y, int32_t cx, int32_t cy, IRender*
     return false;
 }
 
+bool Render_Skia::ScrollRect(const UiRect& rcScroll, int32_t dx, int32_t dy)
+{
+    UiRect rcRect = rcScroll;
+    if (!rcRect.Intersect(UiRect(0, 0, GetWidth(), GetHeight()))) {
+        return false;
+    }
+    if ((std::abs(dx) >= rcRect.Width()) || (std::abs(dy) >= rcRect.Height())) {
+        //平移后没有可复用的内容
+        return false;
+    }
+    if ((dx == 0) && (dy == 0)) {
+        return true;
+    }
+    if (CancelRecord()) {
+        return false;
+    }
+    //只支持CPU绘制：直接在像素数据中平移（GPU绘制时，交换缓冲区后原有内容不保证有效）
+    SkCanvas* skCanvas = GetSkCanvas();
+    SkPixmap pixmap;
+    if ((skCanvas == nullptr) || !skCanvas->peekPixels(&pixmap)) {
+        return false;
+    }
+    if (pixmap.info().bytesPerPixel() != sizeof(uint32_t)) {
+        return false;
+    }
+    //目标区域及其对应的源区域
+    UiRect rcDest = rcRect;
+    rcDest.Offset(dx, dy);
+    rcDest.Intersect(rcRect);
+    const int32_t xSrc = rcDest.left - dx;
+    const int32_t nRowBytes = rcDest.Width() * (int32_t)sizeof(uint32_t);
+    const int32_t nRows = rcDest.Height();
+    for (int32_t i = 0; i < nRows; ++i) {
+        //向下平移时从下往上复制，避免覆盖尚未复制的源数据
+        const int32_t yDest = (dy > 0) ? (rcDest.bottom - 1 - i) : (rcDest.top + i);
+        const int32_t ySrc = yDest - dy;
+        ::memmove(pixmap.writable_addr32(rcDest.left, yDest), pixmap.addr32(xSrc, ySrc), nRowBytes);
+    }
+    return true;
+}
+
 bool Render_Skia::StretchBlt(int32_t xDest, int32_t yDest, int32_t widthDest, int32_t heightDest, IRender* pSrcRender, int32_t xSrc, int32_t ySrc, int32_t widthSrc, int32_t heightSrc, RopMode rop)
 {
     ASSERT((GetWidth() > 0) && (GetHeight() > 0));
@@ -350,6 +431,10 @@ bool Render_Skia::StretchBlt(int32_t xDest, int32_t yDest, int32_t widthDest, in
     if (pSkiaRender == nullptr) {
         return false;
     }
+    if (pSkiaRender->CancelRecord()) {
+        //源画布正在录制，像素数据尚未绘制
+        return false;
+    }
     SkSurface* skSurface = pSkiaRender->GetSkSurface();
     ASSERT(skSurface != nullptr);
     if (skSurface == nullptr) {
@@ -394,6 +479,10 @@ bool Render_Skia::AlphaBlend(int32_t xDest, int32_t yDest, int32_t widthDest, in
     if (pSkiaRender == nullptr) {
         return false;
     }
+    if (pSkiaRender->CancelRecord()) {
+        //源画布正在录制，像素数据尚未绘制
+        return false;
+    }
     SkSurface* skSurface = pSkiaRender->GetSkSurface();
     ASSERT(skSurface != nullptr);
     if (skSurface == nullptr) {
@@ -1659,11 +1748,12 @@ UiRect Render_Skia::MeasureString(const DString& strText,
 
     if (isSingleLineMode || (width <= 0)) {
         //单行模式, 或者没有限制宽度
-        SkScalar textWidth = pSkFont->measureText(strText.c_str(),
-                                                  strText.size() * sizeof(DString::value_type),
-                                                  GetTextEncoding(),
-                                                  nullptr,
-                                                  &skPaint);
+        SkScalar textWidth = SkTextGlyphCache::Instance().MeasureText(strText.c_str(),
+                                                                      strText.size() * sizeof(DString::value_type),
+                                                                      GetTextEncoding(),
+                                                                      *pSkFont,
+                                                                      nullptr,
+                                                                      &skPaint);
         int textIWidth = SkScalarTruncToInt(textWidth + 0.5f);
         if (textWidth > textIWidth) {
             textIWidth += 1;
@@ -3035,6 +3125,9 @@ bool Render_Skia::ReadPixels(const UiRect& rc, void* dstPixels, size_t dstPixels
     if (dstPixelsLen < (rc.Width() * rc.Height() * sizeof(uint32_t))) {
         return false;
     }
+    if (CancelRecord()) {
+        return false;
+    }
 
     SkCanvas* skCanvas = GetSkCanvas();
     ASSERT(skCanvas != nullptr);
@@ -3064,6 +3157,9 @@ bool Render_Skia::WritePixels(void* srcPixels, size_t srcPixelsLen, const UiRect
     if (srcPixelsLen < (rc.Width() * rc.Height() * sizeof(uint32_t))) {
         return false;
     }
+    if (CancelRecord()) {
+        return false;
+    }
 
     SkCanvas* skCanvas = GetSkCanvas();
     ASSERT(skCanvas != nullptr);
@@ -3097,6 +3193,9 @@ bool Render_Skia::WritePixels(void* srcPixels, size_t srcPixelsLen, const UiRect
     if (srcPixelsLen < (rc.Width() * rc.Height() * sizeof(uint32_t))) {
         return false;
     }
+    if (CancelRecord()) {
+        return false;
+    }
 
     SkCanvas* skCanvas = GetSkCanvas();
     ASSERT(skCanvas != nullptr);
@@ -3196,6 +3295,173 @@ void Render_Skia::SetRenderDpi(const IRenderDpiPtr& spRenderDpi)
     m_spRenderDpi = spRenderDpi;
 }
 
+/** 分块光栅化时，每块的最小高度
+*/
+static constexpr int32_t kMinRasterTileHeight = 64;
+
+/** 分块光栅化的任务（由UI线程和线程池中的工作线程共同执行，每个线程每次领取一块）
+*/
+struct RasterTileTask
+{
+    /** 录制的绘制命令（只读，可在多个线程中同时回放）
+    */
+    sk_sp<SkPicture> m_skPicture;
+
+    /** 目标位图的像素数据
+    */
+    SkPixmap m_pixmap;
+
+    /** 目标画布的属性（文字的绘制方式与目标画布保持一致）
+    */
+    SkSurfaceProps m_surfaceProps;
+
+    /** 分块的区域（互不相交）
+    */
+    std::vector<SkIRect> m_tiles;
+
+    /** 下一个待领取的分块
+    */
+    std::atomic<size_t> m_nNextTile{ 0 };
+
+    /** 已经完成的分块个数
+    */
+    size_t m_nFinishedTiles = 0;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+
+    /** 领取并光栅化分块，直到所有分块都已领取
+    */
+    void Run()
+    {
+        size_t nTile = m_nNextTile++;
+        while (nTile < m_tiles.size()) {
+            std::unique_ptr<SkCanvas> skCanvas = SkCanvas::MakeRasterDirect(m_pixmap.info(), m_pixmap.writable_addr(),
+                                                                            m_pixmap.rowBytes(), &m_surfaceProps);
+            if (skCanvas != nullptr) {
+                skCanvas->clipIRect(m_tiles[nTile]);
+                skCanvas->drawPicture(m_skPicture);
+            }
+            {
+                std::lock_guard<std::mutex> threadGuard(m_mutex);
+                ++m_nFinishedTiles;
+            }
+            m_cv.notify_all();
+            nTile = m_nNextTile++;
+        }
+    }
+
+    /** 等待所有分块完成
+    */
+    void Wait()
+    {
+        std::unique_lock<std::mutex> threadGuard(m_mutex);
+        m_cv.wait(threadGuard, [this]() { return m_nFinishedTiles >= m_tiles.size(); });
+    }
+};
+
+SkCanvas* Render_Skia::GetRecordCanvas() const
+{
+    return m_pRecordCanvas;
+}
+
+bool Render_Skia::CancelRecord()
+{
+    if (m_pSkRecorder == nullptr) {
+        return false;
+    }
+    m_bRecordCanceled = true;
+    return true;
+}
+
+bool Render_Skia::BeginRecord(const UiRect& rcPaint)
+{
+    ASSERT(m_pSkRecorder == nullptr);
+    if ((m_pSkRecorder != nullptr) || m_bRecordDisabled) {
+        return false;
+    }
+    UiRect rcRecord = rcPaint;
+    if (!rcRecord.Intersect(UiRect(0, 0, GetWidth(), GetHeight()))) {
+        return false;
+    }
+    //只支持CPU绘制：光栅化时多个线程直接写入位图的像素数据
+    SkSurface* skSurface = GetSkSurface();
+    SkPixmap pixmap;
+    if ((skSurface == nullptr) || !skSurface->peekPixels(&pixmap)) {
+        return false;
+    }
+    //画布上不能有未恢复的剪辑区域和变换（光栅化时使用新的画布，无法还原这些状态）
+    SkCanvas* skCanvas = skSurface->getCanvas();
+    if ((skCanvas == nullptr) || (skCanvas->getSaveCount() != 1) || !skCanvas->getTotalMatrix().isIdentity()) {
+        return false;
+    }
+    m_pSkRecorder = new SkPictureRecorder;
+    m_pRecordCanvas = m_pSkRecorder->beginRecording(SkRect::MakeLTRB((SkScalar)rcRecord.left, (SkScalar)rcRecord.top,
+                                                                     (SkScalar)rcRecord.right, (SkScalar)rcRecord.bottom));
+    ASSERT(m_pRecordCanvas != nullptr);
+    if (m_pRecordCanvas == nullptr) {
+        delete m_pSkRecorder;
+        m_pSkRecorder = nullptr;
+        return false;
+    }
+    m_rcRecord = rcRecord;
+    m_bRecordCanceled = false;
+    return true;
+}
+
+bool Render_Skia::EndRecord(uint32_t nTileCount)
+{
+    ASSERT(m_pSkRecorder != nullptr);
+    if (m_pSkRecorder == nullptr) {
+        return false;
+    }
+    //Render_Skia不使用saveLayer，录制时的优化不会改变绘制结果
+    sk_sp<SkPicture> skPicture = m_pSkRecorder->finishRecordingAsPicture();
+    delete m_pSkRecorder;
+    m_pSkRecorder = nullptr;
+    m_pRecordCanvas = nullptr;
+    if (m_bRecordCanceled) {
+        //有不能录制的操作，以后该画布均直接绘制
+        m_bRecordCanceled = false;
+        m_bRecordDisabled = true;
+        return false;
+    }
+    SkSurface* skSurface = GetSkSurface();
+    ASSERT((skSurface != nullptr) && (skPicture != nullptr));
+    if ((skSurface == nullptr) || (skPicture == nullptr)) {
+        return false;
+    }
+    //直接写入像素数据前，确保已有的快照不受影响
+    skSurface->notifyContentWillChange(SkSurface::kRetain_ContentChangeMode);
+
+    std::shared_ptr<RasterTileTask> spTask = std::make_shared<RasterTileTask>();
+    if (!skSurface->peekPixels(&spTask->m_pixmap)) {
+        return false;
+    }
+    spTask->m_skPicture = skPicture;
+    spTask->m_surfaceProps = skSurface->props();
+
+    //按行分块：每块的像素数据在内存中连续，各块互不相交，光栅化的结果与整体绘制相同
+    const int32_t nHeight = m_rcRecord.Height();
+    int32_t nTiles = std::clamp((int32_t)nTileCount, 1, std::max(nHeight / kMinRasterTileHeight, 1));
+    for (int32_t nTile = 0; nTile < nTiles; ++nTile) {
+        const int32_t nTop = m_rcRecord.top + nHeight * nTile / nTiles;
+        const int32_t nBottom = m_rcRecord.top + nHeight * (nTile + 1) / nTiles;
+        spTask->m_tiles.push_back(SkIRect::MakeLTRB(m_rcRecord.left, nTop, m_rcRecord.right, nBottom));
+    }
+
+    //当前线程也参与光栅化，工作线程忙时，由当前线程完成剩余的分块
+    ThreadManager& threadManager = GlobalManager::Instance().Thread();
+    const size_t nPostCount = std::min(spTask->m_tiles.size() - 1, (size_t)threadManager.GetThreadPoolSize());
+    for (size_t nIndex = 0; nIndex < nPostCount; ++nIndex) {
+        threadManager.PostTask(kThreadPool, [spTask]() {
+                spTask->Run();
+            });
+    }
+    spTask->Run();
+    spTask->Wait();
+    return true;
+}
+
 SkTextEncoding Render_Skia::GetTextEncoding() const
 {
     constexpr const size_t nValueLen = sizeof(DString::value_type);
@@ -7,6 +7,7 @@
 //Skia相关类的前置声明
 class SkSurface;
 class SkCanvas;
+class SkPictureRecorder;
 struct SkPoint;
 class SkPaint;
 enum class SkTextEncoding;
@@ -49,6 +50,7 @@ public:
     virtual void ClearClip() override;
 
     virtual bool BitBlt(int32_t x, int32_t y, int32_t cx, int32_t cy, IRender* pSrcRender, int32_t xSrc, int32_t ySrc, RopMode rop) override;
+    virtual bool ScrollRect(const UiRect& rcScroll, int32_t dx, int32_t dy) override;
     virtual bool StretchBlt(int32_t xDest, int32_t yDest, int32_t widthDest, int32_t heightDest, IRender* pSrcRender, int32_t xSrc, int32_t ySrc, int32_t widthSrc, int32_t heightSrc, RopMode rop) override;
     virtual bool AlphaBlend(int32_t xDest, int32_t yDest, int32_t widthDest, int32_t heightDest, IRender* pSrcRender, int32_t xSrc, int32_t ySrc, int32_t widthSrc, int32_t heightSrc, uint8_t alpha = 255) override;
 
@@ -191,12 +193,15 @@ public:
     virtual bool IsEmpty() const override;
     virtual void SetRenderDpi(const IRenderDpiPtr& spRenderDpi) override;
 
+    virtual bool BeginRecord(const UiRect& rcPaint) override;
+    virtual bool EndRecord(uint32_t nTileCount) override;
+
 public:
     /** 获取SkSurface接口
     */
     virtual SkSurface* GetSkSurface() const = 0;
 
-    /** 获取SkCanvas接口
+    /** 获取SkCanvas接口（录制绘制命令期间，应返回录制用的画布，即GetRecordCanvas()）
     */
     virtual SkCanvas* GetSkCanvas() const = 0;
 
@@ -209,6 +214,15 @@ protected:
     */
     IRenderDpiPtr GetRenderDpi() const;
 
+    /** 获取录制绘制命令的画布（录制期间GetSkCanvas应返回该画布），未在录制时返回nullptr
+    */
+    SkCanvas* GetRecordCanvas() const;
+
+    /** 直接访问像素数据之前调用：如果正在录制绘制命令，放弃本次录制（EndRecord返回false，由调用方重新直接绘制）
+    * @return 如果正在录制，返回true，此时不能访问像素数据
+    */
+    bool CancelRecord();
+
 private:
     /** 获取GDI的光栅操作代码
     */
@@ -298,6 +312,23 @@ private:
     /** DPI转换辅助接口
     */
     IRenderDpiPtr m_spRenderDpi;
+
+    /** 录制绘制命令的对象，及其画布（仅在录制期间有效）
+    */
+    SkPictureRecorder* m_pSkRecorder;
+    SkCanvas* m_pRecordCanvas;
+
+    /** 录制的区域
+    */
+    UiRect m_rcRecord;
+
+    /** 本次录制是否已经放弃
+    */
+    bool m_bRecordCanceled;
+
+    /** 是否不再录制（录制过程中出现过不能录制的操作，比如有控件直接写入像素数据，以后均直接绘制）
+    */
+    bool m_bRecordDisabled;
 };
 
 } // namespace ui
@@ -161,6 +161,11 @@ SkSurface* Render_Skia_SDL::GetSkSurface() const
 
 SkCanvas* Render_Skia_SDL::GetSkCanvas() const
 {
+    SkCanvas* pRecordCanvas = GetRecordCanvas();
+    if (pRecordCanvas != nullptr) {
+        //正在录制绘制命令
+        return pRecordCanvas;
+    }
     ASSERT(m_pWindowContext != nullptr);
     if (m_pWindowContext == nullptr) {
         return nullptr;
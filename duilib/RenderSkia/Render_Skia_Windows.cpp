@@ -167,6 +167,11 @@ SkSurface* Render_Skia_Windows::GetSkSurface() const
 
 SkCanvas* Render_Skia_Windows::GetSkCanvas() const
 {
+    SkCanvas* pRecordCanvas = GetRecordCanvas();
+    if (pRecordCanvas != nullptr) {
+        //正在录制绘制命令
+        return pRecordCanvas;
+    }
     ASSERT(m_pWindowContext != nullptr);
     if (m_pWindowContext == nullptr) {
         return nullptr;
@@ -185,6 +190,10 @@ HDC Render_Skia_Windows::GetRenderDC(HWND hWnd)
     if (m_hDC != nullptr) {
         return m_hDC;
     }
+    if (CancelRecord()) {
+        //正在录制绘制命令，不能使用GDI直接绘制
+        return nullptr;
+    }
     SkCanvas* skCanvas = GetSkCanvas();
     ASSERT(skCanvas != nullptr);
     if (skCanvas == nullptr) {
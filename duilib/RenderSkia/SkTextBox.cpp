@@ -6,6 +6,7 @@
  */
 
 #include "SkTextBox.h"
+#include "SkTextGlyphCache.h"
 #include "SkUtils.h"
 
 #include "SkiaHeaderBegin.h"
@@ -404,11 +405,12 @@ SkScalar SkTextBox::visit(Visitor& visitor) const {
             }
             else {
                 //右对齐或者中对齐
-                SkScalar textWidth = font.measureText(text,
-                                                      len - trailing,
-                                                      textEncoding,
-                                                      nullptr,
-                                                      &paint);
+                SkScalar textWidth = SkTextGlyphCache::Instance().MeasureText(text,
+                                                                              len - trailing,
+                                                                              textEncoding,
+                                                                              font,
+                                                                              nullptr,
+                                                                              &paint);
                 if (textAlign == kCenter_Align) {
                     //横向：中对齐
                     x = boxRect.fLeft + (marginWidth / 2) - textWidth / 2;
@@ -470,14 +472,15 @@ static bool EllipsisTextUTF(const char text[], size_t length, SkTextEncoding tex
     if (textEncoding == SkTextEncoding::kUTF32) {
         charBytes = 4;
     }
-    SkScalar ellipsisWidth = font.measureText(ellipsisStr.c_str(), ellipsisStr.size()* charBytes, textEncoding, nullptr, &paint);
+    SkTextGlyphCache& glyphCache = SkTextGlyphCache::Instance();
+    SkScalar ellipsisWidth = glyphCache.MeasureText(ellipsisStr.c_str(), ellipsisStr.size()* charBytes, textEncoding, font, nullptr, &paint);
     SkScalar pathEndWidth = 0;    
     string.assign((const typename T::value_type*)text, length / charBytes);
     if (bPathEllipsis) {
         int pos = (int)string.find_last_of(pathSep);
         if (pos > 0) {
             pathEnd = string.substr(pos);
-            pathEndWidth = font.measureText(pathEnd.c_str(), pathEnd.size()* charBytes, textEncoding, nullptr, &paint);
+            pathEndWidth = glyphCache.MeasureText(pathEnd.c_str(), pathEnd.size()* charBytes, textEncoding, font, nullptr, &paint);
             if ((pathEndWidth + ellipsisWidth) > destWidth) {
                 //宽度不足以显示路径的最后一段文字
                 pathEnd.clear();
@@ -584,14 +587,14 @@ static void TextBox_DrawText(SkTextBox* textBox,
     bool isSingleLine = textBox->getLineMode() == SkTextBox::kOneLine_Mode;
 
     if (!bEndEllipsis && !bPathEllipsis && !bUnderline && !bStrikeOut) {
-        canvas->drawSimpleText(text, length, textEncoding, x, y, font, paint);
+        SkTextGlyphCache::Instance().DrawText(canvas, text, length, textEncoding, x, y, font, paint);
     }
     else {
         bool needEllipsis = false;
         if (bEndEllipsis || bPathEllipsis) {
             if (isSingleLine) {                
                 //单行模式
-                SkScalar textWidth = font.measureText(text, length, textEncoding, nullptr, &paint);
+                SkScalar textWidth = SkTextGlyphCache::Instance().MeasureText(text, length, textEncoding, font, nullptr, &paint);
                 if ((x + textWidth) > boxRect.fRight) {
                     //文字超出边界，需要增加"..."替代无法显示的文字
                     needEllipsis = true;
@@ -606,7 +609,7 @@ static void TextBox_DrawText(SkTextBox* textBox,
             }
         }
         if(!needEllipsis && !bUnderline && !bStrikeOut) {
-            canvas->drawSimpleText(text, length, textEncoding, x, y, font, paint);
+            SkTextGlyphCache::Instance().DrawText(canvas, text, length, textEncoding, x, y, font, paint);
         }
         else {
             std::string string_utf8;
@@ -629,9 +632,9 @@ static void TextBox_DrawText(SkTextBox* textBox,
                 }
             }
             //绘制文本
-            canvas->drawSimpleText(text, length, textEncoding, x, y, font, paint);
+            SkTextGlyphCache::Instance().DrawText(canvas, text, length, textEncoding, x, y, font, paint);
             if (bUnderline || bStrikeOut) {
-                SkScalar width = font.measureText(text, length, textEncoding, nullptr, &paint);
+                SkScalar width = SkTextGlyphCache::Instance().MeasureText(text, length, textEncoding, font, nullptr, &paint);
 
                 // Default fraction of the text size to use for a strike-through or underline.
                 static constexpr SkScalar kLineThicknessFactor = (SK_Scalar1 / 18);
@@ -818,16 +821,15 @@ bool SkTextBox::TextToGlyphs(const void* text, size_t byteLength, SkTextEncoding
                              const SkFont& font,
                              std::vector<SkGlyphID>& glyphs,
                              std::vector<uint8_t>& glyphChars,
-                             size_t& charBytes)
+                             size_t& charBytes,
+                             bool& bHasMissing)
 {
-    glyphs.clear();
-    glyphs.resize(byteLength, { 0, });
-    int glyphsCount = font.textToGlyphs(text, byteLength, textEncoding, glyphs.data(), (int)glyphs.size());
+    //使用Glyph缓存转换，避免每次绘制都重新查询字体
+    int glyphsCount = SkTextGlyphCache::Instance().TextToGlyphs(text, byteLength, textEncoding, font, glyphs, bHasMissing);
     if (glyphsCount <= 0) {
         return false;
     }
-    SkASSERT(glyphsCount <= (int)glyphs.size());
-    glyphs.resize(glyphsCount);
+    SkASSERT(glyphsCount == (int)glyphs.size());
 
     glyphChars.clear();
     glyphChars.resize(glyphs.size(), 1);
@@ -933,7 +935,7 @@ size_t SkTextBox::breakText(const void* text, size_t byteLength, SkTextEncoding
         return 0;
     }
     SkRect bounds = SkRect::MakeEmpty();
-    SkScalar width = font.measureText(text, byteLength, textEncoding, &bounds);
+    SkScalar width = SkTextGlyphCache::Instance().MeasureText(text, byteLength, textEncoding, font, &bounds);
     if (measuredHeight != nullptr) {
         *measuredHeight = bounds.height();
         SkASSERT(*measuredHeight > 0);
@@ -950,8 +952,10 @@ size_t SkTextBox::breakText(const void* text, size_t byteLength, SkTextEncoding
     std::vector<uint8_t> glyphChars;
     //每个字符的字节数
     size_t charBytes = 1;
+    //是否含有字体中缺失的字符
+    bool bHasMissing = false;
 
-    if (!TextToGlyphs(text, byteLength, textEncoding, font, glyphs, glyphChars, charBytes)) {
+    if (!TextToGlyphs(text, byteLength, textEncoding, font, glyphs, glyphChars, charBytes, bHasMissing)) {
         if (measuredWidth != nullptr) {
             *measuredWidth = width;
         }
@@ -959,8 +963,8 @@ size_t SkTextBox::breakText(const void* text, size_t byteLength, SkTextEncoding
     }
 
     std::vector<SkScalar> glyphWidths;
-    glyphWidths.resize(glyphs.size(), 0);
-    font.getWidthsBounds(glyphs.data(), (int)glyphs.size(), glyphWidths.data(), nullptr, &paint);
+    SkTextGlyphCache::Instance().GetGlyphWidths(text, byteLength, textEncoding, font, &paint,
+                                                glyphs, bHasMissing, glyphWidths);
 
     size_t breakByteLength = 0;//单位是字节
     SkScalar totalWidth = 0;
@@ -1001,7 +1005,7 @@ size_t SkTextBox::breakText(const void* text, size_t byteLength, SkTextEncoding
     }
     bool bWantGlyphData = (glyphCharList != nullptr) || (glyphWidthList != nullptr);
     SkRect bounds = SkRect::MakeEmpty();
-    SkScalar width = font.measureText(text, byteLength, textEncoding, &bounds);
+    SkScalar width = SkTextGlyphCache::Instance().MeasureText(text, byteLength, textEncoding, font, &bounds);
     if (measuredHeight != nullptr) {
         *measuredHeight = bounds.height();
         SkASSERT(*measuredHeight > 0);
@@ -1019,8 +1023,10 @@ size_t SkTextBox::breakText(const void* text, size_t byteLength, SkTextEncoding
     glyphChars.clear(); //保存每个glyphs对应的字符个数
     //每个字符的字节数
     size_t charBytes = 1;
+    //是否含有字体中缺失的字符
+    bool bHasMissing = false;
 
-    if (!TextToGlyphs(text, byteLength, textEncoding, font, glyphs, glyphChars, charBytes)) {
+    if (!TextToGlyphs(text, byteLength, textEncoding, font, glyphs, glyphChars, charBytes, bHasMissing)) {
         if (measuredWidth != nullptr) {
             *measuredWidth = width;
         }
@@ -1028,8 +1034,8 @@ size_t SkTextBox::breakText(const void* text, size_t byteLength, SkTextEncoding
     }
 
     glyphWidths.clear(); //保存每个glyphs字符的宽度
-    glyphWidths.resize(glyphs.size(), 0);
-    font.getWidthsBounds(glyphs.data(), (int)glyphs.size(), glyphWidths.data(), nullptr, &paint);
+    SkTextGlyphCache::Instance().GetGlyphWidths(text, byteLength, textEncoding, font, &paint,
+                                                glyphs, bHasMissing, glyphWidths);
 
     if (bWantGlyphData && (width <= maxWidth)) {
         if (glyphCharList != nullptr) {
@@ -164,12 +164,14 @@ private:
     * @param [out] glyphs 转换结果Glyphs
     * @param [out] 每个SkGlyphID对应的原text字符串中的字符个数
     * @param [out] 每个字符占的字节数
+    * @param [out] bHasMissing 是否含有字体中缺失的字符（Glyph为0）
     */
     static bool TextToGlyphs(const void* text, size_t byteLength, SkTextEncoding textEncoding, 
                              const SkFont& font,
                              std::vector<SkGlyphID>& glyphs,
                              std::vector<uint8_t>& glyphChars,
-                             size_t& charBytes);
+                             size_t& charBytes,
+                             bool& bHasMissing);
 
 private:
     //文字绘制区域
@@ -0,0 +1,409 @@
+#include "SkTextGlyphCache.h"
+#include "SkUtils.h"
+
+#include "SkiaHeaderBegin.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkString.h"
+#include "SkiaHeaderEnd.h"
+
+#include <cstring>
+
+namespace ui
+{
+/** SkTextBlob缓存的最大个数
+*/
+static constexpr size_t kMaxTextBlobCount = 2048;
+
+/** 可缓存SkTextBlob的文本最大字节数（长文本一般不会重复绘制）
+*/
+static constexpr size_t kMaxTextBlobBytes = 1024;
+
+/** 最大的Unicode字符
+*/
+static constexpr SkUnichar kMaxUnichar = 0x10FFFF;
+
+/** 读取一个Unicode字符，并移动到下一个字符
+*/
+static SkUnichar NextUnichar(const char*& text, const char* stop, SkTextEncoding textEncoding)
+{
+    if (textEncoding == SkTextEncoding::kUTF16) {
+        const uint16_t* src = (const uint16_t*)text;
+        const uint16_t* srcStop = (const uint16_t*)stop;
+        SkUnichar c = *src++;
+        if (SkUTF16_IsHighSurrogate(c) && (src < srcStop) && SkUTF16_IsLowSurrogate(*src)) {
+            c = ((c - 0xD800) << 10) + (*src++ - 0xDC00) + 0x10000;
+        }
+        text = (const char*)src;
+        return c;
+    }
+    else if (textEncoding == SkTextEncoding::kUTF32) {
+        SkUnichar c = *(const int32_t*)text;
+        text += sizeof(int32_t);
+        return c;
+    }
+    else {
+        return SkUTF8_NextUnichar(&text, stop);
+    }
+}
+
+/** 将数据追加到缓存的Key中
+*/
+template<typename T>
+static void AppendKeyData(std::string& key, const T& value)
+{
+    key.append((const char*)&value, sizeof(value));
+}
+
+SkTextGlyphCache& SkTextGlyphCache::Instance()
+{
+    static SkTextGlyphCache self;
+    return self;
+}
+
+SkTextGlyphCache::SkTextGlyphCache()
+{
+}
+
+SkTextGlyphCache::~SkTextGlyphCache()
+{
+}
+
+void SkTextGlyphCache::SetFontMgr(const sk_sp<SkFontMgr>& spFontMgr)
+{
+    std::lock_guard<std::mutex> threadGuard(m_mutex);
+    m_spFontMgr = spFontMgr;
+    m_fallbackTypefaces.clear();
+    m_textBlobMap.clear();
+    m_textBlobList.clear();
+}
+
+void SkTextGlyphCache::Clear()
+{
+    std::lock_guard<std::mutex> threadGuard(m_mutex);
+    m_typefaceGlyphs.clear();
+    m_fallbackTypefaces.clear();
+    m_textBlobMap.clear();
+    m_textBlobList.clear();
+}
+
+SkGlyphID SkTextGlyphCache::UnicharToGlyph(TypefaceGlyphs& typefaceGlyphs, const SkTypeface* typeface, SkUnichar uni)
+{
+    if ((uni < 0) || (uni > kMaxUnichar)) {
+        return 0;
+    }
+    const size_t nPage = (size_t)uni >> 8;
+    std::vector<std::unique_ptr<GlyphPage>>& pages = typefaceGlyphs.m_pages;
+    if (pages.size() <= nPage) {
+        pages.resize(nPage + 1);
+    }
+    if (pages[nPage] == nullptr) {
+        //首次访问该页，整页批量查询
+        std::unique_ptr<GlyphPage> page = std::make_unique<GlyphPage>();
+        SkUnichar unichars[256];
+        for (SkUnichar i = 0; i < 256; ++i) {
+            unichars[i] = (SkUnichar)(nPage << 8) + i;
+        }
+        typeface->unicharsToGlyphs(unichars, 256, page->data());
+        pages[nPage] = std::move(page);
+    }
+    return (*pages[nPage])[uni & 0xFF];
+}
+
+int SkTextGlyphCache::TextToGlyphs(const void* text, size_t byteLength, SkTextEncoding textEncoding,
+                                   const SkFont& font, std::vector<SkGlyphID>& glyphs, bool& bHasMissing)
+{
+    glyphs.clear();
+    bHasMissing = false;
+    if ((text == nullptr) || (byteLength == 0)) {
+        return 0;
+    }
+    const SkTypeface* typeface = font.getTypeface();
+    if ((typeface == nullptr) ||
+        ((textEncoding != SkTextEncoding::kUTF8) &&
+         (textEncoding != SkTextEncoding::kUTF16) &&
+         (textEncoding != SkTextEncoding::kUTF32))) {
+        //无法缓存，直接转换
+        glyphs.resize(byteLength, 0);
+        int glyphsCount = font.textToGlyphs(text, byteLength, textEncoding, glyphs.data(), (int)glyphs.size());
+        glyphs.resize(glyphsCount > 0 ? glyphsCount : 0);
+        return (int)glyphs.size();
+    }
+
+    const char* src = (const char*)text;
+    const char* stop = src + byteLength;
+    if (textEncoding == SkTextEncoding::kUTF16) {
+        glyphs.reserve(byteLength / sizeof(uint16_t));
+    }
+    else if (textEncoding == SkTextEncoding::kUTF32) {
+        glyphs.reserve(byteLength / sizeof(uint32_t));
+    }
+    else {
+        glyphs.reserve(byteLength);
+    }
+
+    std::lock_guard<std::mutex> threadGuard(m_mutex);
+    TypefaceGlyphs& typefaceGlyphs = m_typefaceGlyphs[typeface->uniqueID()];
+    while (src < stop) {
+        SkUnichar uni = NextUnichar(src, stop, textEncoding);
+        SkGlyphID glyph = UnicharToGlyph(typefaceGlyphs, typeface, uni);
+        if (glyph == 0) {
+            bHasMissing = true;
+        }
+        glyphs.push_back(glyph);
+    }
+    return (int)glyphs.size();
+}
+
+sk_sp<SkTypeface> SkTextGlyphCache::FindFallbackTypeface(const SkTypeface* typeface, SkUnichar uni)
+{
+    if ((typeface == nullptr) || (uni < 0) || (uni > kMaxUnichar)) {
+        return nullptr;
+    }
+    const uint64_t nKey = ((uint64_t)typeface->uniqueID() << 32) | (uint32_t)uni;
+    auto iter = m_fallbackTypefaces.find(nKey);
+    if (iter != m_fallbackTypefaces.end()) {
+        return iter->second;
+    }
+
+    sk_sp<SkTypeface> spFallback;
+    if (m_spFontMgr != nullptr) {
+        SkString familyName;
+        typeface->getFamilyName(&familyName);
+        spFallback = m_spFontMgr->matchFamilyStyleCharacter(familyName.c_str(), typeface->fontStyle(),
+                                                            nullptr, 0, uni);
+        if ((spFallback != nullptr) && (spFallback->uniqueID() == typeface->uniqueID())) {
+            spFallback.reset();
+        }
+        if (spFallback != nullptr) {
+            //回退字体中也没有该字符时，不使用
+            TypefaceGlyphs& fallbackGlyphs = m_typefaceGlyphs[spFallback->uniqueID()];
+            if (UnicharToGlyph(fallbackGlyphs, spFallback.get(), uni) == 0) {
+                spFallback.reset();
+            }
+        }
+    }
+    //没有可用的回退字体时也缓存，避免重复查询
+    m_fallbackTypefaces[nKey] = spFallback;
+    return spFallback;
+}
+
+sk_sp<SkTypeface> SkTextGlyphCache::GetFallbackTypeface(const SkFont& font, SkUnichar uni)
+{
+    std::lock_guard<std::mutex> threadGuard(m_mutex);
+    return FindFallbackTypeface(font.getTypeface(), uni);
+}
+
+bool SkTextGlyphCache::GetFallbackGlyph(const SkTypeface* typeface, SkUnichar uni,
+                                        sk_sp<SkTypeface>& spFallback, SkGlyphID& glyph)
+{
+    glyph = 0;
+    std::lock_guard<std::mutex> threadGuard(m_mutex);
+    spFallback = FindFallbackTypeface(typeface, uni);
+    if (spFallback == nullptr) {
+        return false;
+    }
+    glyph = UnicharToGlyph(m_typefaceGlyphs[spFallback->uniqueID()], spFallback.get(), uni);
+    return glyph != 0;
+}
+
+void SkTextGlyphCache::GetGlyphWidthsBounds(const void* text, size_t byteLength, SkTextEncoding textEncoding,
+                                            const SkFont& font, const SkPaint* paint,
+                                            const std::vector<SkGlyphID>& glyphs, bool bHasMissing,
+                                            std::vector<SkScalar>& glyphWidths,
+                                            std::vector<SkRect>* glyphBounds)
+{
+    const int nGlyphCount = (int)glyphs.size();
+    glyphWidths.resize(glyphs.size(), 0);
+    if (glyphBounds != nullptr) {
+        glyphBounds->resize(glyphs.size(), SkRect::MakeEmpty());
+    }
+    if (nGlyphCount == 0) {
+        return;
+    }
+    font.getWidthsBounds(glyphs.data(), nGlyphCount, glyphWidths.data(),
+                         (glyphBounds != nullptr) ? glyphBounds->data() : nullptr, paint);
+    if (!bHasMissing || (text == nullptr)) {
+        return;
+    }
+
+    //缺失的字符，按回退字体计算宽度
+    const char* src = (const char*)text;
+    const char* stop = src + byteLength;
+    SkFont fallbackFont = font;
+    sk_sp<SkTypeface> spFallback;
+    SkGlyphID fallbackGlyph = 0;
+    for (int nIndex = 0; (nIndex < nGlyphCount) && (src < stop); ++nIndex) {
+        SkUnichar uni = NextUnichar(src, stop, textEncoding);
+        if (glyphs[nIndex] != 0) {
+            continue;
+        }
+        if (!GetFallbackGlyph(font.getTypeface(), uni, spFallback, fallbackGlyph)) {
+            continue;
+        }
+        fallbackFont.setTypeface(spFallback);
+        fallbackFont.getWidthsBounds(&fallbackGlyph, 1, &glyphWidths[nIndex],
+                                     (glyphBounds != nullptr) ? &(*glyphBounds)[nIndex] : nullptr, paint);
+    }
+}
+
+void SkTextGlyphCache::GetGlyphWidths(const void* text, size_t byteLength, SkTextEncoding textEncoding,
+                                      const SkFont& font, const SkPaint* paint,
+                                      const std::vector<SkGlyphID>& glyphs, bool bHasMissing,
+                                      std::vector<SkScalar>& glyphWidths)
+{
+    GetGlyphWidthsBounds(text, byteLength, textEncoding, font, paint, glyphs, bHasMissing, glyphWidths, nullptr);
+}
+
+SkScalar SkTextGlyphCache::MeasureText(const void* text, size_t byteLength, SkTextEncoding textEncoding,
+                                       const SkFont& font, SkRect* bounds, const SkPaint* paint)
+{
+    std::vector<SkGlyphID> glyphs;
+    bool bHasMissing = false;
+    int nGlyphCount = TextToGlyphs(text, byteLength, textEncoding, font, glyphs, bHasMissing);
+    if (nGlyphCount <= 0) {
+        if (bounds != nullptr) {
+            bounds->setEmpty();
+        }
+        return 0;
+    }
+    if (!bHasMissing) {
+        //Glyph已经转换完成，按Glyph计算，避免再次转换
+        return font.measureText(glyphs.data(), glyphs.size() * sizeof(SkGlyphID), SkTextEncoding::kGlyphID,
+                                bounds, paint);
+    }
+
+    std::vector<SkScalar> glyphWidths;
+    std::vector<SkRect> glyphBounds;
+    GetGlyphWidthsBounds(text, byteLength, textEncoding, font, paint, glyphs, bHasMissing,
+                         glyphWidths, (bounds != nullptr) ? &glyphBounds : nullptr);
+    SkScalar width = 0;
+    SkRect textBounds = SkRect::MakeEmpty();
+    for (int nIndex = 0; nIndex < nGlyphCount; ++nIndex) {
+        if (bounds != nullptr) {
+            SkRect rcGlyph = glyphBounds[nIndex];
+            rcGlyph.offset(width, 0);
+            textBounds.join(rcGlyph);
+        }
+        width += glyphWidths[nIndex];
+    }
+    if (bounds != nullptr) {
+        *bounds = textBounds;
+    }
+    return width;
+}
+
+sk_sp<SkTextBlob> SkTextGlyphCache::MakeTextBlob(const void* text, size_t byteLength, SkTextEncoding textEncoding,
+                                                 const SkFont& font)
+{
+    std::vector<SkGlyphID> glyphs;
+    bool bHasMissing = false;
+    const int nGlyphCount = TextToGlyphs(text, byteLength, textEncoding, font, glyphs, bHasMissing);
+    if (nGlyphCount <= 0) {
+        return nullptr;
+    }
+    SkTextBlobBuilder builder;
+    if (!bHasMissing) {
+        SkTextBlobBuilder::RunBuffer runBuffer = builder.allocRun(font, nGlyphCount, 0, 0);
+        ::memcpy(runBuffer.glyphs, glyphs.data(), nGlyphCount * sizeof(SkGlyphID));
+        return builder.make();
+    }
+
+    //缺失的字符使用回退字体，相邻的使用相同字体的字符合并为一个Run
+    std::vector<sk_sp<SkTypeface>> glyphTypefaces(glyphs.size());
+    const char* src = (const char*)text;
+    const char* stop = src + byteLength;
+    sk_sp<SkTypeface> spFallback;
+    SkGlyphID fallbackGlyph = 0;
+    for (int nIndex = 0; (nIndex < nGlyphCount) && (src < stop); ++nIndex) {
+        SkUnichar uni = NextUnichar(src, stop, textEncoding);
+        if ((glyphs[nIndex] == 0) && GetFallbackGlyph(font.getTypeface(), uni, spFallback, fallbackGlyph)) {
+            glyphs[nIndex] = fallbackGlyph;
+            glyphTypefaces[nIndex] = spFallback;
+        }
+    }
+
+    SkScalar x = 0;
+    int nRunStart = 0;
+    while (nRunStart < nGlyphCount) {
+        int nRunEnd = nRunStart + 1;
+        while ((nRunEnd < nGlyphCount) && (glyphTypefaces[nRunEnd] == glyphTypefaces[nRunStart])) {
+            ++nRunEnd;
+        }
+        SkFont runFont = font;
+        if (glyphTypefaces[nRunStart] != nullptr) {
+            runFont.setTypeface(glyphTypefaces[nRunStart]);
+        }
+        const int nRunCount = nRunEnd - nRunStart;
+        SkTextBlobBuilder::RunBuffer runBuffer = builder.allocRun(runFont, nRunCount, x, 0);
+        ::memcpy(runBuffer.glyphs, glyphs.data() + nRunStart, nRunCount * sizeof(SkGlyphID));
+        x += runFont.measureText(glyphs.data() + nRunStart, nRunCount * sizeof(SkGlyphID), SkTextEncoding::kGlyphID);
+        nRunStart = nRunEnd;
+    }
+    return builder.make();
+}
+
+void SkTextGlyphCache::DrawText(SkCanvas* canvas, const void* text, size_t byteLength, SkTextEncoding textEncoding,
+                                SkScalar x, SkScalar y, const SkFont& font, const SkPaint& paint)
+{
+    if ((canvas == nullptr) || (text == nullptr) || (byteLength == 0)) {
+        return;
+    }
+    const SkTypeface* typeface = font.getTypeface();
+    if (typeface == nullptr) {
+        canvas->drawSimpleText(text, byteLength, textEncoding, x, y, font, paint);
+        return;
+    }
+
+    sk_sp<SkTextBlob> spTextBlob;
+    std::string key;
+    const bool bCacheable = byteLength <= kMaxTextBlobBytes;
+    if (bCacheable) {
+        //Key：字体属性 + 文本编码 + 文本
+        key.reserve(32 + byteLength);
+        AppendKeyData(key, typeface->uniqueID());
+        AppendKeyData(key, font.getSize());
+        AppendKeyData(key, font.getScaleX());
+        AppendKeyData(key, font.getSkewX());
+        AppendKeyData(key, (uint8_t)font.getEdging());
+        AppendKeyData(key, (uint8_t)font.getHinting());
+        uint8_t nFlags = 0;
+        nFlags |= font.isForceAutoHinting() ? 0x01 : 0;
+        nFlags |= font.isEmbeddedBitmaps() ? 0x02 : 0;
+        nFlags |= font.isSubpixel() ? 0x04 : 0;
+        nFlags |= font.isLinearMetrics() ? 0x08 : 0;
+        nFlags |= font.isEmbolden() ? 0x10 : 0;
+        nFlags |= font.isBaselineSnap() ? 0x20 : 0;
+        AppendKeyData(key, nFlags);
+        AppendKeyData(key, (uint8_t)textEncoding);
+        key.append((const char*)text, byteLength);
+
+        std::lock_guard<std::mutex> threadGuard(m_mutex);
+        auto iter = m_textBlobMap.find(key);
+        if (iter != m_textBlobMap.end()) {
+            m_textBlobList.splice(m_textBlobList.begin(), m_textBlobList, iter->second);
+            spTextBlob = iter->second->m_spTextBlob;
+        }
+    }
+    if (spTextBlob == nullptr) {
+        spTextBlob = MakeTextBlob(text, byteLength, textEncoding, font);
+        if (spTextBlob == nullptr) {
+            return;
+        }
+        if (bCacheable) {
+            std::lock_guard<std::mutex> threadGuard(m_mutex);
+            if (m_textBlobMap.find(key) == m_textBlobMap.end()) {
+                m_textBlobList.push_front({ key, spTextBlob });
+                m_textBlobMap[key] = m_textBlobList.begin();
+                if (m_textBlobList.size() > kMaxTextBlobCount) {
+                    //移除最久未使用的
+                    m_textBlobMap.erase(m_textBlobList.back().m_key);
+                    m_textBlobList.pop_back();
+                }
+            }
+        }
+    }
+    canvas->drawTextBlob(spTextBlob, x, y, paint);
+}
+
+} // namespace ui
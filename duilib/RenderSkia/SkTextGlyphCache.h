@@ -0,0 +1,174 @@
+#ifndef UI_RENDER_SKIA_SK_TEXT_GLYPH_CACHE_H_
+#define UI_RENDER_SKIA_SK_TEXT_GLYPH_CACHE_H_
+
+#include "SkiaHeaderBegin.h"
+#include "include/core/SkFont.h"
+#include "include/core/SkFontMgr.h"
+#include "include/core/SkTextBlob.h"
+#include "include/core/SkTypeface.h"
+#include "SkiaHeaderEnd.h"
+
+#include <array>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class SkCanvas;
+class SkPaint;
+
+namespace ui
+{
+
+/** Skia文字绘制的Glyph缓存（进程内唯一），包含：
+*   1. 按字体（SkTypeface）缓存Unicode字符到Glyph的映射，按页（每页256个字符）批量查询；
+*   2. 缓存字体中缺失的字符所使用的回退字体（比如表情符号、生僻字）；
+*   3. 缓存文本转换后的SkTextBlob，相同文本和字体重复绘制时直接复用
+*   所有接口都是线程安全的
+*/
+class SkTextGlyphCache
+{
+public:
+    /** 获取单例对象
+    */
+    static SkTextGlyphCache& Instance();
+
+    SkTextGlyphCache(const SkTextGlyphCache&) = delete;
+    SkTextGlyphCache& operator=(const SkTextGlyphCache&) = delete;
+
+public:
+    /** 设置查询回退字体时使用的字体管理器（为空时不使用回退字体）
+    */
+    void SetFontMgr(const sk_sp<SkFontMgr>& spFontMgr);
+
+    /** 清除所有缓存
+    */
+    void Clear();
+
+    /** 将文本转换为Glyphs，字体中缺失的字符对应的Glyph为0
+    * @param [in] text 文本
+    * @param [in] byteLength 文本的字节数
+    * @param [in] textEncoding 文本编码，支持kUTF8、kUTF16、kUTF32
+    * @param [in] font 字体
+    * @param [out] glyphs 返回转换后的Glyphs，每个Unicode字符对应一个Glyph
+    * @param [out] bHasMissing 返回是否含有字体中缺失的字符
+    * @return 返回Glyph的个数
+    */
+    int TextToGlyphs(const void* text, size_t byteLength, SkTextEncoding textEncoding,
+                     const SkFont& font, std::vector<SkGlyphID>& glyphs, bool& bHasMissing);
+
+    /** 获取字体中缺失字符的回退字体
+    * @param [in] font 字体
+    * @param [in] uni Unicode字符
+    * @return 如果没有可用的回退字体，返回nullptr
+    */
+    sk_sp<SkTypeface> GetFallbackTypeface(const SkFont& font, SkUnichar uni);
+
+    /** 获取Glyphs的宽度，缺失的字符（Glyph为0）按回退字体计算宽度
+    * @param [in] text 文本（与glyphs一一对应，用于查询回退字体）
+    * @param [in] byteLength 文本的字节数
+    * @param [in] textEncoding 文本编码
+    * @param [in] font 字体
+    * @param [in] paint 绘制属性，可以为nullptr
+    * @param [in] glyphs 由TextToGlyphs返回的Glyphs
+    * @param [in] bHasMissing 是否含有缺失的字符（由TextToGlyphs返回）
+    * @param [out] glyphWidths 返回每个Glyph的宽度
+    */
+    void GetGlyphWidths(const void* text, size_t byteLength, SkTextEncoding textEncoding,
+                        const SkFont& font, const SkPaint* paint,
+                        const std::vector<SkGlyphID>& glyphs, bool bHasMissing,
+                        std::vector<SkScalar>& glyphWidths);
+
+    /** 计算文本的宽度（功能与SkFont::measureText相同，但使用Glyph缓存和回退字体）
+    * @param [out] bounds 返回文本的边界，可以为nullptr
+    * @return 返回文本的宽度
+    */
+    SkScalar MeasureText(const void* text, size_t byteLength, SkTextEncoding textEncoding,
+                         const SkFont& font, SkRect* bounds = nullptr, const SkPaint* paint = nullptr);
+
+    /** 绘制文本（功能与SkCanvas::drawSimpleText相同，但使用Glyph缓存、回退字体和SkTextBlob缓存）
+    */
+    void DrawText(SkCanvas* canvas, const void* text, size_t byteLength, SkTextEncoding textEncoding,
+                  SkScalar x, SkScalar y, const SkFont& font, const SkPaint& paint);
+
+private:
+    SkTextGlyphCache();
+    ~SkTextGlyphCache();
+
+    /** 一页Glyph数据（256个连续的Unicode字符）
+    */
+    typedef std::array<SkGlyphID, 256> GlyphPage;
+
+    /** 一个字体的Glyph数据，按页索引
+    */
+    struct TypefaceGlyphs
+    {
+        std::vector<std::unique_ptr<GlyphPage>> m_pages;
+    };
+
+    /** 一个缓存的SkTextBlob
+    */
+    struct TextBlobItem
+    {
+        std::string m_key;              //缓存的Key（字体属性 + 文本）
+        sk_sp<SkTextBlob> m_spTextBlob; //文本的SkTextBlob，原点为(0, 0)
+    };
+
+    /** 查询一个字符的Glyph，首次访问某页时批量查询整页（调用方需加锁）
+    */
+    SkGlyphID UnicharToGlyph(TypefaceGlyphs& typefaceGlyphs, const SkTypeface* typeface, SkUnichar uni);
+
+    /** 查询回退字体（调用方需加锁）
+    */
+    sk_sp<SkTypeface> FindFallbackTypeface(const SkTypeface* typeface, SkUnichar uni);
+
+    /** 查询字体中缺失字符的回退字体和对应的Glyph
+    * @return 如果没有可用的回退字体，返回false
+    */
+    bool GetFallbackGlyph(const SkTypeface* typeface, SkUnichar uni,
+                          sk_sp<SkTypeface>& spFallback, SkGlyphID& glyph);
+
+    /** 获取Glyphs的宽度和边界，缺失的字符按回退字体计算
+    */
+    void GetGlyphWidthsBounds(const void* text, size_t byteLength, SkTextEncoding textEncoding,
+                              const SkFont& font, const SkPaint* paint,
+                              const std::vector<SkGlyphID>& glyphs, bool bHasMissing,
+                              std::vector<SkScalar>& glyphWidths,
+                              std::vector<SkRect>* glyphBounds);
+
+    /** 生成SkTextBlob，缺失的字符使用回退字体，分成多个Run
+    */
+    sk_sp<SkTextBlob> MakeTextBlob(const void* text, size_t byteLength, SkTextEncoding textEncoding,
+                                   const SkFont& font);
+
+private:
+    /** 多线程同步锁
+    */
+    std::mutex m_mutex;
+
+    /** 字体管理器
+    */
+    sk_sp<SkFontMgr> m_spFontMgr;
+
+    /** 每个字体的Glyph数据，Key是SkTypeface::uniqueID()
+    */
+    std::unordered_map<uint32_t, TypefaceGlyphs> m_typefaceGlyphs;
+
+    /** 回退字体缓存，Key是SkTypeface::uniqueID()和Unicode字符的组合，Value为nullptr表示没有可用的回退字体
+    */
+    std::unordered_map<uint64_t, sk_sp<SkTypeface>> m_fallbackTypefaces;
+
+    /** SkTextBlob缓存（最近使用的放在最前面）
+    */
+    std::list<TextBlobItem> m_textBlobList;
+
+    /** SkTextBlob缓存的索引
+    */
+    std::unordered_map<std::string, std::list<TextBlobItem>::iterator> m_textBlobMap;
+};
+
+} // namespace ui
+
+#endif // UI_RENDER_SKIA_SK_TEXT_GLYPH_CACHE_H_
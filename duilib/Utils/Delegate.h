@@ -6,11 +6,244 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <array>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 
-namespace ui 
+namespace ui
 {
 
-typedef std::function<bool(const ui::EventArgs&)> EventCallback;
+/** 事件回调函数，函数原型：bool FunctionName(const ui::EventArgs&);
+*   使用方法与 std::function<bool(const ui::EventArgs&)> 相同
+*   小对象优化：函数对象的大小不超过内部缓冲区（kInlineSize）时，直接存储在对象内部，不分配堆内存
+*   （比如lambda捕获少量变量、UiBind绑定成员函数等常见用法），复制回调函数时也不需要分配堆内存
+*/
+class EventCallback
+{
+public:
+    EventCallback() noexcept:
+        m_pOps(nullptr)
+    {
+    }
+
+    EventCallback(std::nullptr_t) noexcept:
+        m_pOps(nullptr)
+    {
+    }
+
+    template<typename TFunc,
+             typename TDecay = typename std::decay<TFunc>::type,
+             typename = typename std::enable_if<!std::is_same<TDecay, EventCallback>::value &&
+                                                std::is_invocable_r<bool, TDecay&, const EventArgs&>::value>::type>
+    EventCallback(TFunc&& func):
+        m_pOps(nullptr)
+    {
+        if (IsNullFunc(func)) {
+            return;
+        }
+        if constexpr (IsInlineType<TDecay>()) {
+            ::new ((void*)m_buffer) TDecay(std::forward<TFunc>(func));
+            m_pOps = &InlineOps<TDecay>::s_ops;
+        }
+        else {
+            *reinterpret_cast<TDecay**>(m_buffer) = new TDecay(std::forward<TFunc>(func));
+            m_pOps = &HeapOps<TDecay>::s_ops;
+        }
+    }
+
+    EventCallback(const EventCallback& r):
+        m_pOps(nullptr)
+    {
+        if (r.m_pOps != nullptr) {
+            r.m_pOps->m_pfnCopy(m_buffer, r.m_buffer);
+            m_pOps = r.m_pOps;
+        }
+    }
+
+    EventCallback(EventCallback&& r) noexcept:
+        m_pOps(nullptr)
+    {
+        MoveFrom(r);
+    }
+
+    ~EventCallback()
+    {
+        Reset();
+    }
+
+    EventCallback& operator = (const EventCallback& r)
+    {
+        if (this != &r) {
+            EventCallback temp(r);
+            Reset();
+            MoveFrom(temp);
+        }
+        return *this;
+    }
+
+    EventCallback& operator = (EventCallback&& r) noexcept
+    {
+        if (this != &r) {
+            Reset();
+            MoveFrom(r);
+        }
+        return *this;
+    }
+
+    EventCallback& operator = (std::nullptr_t) noexcept
+    {
+        Reset();
+        return *this;
+    }
+
+    /** 调用回调函数（回调函数为空时返回false）
+    */
+    bool operator() (const EventArgs& param) const
+    {
+        ASSERT(m_pOps != nullptr);
+        if (m_pOps == nullptr) {
+            return false;
+        }
+        return m_pOps->m_pfnInvoke(m_buffer, param);
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return m_pOps != nullptr;
+    }
+
+    bool operator == (std::nullptr_t) const noexcept
+    {
+        return m_pOps == nullptr;
+    }
+
+public:
+    /** 内部缓冲区的大小（可存储6个指针大小的函数对象）
+    */
+    static constexpr size_t kInlineSize = 6 * sizeof(void*);
+
+private:
+    /** 函数对象的操作函数表
+    */
+    struct FuncOps
+    {
+        bool (*m_pfnInvoke)(const void* pBuffer, const EventArgs& param);
+        void (*m_pfnCopy)(void* pDestBuffer, const void* pSrcBuffer);
+        void (*m_pfnMove)(void* pDestBuffer, void* pSrcBuffer) noexcept;
+        void (*m_pfnDestroy)(void* pBuffer) noexcept;
+    };
+
+    /** 函数对象存储在内部缓冲区中
+    */
+    template<typename TFunc>
+    struct InlineOps
+    {
+        static bool Invoke(const void* pBuffer, const EventArgs& param)
+        {
+            TFunc& func = *const_cast<TFunc*>(static_cast<const TFunc*>(pBuffer));
+            return static_cast<bool>(std::invoke(func, param));
+        }
+        static void Copy(void* pDestBuffer, const void* pSrcBuffer)
+        {
+            ::new (pDestBuffer) TFunc(*static_cast<const TFunc*>(pSrcBuffer));
+        }
+        static void Move(void* pDestBuffer, void* pSrcBuffer) noexcept
+        {
+            TFunc* pSrc = static_cast<TFunc*>(pSrcBuffer);
+            ::new (pDestBuffer) TFunc(std::move(*pSrc));
+            pSrc->~TFunc();
+        }
+        static void Destroy(void* pBuffer) noexcept
+        {
+            static_cast<TFunc*>(pBuffer)->~TFunc();
+        }
+        static constexpr FuncOps s_ops = { &Invoke, &Copy, &Move, &Destroy };
+    };
+
+    /** 函数对象较大，存储在堆内存中（内部缓冲区中存储指针）
+    */
+    template<typename TFunc>
+    struct HeapOps
+    {
+        static bool Invoke(const void* pBuffer, const EventArgs& param)
+        {
+            TFunc& func = **static_cast<TFunc* const*>(pBuffer);
+            return static_cast<bool>(std::invoke(func, param));
+        }
+        static void Copy(void* pDestBuffer, const void* pSrcBuffer)
+        {
+            *static_cast<TFunc**>(pDestBuffer) = new TFunc(**static_cast<TFunc* const*>(pSrcBuffer));
+        }
+        static void Move(void* pDestBuffer, void* pSrcBuffer) noexcept
+        {
+            *static_cast<TFunc**>(pDestBuffer) = *static_cast<TFunc**>(pSrcBuffer);
+            *static_cast<TFunc**>(pSrcBuffer) = nullptr;
+        }
+        static void Destroy(void* pBuffer) noexcept
+        {
+            delete *static_cast<TFunc**>(pBuffer);
+        }
+        static constexpr FuncOps s_ops = { &Invoke, &Copy, &Move, &Destroy };
+    };
+
+    /** 判断函数对象是否可以存储在内部缓冲区中
+    */
+    template<typename TFunc>
+    static constexpr bool IsInlineType()
+    {
+        return (sizeof(TFunc) <= kInlineSize) &&
+               (alignof(TFunc) <= alignof(std::max_align_t)) &&
+               std::is_nothrow_move_constructible<TFunc>::value;
+    }
+
+    /** 判断函数对象是否为空（空的函数指针、空的std::function等）
+    */
+    template<typename TFunc>
+    static bool IsNullFunc(const TFunc& func)
+    {
+        if constexpr (std::is_pointer<TFunc>::value || std::is_member_pointer<TFunc>::value) {
+            return func == nullptr;
+        }
+        else if constexpr (IsStdFunction<TFunc>::value) {
+            return func == nullptr;
+        }
+        else {
+            return false;
+        }
+    }
+
+    template<typename T> struct IsStdFunction: std::false_type {};
+    template<typename T> struct IsStdFunction<std::function<T>>: std::true_type {};
+
+    void MoveFrom(EventCallback& r) noexcept
+    {
+        if (r.m_pOps != nullptr) {
+            r.m_pOps->m_pfnMove(m_buffer, r.m_buffer);
+            m_pOps = r.m_pOps;
+            r.m_pOps = nullptr;
+        }
+    }
+
+    void Reset() noexcept
+    {
+        if (m_pOps != nullptr) {
+            const FuncOps* pOps = m_pOps;
+            m_pOps = nullptr;
+            pOps->m_pfnDestroy(m_buffer);
+        }
+    }
+
+private:
+    /** 函数对象的存储空间
+    */
+    alignas(std::max_align_t) unsigned char m_buffer[kInlineSize];
+
+    /** 函数对象的操作函数表，为nullptr表示回调函数为空
+    */
+    const FuncOps* m_pOps;
+};
 
 class CEventSource : public std::vector<EventCallback>
 {
@@ -20,7 +253,7 @@ public:
         ASSERT(callback != nullptr);
         if (callback != nullptr) {
             push_back(callback);
-        }        
+        }
         return *this;
     }
 
@@ -41,7 +274,101 @@ public:
 
 };
 
-typedef std::map<EventType, CEventSource> EventMap;
+/** 事件类型与回调函数容器的映射表
+*   按事件类型直接索引（平坦表），查找的时间复杂度为O(1)，没有注册回调函数的事件类型只占用1个字节
+*   已创建的回调函数容器在映射表的生命周期内地址不变，支持在回调函数中添加或者移除事件
+*/
+class EventMap
+{
+public:
+    EventMap()
+    {
+        m_eventIndex.fill(0);
+    }
+    EventMap(const EventMap&) = delete;
+    EventMap& operator = (const EventMap&) = delete;
+
+public:
+    /** 获取事件类型对应的回调函数容器，如果不存在则创建
+    */
+    CEventSource& operator[] (EventType eventType)
+    {
+        ASSERT((eventType >= 0) && (eventType < kEventLast));
+        uint8_t& nIndex = m_eventIndex[(size_t)eventType];
+        if (nIndex == 0) {
+            m_eventSources.push_back(std::make_unique<CEventSource>());
+            nIndex = (uint8_t)m_eventSources.size();
+        }
+        return *m_eventSources[nIndex - 1];
+    }
+
+    /** 查找事件类型对应的回调函数容器
+    * @return 如果该事件类型没有注册回调函数，返回nullptr
+    */
+    const CEventSource* Find(EventType eventType) const
+    {
+        if ((eventType < 0) || (eventType >= kEventLast)) {
+            return nullptr;
+        }
+        const uint8_t nIndex = m_eventIndex[(size_t)eventType];
+        if (nIndex == 0) {
+            return nullptr;
+        }
+        const CEventSource* pEventSource = m_eventSources[nIndex - 1].get();
+        return pEventSource->empty() ? nullptr : pEventSource;
+    }
+
+    /** 该事件类型是否注册了回调函数
+    */
+    bool HasEvent(EventType eventType) const
+    {
+        return Find(eventType) != nullptr;
+    }
+
+    /** 该事件类型或者kEventAll是否注册了回调函数（派发事件的快速判断）
+    */
+    bool HasEventOrAll(EventType eventType) const
+    {
+        return (Find(eventType) != nullptr) || (Find(kEventAll) != nullptr);
+    }
+
+    /** 移除事件类型对应的所有回调函数
+    *   （只清空回调函数容器，不释放容器，避免正在执行的回调函数中移除事件时访问已释放的内存）
+    */
+    void Remove(EventType eventType)
+    {
+        if ((eventType < 0) || (eventType >= kEventLast)) {
+            return;
+        }
+        const uint8_t nIndex = m_eventIndex[(size_t)eventType];
+        if (nIndex != 0) {
+            m_eventSources[nIndex - 1]->clear();
+        }
+    }
+
+    /** 是否没有注册任何回调函数
+    */
+    bool IsEmpty() const
+    {
+        for (const std::unique_ptr<CEventSource>& pEventSource : m_eventSources) {
+            if (!pEventSource->empty()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    static_assert(kEventLast < UINT8_MAX, "EventType value is out of range!");
+
+    /** 事件类型到回调函数容器的索引（值为容器下标加1，为0表示未创建）
+    */
+    std::array<uint8_t, (size_t)kEventLast> m_eventIndex;
+
+    /** 回调函数容器
+    */
+    std::vector<std::unique_ptr<CEventSource>> m_eventSources;
+};
 
 }
 
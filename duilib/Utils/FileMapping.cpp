@@ -0,0 +1,119 @@
+#include "FileMapping.h"
+
+#ifndef DUILIB_BUILD_FOR_WIN
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace ui
+{
+
+FileMapping::FileMapping():
+    m_pData(nullptr),
+    m_nSize(0)
+#ifdef DUILIB_BUILD_FOR_WIN
+    ,m_hMapping(nullptr)
+#endif
+{
+}
+
+FileMapping::~FileMapping()
+{
+    Close();
+}
+
+bool FileMapping::Open(const FilePath& filePath)
+{
+    Close();
+#ifdef DUILIB_BUILD_FOR_WIN
+    //Windows平台
+    #ifdef DUILIB_UNICODE
+        HANDLE hFile = ::CreateFileW(filePath.NativePath().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                     OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    #else
+        HANDLE hFile = ::CreateFileA(filePath.NativePath().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                     OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    #endif
+    if (hFile == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER fileSize = { 0, };
+    if (!::GetFileSizeEx(hFile, &fileSize) || (fileSize.QuadPart <= 0) ||
+        ((uint64_t)fileSize.QuadPart > (uint64_t)SIZE_MAX)) {
+        ::CloseHandle(hFile);
+        return false;
+    }
+    //映射对象创建后，文件句柄可以立即关闭
+    HANDLE hMapping = ::CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    ::CloseHandle(hFile);
+    if (hMapping == nullptr) {
+        return false;
+    }
+    void* pData = ::MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+    if (pData == nullptr) {
+        ::CloseHandle(hMapping);
+        return false;
+    }
+    m_hMapping = hMapping;
+    m_pData = (const uint8_t*)pData;
+    m_nSize = (size_t)fileSize.QuadPart;
+#else
+    //Linux/macOS/FreeBSD平台
+    int fd = ::open(filePath.NativePath().c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat fileStat;
+    if ((::fstat(fd, &fileStat) != 0) || (fileStat.st_size <= 0)) {
+        ::close(fd);
+        return false;
+    }
+    //映射完成后，文件描述符可以立即关闭
+    void* pData = ::mmap(nullptr, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (pData == MAP_FAILED) {
+        return false;
+    }
+    m_pData = (const uint8_t*)pData;
+    m_nSize = (size_t)fileStat.st_size;
+#endif
+    return true;
+}
+
+void FileMapping::Close()
+{
+#ifdef DUILIB_BUILD_FOR_WIN
+    if (m_pData != nullptr) {
+        ::UnmapViewOfFile(m_pData);
+    }
+    if (m_hMapping != nullptr) {
+        ::CloseHandle(m_hMapping);
+        m_hMapping = nullptr;
+    }
+#else
+    if (m_pData != nullptr) {
+        ::munmap((void*)m_pData, m_nSize);
+    }
+#endif
+    m_pData = nullptr;
+    m_nSize = 0;
+}
+
+bool FileMapping::IsValid() const
+{
+    return m_pData != nullptr;
+}
+
+const uint8_t* FileMapping::GetData() const
+{
+    return m_pData;
+}
+
+size_t FileMapping::GetSize() const
+{
+    return m_nSize;
+}
+
+}
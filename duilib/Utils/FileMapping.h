@@ -0,0 +1,60 @@
+#ifndef UI_UTILS_FILE_MAPPING_H_
+#define UI_UTILS_FILE_MAPPING_H_
+
+#include "duilib/Utils/FilePath.h"
+
+namespace ui
+{
+
+/** 只读的内存映射文件（文件内容按需由系统分页加载，不需要读取和复制整个文件）
+*/
+class UILIB_API FileMapping
+{
+public:
+    FileMapping();
+    ~FileMapping();
+    FileMapping(const FileMapping&) = delete;
+    FileMapping& operator = (const FileMapping&) = delete;
+
+public:
+    /** 以只读方式映射文件
+    * @param [in] filePath 本地文件路径(绝对路径)
+    * @return 成功返回true；如果文件不存在、文件为空或者映射失败，返回false
+    */
+    bool Open(const FilePath& filePath);
+
+    /** 关闭映射
+    */
+    void Close();
+
+    /** 是否已经映射
+    */
+    bool IsValid() const;
+
+    /** 获取文件数据
+    */
+    const uint8_t* GetData() const;
+
+    /** 获取文件数据的长度
+    */
+    size_t GetSize() const;
+
+private:
+    /** 文件数据
+    */
+    const uint8_t* m_pData;
+
+    /** 文件数据的长度
+    */
+    size_t m_nSize;
+
+#ifdef DUILIB_BUILD_FOR_WIN
+    /** 文件映射对象的句柄
+    */
+    HANDLE m_hMapping;
+#endif
+};
+
+}
+
+#endif // UI_UTILS_FILE_MAPPING_H_
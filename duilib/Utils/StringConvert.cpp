@@ -1,42 +1,556 @@
 #include "StringConvert.h"
-#include "duilib/third_party/convert_utf/ConvertUTF.h"
-#include <vector>
 
-using namespace llvm; //for ConvertUTF.h
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    //x86/x64：SSE2
+    #define DUILIB_UTF_SSE2 1
+    #include <emmintrin.h>
+#elif defined(_M_ARM64) || defined(__aarch64__)
+    //ARM64：NEON
+    #define DUILIB_UTF_NEON 1
+    #include <arm_neon.h>
+#endif
 
 namespace ui
 {
+static_assert(sizeof(DUTF8Char) == sizeof(uint8_t), "DUTF8Char must be 8 bits");
+static_assert(sizeof(DUTF16Char) == sizeof(uint16_t), "DUTF16Char must be 16 bits");
+static_assert(sizeof(DUTF32Char) == sizeof(uint32_t), "DUTF32Char must be 32 bits");
 
-std::basic_string<DUTF16Char> StringConvert::UTF8ToUTF16(const DUTF8Char* utf8, size_t length)
+/** 替换字符（无法表示的字符用该字符替换）
+*/
+static constexpr uint32_t kReplacementChar = 0xFFFD;
+
+/** 最大的Unicode字符
+*/
+static constexpr uint32_t kMaxUnicodeChar = 0x10FFFF;
+
+/** UTF8：计算开头连续的ASCII字符个数
+*/
+static size_t AsciiPrefixUTF8(const uint8_t* src, size_t length)
 {
-    if ((utf8 == nullptr) || (length == 0)) {
-        return std::basic_string<DUTF16Char>();
+    size_t i = 0;
+#if defined(DUILIB_UTF_SSE2)
+    for (; i + 16 <= length; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        if (_mm_movemask_epi8(v) != 0) {
+            break;
+        }
     }
-    std::vector<DUTF16Char> data;
-    data.resize(8192);
-    DUTF16Char* output = &data[0];
-    const UTF8* src_begin = reinterpret_cast<const UTF8*>(utf8);
-    const UTF8* src_end = src_begin + length;
-    UTF16* dst_begin = reinterpret_cast<UTF16*>(output);
+#elif defined(DUILIB_UTF_NEON)
+    for (; i + 16 <= length; i += 16) {
+        if (vmaxvq_u8(vld1q_u8(src + i)) >= 0x80) {
+            break;
+        }
+    }
+#endif
+    while ((i < length) && (src[i] < 0x80)) {
+        ++i;
+    }
+    return i;
+}
 
-    std::basic_string<DUTF16Char> utf16;
-    while (src_begin < src_end) {
-        ConversionResult result = ConvertUTF8toUTF16(&src_begin,
-                                                     src_end,
-                                                     &dst_begin,
-                                                     dst_begin + data.size(),
-                                                     lenientConversion);
-        utf16.append((const DUTF16Char*)output, dst_begin - reinterpret_cast<UTF16*>(output));
-        dst_begin = reinterpret_cast<UTF16*>(output);
-        if (result == sourceIllegal || result == sourceExhausted)
-        {
-            utf16.clear();
+/** UTF16：计算开头连续的ASCII字符个数
+*/
+static size_t AsciiPrefixUTF16(const uint16_t* src, size_t length)
+{
+    size_t i = 0;
+#if defined(DUILIB_UTF_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i mask = _mm_set1_epi16((short)0xFF80);
+    for (; i + 16 <= length; i += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(src + i + 8));
+        __m128i v = _mm_and_si128(_mm_or_si128(a, b), mask);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(v, zero)) != 0xFFFF) {
+            break;
+        }
+    }
+#elif defined(DUILIB_UTF_NEON)
+    for (; i + 16 <= length; i += 16) {
+        uint16x8_t v = vorrq_u16(vld1q_u16(src + i), vld1q_u16(src + i + 8));
+        if (vmaxvq_u16(v) >= 0x80) {
+            break;
+        }
+    }
+#endif
+    while ((i < length) && (src[i] < 0x80)) {
+        ++i;
+    }
+    return i;
+}
+
+/** 转换开头连续的ASCII字符：UTF8 -> UTF16
+* @return 返回转换的字符个数
+*/
+static size_t AsciiUTF8ToUTF16(const uint8_t* src, size_t length, uint16_t* dst)
+{
+    size_t i = 0;
+#if defined(DUILIB_UTF_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= length; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        if (_mm_movemask_epi8(v) != 0) {
+            break;
+        }
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_unpacklo_epi8(v, zero));
+        _mm_storeu_si128((__m128i*)(dst + i + 8), _mm_unpackhi_epi8(v, zero));
+    }
+#elif defined(DUILIB_UTF_NEON)
+    for (; i + 16 <= length; i += 16) {
+        uint8x16_t v = vld1q_u8(src + i);
+        if (vmaxvq_u8(v) >= 0x80) {
+            break;
+        }
+        vst1q_u16(dst + i, vmovl_u8(vget_low_u8(v)));
+        vst1q_u16(dst + i + 8, vmovl_u8(vget_high_u8(v)));
+    }
+#endif
+    for (; (i < length) && (src[i] < 0x80); ++i) {
+        dst[i] = src[i];
+    }
+    return i;
+}
+
+/** 转换开头连续的ASCII字符：UTF8 -> UTF32
+* @return 返回转换的字符个数
+*/
+static size_t AsciiUTF8ToUTF32(const uint8_t* src, size_t length, uint32_t* dst)
+{
+    size_t i = 0;
+#if defined(DUILIB_UTF_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= length; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        if (_mm_movemask_epi8(v) != 0) {
+            break;
+        }
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_unpacklo_epi16(lo, zero));
+        _mm_storeu_si128((__m128i*)(dst + i + 4), _mm_unpackhi_epi16(lo, zero));
+        _mm_storeu_si128((__m128i*)(dst + i + 8), _mm_unpacklo_epi16(hi, zero));
+        _mm_storeu_si128((__m128i*)(dst + i + 12), _mm_unpackhi_epi16(hi, zero));
+    }
+#elif defined(DUILIB_UTF_NEON)
+    for (; i + 16 <= length; i += 16) {
+        uint8x16_t v = vld1q_u8(src + i);
+        if (vmaxvq_u8(v) >= 0x80) {
             break;
         }
+        uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+        uint16x8_t hi = vmovl_u8(vget_high_u8(v));
+        vst1q_u32(dst + i, vmovl_u16(vget_low_u16(lo)));
+        vst1q_u32(dst + i + 4, vmovl_u16(vget_high_u16(lo)));
+        vst1q_u32(dst + i + 8, vmovl_u16(vget_low_u16(hi)));
+        vst1q_u32(dst + i + 12, vmovl_u16(vget_high_u16(hi)));
+    }
+#endif
+    for (; (i < length) && (src[i] < 0x80); ++i) {
+        dst[i] = src[i];
+    }
+    return i;
+}
+
+/** 转换开头连续的ASCII字符：UTF16 -> UTF8
+* @return 返回转换的字符个数
+*/
+static size_t AsciiUTF16ToUTF8(const uint16_t* src, size_t length, uint8_t* dst)
+{
+    size_t i = 0;
+#if defined(DUILIB_UTF_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i mask = _mm_set1_epi16((short)0xFF80);
+    for (; i + 16 <= length; i += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(src + i + 8));
+        __m128i v = _mm_and_si128(_mm_or_si128(a, b), mask);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(v, zero)) != 0xFFFF) {
+            break;
+        }
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(a, b));
+    }
+#elif defined(DUILIB_UTF_NEON)
+    for (; i + 16 <= length; i += 16) {
+        uint16x8_t a = vld1q_u16(src + i);
+        uint16x8_t b = vld1q_u16(src + i + 8);
+        if (vmaxvq_u16(vorrq_u16(a, b)) >= 0x80) {
+            break;
+        }
+        vst1q_u8(dst + i, vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+    }
+#endif
+    for (; (i < length) && (src[i] < 0x80); ++i) {
+        dst[i] = (uint8_t)src[i];
+    }
+    return i;
+}
+
+/** 解码一个UTF8字符（按Unicode标准严格校验：不允许超长编码、代理项和超出范围的字符）
+* @return 返回该字符占的字节数，如果编码无效返回0
+*/
+static inline size_t DecodeUTF8(const uint8_t* src, size_t length, uint32_t& ch)
+{
+    const uint32_t c = src[0];
+    if (c < 0x80) {
+        ch = c;
+        return 1;
+    }
+    if (c < 0xC2) {
+        return 0;
+    }
+    if (c < 0xE0) {
+        if ((length < 2) || ((src[1] & 0xC0) != 0x80)) {
+            return 0;
+        }
+        ch = ((c & 0x1F) << 6) | (src[1] & 0x3F);
+        return 2;
+    }
+    if (c < 0xF0) {
+        if ((length < 3) || ((src[1] & 0xC0) != 0x80) || ((src[2] & 0xC0) != 0x80)) {
+            return 0;
+        }
+        if (((c == 0xE0) && (src[1] < 0xA0)) || ((c == 0xED) && (src[1] > 0x9F))) {
+            return 0;
+        }
+        ch = ((c & 0x0F) << 12) | ((src[1] & 0x3F) << 6) | (src[2] & 0x3F);
+        return 3;
+    }
+    if (c < 0xF5) {
+        if ((length < 4) || ((src[1] & 0xC0) != 0x80) || ((src[2] & 0xC0) != 0x80) || ((src[3] & 0xC0) != 0x80)) {
+            return 0;
+        }
+        if (((c == 0xF0) && (src[1] < 0x90)) || ((c == 0xF4) && (src[1] > 0x8F))) {
+            return 0;
+        }
+        ch = ((c & 0x07) << 18) | ((src[1] & 0x3F) << 12) | ((src[2] & 0x3F) << 6) | (src[3] & 0x3F);
+        return 4;
+    }
+    return 0;
+}
+
+/** 解码一个UTF16字符，未配对的代理项原样保留
+* @return 返回该字符占的字符数，如果末尾是不完整的代理对返回0
+*/
+static inline size_t DecodeUTF16(const uint16_t* src, size_t length, uint32_t& ch)
+{
+    const uint32_t c = src[0];
+    if ((c >= 0xD800) && (c <= 0xDBFF)) {
+        if (length < 2) {
+            return 0;
+        }
+        const uint32_t c2 = src[1];
+        if ((c2 >= 0xDC00) && (c2 <= 0xDFFF)) {
+            ch = ((c - 0xD800) << 10) + (c2 - 0xDC00) + 0x10000;
+            return 2;
+        }
+    }
+    ch = c;
+    return 1;
+}
+
+/** 获取字符的UTF8编码字节数
+*/
+static inline size_t GetUTF8Bytes(uint32_t ch)
+{
+    if (ch < 0x80) {
+        return 1;
+    }
+    else if (ch < 0x800) {
+        return 2;
+    }
+    else if (ch < 0x10000) {
+        return 3;
+    }
+    return 4;
+}
+
+/** 将字符编码为UTF8
+* @return 返回写入的字节数
+*/
+static inline size_t EncodeUTF8(uint32_t ch, uint8_t* dst)
+{
+    if (ch < 0x80) {
+        dst[0] = (uint8_t)ch;
+        return 1;
+    }
+    else if (ch < 0x800) {
+        dst[0] = (uint8_t)(0xC0 | (ch >> 6));
+        dst[1] = (uint8_t)(0x80 | (ch & 0x3F));
+        return 2;
+    }
+    else if (ch < 0x10000) {
+        dst[0] = (uint8_t)(0xE0 | (ch >> 12));
+        dst[1] = (uint8_t)(0x80 | ((ch >> 6) & 0x3F));
+        dst[2] = (uint8_t)(0x80 | (ch & 0x3F));
+        return 3;
+    }
+    dst[0] = (uint8_t)(0xF0 | (ch >> 18));
+    dst[1] = (uint8_t)(0x80 | ((ch >> 12) & 0x3F));
+    dst[2] = (uint8_t)(0x80 | ((ch >> 6) & 0x3F));
+    dst[3] = (uint8_t)(0x80 | (ch & 0x3F));
+    return 4;
+}
+
+/** 将字符编码为UTF16（代理项和超出范围的字符用替换字符代替）
+* @return 返回写入的字符数
+*/
+static inline size_t EncodeUTF16(uint32_t ch, uint16_t* dst)
+{
+    if (ch < 0x10000) {
+        dst[0] = ((ch >= 0xD800) && (ch <= 0xDFFF)) ? (uint16_t)kReplacementChar : (uint16_t)ch;
+        return 1;
+    }
+    else if (ch > kMaxUnicodeChar) {
+        dst[0] = (uint16_t)kReplacementChar;
+        return 1;
+    }
+    ch -= 0x10000;
+    dst[0] = (uint16_t)(0xD800 + (ch >> 10));
+    dst[1] = (uint16_t)(0xDC00 + (ch & 0x3FF));
+    return 2;
+}
+
+/** 计算UTF8转换为UTF16后的字符数（同时校验编码）
+*/
+static bool CalcUTF8ToUTF16Length(const uint8_t* src, size_t length, size_t& outputLength)
+{
+    size_t nCount = 0;
+    size_t i = 0;
+    uint32_t ch = 0;
+    while (i < length) {
+        if (src[i] < 0x80) {
+            const size_t n = AsciiPrefixUTF8(src + i, length - i);
+            i += n;
+            nCount += n;
+            continue;
+        }
+        const size_t n = DecodeUTF8(src + i, length - i, ch);
+        if (n == 0) {
+            return false;
+        }
+        i += n;
+        nCount += (ch >= 0x10000) ? 2 : 1;
+    }
+    outputLength = nCount;
+    return true;
+}
+
+/** UTF8转换为UTF16（输入必须已经校验，输出缓冲区大小由CalcUTF8ToUTF16Length计算）
+*/
+static void WriteUTF8ToUTF16(const uint8_t* src, size_t length, uint16_t* dst)
+{
+    size_t i = 0;
+    uint32_t ch = 0;
+    while (i < length) {
+        if (src[i] < 0x80) {
+            const size_t n = AsciiUTF8ToUTF16(src + i, length - i, dst);
+            i += n;
+            dst += n;
+            continue;
+        }
+        i += DecodeUTF8(src + i, length - i, ch);
+        dst += EncodeUTF16(ch, dst);
+    }
+}
+
+/** 计算UTF8转换为UTF32后的字符数（同时校验编码）
+*/
+static bool CalcUTF8ToUTF32Length(const uint8_t* src, size_t length, size_t& outputLength)
+{
+    size_t nCount = 0;
+    size_t i = 0;
+    uint32_t ch = 0;
+    while (i < length) {
+        if (src[i] < 0x80) {
+            const size_t n = AsciiPrefixUTF8(src + i, length - i);
+            i += n;
+            nCount += n;
+            continue;
+        }
+        const size_t n = DecodeUTF8(src + i, length - i, ch);
+        if (n == 0) {
+            return false;
+        }
+        i += n;
+        ++nCount;
+    }
+    outputLength = nCount;
+    return true;
+}
+
+/** UTF8转换为UTF32（输入必须已经校验）
+*/
+static void WriteUTF8ToUTF32(const uint8_t* src, size_t length, uint32_t* dst)
+{
+    size_t i = 0;
+    while (i < length) {
+        if (src[i] < 0x80) {
+            const size_t n = AsciiUTF8ToUTF32(src + i, length - i, dst);
+            i += n;
+            dst += n;
+            continue;
+        }
+        i += DecodeUTF8(src + i, length - i, *dst);
+        ++dst;
+    }
+}
+
+/** 计算UTF16转换为UTF8后的字节数（同时校验编码）
+*/
+static bool CalcUTF16ToUTF8Length(const uint16_t* src, size_t length, size_t& outputLength)
+{
+    size_t nCount = 0;
+    size_t i = 0;
+    uint32_t ch = 0;
+    while (i < length) {
+        if (src[i] < 0x80) {
+            const size_t n = AsciiPrefixUTF16(src + i, length - i);
+            i += n;
+            nCount += n;
+            continue;
+        }
+        const size_t n = DecodeUTF16(src + i, length - i, ch);
+        if (n == 0) {
+            return false;
+        }
+        i += n;
+        nCount += GetUTF8Bytes(ch);
+    }
+    outputLength = nCount;
+    return true;
+}
+
+/** UTF16转换为UTF8（输入必须已经校验）
+*/
+static void WriteUTF16ToUTF8(const uint16_t* src, size_t length, uint8_t* dst)
+{
+    size_t i = 0;
+    uint32_t ch = 0;
+    while (i < length) {
+        if (src[i] < 0x80) {
+            const size_t n = AsciiUTF16ToUTF8(src + i, length - i, dst);
+            i += n;
+            dst += n;
+            continue;
+        }
+        i += DecodeUTF16(src + i, length - i, ch);
+        dst += EncodeUTF8(ch, dst);
+    }
+}
+
+/** 计算UTF16转换为UTF32后的字符数（同时校验编码）
+*/
+static bool CalcUTF16ToUTF32Length(const uint16_t* src, size_t length, size_t& outputLength)
+{
+    size_t nCount = 0;
+    size_t i = 0;
+    uint32_t ch = 0;
+    while (i < length) {
+        if (src[i] < 0x80) {
+            const size_t n = AsciiPrefixUTF16(src + i, length - i);
+            i += n;
+            nCount += n;
+            continue;
+        }
+        const size_t n = DecodeUTF16(src + i, length - i, ch);
+        if (n == 0) {
+            return false;
+        }
+        i += n;
+        ++nCount;
+    }
+    outputLength = nCount;
+    return true;
+}
+
+/** UTF16转换为UTF32（输入必须已经校验）
+*/
+static void WriteUTF16ToUTF32(const uint16_t* src, size_t length, uint32_t* dst)
+{
+    size_t i = 0;
+    while (i < length) {
+        i += DecodeUTF16(src + i, length - i, *dst);
+        ++dst;
+    }
+}
+
+/** 计算UTF32转换为UTF8后的字节数（同时校验编码）
+*/
+static bool CalcUTF32ToUTF8Length(const uint32_t* src, size_t length, size_t& outputLength)
+{
+    size_t nCount = 0;
+    for (size_t i = 0; i < length; ++i) {
+        if (src[i] > kMaxUnicodeChar) {
+            return false;
+        }
+        nCount += GetUTF8Bytes(src[i]);
+    }
+    outputLength = nCount;
+    return true;
+}
+
+/** UTF32转换为UTF8（输入必须已经校验）
+*/
+static void WriteUTF32ToUTF8(const uint32_t* src, size_t length, uint8_t* dst)
+{
+    for (size_t i = 0; i < length; ++i) {
+        dst += EncodeUTF8(src[i], dst);
+    }
+}
+
+/** 计算UTF32转换为UTF16后的字符数
+*/
+static size_t CalcUTF32ToUTF16Length(const uint32_t* src, size_t length)
+{
+    size_t nCount = length;
+    for (size_t i = 0; i < length; ++i) {
+        if ((src[i] >= 0x10000) && (src[i] <= kMaxUnicodeChar)) {
+            ++nCount;
+        }
+    }
+    return nCount;
+}
+
+/** UTF32转换为UTF16
+*/
+static void WriteUTF32ToUTF16(const uint32_t* src, size_t length, uint16_t* dst)
+{
+    for (size_t i = 0; i < length; ++i) {
+        dst += EncodeUTF16(src[i], dst);
+    }
+}
+
+std::basic_string<DUTF16Char> StringConvert::UTF8ToUTF16(const DUTF8Char* utf8, size_t length)
+{
+    std::basic_string<DUTF16Char> utf16;
+    size_t nLength = 0;
+    if ((utf8 != nullptr) && (length > 0) &&
+        CalcUTF8ToUTF16Length((const uint8_t*)utf8, length, nLength)) {
+        utf16.resize(nLength);
+        WriteUTF8ToUTF16((const uint8_t*)utf8, length, (uint16_t*)utf16.data());
     }
     return utf16;
 }
 
+bool StringConvert::GetUTF8ToUTF16Length(const UTF8StringView& utf8, size_t& length)
+{
+    length = 0;
+    return CalcUTF8ToUTF16Length((const uint8_t*)utf8.data(), utf8.size(), length);
+}
+
+bool StringConvert::UTF8ToUTF16(const UTF8StringView& utf8, DUTF16Char* output, size_t outputSize, size_t& outputLength)
+{
+    outputLength = 0;
+    if (!CalcUTF8ToUTF16Length((const uint8_t*)utf8.data(), utf8.size(), outputLength)) {
+        return false;
+    }
+    if ((outputLength > outputSize) || ((output == nullptr) && (outputLength > 0))) {
+        return false;
+    }
+    WriteUTF8ToUTF16((const uint8_t*)utf8.data(), utf8.size(), (uint16_t*)output);
+    return true;
+}
+
 DStringW StringConvert::UTF8ToWString(const std::string& utf8)
 {
 #if defined(WCHAR_T_IS_UTF16)
@@ -48,34 +562,35 @@ DStringW StringConvert::UTF8ToWString(const std::string& utf8)
 
 std::string StringConvert::UTF16ToUTF8(const DUTF16Char* utf16, size_t length)
 {
-    if ((utf16 == nullptr) || (length == 0)) {
-        return std::string();
-    }
-    std::vector<DUTF8Char> data;
-    data.resize(8192);
-    DUTF8Char* output = &data[0];
-    const UTF16* src_begin = reinterpret_cast<const UTF16*>(utf16);
-    const UTF16* src_end = src_begin + length;
-    UTF8* dst_begin = reinterpret_cast<UTF8*>(output);
-
     std::string utf8;
-    while (src_begin < src_end) {
-        ConversionResult result = ConvertUTF16toUTF8(&src_begin,
-                                                     src_end,
-                                                     &dst_begin,
-                                                     dst_begin + data.size(),
-                                                     lenientConversion);
-        utf8.append(output, dst_begin - reinterpret_cast<UTF8*>(output));
-        dst_begin = reinterpret_cast<UTF8*>(output);
-        if (result == sourceIllegal || result == sourceExhausted) {
-            utf8.clear();
-            break;
-        }
+    size_t nLength = 0;
+    if ((utf16 != nullptr) && (length > 0) &&
+        CalcUTF16ToUTF8Length((const uint16_t*)utf16, length, nLength)) {
+        utf8.resize(nLength);
+        WriteUTF16ToUTF8((const uint16_t*)utf16, length, (uint8_t*)utf8.data());
     }
-
     return utf8;
 }
 
+bool StringConvert::GetUTF16ToUTF8Length(const UTF16StringView& utf16, size_t& length)
+{
+    length = 0;
+    return CalcUTF16ToUTF8Length((const uint16_t*)utf16.data(), utf16.size(), length);
+}
+
+bool StringConvert::UTF16ToUTF8(const UTF16StringView& utf16, DUTF8Char* output, size_t outputSize, size_t& outputLength)
+{
+    outputLength = 0;
+    if (!CalcUTF16ToUTF8Length((const uint16_t*)utf16.data(), utf16.size(), outputLength)) {
+        return false;
+    }
+    if ((outputLength > outputSize) || ((output == nullptr) && (outputLength > 0))) {
+        return false;
+    }
+    WriteUTF16ToUTF8((const uint16_t*)utf16.data(), utf16.size(), (uint8_t*)output);
+    return true;
+}
+
 std::string StringConvert::WStringToUTF8(const std::wstring& wstr)
 {
 #if defined(WCHAR_T_IS_UTF16)
@@ -90,89 +605,74 @@ std::string StringConvert::WStringToUTF8(const std::wstring& wstr)
 #ifdef DUILIB_UTF32_SUPPORT
 std::basic_string<DUTF32Char> StringConvert::UTF8ToUTF32(const DUTF8Char* utf8, size_t length)
 {
-    std::vector<DUTF32Char> data;
-    data.resize(8192);
-    DUTF32Char* output = &data[0];
-    const UTF8* src_begin = reinterpret_cast<const UTF8*>(utf8);
-    const UTF8* src_end = src_begin + length;
-    UTF32* dst_begin = reinterpret_cast<UTF32*>(output);
-
     std::basic_string<DUTF32Char> utf32;
-    while (src_begin < src_end)
-    {
-        ConversionResult result = ConvertUTF8toUTF32(&src_begin,
-            src_end,
-            &dst_begin,
-            dst_begin + data.size(),
-            lenientConversion);
-
-        utf32.append(output, dst_begin - reinterpret_cast<UTF32*>(output));
-        dst_begin = reinterpret_cast<UTF32*>(output);
-        if (result == sourceIllegal || result == sourceExhausted)
-        {
-            utf32.clear();
-            break;
-        }
+    size_t nLength = 0;
+    if ((utf8 != nullptr) && (length > 0) &&
+        CalcUTF8ToUTF32Length((const uint8_t*)utf8, length, nLength)) {
+        utf32.resize(nLength);
+        WriteUTF8ToUTF32((const uint8_t*)utf8, length, (uint32_t*)utf32.data());
     }
-
     return utf32;
 }
 
-std::string StringConvert::UTF32ToUTF8(const DUTF32Char* utf32, size_t length)
+bool StringConvert::GetUTF8ToUTF32Length(const UTF8StringView& utf8, size_t& length)
 {
-    std::vector<DUTF8Char> data;
-    data.resize(8192);
-    DUTF8Char* output = &data[0];
-    const UTF32* src_begin = reinterpret_cast<const UTF32*>(utf32);
-    const UTF32* src_end = src_begin + length;
-    UTF8* dst_begin = reinterpret_cast<UTF8*>(output);
+    length = 0;
+    return CalcUTF8ToUTF32Length((const uint8_t*)utf8.data(), utf8.size(), length);
+}
 
-    std::string utf8;
-    while (src_begin < src_end)
-    {
-        ConversionResult result = ConvertUTF32toUTF8(&src_begin,
-            src_end,
-            &dst_begin,
-            dst_begin + data.size(),
-            lenientConversion);
-
-        utf8.append(output, dst_begin - reinterpret_cast<UTF8*>(output));
-        dst_begin = reinterpret_cast<UTF8*>(output);
-        if (result == sourceIllegal || result == sourceExhausted)
-        {
-            utf8.clear();
-            break;
-        }
+bool StringConvert::UTF8ToUTF32(const UTF8StringView& utf8, DUTF32Char* output, size_t outputSize, size_t& outputLength)
+{
+    outputLength = 0;
+    if (!CalcUTF8ToUTF32Length((const uint8_t*)utf8.data(), utf8.size(), outputLength)) {
+        return false;
+    }
+    if ((outputLength > outputSize) || ((output == nullptr) && (outputLength > 0))) {
+        return false;
     }
+    WriteUTF8ToUTF32((const uint8_t*)utf8.data(), utf8.size(), (uint32_t*)output);
+    return true;
+}
 
+std::string StringConvert::UTF32ToUTF8(const DUTF32Char* utf32, size_t length)
+{
+    std::string utf8;
+    size_t nLength = 0;
+    if ((utf32 != nullptr) && (length > 0) &&
+        CalcUTF32ToUTF8Length((const uint32_t*)utf32, length, nLength)) {
+        utf8.resize(nLength);
+        WriteUTF32ToUTF8((const uint32_t*)utf32, length, (uint8_t*)utf8.data());
+    }
     return utf8;
 }
 
-std::basic_string<DUTF32Char> StringConvert::UTF16ToUTF32(const DUTF16Char* utf16, size_t length)
+bool StringConvert::GetUTF32ToUTF8Length(const UTF32StringView& utf32, size_t& length)
 {
-    if ((utf16 == nullptr) || (length == 0)) {
-        return std::basic_string<DUTF32Char>();
+    length = 0;
+    return CalcUTF32ToUTF8Length((const uint32_t*)utf32.data(), utf32.size(), length);
+}
+
+bool StringConvert::UTF32ToUTF8(const UTF32StringView& utf32, DUTF8Char* output, size_t outputSize, size_t& outputLength)
+{
+    outputLength = 0;
+    if (!CalcUTF32ToUTF8Length((const uint32_t*)utf32.data(), utf32.size(), outputLength)) {
+        return false;
     }
-    std::vector<DUTF32Char> data;
-    data.resize(8192);
-    DUTF32Char* output = &data[0];
-    const UTF16* src_begin = reinterpret_cast<const UTF16*>(utf16);
-    const UTF16* src_end = src_begin + length;
-    UTF32* dst_begin = reinterpret_cast<UTF32*>(output);
+    if ((outputLength > outputSize) || ((output == nullptr) && (outputLength > 0))) {
+        return false;
+    }
+    WriteUTF32ToUTF8((const uint32_t*)utf32.data(), utf32.size(), (uint8_t*)output);
+    return true;
+}
 
+std::basic_string<DUTF32Char> StringConvert::UTF16ToUTF32(const DUTF16Char* utf16, size_t length)
+{
     std::basic_string<DUTF32Char> utf32;
-    while (src_begin < src_end) {
-        ConversionResult result = ConvertUTF16toUTF32(&src_begin,
-                                                      src_end,
-                                                      &dst_begin,
-                                                      dst_begin + data.size(),
-                                                      lenientConversion);
-        utf32.append(output, dst_begin - reinterpret_cast<UTF32*>(output));
-        dst_begin = reinterpret_cast<UTF32*>(output);
-        if (result == sourceIllegal || result == sourceExhausted) {
-            utf32.clear();
-            break;
-        }
+    size_t nLength = 0;
+    if ((utf16 != nullptr) && (length > 0) &&
+        CalcUTF16ToUTF32Length((const uint16_t*)utf16, length, nLength)) {
+        utf32.resize(nLength);
+        WriteUTF16ToUTF32((const uint16_t*)utf16, length, (uint32_t*)utf32.data());
     }
     return utf32;
 }
@@ -196,26 +696,9 @@ DStringW StringConvert::UTF32ToWString(const DUTF32Char* utf32, size_t length)
         return DStringW();
     }
 #if defined(WCHAR_T_IS_UTF16)
-    std::vector<DUTF16Char> data;
-    data.resize(8192);
-    DUTF16Char* output = &data[0];
-    const UTF32* src_begin = reinterpret_cast<const UTF32*>(utf32);
-    const UTF32* src_end = src_begin + length;
-    UTF16* dst_begin = reinterpret_cast<UTF16*>(output);
     std::wstring utf16;
-    while (src_begin < src_end) {
-        ConversionResult result = ConvertUTF32toUTF16(&src_begin,
-                                                      src_end,
-                                                      &dst_begin,
-                                                      dst_begin + data.size(),
-                                                      lenientConversion);
-        utf16.append((const std::wstring::value_type*)output, dst_begin - reinterpret_cast<UTF16*>(output));
-        dst_begin = reinterpret_cast<UTF16*>(output);
-        if (result == sourceIllegal || result == sourceExhausted) {
-            utf16.clear();
-            break;
-        }
-    }
+    utf16.resize(CalcUTF32ToUTF16Length((const uint32_t*)utf32, length));
+    WriteUTF32ToUTF16((const uint32_t*)utf32, length, (uint16_t*)utf16.data());
     return utf16;
 #else
     ASSERT(sizeof(wchar_t) == sizeof(DUTF32Char));
@@ -19,6 +19,38 @@ public:
     //UTF16字符串转换为UTF8字符串
     static std::string UTF16ToUTF8(const DUTF16Char* utf16, size_t length);
 
+    /** 计算UTF8字符串转换为UTF16后的字符数（不含结尾的'\0'）
+    * @param [in] utf8 UTF8字符串
+    * @param [out] length 返回转换后的字符数
+    * @return 如果UTF8编码无效，返回false
+    */
+    static bool GetUTF8ToUTF16Length(const UTF8StringView& utf8, size_t& length);
+
+    /** UTF8字符串转换为UTF16，写入调用方提供的缓冲区（不分配内存，不写入结尾的'\0'）
+    * @param [in] utf8 UTF8字符串
+    * @param [out] output 输出缓冲区
+    * @param [in] outputSize 输出缓冲区的大小（字符数）
+    * @param [out] outputLength 返回转换后的字符数，如果缓冲区不足，返回需要的字符数
+    * @return 如果UTF8编码无效或者缓冲区不足，返回false
+    */
+    static bool UTF8ToUTF16(const UTF8StringView& utf8, DUTF16Char* output, size_t outputSize, size_t& outputLength);
+
+    /** 计算UTF16字符串转换为UTF8后的字节数（不含结尾的'\0'）
+    * @param [in] utf16 UTF16字符串
+    * @param [out] length 返回转换后的字节数
+    * @return 如果UTF16编码无效，返回false
+    */
+    static bool GetUTF16ToUTF8Length(const UTF16StringView& utf16, size_t& length);
+
+    /** UTF16字符串转换为UTF8，写入调用方提供的缓冲区（不分配内存，不写入结尾的'\0'）
+    * @param [in] utf16 UTF16字符串
+    * @param [out] output 输出缓冲区
+    * @param [in] outputSize 输出缓冲区的大小（字节数）
+    * @param [out] outputLength 返回转换后的字节数，如果缓冲区不足，返回需要的字节数
+    * @return 如果UTF16编码无效或者缓冲区不足，返回false
+    */
+    static bool UTF16ToUTF8(const UTF16StringView& utf16, DUTF8Char* output, size_t outputSize, size_t& outputLength);
+
     //DStringW字符串转换为UTF8字符串
     static std::string WStringToUTF8(const DStringW& wstr);
 
@@ -59,6 +91,18 @@ public:
     static std::string UTF32ToUTF8(const DUTF32Char* utf32, size_t length);
     static std::string UTF32ToUTF8(const std::basic_string<DUTF32Char>& utf32);
 
+    //计算UTF8转换为UTF32后的字符数，UTF8编码无效时返回false
+    static bool GetUTF8ToUTF32Length(const UTF8StringView& utf8, size_t& length);
+
+    //UTF8转换为UTF32，写入调用方提供的缓冲区（参数含义同UTF8ToUTF16）
+    static bool UTF8ToUTF32(const UTF8StringView& utf8, DUTF32Char* output, size_t outputSize, size_t& outputLength);
+
+    //计算UTF32转换为UTF8后的字节数，含有无效字符时返回false
+    static bool GetUTF32ToUTF8Length(const UTF32StringView& utf32, size_t& length);
+
+    //UTF32转换为UTF8，写入调用方提供的缓冲区（参数含义同UTF16ToUTF8）
+    static bool UTF32ToUTF8(const UTF32StringView& utf32, DUTF8Char* output, size_t outputSize, size_t& outputLength);
+
     //UTF16转换为UTF32字符串
     static std::basic_string<DUTF32Char> UTF16ToUTF32(const DUTF16Char* utf16, size_t length);
 
@@ -38,6 +38,7 @@
 #include "Core/ScrollBar.h"
 #include "Core/ControlDragable.h"
 #include "Core/Callback.h"
+#include "Core/Coroutine.h"
 
 #include "Core/Keycode.h"
 #include "Core/Keyboard.h"